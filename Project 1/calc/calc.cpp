@@ -3,8 +3,16 @@
 #include <assert.h>
 #include <string.h>
 #include <ctype.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <stack>
-#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 using namespace std;
 
@@ -30,9 +38,9 @@ typedef enum {
 //class to actually dump the parsetree to a dot file (which can then be turned
 //into a picture).  Note that the return char* is a reference to a local copy
 //and it needs to be duplicated if you are a going require multiple instances
-//simultaniously
+//simultaniously (each thread gets its own copy)
 char* token_to_string(token_type c) {
-	static char buffer[MAX_SYMBOL_NAME_SIZE];
+	static thread_local char buffer[MAX_SYMBOL_NAME_SIZE];
 	switch( c ) {
 		case T_eof: strncpy(buffer,"eof",MAX_SYMBOL_NAME_SIZE); break;
 		case T_num: strncpy(buffer,"num",MAX_SYMBOL_NAME_SIZE); break;
@@ -68,10 +76,10 @@ typedef enum {
 //class to actually dump the parsetree to a dot file (which can then be turned
 //into a picture).  Note that the return char* is a reference to a local copy
 //and it needs to be duplicated if you are a going require multiple instances
-//simultaniously. 
+//simultaniously (each thread gets its own copy). 
 char* nonterm_to_string(nonterm_type nt)
 {
-	static char buffer[MAX_SYMBOL_NAME_SIZE];
+	static thread_local char buffer[MAX_SYMBOL_NAME_SIZE];
 	switch( nt ) {
 		  case epsilon: strncpy(buffer,"e",MAX_SYMBOL_NAME_SIZE); break;
 		  case NT_List: strncpy(buffer,"List",MAX_SYMBOL_NAME_SIZE); break;
@@ -87,8 +95,303 @@ char* nonterm_to_string(nonterm_type nt)
 	return buffer;
 }
 
+/*** Input Class ***********************************************/
+
+//input_t hands the scanner the raw bytes of the program.  If stdin is a
+//regular file the whole thing is mmap'd and scanned in place.  Anything
+//else (a pipe, a terminal) is read in large blocks into a buffer that is
+//refilled whenever the scanner runs off the end of it.  Either way the
+//scanner just walks a pointer over [begin,end) and offsets are counted
+//from the start of the input.  An input_t can also just be a view of
+//bytes that are already in memory, like one piece of a mapped input.
+class input_t {
+  public:
+	const char* begin;	//first byte currently available
+	const char* end;	//one past the last byte currently available
+
+	//offset of p (which must be in [begin,end]) from the start of input
+	size_t offset(const char* p);
+
+	//pulls in more input, keeping everything from keep onward.  keep is
+	//updated to point at the same byte in the (possibly moved) buffer.
+	//Returns false if there is nothing more to read
+	bool refill(const char*& keep);
+
+	//true if the whole input is mapped, so [begin,end) is all of it
+	bool mapped();
+
+	input_t(int fd);
+	//a view of [begin,end), which starts base bytes into the input
+	input_t(const char* begin, const char* end, size_t base);
+	~input_t();
+
+  private:
+	enum { BLOCK_SIZE = 1 << 20 };
+
+	int fd;
+	char* buf;		//read buffer (NULL if the input is mapped or a view)
+	size_t cap;		//size of buf
+	size_t base;		//input offset of begin
+	size_t map_len;		//length of the mapping (0 if not mapped)
+};
+
+input_t::input_t(int fd)
+{
+	struct stat st;
+
+	this->fd = fd;
+	buf = NULL;
+	cap = 0;
+	base = 0;
+	map_len = 0;
+	begin = end = NULL;
+
+	if ( fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 ) {
+		void* m = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if ( m != MAP_FAILED ) {
+			madvise(m, st.st_size, MADV_SEQUENTIAL);
+			map_len = st.st_size;
+			begin = (const char*)m;
+			end = begin + map_len;
+			return;
+		}
+	}
+
+	//not mappable, fall back to reading blocks
+	cap = BLOCK_SIZE;
+	buf = (char*)malloc(cap);
+	assert(buf);
+	begin = end = buf;
+}
+
+input_t::input_t(const char* begin, const char* end, size_t base)
+{
+	fd = -1;
+	buf = NULL;
+	cap = 0;
+	this->base = base;
+	map_len = 0;
+	this->begin = begin;
+	this->end = end;
+}
+
+input_t::~input_t()
+{
+	if ( map_len ) {
+		munmap((void*)begin, map_len);
+	}
+	free(buf);
+}
+
+bool input_t::mapped()
+{
+	return map_len != 0;
+}
+
+size_t input_t::offset(const char* p)
+{
+	return base + (p - begin);
+}
+
+bool input_t::refill(const char*& keep)
+{
+	//the mapping (or view) already holds all of the input
+	if ( !buf ) {
+		return false;
+	}
+
+	//slide the bytes we still need to the front of the buffer, and
+	//grow it if a single token is eating the whole thing
+	size_t kept = end - keep;
+	base += keep - begin;
+	memmove(buf, keep, kept);
+	if ( cap - kept < BLOCK_SIZE / 2 ) {
+		cap *= 2;
+		buf = (char*)realloc(buf, cap);
+		assert(buf);
+	}
+	begin = keep = buf;
+	end = buf + kept;
+
+	ssize_t n;
+	do {
+		n = read(fd, buf + kept, cap - kept);
+	} while ( n < 0 && errno == EINTR );
+
+	if ( n <= 0 ) {
+		return false;
+	}
+	end += n;
+	return true;
+}
+
+/*** Output Buffer Class ***********************************************/
+
+//Everything the evaluator prints goes through an outbuf_t, which collects
+//output in a large buffer and hands it to stdio one batch at a time
+//instead of making a call per result.  Anything else printing to stdout
+//(the error messages) must flush() first so the output stays in order.
+//
+//An outbuf_t without a file just keeps everything in memory, for output
+//that has to wait its turn before it can be written (see chunked_parser_t).
+class outbuf_t {
+  public:
+	void put(char c);
+	void put(const char* s, size_t n);
+	void put_int(long long v);
+	void flush();
+
+	//everything collected so far, if there is no file
+	const char* data();
+	size_t size();
+
+	outbuf_t(FILE* f);
+	~outbuf_t();
+
+  private:
+	enum { BUFFER_SIZE = 1 << 16 };
+
+	FILE* file;		//NULL to collect the output in memory
+	char* buffer;
+	size_t cap;
+	size_t len;
+
+	void make_room(size_t n);
+};
+
+outbuf_t::outbuf_t(FILE* f)
+{
+	file = f;
+	cap = BUFFER_SIZE;
+	len = 0;
+	buffer = (char*)malloc(cap);
+	assert(buffer);
+}
+
+outbuf_t::~outbuf_t()
+{
+	flush();
+	free(buffer);
+}
+
+void outbuf_t::flush()
+{
+	if ( len && file ) {
+		fwrite(buffer, 1, len, file);
+		len = 0;
+	}
+}
+
+const char* outbuf_t::data()
+{
+	return buffer;
+}
+
+size_t outbuf_t::size()
+{
+	return len;
+}
+
+//makes room for n more bytes, by writing out what is in the buffer or,
+//if there is no file to write to, by making the buffer bigger
+void outbuf_t::make_room(size_t n)
+{
+	if ( file ) {
+		flush();
+		return;
+	}
+	while ( cap - len < n ) {
+		cap *= 2;
+	}
+	buffer = (char*)realloc(buffer, cap);
+	assert(buffer);
+}
+
+void outbuf_t::put(char c)
+{
+	if ( len == cap ) {
+		make_room(1);
+	}
+	buffer[len++] = c;
+}
+
+void outbuf_t::put(const char* s, size_t n)
+{
+	if ( len + n > cap ) {
+		if ( file && n > BUFFER_SIZE ) {
+			flush();
+			fwrite(s, 1, n, file);
+			return;
+		}
+		make_room(n);
+	}
+	memcpy(buffer + len, s, n);
+	len += n;
+}
+
+void outbuf_t::put_int(long long v)
+{
+	char digits[24];
+	char* p = digits + sizeof(digits);
+	unsigned long long u = v < 0 ? 0ULL - (unsigned long long)v : v;
+
+	do {
+		*--p = '0' + u % 10;
+		u /= 10;
+	} while ( u );
+	if ( v < 0 ) {
+		*--p = '-';
+	}
+	put(p, digits + sizeof(digits) - p);
+}
+
+//all of stdout goes through here
+outbuf_t output(stdout);
+
+/*** Errors ***********************************************/
+
+//The scanner and parser throw a calc_error_t when the input is bad instead
+//of printing the message and exiting on the spot, so a parse running on a
+//worker thread can be stopped cleanly.  Whoever catches it writes out the
+//output from before the error, then print()s the message and exits with
+//status.
+struct calc_error_t {
+	int status;		//1 for scan errors, 2 for syntax errors
+	int line;		//line of the error, 0 if the message has none
+	char message[128];
+
+	//prints the message, with line_base added to the line number (for
+	//a parse that did not start on the first line)
+	void print(int line_base);
+	calc_error_t(int status = 0, int line = 0);
+};
+
+calc_error_t::calc_error_t(int status, int line)
+{
+	this->status = status;
+	this->line = line;
+	message[0] = 0;
+}
+
+void calc_error_t::print(int line_base)
+{
+	if ( line ) {
+		printf("%s - line %d\n", message, line_base + line);
+	} else {
+		printf("%s\n", message);
+	}
+}
+
 /*** Scanner Class ***********************************************/
 
+//a token is just its type plus where it sits in the input, the scanner
+//never copies the characters out
+struct token_t {
+	token_type type;
+	size_t offset;		//offset of the first byte of the token
+	size_t length;		//number of bytes in the token
+};
+
 class scanner_t {
   public:
 
@@ -98,282 +401,1122 @@ class scanner_t {
 	//peeks at the lookahead token
 	token_type next_token();
 
+	//the full lookahead token (call next_token first)
+	const token_t& token();
+
+	//the characters of the lookahead token.  This points straight into
+	//the input buffer, so it is only good until the token is eaten
+	const char* token_text();
+
 	//return line number for errors
 	int get_line();
 
-	//constructor - inits g_next_token
-	scanner_t();
+	//true if there is nothing left in the input at all (not even
+	//whitespace).  Unlike next_token this never scans anything
+	bool at_end();
 
-  private:
+	//constructor - scans the input in
+	scanner_t(input_t& in);
 
-	//WRITEME: Figure out what you will need to write the scanner
-	//and to implement the above interface.  It does not have to
-	//be a state machine or anything fancy.  Just read in the
-	//characters one at a time (using getchar would be a good way)
-	//and group them into tokens.  All of the tokens in this calculator
-	//are trivial except for the numbers, so it should not be that bad
-	//(10 lines or so)
+  private:
 
-	//This is a bogus member for implementing a useful stub, it should
-	//be cut out once you get the scanner up and going.
-	token_type bogo_token;
+	input_t& in;
+	const char* cursor;	//first byte that has not been scanned yet
 
-	token_type cached_token;
+	token_t cached_token;
 	bool cache_valid; 
-	int num_lines = 1; 
+	int num_lines; 
 
-	//error message and exit if weird character
+	//throws an error if weird character
 	void scan_error(char x);
-	//error message and exit for mismatch
+	//throws an error for mismatch
 	void mismatch_error(token_type c);
 
 };
 
 token_type scanner_t::next_token()
 {
-	//WRITEME: replace this bogus junk with code that will take a peek
-	//at the next token and return it to the parser.  It should _not_
-	//actually consume a token - you should be able to call next_token()
-	//multiple times without actually reading any more tokens in 
-	// if ( bogo_token!=T_plus && bogo_token!=T_eof ) return T_plus;
-	// else return bogo_token;
+	if ( cache_valid ) {
+		return cached_token.type;
+	}
 
-	if(!cache_valid) //Update cache
-	{
-		char input = cin.get(); 
-		while(input == '\n' || input == ' ') //ignore whitespace
-		{
-			if(input == '\n')
-			{
-				num_lines++; 
+	const char* p = cursor;
+
+	//skip whitespace
+	for(;;) {
+		if ( p == in.end && !in.refill(p) ) {
+			cursor = p;
+			cached_token.type = T_eof;
+			cached_token.offset = in.offset(p);
+			cached_token.length = 0;
+			cache_valid = true;
+			return T_eof;
+		}
+		if ( *p == ' ' ) {
+			p++;
+		} else if ( *p == '\n' ) {
+			num_lines++;
+			p++;
+		} else {
+			break;
+		}
+	}
+
+	const char* start = p;
+	token_type t;
+
+	switch( *p++ ) {
+		case '+': t = T_plus; break;
+		case '-': t = T_minus; break;
+		case '*': t = T_times; break;
+		case '.': t = T_period; break;
+		case '|': t = T_bar; break;
+		case '(': t = T_openparen; break;
+		case ')': t = T_closeparen; break;
+		case '0': case '1': case '2': case '3': case '4':
+		case '5': case '6': case '7': case '8': case '9':
+			//numbers can run past the end of a block, so keep
+			//refilling until we see something that is not a digit
+			for(;;) {
+				while ( p != in.end && (unsigned)(*p - '0') < 10 ) {
+					p++;
+				}
+				size_t len = p - start;
+				if ( p != in.end || !in.refill(start) ) {
+					p = start + len;
+					break;
+				}
+				p = start + len;
 			}
-			input = cin.get(); 
+			t = T_num;
+			break;
+		default:
+			scan_error(*start);
+			return T_eof;
+	}
+
+	cursor = p;
+	cached_token.type = t;
+	cached_token.offset = in.offset(start);
+	cached_token.length = p - start;
+	cache_valid = true;
+
+	return t;
+}
+
+const token_t& scanner_t::token()
+{
+	next_token();
+	return cached_token;
+}
+
+const char* scanner_t::token_text()
+{
+	next_token();
+	return cursor - cached_token.length;
+}
+
+void scanner_t::eat_token(token_type c)
+{
+	//if we are supposed to eat token c, and it does not match
+	//what we are supposed to be reading from file, then it is a 
+	//mismatch error ( call - mismatch_error(c) )
+	if ( next_token() != c ) {
+		mismatch_error(c); 
+	}
+
+	cache_valid = false; 
+}
+
+scanner_t::scanner_t(input_t& in) : in(in)
+{
+	cursor = in.begin;
+	cache_valid = false; 
+	num_lines = 1;
+}
+
+int scanner_t::get_line()
+{
+	return num_lines; 
+}
+
+bool scanner_t::at_end()
+{
+	return !cache_valid && cursor == in.end;
+}
+
+void scanner_t::scan_error (char x)
+{
+	calc_error_t e(1);
+	snprintf(e.message, sizeof(e.message), "scan error: unrecognized character '%c'", x);
+	throw e;
+}
+
+void scanner_t::mismatch_error (token_type x)
+{
+	calc_error_t e(2, get_line());
+	int n = snprintf(e.message, sizeof(e.message), "syntax error: found %s ", token_to_string(next_token()));
+	snprintf(e.message + n, sizeof(e.message) - n, "expecting %s", token_to_string(x));
+	throw e;
+}
+
+
+/*** ParseTree Sinks **********************************************/
+
+//one node of the parse tree, as handed to a treesink_t
+struct treenode_t {
+	int kind;		//token_type for terminals, nonterm_type otherwise
+	bool terminal;
+	int uniq;		//unique id of this node (numbered from 1)
+	int parent;		//uniq of the parent (0 for the root)
+	int parent_kind;	//nonterm_type of the parent
+	size_t offset;		//input span of the token, for terminals
+	size_t length;
+};
+
+//parsetree_t tells a sink about every node as the tree is built, and the
+//sink decides what (if anything) to do with it.  start() is called just
+//before the root is pushed, open() when a node is pushed and finish() once
+//the root has been popped.  Sinks only ever see nodes in the order they
+//are pushed, so the parser is free to forget about a node as soon as its
+//last child has been pushed.  A parse that picks up in the middle of a
+//tree (see parsetree_t::resume) may see neither start() nor finish().
+class treesink_t {
+  public:
+	virtual void start() = 0;
+	virtual void open(const treenode_t& n) = 0;
+	virtual void finish() = 0;
+	virtual ~treesink_t() {}
+};
+
+//throws the tree away, for when all we want to know is if the input parses
+class nullsink_t : public treesink_t {
+  public:
+	void start() {}
+	void open(const treenode_t&) {}
+	void finish() {}
+};
+
+//writes the tree as a dot file (which can then be turned into a picture).
+//Node names are looked up once up front and everything is formatted by
+//hand into an outbuf_t, so drawing a node does not cost any stdio calls
+class dotsink_t : public treesink_t {
+  public:
+	void start();
+	void open(const treenode_t& n);
+	void finish();
+	dotsink_t(outbuf_t& out);
+
+  private:
+	struct name_t {
+		char str[MAX_SYMBOL_NAME_SIZE];
+		size_t len;
+	};
+
+	outbuf_t& out;
+	name_t tokens[T_closeparen + 1];
+	name_t nonterms[NT_Fact - epsilon + 1];
+
+	void put_id(const name_t& nm, int uniq);
+};
+
+dotsink_t::dotsink_t(outbuf_t& out) : out(out)
+{
+	for( int i = T_eof; i <= T_closeparen; i++ ) {
+		strncpy(tokens[i].str, token_to_string((token_type)i), MAX_SYMBOL_NAME_SIZE);
+		tokens[i].len = strlen(tokens[i].str);
+	}
+	for( int i = epsilon; i <= NT_Fact; i++ ) {
+		strncpy(nonterms[i - epsilon].str, nonterm_to_string((nonterm_type)i), MAX_SYMBOL_NAME_SIZE);
+		nonterms[i - epsilon].len = strlen(nonterms[i - epsilon].str);
+	}
+}
+
+void dotsink_t::start()
+{
+	static const char header[] = "digraph G { page=\"8.5,11\"; size=\"7.5, 10\"\n";
+	out.put(header, sizeof(header) - 1);
+}
+
+//writes the "name+uniq" that identifies a node in the dot file
+void dotsink_t::put_id(const name_t& nm, int uniq)
+{
+	out.put('"');
+	out.put(nm.str, nm.len);
+	out.put_int(uniq);
+	out.put('"');
+}
+
+// prints out the command to draw an edge from the parent to the new node.
+// If it happens to be a terminal then it makes it a snazzy blue color so
+// you can see your program on the leaves 
+void dotsink_t::open(const treenode_t& n)
+{
+	static const char label[] = " [label=\"";
+	static const char terminal[] = "\",style=filled,fillcolor=powderblue]\n";
+	static const char nonterminal[] = "\"]\n";
+	static const char arrow[] = " -> ";
+	const name_t& nm = n.terminal ? tokens[n.kind] : nonterms[n.kind - epsilon];
+
+	out.put('\t');
+	put_id(nm, n.uniq);
+	out.put(label, sizeof(label) - 1);
+	out.put(nm.str, nm.len);
+	if ( n.terminal ) {
+		out.put(terminal, sizeof(terminal) - 1);
+	} else {
+		out.put(nonterminal, sizeof(nonterminal) - 1);
+	}
+
+	//no edge to print if this is the first node
+	if ( n.parent ) {
+		out.put('\t');
+		put_id(nonterms[n.parent_kind - epsilon], n.parent);
+		out.put(arrow, sizeof(arrow) - 1);
+		put_id(nm, n.uniq);
+		out.put('\n');
+	}
+}
+
+void dotsink_t::finish()
+{
+	out.put("}\n", 2);
+}
+
+//writes the tree in a compact binary form that can be read back without
+//parsing dot.  The file is a header followed by one fixed size record per
+//node, in the order the nodes are pushed (so a parent always comes before
+//its children).  Every field is little endian.
+//
+//  header:  char magic[8] = "CALCTREE", u32 version = 2, u32 record size
+//  record:  u32 uniq, u32 parent (0 for the root), u16 kind, u16 terminal,
+//           u32 length, u64 offset
+//
+//kind uses the token_type/nonterm_type numbering.  For terminals
+//offset/length are the bytes of the token in the input; they are 0 for
+//non-terminals, whose span is just that of the tokens below them.
+class binsink_t : public treesink_t {
+  public:
+	void start();
+	void open(const treenode_t& n);
+	void finish() {}
+	binsink_t(outbuf_t& out);
+
+  private:
+	enum { VERSION = 2, RECORD_SIZE = 24 };
+
+	outbuf_t& out;
+	void put_u16(char* p, unsigned v);
+	void put_u32(char* p, unsigned long v);
+	void put_u64(char* p, unsigned long long v);
+};
+
+binsink_t::binsink_t(outbuf_t& out) : out(out)
+{
+}
+
+void binsink_t::start()
+{
+	char header[16];
+	memcpy(header, "CALCTREE", 8);
+	put_u32(header + 8, VERSION);
+	put_u32(header + 12, RECORD_SIZE);
+	out.put(header, sizeof(header));
+}
+
+void binsink_t::put_u16(char* p, unsigned v)
+{
+	p[0] = v;
+	p[1] = v >> 8;
+}
+
+void binsink_t::put_u32(char* p, unsigned long v)
+{
+	put_u16(p, v & 0xffff);
+	put_u16(p + 2, v >> 16);
+}
+
+void binsink_t::put_u64(char* p, unsigned long long v)
+{
+	put_u32(p, v & 0xffffffff);
+	put_u32(p + 4, v >> 32);
+}
+
+void binsink_t::open(const treenode_t& n)
+{
+	char rec[RECORD_SIZE];
+	put_u32(rec, n.uniq);
+	put_u32(rec + 4, n.parent);
+	put_u16(rec + 8, n.kind);
+	put_u16(rec + 10, n.terminal);
+	put_u32(rec + 12, n.length);
+	put_u64(rec + 16, n.offset);
+	out.put(rec, RECORD_SIZE);
+}
+
+
+/*** ParseTree Class **********************************************/
+
+//keeps track of where we are in the parse tree and reports every node to
+//a treesink_t, which decides what to actually do with it.  The interface
+//is described below on the actual methods.  You will have to call it from
+//your recursive decent parser, so read about the interface below.
+
+//where a parse tree stands in between two statements: the list node (List
+//or List') the next statement hangs off of, and how many nodes have been
+//drawn so far
+struct treepos_t {
+	int kind;
+	int uniq;
+	int counter;
+};
+
+class parsetree_t {
+  public:
+	void push(token_type t, const token_t& tok);
+	void push(nonterm_type nt, bool tail = false);
+	void pop();
+	void drawepsilon();
+	treepos_t position();
+	void resume(const treepos_t& at);
+	parsetree_t(treesink_t* sink);
+  private:
+	struct stuple {
+		int kind;
+		int uniq;
+	};
+	void push(treenode_t& n);
+	treesink_t* sink;
+	vector<stuple> stuple_stack;
+	int counter;
+};
+
+
+//the constructer just starts by initializing a counter (used to uniquely
+//name all the parse tree nodes)
+parsetree_t::parsetree_t(treesink_t* sink)
+{
+	this->sink = sink;
+	counter = 0;
+}
+
+//This push function taken a non terminal and keeps it on the parsetree
+//stack.  The stack keeps trace of where we are in the parse tree as
+//we walk it in a depth first way.  You should call push when you start
+//expanding a symbol, and call pop when you are done.  The parsetree_t
+//will keep track of everything, and draw the parse tree as you go.
+//This particular function should be called if you are pushing a non-terminal.
+//
+//Set tail if nt is the last symbol of the production being expanded at the
+//top of the stack.  nt then takes its parent's place on the stack, and the
+//pop that finishes nt finishes the parent too.  That keeps the stack from
+//growing with every List' (and Expr' and Term') in a long input.
+void parsetree_t::push(nonterm_type nt, bool tail)
+{
+	treenode_t temp;
+	temp.kind = nt;
+	temp.terminal = false;
+	temp.offset = 0;
+	temp.length = 0;
+	push(temp);
+
+	if ( tail ) {
+		stuple top = stuple_stack.back();
+		stuple_stack.pop_back();
+		stuple_stack.back() = top;
+	}
+}
+
+//same as above, but for terminals.  tok is the token being eaten
+void parsetree_t::push(token_type t, const token_t& tok)
+{
+	treenode_t temp;
+	temp.kind = t;
+	temp.terminal = true;
+	temp.offset = tok.offset;
+	temp.length = tok.length;
+	push(temp);
+}
+
+void parsetree_t::push(treenode_t& n)
+{
+	counter ++;
+	n.uniq = counter;
+	if ( stuple_stack.empty() ) {
+		n.parent = 0;
+		n.parent_kind = 0;
+		sink->start();
+	} else {
+		n.parent = stuple_stack.back().uniq;
+		n.parent_kind = stuple_stack.back().kind;
+	}
+	sink->open( n );
+
+	stuple temp;
+	temp.kind = n.kind;
+	temp.uniq = n.uniq;
+	stuple_stack.push_back( temp );
+}
+
+//when you are parsing a symbol, pop it.  That way the parsetree_t will
+//know that you are now working on a higher part of the tree.
+void parsetree_t::pop()
+{
+	if ( !stuple_stack.empty() ) {
+		stuple_stack.pop_back();
+	}
+
+	if ( stuple_stack.empty() ) {
+		sink->finish();
+	}
+}
+
+//where the tree stands, which must be in between two statements (so the
+//only thing on the stack is the current list node)
+treepos_t parsetree_t::position()
+{
+	assert( stuple_stack.size() == 1 );
+	treepos_t at;
+	at.kind = stuple_stack.back().kind;
+	at.uniq = stuple_stack.back().uniq;
+	at.counter = counter;
+	return at;
+}
+
+//picks up drawing a tree somebody else started, at a position they got
+//from position().  The next node pushed is numbered at.counter + 1
+void parsetree_t::resume(const treepos_t& at)
+{
+	stuple temp;
+	temp.kind = at.kind;
+	temp.uniq = at.uniq;
+	stuple_stack.clear();
+	stuple_stack.push_back( temp );
+	counter = at.counter;
+}
+
+//draw an epsilon on the parse tree hanging off of the top of stack
+void parsetree_t::drawepsilon()
+{
+	push(epsilon);
+	pop();
+}
+
+
+/*** Bignum Class ***********************************************/
+
+//Numbers in calc can have as many digits as you like, so the evaluator
+//computes with bignum_t values, which are exact.  A bignum_t is a sign and
+//a magnitude, stored as limbs of 9 decimal digits each (so in base 10^9),
+//least significant limb first, with no zero limbs on top.  Zero has no
+//limbs at all and is never negative.
+//
+//Keeping the limbs in a power of ten makes reading a number in and
+//printing it out linear (9 digits are just copied to or from each limb)
+//where a binary base would need quadratic base conversion, which would
+//cost far more than all the arithmetic in a statement.  Everything fits
+//in 64 bit products.  Multiplication is the schoolbook method on small
+//numbers and Karatsuba's method once both numbers have at least
+//KARATSUBA_THRESHOLD limbs (which has to be at least 4, or the sums of the
+//halves would be as long as the numbers they came from).
+class bignum_t {
+  public:
+	typedef unsigned limb_t;
+
+	//appends the limbs of the number spelled by the len digits at s to
+	//limbs, and returns how many there are
+	static size_t decimal_limbs(const char* s, size_t len, vector<limb_t>& limbs);
+	//sets the value to the (non-negative) number with the n limbs at p
+	void set_limbs(const limb_t* p, size_t n);
+
+	//this = this + b, this - b
+	void add(const bignum_t& b);
+	void sub(const bignum_t& b);
+	//this = a * b (neither a nor b may be this)
+	void mul(const bignum_t& a, const bignum_t& b);
+	//this = -this, |this|
+	void negate();
+	void absolute();
+
+	//writes the value out in decimal
+	void put(outbuf_t& out) const;
+
+	bignum_t();
+
+  private:
+	typedef unsigned long long wide_t;
+	enum { DIGITS = 9, BASE = 1000000000, KARATSUBA_THRESHOLD = 32 };
+
+	bool negative;
+	vector<limb_t> mag;
+
+	void trim();
+	void add_signed(const bignum_t& b, bool b_negative);
+
+	static int compare(const limb_t* a, size_t na, const limb_t* b, size_t nb);
+	static limb_t add_into(limb_t* r, size_t nr, const limb_t* a, size_t na);
+	static void sub_into(limb_t* r, size_t nr, const limb_t* a, size_t na);
+	static void mul_school(const limb_t* a, size_t na, const limb_t* b, size_t nb, limb_t* r);
+	static void mul_mag(const limb_t* a, size_t na, const limb_t* b, size_t nb, limb_t* r);
+};
+
+bignum_t::bignum_t()
+{
+	negative = false;
+}
+
+//drops zero limbs off the top (and the sign off of zero)
+void bignum_t::trim()
+{
+	while ( !mag.empty() && mag.back() == 0 ) {
+		mag.pop_back();
+	}
+	if ( mag.empty() ) {
+		negative = false;
+	}
+}
+
+size_t bignum_t::decimal_limbs(const char* s, size_t len, vector<limb_t>& limbs)
+{
+	while ( len > 0 && *s == '0' ) {
+		s++;
+		len--;
+	}
+
+	//limbs are filled from the least significant digits up
+	size_t n = (len + DIGITS - 1) / DIGITS;
+	size_t end = len;
+	for( size_t i = 0; i < n; i++ ) {
+		size_t start = end > DIGITS ? end - DIGITS : 0;
+		limb_t v = 0;
+		for( size_t j = start; j < end; j++ ) {
+			v = v * 10 + (s[j] - '0');
+		}
+		limbs.push_back(v);
+		end = start;
+	}
+	return n;
+}
+
+void bignum_t::set_limbs(const limb_t* p, size_t n)
+{
+	negative = false;
+	mag.assign(p, p + n);
+}
+
+void bignum_t::put(outbuf_t& out) const
+{
+	if ( mag.empty() ) {
+		out.put('0');
+		return;
+	}
+	if ( negative ) {
+		out.put('-');
+	}
+
+	//the top limb is printed as is, the rest are padded out to 9 digits
+	out.put_int(mag.back());
+	for( size_t i = mag.size() - 1; i-- > 0; ) {
+		char digits[DIGITS];
+		limb_t v = mag[i];
+		for( int d = DIGITS - 1; d >= 0; d-- ) {
+			digits[d] = '0' + v % 10;
+			v /= 10;
 		}
+		out.put(digits, DIGITS);
+	}
+}
+
+void bignum_t::negate()
+{
+	if ( !mag.empty() ) {
+		negative = !negative;
+	}
+}
+
+void bignum_t::absolute()
+{
+	negative = false;
+}
+
+void bignum_t::add(const bignum_t& b)
+{
+	add_signed(b, b.negative);
+}
+
+void bignum_t::sub(const bignum_t& b)
+{
+	add_signed(b, !b.negative && !b.mag.empty());
+}
+
+//this = this + b, where b has the sign b_negative instead of its own
+void bignum_t::add_signed(const bignum_t& b, bool b_negative)
+{
+	assert( &b != this );
+	if ( negative == b_negative ) {
+		if ( mag.size() < b.mag.size() ) {
+			mag.resize(b.mag.size(), 0);
+		}
+		if ( add_into(mag.data(), mag.size(), b.mag.data(), b.mag.size()) ) {
+			mag.push_back(1);
+		}
+		return;
+	} else if ( compare(mag.data(), mag.size(), b.mag.data(), b.mag.size()) >= 0 ) {
+		sub_into(mag.data(), mag.size(), b.mag.data(), b.mag.size());
+	} else {
+		//|b| is bigger, so the answer is b's size and sign
+		vector<limb_t> r(b.mag);
+		sub_into(&r[0], r.size(), mag.data(), mag.size());
+		mag.swap(r);
+		negative = b_negative;
+	}
+	trim();
+}
+
+void bignum_t::mul(const bignum_t& a, const bignum_t& b)
+{
+	assert( &a != this && &b != this );
+	if ( a.mag.empty() || b.mag.empty() ) {
+		mag.clear();
+		negative = false;
+		return;
+	}
+	mag.resize(a.mag.size() + b.mag.size());
+	mul_mag(a.mag.data(), a.mag.size(), b.mag.data(), b.mag.size(), &mag[0]);
+	negative = a.negative != b.negative;
+	trim();
+}
 
-		if(cin.eof())
-		{
-			cached_token = T_eof; 
-			return cached_token; 
+//compares the magnitudes a and b (which must not have zero limbs on top)
+int bignum_t::compare(const limb_t* a, size_t na, const limb_t* b, size_t nb)
+{
+	if ( na != nb ) {
+		return na < nb ? -1 : 1;
+	}
+	while ( na-- > 0 ) {
+		if ( a[na] != b[na] ) {
+			return a[na] < b[na] ? -1 : 1;
 		}
+	}
+	return 0;
+}
 
-		switch(input)
-		{
-			case '+': 
-				cached_token = T_plus; 
-			break;
-			case '-': 
-				cached_token = T_minus; 
-			break; 
-			case '*': 
-				cached_token = T_times; 
-			break; 
-			case '.': 
-				cached_token = T_period; 
-			break; 
-			case '|': 
-				cached_token = T_bar; 
-			break; 
-			case '(': 
-				cached_token = T_openparen; 
-			break; 
-			case ')':
-				cached_token = T_closeparen; 
-			break; 
-			case '0': 
-			case '1': 
-			case '2': 
-			case '3': 
-			case '4': 
-			case '5': 
-			case '6': 
-			case '7': 
-			case '8': 
-			case '9': 
-					  while(isdigit(cin.peek()))
-					  {
-						cin.get(); 
-					  }
-					  cached_token = T_num; 
-			break; 
-			default:
-				scan_error(input); 
-			break; 
+//r += a, where r has nr >= na limbs.  Returns the carry out of the top
+//limb of r
+bignum_t::limb_t bignum_t::add_into(limb_t* r, size_t nr, const limb_t* a, size_t na)
+{
+	limb_t carry = 0;
+	size_t i;
+	for( i = 0; i < na; i++ ) {
+		limb_t s = r[i] + a[i] + carry;
+		carry = s >= BASE;
+		r[i] = carry ? s - BASE : s;
+	}
+	for( ; carry && i < nr; i++ ) {
+		carry = ++r[i] == BASE;
+		if ( carry ) {
+			r[i] = 0;
 		}
+	}
+	return carry;
+}
 
-		cache_valid = true; 
+//r -= a, where r has nr >= na limbs and is at least as big as a
+void bignum_t::sub_into(limb_t* r, size_t nr, const limb_t* a, size_t na)
+{
+	limb_t borrow = 0;
+	size_t i;
+	for( i = 0; i < na; i++ ) {
+		limb_t d = a[i] + borrow;
+		borrow = r[i] < d;
+		r[i] = borrow ? r[i] + BASE - d : r[i] - d;
+	}
+	for( ; borrow && i < nr; i++ ) {
+		borrow = r[i] == 0;
+		r[i] = borrow ? BASE - 1 : r[i] - 1;
 	}
+	assert( !borrow );
+}
 
-	return cached_token;
+//r = a * b, where r has room for na + nb limbs
+void bignum_t::mul_school(const limb_t* a, size_t na, const limb_t* b, size_t nb, limb_t* r)
+{
+	memset(r, 0, (na + nb) * sizeof(limb_t));
+	for( size_t i = 0; i < na; i++ ) {
+		wide_t carry = 0;
+		for( size_t j = 0; j < nb; j++ ) {
+			wide_t t = r[i + j] + (wide_t)a[i] * b[j] + carry;
+			r[i + j] = t % BASE;
+			carry = t / BASE;
+		}
+		r[i + nb] = carry;
+	}
 }
 
-void scanner_t::eat_token(token_type c)
+//r = a * b, where r has room for na + nb limbs.  a and b may have zero
+//limbs on top.  Once both are big enough this splits them in half around
+//B = BASE^m and does Karatsuba's three multiplications instead of four:
+//
+//  a*b = a1*b1 B^2 + ((a0 + a1)(b0 + b1) - a0*b0 - a1*b1) B + a0*b0
+void bignum_t::mul_mag(const limb_t* a, size_t na, const limb_t* b, size_t nb, limb_t* r)
 {
-	//if we are supposed to eat token c, and it does not match
-	//what we are supposed to be reading from file, then it is a 
-	//mismatch error ( call - mismatch_error(c) )
-	cache_valid = false; 
+	if ( na < nb ) {
+		swap(a, b);
+		swap(na, nb);
+	}
+	if ( nb < KARATSUBA_THRESHOLD ) {
+		mul_school(a, na, b, nb, r);
+		return;
+	}
 
-	if(cached_token != c)
-	{
-		mismatch_error(c); 
+	size_t m = na / 2;
+
+	//b is too short to split, so do the two halves of a separately
+	if ( nb <= m ) {
+		vector<limb_t> high(na - m + nb);
+		mul_mag(a, m, b, nb, r);
+		mul_mag(a + m, na - m, b, nb, &high[0]);
+		memset(r + m + nb, 0, (na - m) * sizeof(limb_t));
+		limb_t carry = add_into(r + m, na - m + nb, &high[0], high.size());
+		assert( !carry );
+		return;
+	}
+
+	const limb_t* a0 = a;
+	const limb_t* a1 = a + m;
+	const limb_t* b0 = b;
+	const limb_t* b1 = b + m;
+	size_t na1 = na - m;
+	size_t nb1 = nb - m;
+
+	//a0*b0 and a1*b1 go straight into the low and high parts of r
+	mul_mag(a0, m, b0, m, r);
+	mul_mag(a1, na1, b1, nb1, r + 2 * m);
+
+	//(a0 + a1) and (b0 + b1), each one limb longer than its longer half
+	vector<limb_t> sa(na1 + 1, 0);
+	vector<limb_t> sb(max(m, nb1) + 1, 0);
+	memcpy(&sa[0], a1, na1 * sizeof(limb_t));
+	add_into(&sa[0], sa.size(), a0, m);
+	memcpy(&sb[0], b0, m * sizeof(limb_t));
+	add_into(&sb[0], sb.size(), b1, nb1);
+
+	vector<limb_t> mid(sa.size() + sb.size());
+	mul_mag(&sa[0], sa.size(), &sb[0], sb.size(), &mid[0]);
+	sub_into(&mid[0], mid.size(), r, 2 * m);
+	sub_into(&mid[0], mid.size(), r + 2 * m, na1 + nb1);
+
+	//what is left of the middle term fits in r, past any zeros on top
+	size_t nmid = mid.size();
+	while ( nmid > 0 && mid[nmid - 1] == 0 ) {
+		nmid--;
 	}
+	limb_t carry = add_into(r + m, na + nb - m, &mid[0], nmid);
+	assert( !carry );
 }
 
-scanner_t::scanner_t()
+
+/*** Evaluator Class ***********************************************/
+
+//The evaluator computes the value of each statement as it is parsed.  The
+//parser lowers the statement into a postfix program (one opcode byte per
+//operation plus a table of the constants it pushes), and when the '.'
+//is eaten the program is run on a value stack and the result is written
+//to the output buffer.  Only one statement is ever held at a time, so
+//memory use does not grow with the size of the input.
+typedef enum {
+	OP_push,	// push the next constant
+	OP_add,		// a b -> a+b
+	OP_sub,		// a b -> a-b
+	OP_mul,		// a b -> a*b
+	OP_neg,		// a -> -a
+	OP_abs		// a -> |a|
+} op_type;
+
+class evaluator_t {
+  public:
+	//push the number spelled by the len digits at s
+	void num(const char* s, size_t len);
+
+	//append an operator to the current statement
+	void op(op_type o);
+
+	//run the current statement, print the result and start a new one
+	void run();
+
+	evaluator_t(outbuf_t& out);
+
+  private:
+	outbuf_t& out;
+	vector<unsigned char> code;
+
+	//the limbs of all the constants in the statement, one after the
+	//other, and where each one starts and how long it is
+	vector<bignum_t::limb_t> limbs;
+	vector<size_t> constants;
+
+	//the value stack only ever grows, and only the first depth entries
+	//are in use.  That way the bignum_t's in it keep their limbs from one
+	//statement to the next instead of allocating new ones all the time
+	vector<bignum_t> stack;
+	size_t depth;
+	bignum_t product;
+};
+
+evaluator_t::evaluator_t(outbuf_t& out) : out(out)
 {
-	cache_valid = false; 
+	depth = 0;
 }
 
-int scanner_t::get_line()
+void evaluator_t::num(const char* s, size_t len)
 {
-	return num_lines; 
+	constants.push_back(limbs.size());
+	constants.push_back(bignum_t::decimal_limbs(s, len, limbs));
+	code.push_back(OP_push);
 }
 
-void scanner_t::scan_error (char x)
+void evaluator_t::op(op_type o)
 {
-	printf("scan error: unrecognized character '%c'\n",x);  
-	exit(1);
-
+	code.push_back(o);
 }
 
-void scanner_t::mismatch_error (token_type x)
+void evaluator_t::run()
 {
-	printf("syntax error: found %s ",token_to_string(next_token()) );
-	printf("expecting %s - line %d\n", token_to_string(x), get_line());
-	exit(2);
+	size_t next_constant = 0;
+
+	depth = 0;
+	for( size_t pc = 0; pc < code.size(); pc++ ) {
+		switch( code[pc] ) {
+			case OP_push:
+				if ( depth == stack.size() ) {
+					stack.push_back(bignum_t());
+				}
+				stack[depth++].set_limbs(limbs.data() + constants[next_constant], constants[next_constant + 1]);
+				next_constant += 2;
+				break;
+			case OP_add:
+				depth--;
+				stack[depth - 1].add(stack[depth]);
+				break;
+			case OP_sub:
+				depth--;
+				stack[depth - 1].sub(stack[depth]);
+				break;
+			case OP_mul:
+				depth--;
+				product.mul(stack[depth - 1], stack[depth]);
+				swap(product, stack[depth - 1]);
+				break;
+			case OP_neg:
+				stack[depth - 1].negate();
+				break;
+			case OP_abs:
+				stack[depth - 1].absolute();
+				break;
+			default:
+				assert(0);
+		}
+	}
+	assert(depth == 1);
+
+	stack[0].put(out);
+	out.put('\n');
+
+	code.clear();
+	limbs.clear();
+	constants.clear();
 }
 
 
-/*** ParseTree Class **********************************************/
+/*** LL(1) Parse Table **********************************************/
 
-//just dumps out the tree as a dot file.  The interface is described below
-//on the actual methods.  This class is full and complete.  You should not
-//have to touch a thing if everything goes according to plan.  While you don't
-//have to modify it, you will have to call it from your recursive decent
-//parser, so read about the interface below.
-class parsetree_t {
+//The grammar the parser recognizes, written out as data.  Right hand sides
+//mix terminals (token_type), non-terminals (nonterm_type) and actions,
+//which are not part of the language but tell the parser when to feed the
+//evaluator.  This is the same grammar the recursive decent routines below
+//implement by hand, and the parse table is derived from it.
+typedef enum {
+	A_num = 200,	// evaluator->num() on the lookahead number
+	A_add,		// evaluator->op(OP_add) ...
+	A_sub,
+	A_mul,
+	A_neg,
+	A_abs,
+	A_run		// evaluator->run()
+} action_type;
+
+#define MAX_RHS 5
+#define END_RHS (-1)
+
+struct production_t {
+	nonterm_type lhs;
+	int rhs[MAX_RHS + 1];	//terminated by END_RHS
+};
+
+static const production_t grammar[] = {
+	{ NT_List,       { NT_Expr, T_period, A_run, NT_List_Prime, END_RHS } },
+	{ NT_List_Prime, { NT_Expr, T_period, A_run, NT_List_Prime, END_RHS } },
+	{ NT_List_Prime, { END_RHS } },
+	{ NT_Expr,       { NT_Term, NT_Expr_Prime, END_RHS } },
+	{ NT_Expr_Prime, { T_plus, NT_Term, A_add, NT_Expr_Prime, END_RHS } },
+	{ NT_Expr_Prime, { T_minus, NT_Term, A_sub, NT_Expr_Prime, END_RHS } },
+	{ NT_Expr_Prime, { END_RHS } },
+	{ NT_Term,       { NT_Fact, NT_Term_Prime, END_RHS } },
+	{ NT_Term_Prime, { T_times, NT_Fact, A_mul, NT_Term_Prime, END_RHS } },
+	{ NT_Term_Prime, { END_RHS } },
+	{ NT_Fact,       { A_num, T_num, END_RHS } },
+	{ NT_Fact,       { T_minus, NT_Fact, A_neg, END_RHS } },
+	{ NT_Fact,       { T_openparen, NT_Expr, T_closeparen, END_RHS } },
+	{ NT_Fact,       { T_bar, NT_Expr, T_bar, A_abs, END_RHS } },
+};
+
+#define NUM_PRODUCTIONS ((int)(sizeof(grammar) / sizeof(grammar[0])))
+#define NUM_TOKENS (T_closeparen + 1)
+#define NUM_NONTERMS (NT_Fact - epsilon + 1)
+
+static bool is_token(int sym) { return sym >= T_eof && sym <= T_closeparen; }
+static bool is_nonterm(int sym) { return sym > epsilon && sym <= NT_Fact; }
+
+//the parse table: for each non-terminal and lookahead, the production to
+//expand (or -1 for a syntax error).  It is worked out once from the
+//grammar above using the usual FIRST and FOLLOW sets.
+//
+//A non-terminal with only one production just expands it without looking
+//at the next token at all (only() returns it).  A bad token then gets
+//reported by the first non-terminal that actually has to choose, which is
+//the same place the recursive decent parser finds it.
+class ll1_table_t {
   public:
-	void push(token_type t);
-	void push(nonterm_type nt);
-	void pop();
-	void drawepsilon();
-	parsetree_t();
+	int lookup(nonterm_type nt, token_type t) const;
+	int only(nonterm_type nt) const;
+	static const ll1_table_t& get();
+
   private:
-	enum stype_t{
-		TERMINAL=1,
-		NONTERMINAL=0,
-		UNDEF=-1
-	};
+	typedef unsigned tokenset_t;	//bit t is set if token t is in the set
 
-	struct stuple { 
-		nonterm_type nt;
-		token_type t;
-		stype_t stype; 
-		int uniq;
-	};
-	void printedge(stuple temp); //prints edge from TOS->temp
-	stack<stuple> stuple_stack;
-	char* stuple_to_string(const stuple& s); 
-	int counter;
-};
+	int table[NUM_NONTERMS][NUM_TOKENS];
+	int single[NUM_NONTERMS];
+	bool nullable[NUM_NONTERMS];
+	tokenset_t first[NUM_NONTERMS];
+	tokenset_t follow[NUM_NONTERMS];
 
+	ll1_table_t();
+	bool first_of(const int* rhs, tokenset_t& set) const;
+	void set_entry(int nt, int t, int prod);
+};
 
-//the constructer just starts by initializing a counter (used to uniquely
-//name all the parse tree nodes) and by printing out the necessary dot commands
-parsetree_t::parsetree_t()
+const ll1_table_t& ll1_table_t::get()
 {
-	counter = 0;
-	printf("digraph G { page=\"8.5,11\"; size=\"7.5, 10\"\n");
+	static const ll1_table_t table;
+	return table;
 }
 
-//This push function taken a non terminal and keeps it on the parsetree
-//stack.  The stack keeps trace of where we are in the parse tree as
-//we walk it in a depth first way.  You should call push when you start
-//expanding a symbol, and call pop when you are done.  The parsetree_t
-//will keep track of everything, and draw the parse tree as you go.
-//This particular function should be called if you are pushing a non-terminal
-void parsetree_t::push(nonterm_type nt)
+int ll1_table_t::lookup(nonterm_type nt, token_type t) const
 {
-	counter ++;
-	stuple temp;
-	temp.nt = nt;
-	temp.stype = NONTERMINAL;
-	temp.uniq = counter;
-	printedge( temp );
-	stuple_stack.push( temp );
+	return table[nt - epsilon][t];
 }
 
-//same as above, but for terminals
-void parsetree_t::push(token_type t)
+int ll1_table_t::only(nonterm_type nt) const
 {
-	counter ++;
-	stuple temp;
-	temp.t = t;
-	temp.stype = TERMINAL;
-	temp.uniq = counter;
-	printedge( temp );
-	stuple_stack.push( temp );
+	return single[nt - epsilon];
 }
 
-//when you are parsing a symbol, pop it.  That way the parsetree_t will
-//know that you are now working on a higher part of the tree.
-void parsetree_t::pop()
+//adds FIRST of the symbol string rhs to set, and returns true if the
+//whole string can derive epsilon
+bool ll1_table_t::first_of(const int* rhs, tokenset_t& set) const
 {
-	if ( !stuple_stack.empty() ) {
-		stuple_stack.pop();
-	}
-
-	if ( stuple_stack.empty() ) {
-		printf( "}\n" );
+	for( ; *rhs != END_RHS; rhs++ ) {
+		if ( is_token(*rhs) ) {
+			set |= 1u << *rhs;
+			return false;
+		}
+		if ( is_nonterm(*rhs) ) {
+			set |= first[*rhs - epsilon];
+			if ( !nullable[*rhs - epsilon] ) {
+				return false;
+			}
+		}
 	}
+	return true;
 }
 
-//draw an epsilon on the parse tree hanging off of the top of stack
-void parsetree_t::drawepsilon()
+void ll1_table_t::set_entry(int nt, int t, int prod)
 {
-	push(epsilon);
-	pop();
+	//two productions for the same entry means the grammar is not LL(1)
+	assert( table[nt - epsilon][t] == -1 || table[nt - epsilon][t] == prod );
+	table[nt - epsilon][t] = prod;
 }
 
-// this private print function is called from push.  Basically it
-// just prints out the command to draw an edge from the top of the stack (TOS)
-// to the new symbol that was just pushed.  If it happens to be a terminal
-// then it makes it a snazzy blue color so you can see your program on the leaves 
-void parsetree_t::printedge(stuple temp)
+ll1_table_t::ll1_table_t()
 {
-	if ( temp.stype == TERMINAL ) {
-		printf("\t\"%s%d\" [label=\"%s\",style=filled,fillcolor=powderblue]\n",
-		  stuple_to_string(temp),
-		  temp.uniq,
-		  stuple_to_string(temp));
-	} else {
-		printf("\t\"%s%d\" [label=\"%s\"]\n",
-		  stuple_to_string(temp),
-		  temp.uniq,
-		  stuple_to_string(temp));
+	bool changed;
+
+	for( int i = 0; i < NUM_NONTERMS; i++ ) {
+		nullable[i] = false;
+		first[i] = follow[i] = 0;
+		single[i] = -1;
+		for( int t = 0; t < NUM_TOKENS; t++ ) {
+			table[i][t] = -1;
+		}
 	}
+	follow[NT_List - epsilon] = 1u << T_eof;
+
+	//nullable and FIRST
+	do {
+		changed = false;
+		for( int p = 0; p < NUM_PRODUCTIONS; p++ ) {
+			int lhs = grammar[p].lhs - epsilon;
+			tokenset_t f = first[lhs];
+			bool n = first_of(grammar[p].rhs, f) || nullable[lhs];
+			if ( f != first[lhs] || n != nullable[lhs] ) {
+				first[lhs] = f;
+				nullable[lhs] = n;
+				changed = true;
+			}
+		}
+	} while ( changed );
+
+	//FOLLOW
+	do {
+		changed = false;
+		for( int p = 0; p < NUM_PRODUCTIONS; p++ ) {
+			for( const int* b = grammar[p].rhs; *b != END_RHS; b++ ) {
+				if ( !is_nonterm(*b) ) {
+					continue;
+				}
+				tokenset_t f = follow[*b - epsilon];
+				if ( first_of(b + 1, f) ) {
+					f |= follow[grammar[p].lhs - epsilon];
+				}
+				if ( f != follow[*b - epsilon] ) {
+					follow[*b - epsilon] = f;
+					changed = true;
+				}
+			}
+		}
+	} while ( changed );
+
+	//the table itself
+	for( int p = 0; p < NUM_PRODUCTIONS; p++ ) {
+		int lhs = grammar[p].lhs;
+		tokenset_t f = 0;
+		if ( first_of(grammar[p].rhs, f) ) {
+			f |= follow[lhs - epsilon];
+		}
+		for( int t = 0; t < NUM_TOKENS; t++ ) {
+			if ( f & (1u << t) ) {
+				set_entry(lhs, t, p);
+			}
+		}
 
-	//no edge to print if this is the first node
-	if ( !stuple_stack.empty() ) {
-		//print the edge
-		printf( "\t\"%s%d\" ", stuple_to_string(stuple_stack.top()), stuple_stack.top().uniq ); 
-		printf( "-> \"%s%d\"\n", stuple_to_string(temp), temp.uniq );
+		//-1 if there are none yet, -2 if there is more than one
+		single[lhs - epsilon] = single[lhs - epsilon] == -1 ? p : -2;
 	}
-}
-
-//just a private utility for helping with the printing of the dot stuff
-char* parsetree_t::stuple_to_string(const stuple& s) 
-{
-	static char buffer[MAX_SYMBOL_NAME_SIZE];
-	if ( s.stype == TERMINAL ) {
-		snprintf( buffer, MAX_SYMBOL_NAME_SIZE, "%s", token_to_string(s.t) );
-	} else if ( s.stype == NONTERMINAL ) {
-		snprintf( buffer, MAX_SYMBOL_NAME_SIZE, "%s", nonterm_to_string(s.nt) );
-	} else {
-		assert(0);
+	for( int i = 0; i < NUM_NONTERMS; i++ ) {
+		if ( single[i] < 0 ) {
+			single[i] = -1;
+		}
 	}
-
-	return buffer;
 }
 
 
@@ -389,8 +1532,11 @@ class parser_t {
   private:
 	scanner_t scanner;
 	parsetree_t parsetree;
+	evaluator_t* evaluator;	//NULL if we are only checking syntax
 	void eat_token(token_type t);
 	void syntax_error(nonterm_type);
+	void action(action_type a);
+	void run(vector<int>& stack, bool last);
 
 	void List();
 	//WRITEME: fill this out with the rest of the 
@@ -403,16 +1549,45 @@ class parser_t {
 	void Fact(); 
 
   public:	
-	void parse();
+	//parses with the table driven engine.  Unless this is the last of
+	//the input, stop after the last statement instead of expecting eof
+	void parse(bool last = true);
+	//same, but starting right after a '.', with the parse tree picking up
+	//at position at
+	void parse_rest(const treepos_t& at, bool last);
+	//parses with the recursive decent routines
+	void parse_recursive();
+
+	//where the parse tree stands after a parse that was not the last
+	treepos_t position();
+	//number of lines eaten so far
+	int lines();
+
+	parser_t(input_t& in, treesink_t* sink, evaluator_t* evaluator = NULL);
 };
 
+parser_t::parser_t(input_t& in, treesink_t* sink, evaluator_t* evaluator) : scanner(in), parsetree(sink)
+{
+	this->evaluator = evaluator;
+}
+
+treepos_t parser_t::position()
+{
+	return parsetree.position();
+}
+
+int parser_t::lines()
+{
+	return scanner.get_line() - 1;
+}
+
 
 //this function not only eats the token (moving the scanner forward one
 //token), it also makes sure that token is drawn in the parse tree 
 //properly by calling push and pop.
 void parser_t::eat_token(token_type t)
 {
-	parsetree.push(t);
+	parsetree.push(t, scanner.token());
 	scanner.eat_token(t);
 	parsetree.pop();
 }
@@ -423,22 +1598,122 @@ void parser_t::eat_token(token_type t)
 //there is a syntax_error. 
 void parser_t::syntax_error(nonterm_type nt)
 {
-	printf("syntax error: found %s in parsing %s - line %d\n",
+	calc_error_t e(2, scanner.get_line());
+	snprintf(e.message, sizeof(e.message), "syntax error: found %s in parsing %s",
 		token_to_string( scanner.next_token()),
-		nonterm_to_string(nt),
-		scanner.get_line() ); 
-	exit(2); 
+		nonterm_to_string(nt) ); 
+	throw e; 
 }
 
 
 //One the recursive decent parser is set up, you simply call parse()
 //to parse the entire input, all of which can be dirived from the start
 //symbol
-void parser_t::parse()
+void parser_t::parse_recursive()
 {
 	List();
 }
 
+//runs one of the evaluator actions from the grammar
+void parser_t::action(action_type a)
+{
+	if ( !evaluator ) {
+		return;
+	}
+	switch( a ) {
+		case A_num: evaluator->num(scanner.token_text(), scanner.token().length); break;
+		case A_add: evaluator->op(OP_add); break;
+		case A_sub: evaluator->op(OP_sub); break;
+		case A_mul: evaluator->op(OP_mul); break;
+		case A_neg: evaluator->op(OP_neg); break;
+		case A_abs: evaluator->op(OP_abs); break;
+		case A_run: evaluator->run(); break;
+		default: assert(0);
+	}
+}
+
+//The table driven parser does the same thing as the recursive decent one,
+//in the same order, but keeps the symbols it still has to match on a heap
+//allocated stack instead of the C stack.  Besides the grammar symbols the
+//stack holds POP_NODE markers, which pop the parse tree once everything
+//under a non-terminal is done.
+//
+//A non-terminal that ends its parent's production (List' in List', Expr'
+//in Expr', ...) is expanded in its parent's place: it reuses the parent's
+//POP_NODE and replaces it in the parse tree.  So the stack only grows with
+//the nesting of parens, bars and unary minus, not with the number of
+//statements or operators.
+//
+//A parse that is not the last of the input stops when it gets to a List'
+//with nothing left to read, before it expands it (or even looks at what
+//comes next, since that is the next chunk's business).  Its parse tree is then
+//sitting in between two statements, and a parse_rest() of the input that
+//follows carries on from there exactly as if it had never stopped.
+#define POP_NODE 300
+
+void parser_t::parse(bool last)
+{
+	vector<int> stack;
+	stack.push_back(NT_List);
+	run(stack, last);
+}
+
+void parser_t::parse_rest(const treepos_t& at, bool last)
+{
+	vector<int> stack;
+	parsetree.resume(at);
+	stack.push_back(POP_NODE);
+	stack.push_back(NT_List_Prime);
+	run(stack, last);
+}
+
+void parser_t::run(vector<int>& stack, bool last)
+{
+	const ll1_table_t& table = ll1_table_t::get();
+
+	while ( !stack.empty() ) {
+		int sym = stack.back();
+		stack.pop_back();
+
+		if ( is_token(sym) ) {
+			eat_token((token_type)sym);
+		} else if ( sym == POP_NODE ) {
+			parsetree.pop();
+		} else if ( is_nonterm(sym) ) {
+			if ( !last && sym == NT_List_Prime && scanner.at_end() ) {
+				return;
+			}
+			bool tail = !stack.empty() && stack.back() == POP_NODE;
+			parsetree.push((nonterm_type)sym, tail);
+
+			int p = table.only((nonterm_type)sym);
+			if ( p < 0 ) {
+				p = table.lookup((nonterm_type)sym, scanner.next_token());
+			}
+			if ( p < 0 ) {
+				syntax_error((nonterm_type)sym);
+			}
+			if ( !tail ) {
+				stack.push_back(POP_NODE);
+			}
+
+			const int* rhs = grammar[p].rhs;
+			int len = 0;
+			while ( rhs[len] != END_RHS ) {
+				len++;
+			}
+			if ( len == 0 ) {
+				parsetree.drawepsilon();
+			}
+			while ( len > 0 ) {
+				stack.push_back(rhs[--len]);
+			}
+		} else {
+			action((action_type)sym);
+		}
+	}
+}
+
 
 //WRITEME: the List() function is not quite right.  Right now
 //it is made to parse the grammar:  List -> '+' List | EOF
@@ -452,6 +1727,7 @@ void parser_t::List()
 	parsetree.push(NT_List); 
 	Expr(); 
 	eat_token(T_period); 
+	if(evaluator) evaluator->run(); 
 	List_Prime();
 	parsetree.pop(); 
 	// //push this non-terminal onto the parse tree.
@@ -488,6 +1764,7 @@ void parser_t::List_Prime()
 	{
 		Expr(); 
 		eat_token(T_period); 
+		if(evaluator) evaluator->run(); 
 		List_Prime(); 
 	}
 	else
@@ -518,11 +1795,13 @@ void parser_t::Expr_Prime()
 		case T_plus: 
 			eat_token(T_plus); 
 			Term(); 
+			if(evaluator) evaluator->op(OP_add); 
 			Expr_Prime(); 
 			break; 
 		case T_minus: 
 			eat_token(T_minus); 
 			Term(); 
+			if(evaluator) evaluator->op(OP_sub); 
 			Expr_Prime(); 
 			break;
 		default: 
@@ -557,10 +1836,11 @@ void parser_t::Term_Prime()
 		case T_times: 
 			eat_token(T_times); 
 			Fact(); 
+			if(evaluator) evaluator->op(OP_mul); 
 			Term_Prime();
 			break; 
 		default: 
-			if(next == T_period || next == T_closeparen || next == T_bar || next == T_plus || T_minus)
+			if(next == T_period || next == T_closeparen || next == T_bar || next == T_plus || next == T_minus)
 			{
 				parsetree.drawepsilon(); 
 			}
@@ -579,11 +1859,13 @@ void parser_t::Fact()
 	switch(scanner.next_token())
 	{
 		case T_num: 
+			if(evaluator) evaluator->num(scanner.token_text(), scanner.token().length); 
 			eat_token(T_num); 
 			break; 
 		case T_minus: 
 			eat_token(T_minus); 
 			Fact(); 
+			if(evaluator) evaluator->op(OP_neg); 
 			break; 
 		case T_openparen:
 			eat_token(T_openparen); 
@@ -594,6 +1876,7 @@ void parser_t::Fact()
 			eat_token(T_bar); 
 			Expr(); 
 			eat_token(T_bar); 
+			if(evaluator) evaluator->op(OP_abs); 
 			break; 
 		default: 
 			syntax_error(NT_Fact); 
@@ -601,19 +1884,377 @@ void parser_t::Fact()
 	parsetree.pop(); 
 }
 
+/*** Chunked Parser ***********************************************/
+
+//makes the sink for a -t option, or returns NULL if there is no such sink
+static treesink_t* make_sink(const char* tree, outbuf_t& out)
+{
+	if ( !strcmp(tree, "dot") ) {
+		return new dotsink_t(out);
+	} else if ( !strcmp(tree, "bin") ) {
+		return new binsink_t(out);
+	} else if ( !strcmp(tree, "null") ) {
+		return new nullsink_t;
+	}
+	return NULL;
+}
+
+//Statements only depend on each other through the '.' that ends them, so a
+//mapped input can be cut into chunks right after a '.' and the chunks
+//parsed (and evaluated) at the same time on worker threads.  Every chunk
+//but the first picks up with the List' for its first statement, just like
+//parser_t::parse() would if it had never stopped.  Each chunk writes into
+//its own in-memory outbuf_t, and the main thread writes them out in input
+//order, so the output is byte for byte what a serial parse writes.
+//
+//The one thing a chunk cannot know on its own is the numbering of its
+//parse tree nodes, which carries on from the chunk before.  So when the
+//tree is being drawn every chunk is parsed twice: once into a nullsink_t
+//just to count its nodes, and then for real once the chunks before it have
+//been counted.  Line numbers are worked out the same way, but only after
+//the fact: a chunk counts its lines from 1, and an error is printed with
+//the lines of the chunks before it added on.
+//
+//A chunk that has a syntax error stops there, and nothing after it is
+//written out, again like the serial parse.
+//
+//None of this pays unless there are CPUs for the workers to run on and
+//enough chunks to keep them busy: on one CPU, or on an input of a few
+//chunks, the counting pass and the hand-offs only make it slower than
+//parser_t.  So worth() first cuts the number of jobs down to what is
+//worth having, and with less than two the input is parsed serially.
+class chunked_parser_t {
+  public:
+	//parses everything and returns the exit status
+	int run();
+	chunked_parser_t(const char* begin, const char* end, const char* tree, bool evaluate, int jobs);
+	~chunked_parser_t();
+
+	//how many of jobs threads are worth using on size bytes of input
+	static int worth(size_t size, int jobs);
+
+  private:
+	//the input is cut about every CHUNK_SIZE bytes.  Chunks need to be
+	//small enough that the workers keep each other busy and that the
+	//output waiting to be written stays small, but big enough to not
+	//spend all the time handing them out.  Workers may get at most
+	//WINDOW chunks per thread ahead of the one being written, and are
+	//given at least MIN_CHUNKS chunks each
+	enum { CHUNK_SIZE = 256 << 10, WINDOW = 2, MIN_CHUNKS = 4 };
+
+	struct chunk_t {
+		const char* begin;
+		const char* end;
+		bool last;		//runs to the end of the input
+		treepos_t after;	//tree position at its end, in its own numbering
+		treepos_t at;		//tree position it starts from
+		int lines;		//number of lines in it
+		outbuf_t* out;		//its output, once it has been parsed
+		bool done;		//set once out is ready
+		bool failed;
+		calc_error_t error;
+	};
+
+	const char* input;		//start of the whole input
+	const char* tree;
+	bool evaluate;
+	int jobs;
+	vector<chunk_t> chunks;
+
+	//handing out chunks to the workers
+	mutex lock;
+	condition_variable changed;
+	size_t next;			//next chunk to hand out
+	size_t todo;			//hand out chunks up to here
+	size_t written;			//chunks written out so far
+
+	void parse(chunk_t& c, parser_t& parser);
+	void count(chunk_t& c);
+	void render(chunk_t& c);
+	void work(bool counting);
+	void spawn(bool counting, vector<thread>& threads);
+};
+
+chunked_parser_t::chunked_parser_t(const char* begin, const char* end, const char* tree, bool evaluate, int jobs)
+{
+	input = begin;
+	this->tree = tree;
+	this->evaluate = evaluate;
+	this->jobs = jobs;
+
+	//cut right after the first '.' at or past every CHUNK_SIZE bytes
+	const char* p = begin;
+	while ( p < end ) {
+		const char* q = end;
+		if ( end - p > CHUNK_SIZE ) {
+			q = (const char*)memchr(p + CHUNK_SIZE, '.', end - p - CHUNK_SIZE);
+			q = q ? q + 1 : end;
+		}
+
+		chunk_t c;
+		c.begin = p;
+		c.end = q;
+		c.last = q == end;
+		c.at.kind = NT_List_Prime;
+		c.at.uniq = 0;
+		c.at.counter = 0;
+		c.after = c.at;
+		c.lines = 0;
+		c.out = NULL;
+		c.done = false;
+		c.failed = false;
+		chunks.push_back(c);
+		p = q;
+	}
+}
+
+int chunked_parser_t::worth(size_t size, int jobs)
+{
+	//hardware_concurrency() is 0 when it cannot tell
+	int cpus = thread::hardware_concurrency();
+	if ( cpus > 0 && jobs > cpus ) {
+		jobs = cpus;
+	}
+	//every worker should get a few chunks
+	if ( (size_t)jobs > size / (MIN_CHUNKS * CHUNK_SIZE) ) {
+		jobs = size / (MIN_CHUNKS * CHUNK_SIZE);
+	}
+	return jobs < 1 ? 1 : jobs;
+}
+
+chunked_parser_t::~chunked_parser_t()
+{
+	for( size_t i = 0; i < chunks.size(); i++ ) {
+		delete chunks[i].out;
+	}
+}
+
+//parses chunk c with parser, and notes how it went
+void chunked_parser_t::parse(chunk_t& c, parser_t& parser)
+{
+	try {
+		if ( c.begin == input ) {
+			parser.parse(c.last);
+		} else {
+			parser.parse_rest(c.at, c.last);
+		}
+		if ( !c.last ) {
+			c.after = parser.position();
+		}
+		c.lines = parser.lines();
+	} catch ( calc_error_t& e ) {
+		c.failed = true;
+		c.error = e;
+	}
+}
+
+//first pass: how many nodes are in c's parse tree, and where does it end
+void chunked_parser_t::count(chunk_t& c)
+{
+	nullsink_t sink;
+	input_t in(c.begin, c.end, c.begin - input);
+	parser_t parser(in, &sink);
+	parse(c, parser);
+}
+
+//second pass: the actual output for c
+void chunked_parser_t::render(chunk_t& c)
+{
+	c.out = new outbuf_t(NULL);
+	treesink_t* sink = make_sink(tree, *c.out);
+	evaluator_t evaluator(*c.out);
+	input_t in(c.begin, c.end, c.begin - input);
+	parser_t parser(in, sink, evaluate ? &evaluator : NULL);
+	parse(c, parser);
+	delete sink;
+}
+
+//what each worker thread runs: parse chunks until there are none left.
+//When rendering, chunks are not handed out too far ahead of the one the
+//main thread is waiting to write
+void chunked_parser_t::work(bool counting)
+{
+	for(;;) {
+		size_t i;
+		{
+			unique_lock<mutex> l(lock);
+			while ( !counting && next < todo && next >= written + WINDOW * jobs ) {
+				changed.wait(l);
+			}
+			if ( next >= todo ) {
+				return;
+			}
+			i = next++;
+		}
+
+		if ( counting ) {
+			count(chunks[i]);
+		} else {
+			render(chunks[i]);
+			unique_lock<mutex> l(lock);
+			chunks[i].done = true;
+			changed.notify_all();
+		}
+	}
+}
+
+void chunked_parser_t::spawn(bool counting, vector<thread>& threads)
+{
+	next = 0;
+	written = 0;
+	for( int i = 0; i < jobs; i++ ) {
+		threads.push_back(thread(&chunked_parser_t::work, this, counting));
+	}
+}
+
+int chunked_parser_t::run()
+{
+	vector<thread> threads;
+	todo = chunks.size();
+
+	//number the trees, unless there is no tree to number
+	if ( strcmp(tree, "null") ) {
+		spawn(true, threads);
+		for( size_t i = 0; i < threads.size(); i++ ) {
+			threads[i].join();
+		}
+		threads.clear();
+
+		//nothing after the first bad chunk gets written anyway
+		int base = 0;
+		for( size_t i = 0; i < chunks.size(); i++ ) {
+			if ( i > 0 ) {
+				chunks[i].at.kind = chunks[i - 1].after.kind;
+				chunks[i].at.uniq = base + chunks[i - 1].after.uniq;
+				base += chunks[i - 1].after.counter;
+				chunks[i].at.counter = base;
+			}
+			if ( chunks[i].failed ) {
+				todo = i + 1;
+				break;
+			}
+		}
+		for( size_t i = 0; i < todo; i++ ) {
+			chunks[i].failed = false;
+		}
+	}
+
+	spawn(false, threads);
+
+	int status = 0;
+	int lines = 0;
+	for( size_t i = 0; i < todo; i++ ) {
+		chunk_t& c = chunks[i];
+		{
+			unique_lock<mutex> l(lock);
+			while ( !c.done ) {
+				changed.wait(l);
+			}
+		}
+
+		output.put(c.out->data(), c.out->size());
+		delete c.out;
+		c.out = NULL;
+
+		if ( c.failed ) {
+			output.flush();
+			c.error.print(lines);
+			status = c.error.status;
+		}
+		lines += c.lines;
+
+		unique_lock<mutex> l(lock);
+		written++;
+		if ( c.failed ) {
+			next = todo;
+		}
+		changed.notify_all();
+		if ( c.failed ) {
+			break;
+		}
+	}
+
+	for( size_t i = 0; i < threads.size(); i++ ) {
+		threads[i].join();
+	}
+	return status;
+}
+
+
 /*** Main ***********************************************/
 
-int main()
+static void usage(const char* prog)
 {
-	parser_t parser;
-	parser.parse();
-	// scanner_t scanner; 
-	// token_type currToken = scanner.next_token(); 
-	// while(currToken != T_eof)
-	// {
-	// 	printf(token_to_string(currToken)); 
-	// 	scanner.eat_token(currToken); 
-	// 	currToken = scanner.next_token(); 
-	// }
-	return 0;
+	fprintf(stderr, "usage: %s [-e] [-r] [-j jobs] [-t dot|bin|null] < input\n", prog);
+	exit(1);
+}
+
+//usage: calc [-e] [-r] [-j jobs] [-t dot|bin|null] < input
+//  -e    evaluate each statement and print its value on its own line
+//  -r    use the recursive decent parser instead of the table driven one
+//  -j    parse with up to this many threads (see chunked_parser_t).  Only
+//        if the input is a file, and not with -r.  Fewer are used if there
+//        are fewer CPUs or the input is small, down to the serial parser
+//  -t    what to do with the parse tree: write it as a dot file (the
+//        default), in the compact binary format (see binsink_t), or
+//        nothing at all (the default with -e)
+int main(int argc, char** argv)
+{
+	bool evaluate = false;
+	bool recursive = false;
+	int jobs = 1;
+	const char* tree = NULL;
+
+	for( int i = 1; i < argc; i++ ) {
+		if ( !strcmp(argv[i], "-e") ) {
+			evaluate = true;
+		} else if ( !strcmp(argv[i], "-r") ) {
+			recursive = true;
+		} else if ( !strcmp(argv[i], "-j") && i + 1 < argc ) {
+			jobs = atoi(argv[++i]);
+			if ( jobs < 1 ) {
+				usage(argv[0]);
+			}
+		} else if ( !strcmp(argv[i], "-t") && i + 1 < argc ) {
+			tree = argv[++i];
+		} else {
+			usage(argv[0]);
+		}
+	}
+	if ( tree == NULL ) {
+		tree = evaluate ? "null" : "dot";
+	}
+
+	treesink_t* sink = make_sink(tree, output);
+	if ( sink == NULL ) {
+		usage(argv[0]);
+	}
+
+	input_t in(0);
+	int status = 0;
+
+	if ( !recursive && in.mapped() ) {
+		jobs = chunked_parser_t::worth(in.end - in.begin, jobs);
+	}
+	if ( jobs > 1 && !recursive && in.mapped() ) {
+		chunked_parser_t parser(in.begin, in.end, tree, evaluate, jobs);
+		status = parser.run();
+	} else {
+		evaluator_t evaluator(output);
+		parser_t parser(in, sink, evaluate ? &evaluator : NULL);
+		try {
+			if ( recursive ) {
+				parser.parse_recursive();
+			} else {
+				parser.parse();
+			}
+		} catch ( calc_error_t& e ) {
+			output.flush();
+			e.print(0);
+			status = e.status;
+		}
+	}
+	delete sink;
+	output.flush();
+	return status;
 }
@@ -0,0 +1,372 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <vector>
+
+using namespace std;
+
+//calcbench generates some calc programs and times parsers on them, so the
+//hand written calc can be compared against the bison/flex calc_def (and
+//against itself, in its different modes).
+//
+//usage: calcbench [-s scale] [-n runs] [-k] command...
+//  -s    make the inputs scale times bigger (default 1)
+//  -n    run each command this many times and keep the fastest (default 3)
+//  -k    keep the generated inputs instead of deleting them at the end
+//
+//Each command is a parser and its options in one argument, e.g. "./calc
+//-t null" or "./calc_def".  It gets an input on stdin, and whatever it
+//writes goes to /dev/null.  For every input and command this prints the
+//best wall clock time, bytes, tokens and statements per second, and the peak
+//resident set size of the parser.  A parser that does not exit with 0
+//(calc_def runs out of stack on the deep input, calc -r crashes) is
+//reported as failing instead.
+
+
+/*** Input Generator ***********************************************/
+
+//writes a calc program, keeping count of the tokens and statements in it
+class generator_t {
+  public:
+	long tokens;
+	long statements;
+
+	//a number with the given number of digits
+	void num(int digits);
+	//a flat expression with terms terms, like 12 + 3 * 45 - 6
+	void flat(int terms);
+	//an expression nested depth deep in parens, bars and unary minus
+	void nested(int depth);
+	//an operator or paren
+	void token(const char* s);
+	//ends the statement
+	void end();
+
+	generator_t(FILE* f);
+
+  private:
+	FILE* file;
+	unsigned long long seed;
+	int column;
+
+	unsigned random(unsigned n);
+};
+
+generator_t::generator_t(FILE* f)
+{
+	file = f;
+	tokens = 0;
+	statements = 0;
+	seed = 160;
+	column = 0;
+}
+
+//the same inputs every time, so runs can be compared
+unsigned generator_t::random(unsigned n)
+{
+	seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+	return (unsigned)(seed >> 33) % n;
+}
+
+//writes a token, breaking the lines once in a while so the scanner has
+//some newlines to count
+void generator_t::token(const char* s)
+{
+	size_t len = strlen(s);
+	fwrite(s, 1, len, file);
+	column += len;
+	if ( column > 72 ) {
+		fputc('\n', file);
+		column = 0;
+	} else {
+		fputc(' ', file);
+		column++;
+	}
+	tokens++;
+}
+
+void generator_t::num(int digits)
+{
+	char buf[64];
+	int i = 0;
+
+	//long numbers are written out in pieces, as one token
+	fputc('1' + random(9), file);
+	for( int d = 1; d < digits; d++ ) {
+		buf[i++] = '0' + random(10);
+		if ( i == (int)sizeof(buf) - 1 || d == digits - 1 ) {
+			buf[i] = 0;
+			fputs(buf, file);
+			i = 0;
+		}
+	}
+	column += digits;
+	token("");
+}
+
+void generator_t::flat(int terms)
+{
+	static const char* ops[] = { "+", "-", "*" };
+
+	num(1 + random(4));
+	for( int i = 1; i < terms; i++ ) {
+		token(ops[random(3)]);
+		num(1 + random(4));
+	}
+}
+
+void generator_t::nested(int depth)
+{
+	vector<const char*> closers;
+
+	for( int i = 0; i < depth; i++ ) {
+		switch( random(3) ) {
+			case 0: token("("); closers.push_back(")"); break;
+			case 1: token("|"); closers.push_back("|"); break;
+			case 2: token("-"); closers.push_back(NULL); break;
+		}
+	}
+	flat(2);
+	while ( !closers.empty() ) {
+		if ( closers.back() ) {
+			token(closers.back());
+		}
+		closers.pop_back();
+		//something for the close to apply to on the way out
+		if ( random(4) == 0 ) {
+			token("+");
+			num(2);
+		}
+	}
+}
+
+void generator_t::end()
+{
+	token(".");
+	statements++;
+}
+
+
+/*** Inputs ***********************************************/
+
+struct input_t {
+	const char* name;
+	const char* about;
+	char path[64];
+	long tokens;
+	long statements;
+	long bytes;
+};
+
+//wide: lots of short statements.  deep: fewer statements nested a few
+//thousand levels (bison's default stack stops at 10000).  long: a few
+//statements of numbers with thousands of digits
+static void generate(input_t& in, int scale)
+{
+	strcpy(in.path, "/tmp/calcbench.XXXXXX");
+	int fd = mkstemp(in.path);
+	if ( fd < 0 ) {
+		perror("mkstemp");
+		exit(1);
+	}
+	FILE* f = fdopen(fd, "w");
+	generator_t g(f);
+
+	if ( !strcmp(in.name, "wide") ) {
+		for( int i = 0; i < 200000 * scale; i++ ) {
+			g.flat(1 + i % 8);
+			g.end();
+		}
+	} else if ( !strcmp(in.name, "deep") ) {
+		for( int i = 0; i < 100 * scale; i++ ) {
+			g.nested(3000);
+			g.end();
+		}
+	} else {
+		for( int i = 0; i < 200 * scale; i++ ) {
+			g.num(5000);
+			g.token("*");
+			g.num(5000);
+			g.token("+");
+			g.num(1000);
+			g.end();
+		}
+	}
+
+	in.tokens = g.tokens;
+	in.statements = g.statements;
+	in.bytes = ftell(f);
+	fclose(f);
+}
+
+
+/*** Runner ***********************************************/
+
+struct result_t {
+	double seconds;		//best wall clock time
+	long max_rss;		//peak resident set size in KB
+	int status;		//wait status of the first run that was not ok
+	bool ok;
+};
+
+static double now()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+//splits a command up at spaces into an argv for execvp
+static vector<char*> split(char* command)
+{
+	vector<char*> argv;
+	for( char* word = strtok(command, " "); word; word = strtok(NULL, " ") ) {
+		argv.push_back(word);
+	}
+	argv.push_back(NULL);
+	return argv;
+}
+
+//runs command once with stdin from path, and adds the run to r
+static void run_once(const char* command, const char* path, result_t& r)
+{
+	char* copy = strdup(command);
+	vector<char*> argv = split(copy);
+	double start = now();
+
+	pid_t pid = fork();
+	if ( pid < 0 ) {
+		perror("fork");
+		exit(1);
+	}
+	if ( pid == 0 ) {
+		int in = open(path, O_RDONLY);
+		int out = open("/dev/null", O_WRONLY);
+		if ( in < 0 || out < 0 ) {
+			_exit(127);
+		}
+		dup2(in, 0);
+		dup2(out, 1);
+		dup2(out, 2);
+		execvp(argv[0], &argv[0]);
+		_exit(127);
+	}
+
+	int status;
+	struct rusage usage;
+	while ( wait4(pid, &status, 0, &usage) < 0 ) {
+		if ( errno != EINTR ) {
+			perror("wait4");
+			exit(1);
+		}
+	}
+	double seconds = now() - start;
+	free(copy);
+
+	if ( !WIFEXITED(status) || WEXITSTATUS(status) != 0 ) {
+		if ( r.ok ) {
+			r.status = status;
+		}
+		r.ok = false;
+	}
+	if ( seconds < r.seconds ) {
+		r.seconds = seconds;
+	}
+	if ( usage.ru_maxrss > r.max_rss ) {
+		r.max_rss = usage.ru_maxrss;
+	}
+}
+
+static void report(const char* command, const input_t& in, const result_t& r)
+{
+	printf("  %-24s", command);
+	if ( !r.ok ) {
+		if ( WIFSIGNALED(r.status) ) {
+			printf(" failed: killed by signal %d\n", WTERMSIG(r.status));
+		} else if ( WEXITSTATUS(r.status) == 127 ) {
+			printf(" failed: could not run it\n");
+		} else {
+			printf(" failed: exit status %d\n", WEXITSTATUS(r.status));
+		}
+		return;
+	}
+	printf(" %9.3f s %8.1f MB/s %8.2f Mtok/s %10.0f stmt/s %9ld KB\n",
+		r.seconds,
+		in.bytes / r.seconds / 1e6,
+		in.tokens / r.seconds / 1e6,
+		in.statements / r.seconds,
+		r.max_rss);
+}
+
+
+/*** Main ***********************************************/
+
+static void usage(const char* prog)
+{
+	fprintf(stderr, "usage: %s [-s scale] [-n runs] [-k] command...\n", prog);
+	exit(1);
+}
+
+int main(int argc, char** argv)
+{
+	int scale = 1;
+	int runs = 3;
+	bool keep = false;
+	int first;
+
+	for( first = 1; first < argc && argv[first][0] == '-'; first++ ) {
+		if ( !strcmp(argv[first], "-s") && first + 1 < argc ) {
+			scale = atoi(argv[++first]);
+		} else if ( !strcmp(argv[first], "-n") && first + 1 < argc ) {
+			runs = atoi(argv[++first]);
+		} else if ( !strcmp(argv[first], "-k") ) {
+			keep = true;
+		} else {
+			usage(argv[0]);
+		}
+	}
+	if ( first == argc || scale < 1 || runs < 1 ) {
+		usage(argv[0]);
+	}
+
+	input_t inputs[] = {
+		{ "wide", "many short statements", "", 0, 0, 0 },
+		{ "deep", "nested parens, bars and minus", "", 0, 0, 0 },
+		{ "long", "numbers with thousands of digits", "", 0, 0, 0 },
+	};
+	int ninputs = sizeof(inputs) / sizeof(inputs[0]);
+
+	for( int i = 0; i < ninputs; i++ ) {
+		input_t& in = inputs[i];
+		generate(in, scale);
+		printf("%s: %s (%.1f MB, %ld tokens, %ld statements)%s%s\n",
+			in.name, in.about, in.bytes / 1e6, in.tokens, in.statements,
+			keep ? " in " : "", keep ? in.path : "");
+
+		for( int c = first; c < argc; c++ ) {
+			result_t r;
+			r.seconds = 1e30;
+			r.max_rss = 0;
+			r.status = 0;
+			r.ok = true;
+			for( int n = 0; n < runs; n++ ) {
+				run_once(argv[c], in.path, r);
+			}
+			report(argv[c], in, r);
+		}
+		fflush(stdout);
+
+		if ( !keep ) {
+			unlink(in.path);
+		}
+	}
+	return 0;
+}
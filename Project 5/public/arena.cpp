@@ -0,0 +1,71 @@
+#include <cassert>
+#include <cstdlib>
+
+#include "arena.hpp"
+
+static const size_t BLOCK_SIZE = 1 << 20;
+
+thread_local Arena* Arena::s_current = NULL;
+
+Arena::Arena()
+{
+    m_used = 0;
+    m_next = NULL;
+    m_left = 0;
+    m_bytes = 0;
+    m_released = NULL;
+    m_released_size = 0;
+}
+
+Arena::~Arena()
+{
+    for(size_t i = 0; i < m_blocks.size(); ++i) {
+        free(m_blocks[i].base);
+    }
+}
+
+// Moves on to the next block, one that was kept from before the last reset
+// if it is big enough, and hands out n bytes from the start of it
+void* Arena::grow(size_t n)
+{
+    if(m_used == m_blocks.size() || m_blocks[m_used].size < n) {
+        Block block;
+        block.size = n > BLOCK_SIZE ? n : BLOCK_SIZE;
+        block.base = (char*) malloc(block.size);
+        assert(block.base != NULL);
+        m_blocks.insert(m_blocks.begin() + m_used, block);
+    }
+    const Block& block = m_blocks[m_used++];
+    m_released = NULL;
+    m_next = block.base + n;
+    m_left = block.size - n;
+    return block.base;
+}
+
+void Arena::release(void* p, size_t n)
+{
+    n = (n + ALIGN - 1) & ~(size_t) (ALIGN - 1);
+    if((char*) p + n != m_next) {
+        m_released = (char*) p;
+        m_released_size = n;
+        return;
+    }
+    m_next -= n;
+    m_left += n;
+    m_bytes -= n;
+    if(m_released && m_released + m_released_size == m_next) {
+        m_next = m_released;
+        m_left += m_released_size;
+        m_bytes -= m_released_size;
+        m_released = NULL;
+    }
+}
+
+void Arena::reset()
+{
+    m_used = 0;
+    m_next = NULL;
+    m_left = 0;
+    m_bytes = 0;
+    m_released = NULL;
+}
@@ -0,0 +1,224 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <vector>
+
+// Memory for the AST.  Nodes are carved out of large blocks one after the
+// other and never freed one at a time: the whole tree goes at once when
+// its Arena is destroyed or reset, without visiting a single node.
+//
+// A node is made in the arena that is current on its thread when it is
+// new'ed, which is the one the innermost ArenaScope made current:
+//
+//   Arena tree;
+//   {
+//       ArenaScope scope(&tree);
+//       ... parse, making nodes with new ...
+//   }
+//   ... the nodes last as long as tree does ...
+//
+// so the parsers and the AST classes need not pass an arena around, and
+// compilations on different threads each use their own.
+class Arena
+{
+  public:
+    enum { ALIGN = sizeof(void*) };
+
+  private:
+    struct Block
+    {
+        char* base;
+        size_t size;
+    };
+
+    std::vector<Block> m_blocks;
+    size_t m_used;              // blocks in use; the rest wait for reuse
+    char* m_next;               // free space in the last block in use
+    size_t m_left;
+    size_t m_bytes;             // handed out since the last reset
+    char* m_released;           // given back out of order, see release
+    size_t m_released_size;
+
+    static thread_local Arena* s_current;
+
+    void* grow(size_t n);
+
+  public:
+    Arena();
+    ~Arena();
+
+    // n bytes, aligned for a pointer
+    void* allocate(size_t n) {
+        n = (n + ALIGN - 1) & ~(size_t) (ALIGN - 1);
+        m_bytes += n;
+        if(n > m_left) {
+            return grow(n);
+        }
+        char* p = m_next;
+        m_next += n;
+        m_left -= n;
+        return p;
+    }
+
+    // Gives back the n bytes at p, which were the last thing allocated, so
+    // they are handed out again (see ExprPool in exprpool.hpp).  Objects
+    // are often given back in a different order than they were made in,
+    // so one block given back early is kept until the space after it is
+    // given back too.  Otherwise nothing happens, and the bytes are freed
+    // with the rest of the arena.
+    void release(void* p, size_t n);
+
+    // Frees everything in the arena at once.  The blocks are kept, so an
+    // arena that is reset over and over only takes as much memory as the
+    // most it ever held.
+    void reset();
+
+    // Bytes handed out since the arena was made or last reset
+    size_t bytes() const {
+        return m_bytes;
+    }
+
+    // The arena nodes are made in on this thread, NULL if there is none
+    static Arena* current() {
+        return s_current;
+    }
+
+    static void set_current(Arena* arena) {
+        s_current = arena;
+    }
+};
+
+// Makes an arena current for as long as it is in scope
+class ArenaScope
+{
+  private:
+    Arena* m_previous;
+
+  public:
+    ArenaScope(Arena* arena) {
+        m_previous = Arena::current();
+        Arena::set_current(arena);
+    }
+
+    ~ArenaScope() {
+        Arena::set_current(m_previous);
+    }
+};
+
+// A base for the classes whose objects are made in the current arena (the
+// AST nodes, SymName, Primitive and StringPrimitive).  They have nothing
+// to free, so delete does nothing, and there is no need to call it.
+class ArenaObject
+{
+  public:
+    static void* operator new(size_t size) {
+        return Arena::current()->allocate(size);
+    }
+
+    static void operator delete(void*) {
+    }
+};
+
+// The lists in the AST (Proc_list and the rest in ast.hpp).  The first N
+// items are kept in the list itself, which is as many as most lists ever
+// hold, so a node gets to them through one pointer instead of two.  A
+// longer list moves its items to the arena, twice as much room each time,
+// and the room it moved out of is only given back with the rest of the
+// arena.  The items are pointers, so they are copied as bytes.
+template<class T, size_t N> class ArenaVector : public ArenaObject
+{
+  public:
+    typedef T value_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+  private:
+    T* m_items;                 // m_inline until there are more than N
+    unsigned m_size;
+    unsigned m_capacity;
+    Arena* m_arena;             // the one the list was made in
+    T m_inline[N];
+
+    // m_items can point into the list itself
+    ArenaVector(const ArenaVector&);
+    ArenaVector& operator=(const ArenaVector&);
+
+    void grow(size_t n) {
+        size_t capacity = m_capacity * 2 > n ? m_capacity * 2 : n;
+        T* items = (T*) m_arena->allocate(capacity * sizeof(T));
+        memcpy(items, m_items, m_size * sizeof(T));
+        m_items = items;
+        m_capacity = capacity;
+    }
+
+  public:
+    ArenaVector() {
+        m_items = m_inline;
+        m_size = 0;
+        m_capacity = N;
+        m_arena = Arena::current();
+    }
+
+    iterator begin() { return m_items; }
+    iterator end() { return m_items + m_size; }
+    const_iterator begin() const { return m_items; }
+    const_iterator end() const { return m_items + m_size; }
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(end());
+    }
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
+    }
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    T& operator[](size_t i) { return m_items[i]; }
+    const T& operator[](size_t i) const { return m_items[i]; }
+    T& front() { return m_items[0]; }
+    T& back() { return m_items[m_size - 1]; }
+
+    void reserve(size_t n) {
+        if(n > m_capacity) {
+            grow(n);
+        }
+    }
+
+    void push_back(const T& item) {
+        if(m_size == m_capacity) {
+            grow(m_size + 1);
+        }
+        m_items[m_size++] = item;
+    }
+
+    // first and last are not in this list
+    void insert(iterator at, const_iterator first, const_iterator last) {
+        size_t i = at - m_items;
+        size_t n = last - first;
+        reserve(m_size + n);
+        memmove(m_items + i + n, m_items + i, (m_size - i) * sizeof(T));
+        memcpy(m_items + i, first, n * sizeof(T));
+        m_size += n;
+    }
+
+    void resize(size_t n) {
+        reserve(n);
+        for(size_t i = m_size; i < n; ++i) {
+            m_items[i] = T();
+        }
+        m_size = n;
+    }
+
+    void clear() {
+        m_size = 0;
+    }
+};
+
+#endif //ARENA_HPP
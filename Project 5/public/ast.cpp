@@ -2,7 +2,9 @@
 
 #include <algorithm>
 #include "ast.hpp"
-extern int yylineno;
+#include "astcache.hpp"
+#include "exprpool.hpp"
+#include "flatast.hpp"
 #include "symtab.hpp"
 #include "primitive.hpp"
 #include "primitive.hpp"
@@ -10,20 +12,15 @@ extern int yylineno;
 
 
 /********* ProgramImpl ************/
- ProgramImpl::ProgramImpl(std::list<Proc_ptr> *p1)  {
+ ProgramImpl::ProgramImpl(Proc_list *p1)  {
 	m_proc_list = p1;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	std::list<Proc_ptr>::iterator m_proc_list_iter;
-	for(m_proc_list_iter = m_proc_list->begin();
-	  m_proc_list_iter != m_proc_list->end();
-	  ++m_proc_list_iter){
-		(*m_proc_list_iter)->m_parent_attribute = &m_attribute;
-	}
+	m_kind = nk_ProgramImpl;
  }
  ProgramImpl::ProgramImpl(const ProgramImpl & other) {
-	m_proc_list = new std::list<Proc_ptr>;
-	std::list<Proc_ptr>::iterator m_proc_list_iter;
+	m_kind = nk_ProgramImpl;
+	m_proc_list = new Proc_list;
+	m_proc_list->reserve(other.m_proc_list->size());
+	Proc_list::iterator m_proc_list_iter;
 	for(m_proc_list_iter = other.m_proc_list->begin();
 	  m_proc_list_iter != other.m_proc_list->end();
 	  ++m_proc_list_iter){
@@ -34,18 +31,10 @@ extern int yylineno;
  void ProgramImpl::swap(ProgramImpl & other) {
 	std::swap(m_proc_list, other.m_proc_list);
  }
- ProgramImpl::~ProgramImpl() {
- 	std::list<Proc_ptr>::iterator m_proc_list_iter;
-	for(m_proc_list_iter = m_proc_list->begin();
-	  m_proc_list_iter != m_proc_list->end();
-	  ++m_proc_list_iter){
-		delete( *m_proc_list_iter );
-	}
- }
  void ProgramImpl::visit_children( Visitor* v ) {
- 	std::list<Proc_ptr>::iterator m_proc_list_iter;
-	for(m_proc_list_iter = m_proc_list->begin();
-	  m_proc_list_iter != m_proc_list->end();
+ 	Proc_list::iterator m_proc_list_iter, m_proc_list_end;
+	for(m_proc_list_iter = m_proc_list->begin(), m_proc_list_end = m_proc_list->end();
+	  m_proc_list_iter != m_proc_list_end;
 	  ++m_proc_list_iter){
 		(*m_proc_list_iter)->accept( v );
 	}
@@ -55,27 +44,19 @@ extern int yylineno;
  
  
 /********* ProcImpl ************/
- ProcImpl::ProcImpl(SymName *p1, std::list<Decl_ptr> *p2, Type *p3, Procedure_block *p4)  {
+ ProcImpl::ProcImpl(const SymName &p1, Decl_list *p2, Type *p3, Procedure_block *p4)  {
 	m_symname = p1;
 	m_decl_list = p2;
 	m_type = p3;
 	m_procedure_block = p4;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_symname->m_parent_attribute = &m_attribute;
- 	std::list<Decl_ptr>::iterator m_decl_list_iter;
-	for(m_decl_list_iter = m_decl_list->begin();
-	  m_decl_list_iter != m_decl_list->end();
-	  ++m_decl_list_iter){
-		(*m_decl_list_iter)->m_parent_attribute = &m_attribute;
-	}
-	m_type->m_parent_attribute = &m_attribute;
- 	m_procedure_block->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_ProcImpl;
+ }
  ProcImpl::ProcImpl(const ProcImpl & other) {
-	m_symname = other.m_symname->clone();
-	m_decl_list = new std::list<Decl_ptr>;
-	std::list<Decl_ptr>::iterator m_decl_list_iter;
+	m_kind = nk_ProcImpl;
+	m_symname = other.m_symname;
+	m_decl_list = new Decl_list;
+	m_decl_list->reserve(other.m_decl_list->size());
+	Decl_list::iterator m_decl_list_iter;
 	for(m_decl_list_iter = other.m_decl_list->begin();
 	  m_decl_list_iter != other.m_decl_list->end();
 	  ++m_decl_list_iter){
@@ -91,22 +72,11 @@ extern int yylineno;
 	std::swap(m_type, other.m_type);
 	std::swap(m_procedure_block, other.m_procedure_block);
  }
- ProcImpl::~ProcImpl() {
- 	delete(m_symname);
- 	std::list<Decl_ptr>::iterator m_decl_list_iter;
-	for(m_decl_list_iter = m_decl_list->begin();
-	  m_decl_list_iter != m_decl_list->end();
-	  ++m_decl_list_iter){
-		delete( *m_decl_list_iter );
-	}
-	delete(m_type);
- 	delete(m_procedure_block);
-  }
  void ProcImpl::visit_children( Visitor* v ) {
- 	m_symname->accept( v );
- 	std::list<Decl_ptr>::iterator m_decl_list_iter;
-	for(m_decl_list_iter = m_decl_list->begin();
-	  m_decl_list_iter != m_decl_list->end();
+ 	m_symname.accept( v );
+ 	Decl_list::iterator m_decl_list_iter, m_decl_list_end;
+	for(m_decl_list_iter = m_decl_list->begin(), m_decl_list_end = m_decl_list->end();
+	  m_decl_list_iter != m_decl_list_end;
 	  ++m_decl_list_iter){
 		(*m_decl_list_iter)->accept( v );
 	}
@@ -118,50 +88,34 @@ extern int yylineno;
  
  
 /********* Procedure_blockImpl ************/
- Procedure_blockImpl::Procedure_blockImpl(std::list<Proc_ptr> *p1, std::list<Decl_ptr> *p2, std::list<Stat_ptr> *p3, Return_stat *p4)  {
+ Procedure_blockImpl::Procedure_blockImpl(Proc_list *p1, Decl_list *p2, Stat_list *p3, Return_stat *p4)  {
 	m_proc_list = p1;
 	m_decl_list = p2;
 	m_stat_list = p3;
 	m_return_stat = p4;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	std::list<Proc_ptr>::iterator m_proc_list_iter;
-	for(m_proc_list_iter = m_proc_list->begin();
-	  m_proc_list_iter != m_proc_list->end();
-	  ++m_proc_list_iter){
-		(*m_proc_list_iter)->m_parent_attribute = &m_attribute;
-	}
-	std::list<Decl_ptr>::iterator m_decl_list_iter;
-	for(m_decl_list_iter = m_decl_list->begin();
-	  m_decl_list_iter != m_decl_list->end();
-	  ++m_decl_list_iter){
-		(*m_decl_list_iter)->m_parent_attribute = &m_attribute;
-	}
-	std::list<Stat_ptr>::iterator m_stat_list_iter;
-	for(m_stat_list_iter = m_stat_list->begin();
-	  m_stat_list_iter != m_stat_list->end();
-	  ++m_stat_list_iter){
-		(*m_stat_list_iter)->m_parent_attribute = &m_attribute;
-	}
-	m_return_stat->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_Procedure_blockImpl;
+ }
  Procedure_blockImpl::Procedure_blockImpl(const Procedure_blockImpl & other) {
-	m_proc_list = new std::list<Proc_ptr>;
-	std::list<Proc_ptr>::iterator m_proc_list_iter;
+	m_kind = nk_Procedure_blockImpl;
+	m_proc_list = new Proc_list;
+	m_proc_list->reserve(other.m_proc_list->size());
+	Proc_list::iterator m_proc_list_iter;
 	for(m_proc_list_iter = other.m_proc_list->begin();
 	  m_proc_list_iter != other.m_proc_list->end();
 	  ++m_proc_list_iter){
 		m_proc_list->push_back( (*m_proc_list_iter)->clone() );
 	}
-	m_decl_list = new std::list<Decl_ptr>;
-	std::list<Decl_ptr>::iterator m_decl_list_iter;
+	m_decl_list = new Decl_list;
+	m_decl_list->reserve(other.m_decl_list->size());
+	Decl_list::iterator m_decl_list_iter;
 	for(m_decl_list_iter = other.m_decl_list->begin();
 	  m_decl_list_iter != other.m_decl_list->end();
 	  ++m_decl_list_iter){
 		m_decl_list->push_back( (*m_decl_list_iter)->clone() );
 	}
-	m_stat_list = new std::list<Stat_ptr>;
-	std::list<Stat_ptr>::iterator m_stat_list_iter;
+	m_stat_list = new Stat_list;
+	m_stat_list->reserve(other.m_stat_list->size());
+	Stat_list::iterator m_stat_list_iter;
 	for(m_stat_list_iter = other.m_stat_list->begin();
 	  m_stat_list_iter != other.m_stat_list->end();
 	  ++m_stat_list_iter){
@@ -176,43 +130,22 @@ extern int yylineno;
 	std::swap(m_stat_list, other.m_stat_list);
 	std::swap(m_return_stat, other.m_return_stat);
  }
- Procedure_blockImpl::~Procedure_blockImpl() {
- 	std::list<Proc_ptr>::iterator m_proc_list_iter;
-	for(m_proc_list_iter = m_proc_list->begin();
-	  m_proc_list_iter != m_proc_list->end();
-	  ++m_proc_list_iter){
-		delete( *m_proc_list_iter );
-	}
-	std::list<Decl_ptr>::iterator m_decl_list_iter;
-	for(m_decl_list_iter = m_decl_list->begin();
-	  m_decl_list_iter != m_decl_list->end();
-	  ++m_decl_list_iter){
-		delete( *m_decl_list_iter );
-	}
-	std::list<Stat_ptr>::iterator m_stat_list_iter;
-	for(m_stat_list_iter = m_stat_list->begin();
-	  m_stat_list_iter != m_stat_list->end();
-	  ++m_stat_list_iter){
-		delete( *m_stat_list_iter );
-	}
-	delete(m_return_stat);
-  }
  void Procedure_blockImpl::visit_children( Visitor* v ) {
- 	std::list<Proc_ptr>::iterator m_proc_list_iter;
-	for(m_proc_list_iter = m_proc_list->begin();
-	  m_proc_list_iter != m_proc_list->end();
+ 	Proc_list::iterator m_proc_list_iter, m_proc_list_end;
+	for(m_proc_list_iter = m_proc_list->begin(), m_proc_list_end = m_proc_list->end();
+	  m_proc_list_iter != m_proc_list_end;
 	  ++m_proc_list_iter){
 		(*m_proc_list_iter)->accept( v );
 	}
-	std::list<Decl_ptr>::iterator m_decl_list_iter;
-	for(m_decl_list_iter = m_decl_list->begin();
-	  m_decl_list_iter != m_decl_list->end();
+	Decl_list::iterator m_decl_list_iter, m_decl_list_end;
+	for(m_decl_list_iter = m_decl_list->begin(), m_decl_list_end = m_decl_list->end();
+	  m_decl_list_iter != m_decl_list_end;
 	  ++m_decl_list_iter){
 		(*m_decl_list_iter)->accept( v );
 	}
-	std::list<Stat_ptr>::iterator m_stat_list_iter;
-	for(m_stat_list_iter = m_stat_list->begin();
-	  m_stat_list_iter != m_stat_list->end();
+	Stat_list::iterator m_stat_list_iter, m_stat_list_end;
+	for(m_stat_list_iter = m_stat_list->begin(), m_stat_list_end = m_stat_list->end();
+	  m_stat_list_iter != m_stat_list_end;
 	  ++m_stat_list_iter){
 		(*m_stat_list_iter)->accept( v );
 	}
@@ -223,34 +156,24 @@ extern int yylineno;
  
  
 /********* Nested_blockImpl ************/
- Nested_blockImpl::Nested_blockImpl(std::list<Decl_ptr> *p1, std::list<Stat_ptr> *p2)  {
+ Nested_blockImpl::Nested_blockImpl(Decl_list *p1, Stat_list *p2)  {
 	m_decl_list = p1;
 	m_stat_list = p2;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	std::list<Decl_ptr>::iterator m_decl_list_iter;
-	for(m_decl_list_iter = m_decl_list->begin();
-	  m_decl_list_iter != m_decl_list->end();
-	  ++m_decl_list_iter){
-		(*m_decl_list_iter)->m_parent_attribute = &m_attribute;
-	}
-	std::list<Stat_ptr>::iterator m_stat_list_iter;
-	for(m_stat_list_iter = m_stat_list->begin();
-	  m_stat_list_iter != m_stat_list->end();
-	  ++m_stat_list_iter){
-		(*m_stat_list_iter)->m_parent_attribute = &m_attribute;
-	}
+	m_kind = nk_Nested_blockImpl;
  }
  Nested_blockImpl::Nested_blockImpl(const Nested_blockImpl & other) {
-	m_decl_list = new std::list<Decl_ptr>;
-	std::list<Decl_ptr>::iterator m_decl_list_iter;
+	m_kind = nk_Nested_blockImpl;
+	m_decl_list = new Decl_list;
+	m_decl_list->reserve(other.m_decl_list->size());
+	Decl_list::iterator m_decl_list_iter;
 	for(m_decl_list_iter = other.m_decl_list->begin();
 	  m_decl_list_iter != other.m_decl_list->end();
 	  ++m_decl_list_iter){
 		m_decl_list->push_back( (*m_decl_list_iter)->clone() );
 	}
-	m_stat_list = new std::list<Stat_ptr>;
-	std::list<Stat_ptr>::iterator m_stat_list_iter;
+	m_stat_list = new Stat_list;
+	m_stat_list->reserve(other.m_stat_list->size());
+	Stat_list::iterator m_stat_list_iter;
 	for(m_stat_list_iter = other.m_stat_list->begin();
 	  m_stat_list_iter != other.m_stat_list->end();
 	  ++m_stat_list_iter){
@@ -262,30 +185,16 @@ extern int yylineno;
 	std::swap(m_decl_list, other.m_decl_list);
 	std::swap(m_stat_list, other.m_stat_list);
  }
- Nested_blockImpl::~Nested_blockImpl() {
- 	std::list<Decl_ptr>::iterator m_decl_list_iter;
-	for(m_decl_list_iter = m_decl_list->begin();
-	  m_decl_list_iter != m_decl_list->end();
-	  ++m_decl_list_iter){
-		delete( *m_decl_list_iter );
-	}
-	std::list<Stat_ptr>::iterator m_stat_list_iter;
-	for(m_stat_list_iter = m_stat_list->begin();
-	  m_stat_list_iter != m_stat_list->end();
-	  ++m_stat_list_iter){
-		delete( *m_stat_list_iter );
-	}
- }
  void Nested_blockImpl::visit_children( Visitor* v ) {
- 	std::list<Decl_ptr>::iterator m_decl_list_iter;
-	for(m_decl_list_iter = m_decl_list->begin();
-	  m_decl_list_iter != m_decl_list->end();
+ 	Decl_list::iterator m_decl_list_iter, m_decl_list_end;
+	for(m_decl_list_iter = m_decl_list->begin(), m_decl_list_end = m_decl_list->end();
+	  m_decl_list_iter != m_decl_list_end;
 	  ++m_decl_list_iter){
 		(*m_decl_list_iter)->accept( v );
 	}
-	std::list<Stat_ptr>::iterator m_stat_list_iter;
-	for(m_stat_list_iter = m_stat_list->begin();
-	  m_stat_list_iter != m_stat_list->end();
+	Stat_list::iterator m_stat_list_iter, m_stat_list_end;
+	for(m_stat_list_iter = m_stat_list->begin(), m_stat_list_end = m_stat_list->end();
+	  m_stat_list_iter != m_stat_list_end;
 	  ++m_stat_list_iter){
 		(*m_stat_list_iter)->accept( v );
 	}
@@ -295,22 +204,16 @@ extern int yylineno;
  
  
 /********* DeclImpl ************/
- DeclImpl::DeclImpl(std::list<SymName_ptr> *p1, Type *p2)  {
+ DeclImpl::DeclImpl(SymName_list *p1, Type *p2)  {
 	m_symname_list = p1;
 	m_type = p2;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	std::list<SymName_ptr>::iterator m_symname_list_iter;
-	for(m_symname_list_iter = m_symname_list->begin();
-	  m_symname_list_iter != m_symname_list->end();
-	  ++m_symname_list_iter){
-		(*m_symname_list_iter)->m_parent_attribute = &m_attribute;
-	}
-	m_type->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_DeclImpl;
+ }
  DeclImpl::DeclImpl(const DeclImpl & other) {
-	m_symname_list = new std::list<SymName_ptr>;
-	std::list<SymName_ptr>::iterator m_symname_list_iter;
+	m_kind = nk_DeclImpl;
+	m_symname_list = new SymName_list;
+	m_symname_list->reserve(other.m_symname_list->size());
+	SymName_list::iterator m_symname_list_iter;
 	for(m_symname_list_iter = other.m_symname_list->begin();
 	  m_symname_list_iter != other.m_symname_list->end();
 	  ++m_symname_list_iter){
@@ -323,19 +226,10 @@ extern int yylineno;
 	std::swap(m_symname_list, other.m_symname_list);
 	std::swap(m_type, other.m_type);
  }
- DeclImpl::~DeclImpl() {
- 	std::list<SymName_ptr>::iterator m_symname_list_iter;
-	for(m_symname_list_iter = m_symname_list->begin();
-	  m_symname_list_iter != m_symname_list->end();
-	  ++m_symname_list_iter){
-		delete( *m_symname_list_iter );
-	}
-	delete(m_type);
-  }
  void DeclImpl::visit_children( Visitor* v ) {
- 	std::list<SymName_ptr>::iterator m_symname_list_iter;
-	for(m_symname_list_iter = m_symname_list->begin();
-	  m_symname_list_iter != m_symname_list->end();
+ 	SymName_list::iterator m_symname_list_iter, m_symname_list_end;
+	for(m_symname_list_iter = m_symname_list->begin(), m_symname_list_end = m_symname_list->end();
+	  m_symname_list_iter != m_symname_list_end;
 	  ++m_symname_list_iter){
 		(*m_symname_list_iter)->accept( v );
 	}
@@ -349,12 +243,10 @@ extern int yylineno;
  Assignment::Assignment(Lhs *p1, Expr *p2)  {
 	m_lhs = p1;
 	m_expr = p2;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_lhs->m_parent_attribute = &m_attribute;
- 	m_expr->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_Assignment;
+ }
  Assignment::Assignment(const Assignment & other) {
+	m_kind = nk_Assignment;
 	m_lhs = other.m_lhs->clone();
 	m_expr = other.m_expr->clone();
  }
@@ -363,10 +255,6 @@ extern int yylineno;
 	std::swap(m_lhs, other.m_lhs);
 	std::swap(m_expr, other.m_expr);
  }
- Assignment::~Assignment() {
- 	delete(m_lhs);
- 	delete(m_expr);
-  }
  void Assignment::visit_children( Visitor* v ) {
  	m_lhs->accept( v );
  	m_expr->accept( v );
@@ -379,12 +267,10 @@ extern int yylineno;
  StringAssignment::StringAssignment(Lhs *p1, StringPrimitive *p2)  {
 	m_lhs = p1;
 	m_stringprimitive = p2;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_lhs->m_parent_attribute = &m_attribute;
- 	m_stringprimitive->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_StringAssignment;
+ }
  StringAssignment::StringAssignment(const StringAssignment & other) {
+	m_kind = nk_StringAssignment;
 	m_lhs = other.m_lhs->clone();
 	m_stringprimitive = other.m_stringprimitive->clone();
  }
@@ -393,10 +279,6 @@ extern int yylineno;
 	std::swap(m_lhs, other.m_lhs);
 	std::swap(m_stringprimitive, other.m_stringprimitive);
  }
- StringAssignment::~StringAssignment() {
- 	delete(m_lhs);
- 	delete(m_stringprimitive);
-  }
  void StringAssignment::visit_children( Visitor* v ) {
  	m_lhs->accept( v );
  	m_stringprimitive->accept( v );
@@ -406,26 +288,19 @@ extern int yylineno;
  
  
 /********* Call ************/
- Call::Call(Lhs *p1, SymName *p2, std::list<Expr_ptr> *p3)  {
+ Call::Call(Lhs *p1, const SymName &p2, Expr_list *p3)  {
 	m_lhs = p1;
 	m_symname = p2;
 	m_expr_list = p3;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_lhs->m_parent_attribute = &m_attribute;
- 	m_symname->m_parent_attribute = &m_attribute;
- 	std::list<Expr_ptr>::iterator m_expr_list_iter;
-	for(m_expr_list_iter = m_expr_list->begin();
-	  m_expr_list_iter != m_expr_list->end();
-	  ++m_expr_list_iter){
-		(*m_expr_list_iter)->m_parent_attribute = &m_attribute;
-	}
+	m_kind = nk_Call;
  }
  Call::Call(const Call & other) {
+	m_kind = nk_Call;
 	m_lhs = other.m_lhs->clone();
-	m_symname = other.m_symname->clone();
-	m_expr_list = new std::list<Expr_ptr>;
-	std::list<Expr_ptr>::iterator m_expr_list_iter;
+	m_symname = other.m_symname;
+	m_expr_list = new Expr_list;
+	m_expr_list->reserve(other.m_expr_list->size());
+	Expr_list::iterator m_expr_list_iter;
 	for(m_expr_list_iter = other.m_expr_list->begin();
 	  m_expr_list_iter != other.m_expr_list->end();
 	  ++m_expr_list_iter){
@@ -438,22 +313,12 @@ extern int yylineno;
 	std::swap(m_symname, other.m_symname);
 	std::swap(m_expr_list, other.m_expr_list);
  }
- Call::~Call() {
- 	delete(m_lhs);
- 	delete(m_symname);
- 	std::list<Expr_ptr>::iterator m_expr_list_iter;
-	for(m_expr_list_iter = m_expr_list->begin();
-	  m_expr_list_iter != m_expr_list->end();
-	  ++m_expr_list_iter){
-		delete( *m_expr_list_iter );
-	}
- }
  void Call::visit_children( Visitor* v ) {
  	m_lhs->accept( v );
- 	m_symname->accept( v );
- 	std::list<Expr_ptr>::iterator m_expr_list_iter;
-	for(m_expr_list_iter = m_expr_list->begin();
-	  m_expr_list_iter != m_expr_list->end();
+ 	m_symname.accept( v );
+ 	Expr_list::iterator m_expr_list_iter, m_expr_list_end;
+	for(m_expr_list_iter = m_expr_list->begin(), m_expr_list_end = m_expr_list->end();
+	  m_expr_list_iter != m_expr_list_end;
 	  ++m_expr_list_iter){
 		(*m_expr_list_iter)->accept( v );
 	}
@@ -466,12 +331,10 @@ extern int yylineno;
  IfNoElse::IfNoElse(Expr *p1, Nested_block *p2)  {
 	m_expr = p1;
 	m_nested_block = p2;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_expr->m_parent_attribute = &m_attribute;
- 	m_nested_block->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_IfNoElse;
+ }
  IfNoElse::IfNoElse(const IfNoElse & other) {
+	m_kind = nk_IfNoElse;
 	m_expr = other.m_expr->clone();
 	m_nested_block = other.m_nested_block->clone();
  }
@@ -480,10 +343,6 @@ extern int yylineno;
 	std::swap(m_expr, other.m_expr);
 	std::swap(m_nested_block, other.m_nested_block);
  }
- IfNoElse::~IfNoElse() {
- 	delete(m_expr);
- 	delete(m_nested_block);
-  }
  void IfNoElse::visit_children( Visitor* v ) {
  	m_expr->accept( v );
  	m_nested_block->accept( v );
@@ -497,13 +356,10 @@ extern int yylineno;
 	m_expr = p1;
 	m_nested_block_1 = p2;
 	m_nested_block_2 = p3;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_expr->m_parent_attribute = &m_attribute;
- 	m_nested_block_1->m_parent_attribute = &m_attribute;
- 	m_nested_block_2->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_IfWithElse;
+ }
  IfWithElse::IfWithElse(const IfWithElse & other) {
+	m_kind = nk_IfWithElse;
 	m_expr = other.m_expr->clone();
 	m_nested_block_1 = other.m_nested_block_1->clone();
 	m_nested_block_2 = other.m_nested_block_2->clone();
@@ -514,11 +370,6 @@ extern int yylineno;
 	std::swap(m_nested_block_1, other.m_nested_block_1);
 	std::swap(m_nested_block_2, other.m_nested_block_2);
  }
- IfWithElse::~IfWithElse() {
- 	delete(m_expr);
- 	delete(m_nested_block_1);
- 	delete(m_nested_block_2);
-  }
  void IfWithElse::visit_children( Visitor* v ) {
  	m_expr->accept( v );
  	m_nested_block_1->accept( v );
@@ -532,12 +383,10 @@ extern int yylineno;
  WhileLoop::WhileLoop(Expr *p1, Nested_block *p2)  {
 	m_expr = p1;
 	m_nested_block = p2;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_expr->m_parent_attribute = &m_attribute;
- 	m_nested_block->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_WhileLoop;
+ }
  WhileLoop::WhileLoop(const WhileLoop & other) {
+	m_kind = nk_WhileLoop;
 	m_expr = other.m_expr->clone();
 	m_nested_block = other.m_nested_block->clone();
  }
@@ -546,10 +395,6 @@ extern int yylineno;
 	std::swap(m_expr, other.m_expr);
 	std::swap(m_nested_block, other.m_nested_block);
  }
- WhileLoop::~WhileLoop() {
- 	delete(m_expr);
- 	delete(m_nested_block);
-  }
  void WhileLoop::visit_children( Visitor* v ) {
  	m_expr->accept( v );
  	m_nested_block->accept( v );
@@ -561,20 +406,16 @@ extern int yylineno;
 /********* CodeBlock ************/
  CodeBlock::CodeBlock(Nested_block *p1)  {
 	m_nested_block = p1;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_nested_block->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_CodeBlock;
+ }
  CodeBlock::CodeBlock(const CodeBlock & other) {
+	m_kind = nk_CodeBlock;
 	m_nested_block = other.m_nested_block->clone();
  }
  CodeBlock &CodeBlock::operator=(const CodeBlock & other) { CodeBlock tmp(other); swap(tmp); return *this; }
  void CodeBlock::swap(CodeBlock & other) {
 	std::swap(m_nested_block, other.m_nested_block);
  }
- CodeBlock::~CodeBlock() {
- 	delete(m_nested_block);
-  }
  void CodeBlock::visit_children( Visitor* v ) {
  	m_nested_block->accept( v );
   }
@@ -585,20 +426,16 @@ extern int yylineno;
 /********* Return ************/
  Return::Return(Expr *p1)  {
 	m_expr = p1;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_expr->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_Return;
+ }
  Return::Return(const Return & other) {
+	m_kind = nk_Return;
 	m_expr = other.m_expr->clone();
  }
  Return &Return::operator=(const Return & other) { Return tmp(other); swap(tmp); return *this; }
  void Return::swap(Return & other) {
 	std::swap(m_expr, other.m_expr);
  }
- Return::~Return() {
- 	delete(m_expr);
-  }
  void Return::visit_children( Visitor* v ) {
  	m_expr->accept( v );
   }
@@ -608,16 +445,14 @@ extern int yylineno;
  
 /********* TInteger ************/
  TInteger::TInteger()  {
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
+	m_kind = nk_TInteger;
  }
  TInteger::TInteger(const TInteger & other) {
+	m_kind = nk_TInteger;
  }
  TInteger &TInteger::operator=(const TInteger & other) { TInteger tmp(other); swap(tmp); return *this; }
  void TInteger::swap(TInteger & other) {
  }
- TInteger::~TInteger() {
-  }
  void TInteger::visit_children( Visitor* v ) {
   }
  void TInteger::accept(Visitor *v) { v->visitTInteger(this); }
@@ -626,16 +461,14 @@ extern int yylineno;
  
 /********* TCharacter ************/
  TCharacter::TCharacter()  {
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
+	m_kind = nk_TCharacter;
  }
  TCharacter::TCharacter(const TCharacter & other) {
+	m_kind = nk_TCharacter;
  }
  TCharacter &TCharacter::operator=(const TCharacter & other) { TCharacter tmp(other); swap(tmp); return *this; }
  void TCharacter::swap(TCharacter & other) {
  }
- TCharacter::~TCharacter() {
-  }
  void TCharacter::visit_children( Visitor* v ) {
   }
  void TCharacter::accept(Visitor *v) { v->visitTCharacter(this); }
@@ -644,16 +477,14 @@ extern int yylineno;
  
 /********* TBoolean ************/
  TBoolean::TBoolean()  {
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
+	m_kind = nk_TBoolean;
  }
  TBoolean::TBoolean(const TBoolean & other) {
+	m_kind = nk_TBoolean;
  }
  TBoolean &TBoolean::operator=(const TBoolean & other) { TBoolean tmp(other); swap(tmp); return *this; }
  void TBoolean::swap(TBoolean & other) {
  }
- TBoolean::~TBoolean() {
-  }
  void TBoolean::visit_children( Visitor* v ) {
   }
  void TBoolean::accept(Visitor *v) { v->visitTBoolean(this); }
@@ -662,16 +493,14 @@ extern int yylineno;
  
 /********* TCharPtr ************/
  TCharPtr::TCharPtr()  {
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
+	m_kind = nk_TCharPtr;
  }
  TCharPtr::TCharPtr(const TCharPtr & other) {
+	m_kind = nk_TCharPtr;
  }
  TCharPtr &TCharPtr::operator=(const TCharPtr & other) { TCharPtr tmp(other); swap(tmp); return *this; }
  void TCharPtr::swap(TCharPtr & other) {
  }
- TCharPtr::~TCharPtr() {
-  }
  void TCharPtr::visit_children( Visitor* v ) {
   }
  void TCharPtr::accept(Visitor *v) { v->visitTCharPtr(this); }
@@ -680,16 +509,14 @@ extern int yylineno;
  
 /********* TIntPtr ************/
  TIntPtr::TIntPtr()  {
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
+	m_kind = nk_TIntPtr;
  }
  TIntPtr::TIntPtr(const TIntPtr & other) {
+	m_kind = nk_TIntPtr;
  }
  TIntPtr &TIntPtr::operator=(const TIntPtr & other) { TIntPtr tmp(other); swap(tmp); return *this; }
  void TIntPtr::swap(TIntPtr & other) {
  }
- TIntPtr::~TIntPtr() {
-  }
  void TIntPtr::visit_children( Visitor* v ) {
   }
  void TIntPtr::accept(Visitor *v) { v->visitTIntPtr(this); }
@@ -697,24 +524,20 @@ extern int yylineno;
  
  
 /********* TString ************/
- TString::TString(Primitive *p1)  {
+ TString::TString(const Primitive &p1)  {
 	m_primitive = p1;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_primitive->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_TString;
+ }
  TString::TString(const TString & other) {
-	m_primitive = other.m_primitive->clone();
+	m_kind = nk_TString;
+	m_primitive = other.m_primitive;
  }
  TString &TString::operator=(const TString & other) { TString tmp(other); swap(tmp); return *this; }
  void TString::swap(TString & other) {
 	std::swap(m_primitive, other.m_primitive);
  }
- TString::~TString() {
- 	delete(m_primitive);
-  }
  void TString::visit_children( Visitor* v ) {
- 	m_primitive->accept( v );
+ 	m_primitive.accept( v );
   }
  void TString::accept(Visitor *v) { v->visitTString(this); }
  TString *TString::clone() const { return new TString(*this); }
@@ -723,20 +546,16 @@ extern int yylineno;
 /********* AbsoluteValue ************/
  AbsoluteValue::AbsoluteValue(Expr *p1)  {
 	m_expr = p1;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_expr->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_AbsoluteValue;
+ }
  AbsoluteValue::AbsoluteValue(const AbsoluteValue & other) {
+	m_kind = nk_AbsoluteValue;
 	m_expr = other.m_expr->clone();
  }
  AbsoluteValue &AbsoluteValue::operator=(const AbsoluteValue & other) { AbsoluteValue tmp(other); swap(tmp); return *this; }
  void AbsoluteValue::swap(AbsoluteValue & other) {
 	std::swap(m_expr, other.m_expr);
  }
- AbsoluteValue::~AbsoluteValue() {
- 	delete(m_expr);
-  }
  void AbsoluteValue::visit_children( Visitor* v ) {
  	m_expr->accept( v );
   }
@@ -747,20 +566,16 @@ extern int yylineno;
 /********* AddressOf ************/
  AddressOf::AddressOf(Lhs *p1)  {
 	m_lhs = p1;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_lhs->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_AddressOf;
+ }
  AddressOf::AddressOf(const AddressOf & other) {
+	m_kind = nk_AddressOf;
 	m_lhs = other.m_lhs->clone();
  }
  AddressOf &AddressOf::operator=(const AddressOf & other) { AddressOf tmp(other); swap(tmp); return *this; }
  void AddressOf::swap(AddressOf & other) {
 	std::swap(m_lhs, other.m_lhs);
  }
- AddressOf::~AddressOf() {
- 	delete(m_lhs);
-  }
  void AddressOf::visit_children( Visitor* v ) {
  	m_lhs->accept( v );
   }
@@ -772,12 +587,10 @@ extern int yylineno;
  And::And(Expr *p1, Expr *p2)  {
 	m_expr_1 = p1;
 	m_expr_2 = p2;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_expr_1->m_parent_attribute = &m_attribute;
- 	m_expr_2->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_And;
+ }
  And::And(const And & other) {
+	m_kind = nk_And;
 	m_expr_1 = other.m_expr_1->clone();
 	m_expr_2 = other.m_expr_2->clone();
  }
@@ -786,10 +599,6 @@ extern int yylineno;
 	std::swap(m_expr_1, other.m_expr_1);
 	std::swap(m_expr_2, other.m_expr_2);
  }
- And::~And() {
- 	delete(m_expr_1);
- 	delete(m_expr_2);
-  }
  void And::visit_children( Visitor* v ) {
  	m_expr_1->accept( v );
  	m_expr_2->accept( v );
@@ -802,12 +611,10 @@ extern int yylineno;
  Div::Div(Expr *p1, Expr *p2)  {
 	m_expr_1 = p1;
 	m_expr_2 = p2;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_expr_1->m_parent_attribute = &m_attribute;
- 	m_expr_2->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_Div;
+ }
  Div::Div(const Div & other) {
+	m_kind = nk_Div;
 	m_expr_1 = other.m_expr_1->clone();
 	m_expr_2 = other.m_expr_2->clone();
  }
@@ -816,10 +623,6 @@ extern int yylineno;
 	std::swap(m_expr_1, other.m_expr_1);
 	std::swap(m_expr_2, other.m_expr_2);
  }
- Div::~Div() {
- 	delete(m_expr_1);
- 	delete(m_expr_2);
-  }
  void Div::visit_children( Visitor* v ) {
  	m_expr_1->accept( v );
  	m_expr_2->accept( v );
@@ -832,12 +635,10 @@ extern int yylineno;
  Compare::Compare(Expr *p1, Expr *p2)  {
 	m_expr_1 = p1;
 	m_expr_2 = p2;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_expr_1->m_parent_attribute = &m_attribute;
- 	m_expr_2->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_Compare;
+ }
  Compare::Compare(const Compare & other) {
+	m_kind = nk_Compare;
 	m_expr_1 = other.m_expr_1->clone();
 	m_expr_2 = other.m_expr_2->clone();
  }
@@ -846,10 +647,6 @@ extern int yylineno;
 	std::swap(m_expr_1, other.m_expr_1);
 	std::swap(m_expr_2, other.m_expr_2);
  }
- Compare::~Compare() {
- 	delete(m_expr_1);
- 	delete(m_expr_2);
-  }
  void Compare::visit_children( Visitor* v ) {
  	m_expr_1->accept( v );
  	m_expr_2->accept( v );
@@ -862,12 +659,10 @@ extern int yylineno;
  Gt::Gt(Expr *p1, Expr *p2)  {
 	m_expr_1 = p1;
 	m_expr_2 = p2;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_expr_1->m_parent_attribute = &m_attribute;
- 	m_expr_2->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_Gt;
+ }
  Gt::Gt(const Gt & other) {
+	m_kind = nk_Gt;
 	m_expr_1 = other.m_expr_1->clone();
 	m_expr_2 = other.m_expr_2->clone();
  }
@@ -876,10 +671,6 @@ extern int yylineno;
 	std::swap(m_expr_1, other.m_expr_1);
 	std::swap(m_expr_2, other.m_expr_2);
  }
- Gt::~Gt() {
- 	delete(m_expr_1);
- 	delete(m_expr_2);
-  }
  void Gt::visit_children( Visitor* v ) {
  	m_expr_1->accept( v );
  	m_expr_2->accept( v );
@@ -892,12 +683,10 @@ extern int yylineno;
  Gteq::Gteq(Expr *p1, Expr *p2)  {
 	m_expr_1 = p1;
 	m_expr_2 = p2;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_expr_1->m_parent_attribute = &m_attribute;
- 	m_expr_2->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_Gteq;
+ }
  Gteq::Gteq(const Gteq & other) {
+	m_kind = nk_Gteq;
 	m_expr_1 = other.m_expr_1->clone();
 	m_expr_2 = other.m_expr_2->clone();
  }
@@ -906,10 +695,6 @@ extern int yylineno;
 	std::swap(m_expr_1, other.m_expr_1);
 	std::swap(m_expr_2, other.m_expr_2);
  }
- Gteq::~Gteq() {
- 	delete(m_expr_1);
- 	delete(m_expr_2);
-  }
  void Gteq::visit_children( Visitor* v ) {
  	m_expr_1->accept( v );
  	m_expr_2->accept( v );
@@ -922,12 +707,10 @@ extern int yylineno;
  Lt::Lt(Expr *p1, Expr *p2)  {
 	m_expr_1 = p1;
 	m_expr_2 = p2;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_expr_1->m_parent_attribute = &m_attribute;
- 	m_expr_2->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_Lt;
+ }
  Lt::Lt(const Lt & other) {
+	m_kind = nk_Lt;
 	m_expr_1 = other.m_expr_1->clone();
 	m_expr_2 = other.m_expr_2->clone();
  }
@@ -936,10 +719,6 @@ extern int yylineno;
 	std::swap(m_expr_1, other.m_expr_1);
 	std::swap(m_expr_2, other.m_expr_2);
  }
- Lt::~Lt() {
- 	delete(m_expr_1);
- 	delete(m_expr_2);
-  }
  void Lt::visit_children( Visitor* v ) {
  	m_expr_1->accept( v );
  	m_expr_2->accept( v );
@@ -952,12 +731,10 @@ extern int yylineno;
  Lteq::Lteq(Expr *p1, Expr *p2)  {
 	m_expr_1 = p1;
 	m_expr_2 = p2;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_expr_1->m_parent_attribute = &m_attribute;
- 	m_expr_2->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_Lteq;
+ }
  Lteq::Lteq(const Lteq & other) {
+	m_kind = nk_Lteq;
 	m_expr_1 = other.m_expr_1->clone();
 	m_expr_2 = other.m_expr_2->clone();
  }
@@ -966,10 +743,6 @@ extern int yylineno;
 	std::swap(m_expr_1, other.m_expr_1);
 	std::swap(m_expr_2, other.m_expr_2);
  }
- Lteq::~Lteq() {
- 	delete(m_expr_1);
- 	delete(m_expr_2);
-  }
  void Lteq::visit_children( Visitor* v ) {
  	m_expr_1->accept( v );
  	m_expr_2->accept( v );
@@ -982,12 +755,10 @@ extern int yylineno;
  Minus::Minus(Expr *p1, Expr *p2)  {
 	m_expr_1 = p1;
 	m_expr_2 = p2;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_expr_1->m_parent_attribute = &m_attribute;
- 	m_expr_2->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_Minus;
+ }
  Minus::Minus(const Minus & other) {
+	m_kind = nk_Minus;
 	m_expr_1 = other.m_expr_1->clone();
 	m_expr_2 = other.m_expr_2->clone();
  }
@@ -996,10 +767,6 @@ extern int yylineno;
 	std::swap(m_expr_1, other.m_expr_1);
 	std::swap(m_expr_2, other.m_expr_2);
  }
- Minus::~Minus() {
- 	delete(m_expr_1);
- 	delete(m_expr_2);
-  }
  void Minus::visit_children( Visitor* v ) {
  	m_expr_1->accept( v );
  	m_expr_2->accept( v );
@@ -1012,12 +779,10 @@ extern int yylineno;
  Noteq::Noteq(Expr *p1, Expr *p2)  {
 	m_expr_1 = p1;
 	m_expr_2 = p2;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_expr_1->m_parent_attribute = &m_attribute;
- 	m_expr_2->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_Noteq;
+ }
  Noteq::Noteq(const Noteq & other) {
+	m_kind = nk_Noteq;
 	m_expr_1 = other.m_expr_1->clone();
 	m_expr_2 = other.m_expr_2->clone();
  }
@@ -1026,10 +791,6 @@ extern int yylineno;
 	std::swap(m_expr_1, other.m_expr_1);
 	std::swap(m_expr_2, other.m_expr_2);
  }
- Noteq::~Noteq() {
- 	delete(m_expr_1);
- 	delete(m_expr_2);
-  }
  void Noteq::visit_children( Visitor* v ) {
  	m_expr_1->accept( v );
  	m_expr_2->accept( v );
@@ -1042,12 +803,10 @@ extern int yylineno;
  Or::Or(Expr *p1, Expr *p2)  {
 	m_expr_1 = p1;
 	m_expr_2 = p2;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_expr_1->m_parent_attribute = &m_attribute;
- 	m_expr_2->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_Or;
+ }
  Or::Or(const Or & other) {
+	m_kind = nk_Or;
 	m_expr_1 = other.m_expr_1->clone();
 	m_expr_2 = other.m_expr_2->clone();
  }
@@ -1056,10 +815,6 @@ extern int yylineno;
 	std::swap(m_expr_1, other.m_expr_1);
 	std::swap(m_expr_2, other.m_expr_2);
  }
- Or::~Or() {
- 	delete(m_expr_1);
- 	delete(m_expr_2);
-  }
  void Or::visit_children( Visitor* v ) {
  	m_expr_1->accept( v );
  	m_expr_2->accept( v );
@@ -1072,12 +827,10 @@ extern int yylineno;
  Plus::Plus(Expr *p1, Expr *p2)  {
 	m_expr_1 = p1;
 	m_expr_2 = p2;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_expr_1->m_parent_attribute = &m_attribute;
- 	m_expr_2->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_Plus;
+ }
  Plus::Plus(const Plus & other) {
+	m_kind = nk_Plus;
 	m_expr_1 = other.m_expr_1->clone();
 	m_expr_2 = other.m_expr_2->clone();
  }
@@ -1086,10 +839,6 @@ extern int yylineno;
 	std::swap(m_expr_1, other.m_expr_1);
 	std::swap(m_expr_2, other.m_expr_2);
  }
- Plus::~Plus() {
- 	delete(m_expr_1);
- 	delete(m_expr_2);
-  }
  void Plus::visit_children( Visitor* v ) {
  	m_expr_1->accept( v );
  	m_expr_2->accept( v );
@@ -1102,12 +851,10 @@ extern int yylineno;
  Times::Times(Expr *p1, Expr *p2)  {
 	m_expr_1 = p1;
 	m_expr_2 = p2;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_expr_1->m_parent_attribute = &m_attribute;
- 	m_expr_2->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_Times;
+ }
  Times::Times(const Times & other) {
+	m_kind = nk_Times;
 	m_expr_1 = other.m_expr_1->clone();
 	m_expr_2 = other.m_expr_2->clone();
  }
@@ -1116,10 +863,6 @@ extern int yylineno;
 	std::swap(m_expr_1, other.m_expr_1);
 	std::swap(m_expr_2, other.m_expr_2);
  }
- Times::~Times() {
- 	delete(m_expr_1);
- 	delete(m_expr_2);
-  }
  void Times::visit_children( Visitor* v ) {
  	m_expr_1->accept( v );
  	m_expr_2->accept( v );
@@ -1131,20 +874,16 @@ extern int yylineno;
 /********* Not ************/
  Not::Not(Expr *p1)  {
 	m_expr = p1;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_expr->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_Not;
+ }
  Not::Not(const Not & other) {
+	m_kind = nk_Not;
 	m_expr = other.m_expr->clone();
  }
  Not &Not::operator=(const Not & other) { Not tmp(other); swap(tmp); return *this; }
  void Not::swap(Not & other) {
 	std::swap(m_expr, other.m_expr);
  }
- Not::~Not() {
- 	delete(m_expr);
-  }
  void Not::visit_children( Visitor* v ) {
  	m_expr->accept( v );
   }
@@ -1155,20 +894,16 @@ extern int yylineno;
 /********* Uminus ************/
  Uminus::Uminus(Expr *p1)  {
 	m_expr = p1;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_expr->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_Uminus;
+ }
  Uminus::Uminus(const Uminus & other) {
+	m_kind = nk_Uminus;
 	m_expr = other.m_expr->clone();
  }
  Uminus &Uminus::operator=(const Uminus & other) { Uminus tmp(other); swap(tmp); return *this; }
  void Uminus::swap(Uminus & other) {
 	std::swap(m_expr, other.m_expr);
  }
- Uminus::~Uminus() {
- 	delete(m_expr);
-  }
  void Uminus::visit_children( Visitor* v ) {
  	m_expr->accept( v );
   }
@@ -1177,40 +912,34 @@ extern int yylineno;
  
  
 /********* Ident ************/
- Ident::Ident(SymName *p1)  {
+ Ident::Ident(const SymName &p1)  {
 	m_symname = p1;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_symname->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_Ident;
+ }
  Ident::Ident(const Ident & other) {
-	m_symname = other.m_symname->clone();
+	m_kind = nk_Ident;
+	m_symname = other.m_symname;
  }
  Ident &Ident::operator=(const Ident & other) { Ident tmp(other); swap(tmp); return *this; }
  void Ident::swap(Ident & other) {
 	std::swap(m_symname, other.m_symname);
  }
- Ident::~Ident() {
- 	delete(m_symname);
-  }
  void Ident::visit_children( Visitor* v ) {
- 	m_symname->accept( v );
+ 	m_symname.accept( v );
   }
  void Ident::accept(Visitor *v) { v->visitIdent(this); }
  Ident *Ident::clone() const { return new Ident(*this); }
  
  
 /********* ArrayAccess ************/
- ArrayAccess::ArrayAccess(SymName *p1, Expr *p2)  {
+ ArrayAccess::ArrayAccess(const SymName &p1, Expr *p2)  {
 	m_symname = p1;
 	m_expr = p2;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_symname->m_parent_attribute = &m_attribute;
- 	m_expr->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_ArrayAccess;
+ }
  ArrayAccess::ArrayAccess(const ArrayAccess & other) {
-	m_symname = other.m_symname->clone();
+	m_kind = nk_ArrayAccess;
+	m_symname = other.m_symname;
 	m_expr = other.m_expr->clone();
  }
  ArrayAccess &ArrayAccess::operator=(const ArrayAccess & other) { ArrayAccess tmp(other); swap(tmp); return *this; }
@@ -1218,12 +947,8 @@ extern int yylineno;
 	std::swap(m_symname, other.m_symname);
 	std::swap(m_expr, other.m_expr);
  }
- ArrayAccess::~ArrayAccess() {
- 	delete(m_symname);
- 	delete(m_expr);
-  }
  void ArrayAccess::visit_children( Visitor* v ) {
- 	m_symname->accept( v );
+ 	m_symname.accept( v );
  	m_expr->accept( v );
   }
  void ArrayAccess::accept(Visitor *v) { v->visitArrayAccess(this); }
@@ -1231,72 +956,60 @@ extern int yylineno;
  
  
 /********* IntLit ************/
- IntLit::IntLit(Primitive *p1)  {
+ IntLit::IntLit(const Primitive &p1)  {
 	m_primitive = p1;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_primitive->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_IntLit;
+ }
  IntLit::IntLit(const IntLit & other) {
-	m_primitive = other.m_primitive->clone();
+	m_kind = nk_IntLit;
+	m_primitive = other.m_primitive;
  }
  IntLit &IntLit::operator=(const IntLit & other) { IntLit tmp(other); swap(tmp); return *this; }
  void IntLit::swap(IntLit & other) {
 	std::swap(m_primitive, other.m_primitive);
  }
- IntLit::~IntLit() {
- 	delete(m_primitive);
-  }
  void IntLit::visit_children( Visitor* v ) {
- 	m_primitive->accept( v );
+ 	m_primitive.accept( v );
   }
  void IntLit::accept(Visitor *v) { v->visitIntLit(this); }
  IntLit *IntLit::clone() const { return new IntLit(*this); }
  
  
 /********* CharLit ************/
- CharLit::CharLit(Primitive *p1)  {
+ CharLit::CharLit(const Primitive &p1)  {
 	m_primitive = p1;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_primitive->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_CharLit;
+ }
  CharLit::CharLit(const CharLit & other) {
-	m_primitive = other.m_primitive->clone();
+	m_kind = nk_CharLit;
+	m_primitive = other.m_primitive;
  }
  CharLit &CharLit::operator=(const CharLit & other) { CharLit tmp(other); swap(tmp); return *this; }
  void CharLit::swap(CharLit & other) {
 	std::swap(m_primitive, other.m_primitive);
  }
- CharLit::~CharLit() {
- 	delete(m_primitive);
-  }
  void CharLit::visit_children( Visitor* v ) {
- 	m_primitive->accept( v );
+ 	m_primitive.accept( v );
   }
  void CharLit::accept(Visitor *v) { v->visitCharLit(this); }
  CharLit *CharLit::clone() const { return new CharLit(*this); }
  
  
 /********* BoolLit ************/
- BoolLit::BoolLit(Primitive *p1)  {
+ BoolLit::BoolLit(const Primitive &p1)  {
 	m_primitive = p1;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_primitive->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_BoolLit;
+ }
  BoolLit::BoolLit(const BoolLit & other) {
-	m_primitive = other.m_primitive->clone();
+	m_kind = nk_BoolLit;
+	m_primitive = other.m_primitive;
  }
  BoolLit &BoolLit::operator=(const BoolLit & other) { BoolLit tmp(other); swap(tmp); return *this; }
  void BoolLit::swap(BoolLit & other) {
 	std::swap(m_primitive, other.m_primitive);
  }
- BoolLit::~BoolLit() {
- 	delete(m_primitive);
-  }
  void BoolLit::visit_children( Visitor* v ) {
- 	m_primitive->accept( v );
+ 	m_primitive.accept( v );
   }
  void BoolLit::accept(Visitor *v) { v->visitBoolLit(this); }
  BoolLit *BoolLit::clone() const { return new BoolLit(*this); }
@@ -1304,16 +1017,14 @@ extern int yylineno;
  
 /********* NullLit ************/
  NullLit::NullLit()  {
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
+	m_kind = nk_NullLit;
  }
  NullLit::NullLit(const NullLit & other) {
+	m_kind = nk_NullLit;
  }
  NullLit &NullLit::operator=(const NullLit & other) { NullLit tmp(other); swap(tmp); return *this; }
  void NullLit::swap(NullLit & other) {
  }
- NullLit::~NullLit() {
-  }
  void NullLit::visit_children( Visitor* v ) {
   }
  void NullLit::accept(Visitor *v) { v->visitNullLit(this); }
@@ -1323,20 +1034,16 @@ extern int yylineno;
 /********* Deref ************/
  Deref::Deref(Expr *p1)  {
 	m_expr = p1;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_expr->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_Deref;
+ }
  Deref::Deref(const Deref & other) {
+	m_kind = nk_Deref;
 	m_expr = other.m_expr->clone();
  }
  Deref &Deref::operator=(const Deref & other) { Deref tmp(other); swap(tmp); return *this; }
  void Deref::swap(Deref & other) {
 	std::swap(m_expr, other.m_expr);
  }
- Deref::~Deref() {
- 	delete(m_expr);
-  }
  void Deref::visit_children( Visitor* v ) {
  	m_expr->accept( v );
   }
@@ -1345,64 +1052,54 @@ extern int yylineno;
  
  
 /********* Variable ************/
- Variable::Variable(SymName *p1)  {
+ Variable::Variable(const SymName &p1)  {
 	m_symname = p1;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_symname->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_Variable;
+ }
  Variable::Variable(const Variable & other) {
-	m_symname = other.m_symname->clone();
+	m_kind = nk_Variable;
+	m_symname = other.m_symname;
  }
  Variable &Variable::operator=(const Variable & other) { Variable tmp(other); swap(tmp); return *this; }
  void Variable::swap(Variable & other) {
 	std::swap(m_symname, other.m_symname);
  }
- Variable::~Variable() {
- 	delete(m_symname);
-  }
  void Variable::visit_children( Visitor* v ) {
- 	m_symname->accept( v );
+ 	m_symname.accept( v );
   }
  void Variable::accept(Visitor *v) { v->visitVariable(this); }
  Variable *Variable::clone() const { return new Variable(*this); }
  
  
 /********* DerefVariable ************/
- DerefVariable::DerefVariable(SymName *p1)  {
+ DerefVariable::DerefVariable(const SymName &p1)  {
 	m_symname = p1;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_symname->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_DerefVariable;
+ }
  DerefVariable::DerefVariable(const DerefVariable & other) {
-	m_symname = other.m_symname->clone();
+	m_kind = nk_DerefVariable;
+	m_symname = other.m_symname;
  }
  DerefVariable &DerefVariable::operator=(const DerefVariable & other) { DerefVariable tmp(other); swap(tmp); return *this; }
  void DerefVariable::swap(DerefVariable & other) {
 	std::swap(m_symname, other.m_symname);
  }
- DerefVariable::~DerefVariable() {
- 	delete(m_symname);
-  }
  void DerefVariable::visit_children( Visitor* v ) {
- 	m_symname->accept( v );
+ 	m_symname.accept( v );
   }
  void DerefVariable::accept(Visitor *v) { v->visitDerefVariable(this); }
  DerefVariable *DerefVariable::clone() const { return new DerefVariable(*this); }
  
  
 /********* ArrayElement ************/
- ArrayElement::ArrayElement(SymName *p1, Expr *p2)  {
+ ArrayElement::ArrayElement(const SymName &p1, Expr *p2)  {
 	m_symname = p1;
 	m_expr = p2;
-	m_attribute.lineno = yylineno;
-	m_parent_attribute = NULL;
-	m_symname->m_parent_attribute = &m_attribute;
- 	m_expr->m_parent_attribute = &m_attribute;
-  }
+	m_kind = nk_ArrayElement;
+ }
  ArrayElement::ArrayElement(const ArrayElement & other) {
-	m_symname = other.m_symname->clone();
+	m_kind = nk_ArrayElement;
+	m_symname = other.m_symname;
 	m_expr = other.m_expr->clone();
  }
  ArrayElement &ArrayElement::operator=(const ArrayElement & other) { ArrayElement tmp(other); swap(tmp); return *this; }
@@ -1410,12 +1107,8 @@ extern int yylineno;
 	std::swap(m_symname, other.m_symname);
 	std::swap(m_expr, other.m_expr);
  }
- ArrayElement::~ArrayElement() {
- 	delete(m_symname);
- 	delete(m_expr);
-  }
  void ArrayElement::visit_children( Visitor* v ) {
- 	m_symname->accept( v );
+ 	m_symname.accept( v );
  	m_expr->accept( v );
   }
  void ArrayElement::accept(Visitor *v) { v->visitArrayElement(this); }
@@ -1423,3 +1116,3546 @@ extern int yylineno;
  
  
 
+/********* AST cache ************/
+
+const char ast_layout[] =
+  "Program ==> *Proc\n"
+  "Proc ==> SymName *Decl Type Procedure_block\n"
+  "Procedure_block ==> *Proc *Decl *Stat Return_stat\n"
+  "Nested_block ==> *Decl *Stat\n"
+  "Decl ==> *SymName Type\n"
+  "Stat:Assignment ==> Lhs Expr\n"
+  "Stat:StringAssignment ==> Lhs StringPrimitive\n"
+  "Stat:Call ==> Lhs SymName *Expr\n"
+  "Stat:IfNoElse ==> Expr Nested_block\n"
+  "Stat:IfWithElse ==> Expr Nested_block Nested_block\n"
+  "Stat:WhileLoop ==> Expr Nested_block\n"
+  "Stat:CodeBlock ==> Nested_block\n"
+  "Return_stat:Return ==> Expr\n"
+  "Type:TInteger ==>\n"
+  "Type:TCharacter ==>\n"
+  "Type:TBoolean ==>\n"
+  "Type:TCharPtr ==>\n"
+  "Type:TIntPtr ==>\n"
+  "Type:TString ==> Primitive\n"
+  "Expr:AbsoluteValue ==> Expr\n"
+  "Expr:AddressOf ==> Lhs\n"
+  "Expr:And ==> Expr Expr\n"
+  "Expr:Div ==> Expr Expr\n"
+  "Expr:Compare ==> Expr Expr\n"
+  "Expr:Gt ==> Expr Expr\n"
+  "Expr:Gteq ==> Expr Expr\n"
+  "Expr:Lt ==> Expr Expr\n"
+  "Expr:Lteq ==> Expr Expr\n"
+  "Expr:Minus ==> Expr Expr\n"
+  "Expr:Noteq ==> Expr Expr\n"
+  "Expr:Or ==> Expr Expr\n"
+  "Expr:Plus ==> Expr Expr\n"
+  "Expr:Times ==> Expr Expr\n"
+  "Expr:Not ==> Expr\n"
+  "Expr:Uminus ==> Expr\n"
+  "Expr:Ident ==> SymName\n"
+  "Expr:ArrayAccess ==> SymName Expr\n"
+  "Expr:IntLit ==> Primitive\n"
+  "Expr:CharLit ==> Primitive\n"
+  "Expr:BoolLit ==> Primitive\n"
+  "Expr:NullLit ==>\n"
+  "Expr:Deref ==> Expr\n"
+  "Lhs:Variable ==> SymName\n"
+  "Lhs:DerefVariable ==> SymName\n"
+  "Lhs:ArrayElement ==> SymName Expr\n"
+  ;
+
+unsigned ast_write(AstWriter *w, Visitable *p)
+{
+  std::vector<AstFrame> &stack = w->frames();
+  size_t bottom = stack.size();
+  stack.push_back(AstFrame(p));
+  while(stack.size() > bottom) {
+    p = stack.back().m_node;
+    unsigned i = stack.back().m_next++;
+    switch(p->kind()) {
+      case nk_ProgramImpl: {
+        ProgramImpl *q = static_cast<ProgramImpl *>(p);
+        if(i < q->m_proc_list->size()) {
+          w->child((*q->m_proc_list)[i]);
+          continue;
+        }
+        if(i == q->m_proc_list->size()) {
+          w->close(q->m_proc_list);
+        }
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_ProgramImpl, q->m_attribute.lineno, 1);
+        w->field(at + 1, q->m_proc_list, c1);
+        w->push(at);
+        break;
+      }
+      case nk_ProcImpl: {
+        ProcImpl *q = static_cast<ProcImpl *>(p);
+        if(i == 0) {
+          w->child(&q->m_symname);
+        }
+        if(i < q->m_decl_list->size()) {
+          w->child((*q->m_decl_list)[i]);
+          continue;
+        }
+        if(i == q->m_decl_list->size()) {
+          w->close(q->m_decl_list);
+        }
+        i -= q->m_decl_list->size();
+        if(i == 0) {
+          w->child(q->m_type);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          w->child(q->m_procedure_block);
+          continue;
+        }
+        unsigned c4 = w->pop();
+        unsigned c3 = w->pop();
+        unsigned c2 = w->pop();
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_ProcImpl, q->m_attribute.lineno, 4);
+        w->field(at + 1, &q->m_symname, c1);
+        w->field(at + 2, q->m_decl_list, c2);
+        w->field(at + 3, q->m_type, c3);
+        w->field(at + 4, q->m_procedure_block, c4);
+        w->push(at);
+        break;
+      }
+      case nk_Procedure_blockImpl: {
+        Procedure_blockImpl *q = static_cast<Procedure_blockImpl *>(p);
+        if(i < q->m_proc_list->size()) {
+          w->child((*q->m_proc_list)[i]);
+          continue;
+        }
+        if(i == q->m_proc_list->size()) {
+          w->close(q->m_proc_list);
+        }
+        i -= q->m_proc_list->size();
+        if(i < q->m_decl_list->size()) {
+          w->child((*q->m_decl_list)[i]);
+          continue;
+        }
+        if(i == q->m_decl_list->size()) {
+          w->close(q->m_decl_list);
+        }
+        i -= q->m_decl_list->size();
+        if(i < q->m_stat_list->size()) {
+          w->child((*q->m_stat_list)[i]);
+          continue;
+        }
+        if(i == q->m_stat_list->size()) {
+          w->close(q->m_stat_list);
+        }
+        i -= q->m_stat_list->size();
+        if(i == 0) {
+          w->child(q->m_return_stat);
+          continue;
+        }
+        unsigned c4 = w->pop();
+        unsigned c3 = w->pop();
+        unsigned c2 = w->pop();
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_Procedure_blockImpl, q->m_attribute.lineno, 4);
+        w->field(at + 1, q->m_proc_list, c1);
+        w->field(at + 2, q->m_decl_list, c2);
+        w->field(at + 3, q->m_stat_list, c3);
+        w->field(at + 4, q->m_return_stat, c4);
+        w->push(at);
+        break;
+      }
+      case nk_Nested_blockImpl: {
+        Nested_blockImpl *q = static_cast<Nested_blockImpl *>(p);
+        if(i < q->m_decl_list->size()) {
+          w->child((*q->m_decl_list)[i]);
+          continue;
+        }
+        if(i == q->m_decl_list->size()) {
+          w->close(q->m_decl_list);
+        }
+        i -= q->m_decl_list->size();
+        if(i < q->m_stat_list->size()) {
+          w->child((*q->m_stat_list)[i]);
+          continue;
+        }
+        if(i == q->m_stat_list->size()) {
+          w->close(q->m_stat_list);
+        }
+        unsigned c2 = w->pop();
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_Nested_blockImpl, q->m_attribute.lineno, 2);
+        w->field(at + 1, q->m_decl_list, c1);
+        w->field(at + 2, q->m_stat_list, c2);
+        w->push(at);
+        break;
+      }
+      case nk_DeclImpl: {
+        DeclImpl *q = static_cast<DeclImpl *>(p);
+        if(i == 0) {
+          for(size_t k = 0; k < q->m_symname_list->size(); ++k) {
+            w->child((*q->m_symname_list)[k]);
+          }
+          w->close(q->m_symname_list);
+        }
+        if(i == 0) {
+          w->child(q->m_type);
+          continue;
+        }
+        unsigned c2 = w->pop();
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_DeclImpl, q->m_attribute.lineno, 2);
+        w->field(at + 1, q->m_symname_list, c1);
+        w->field(at + 2, q->m_type, c2);
+        w->push(at);
+        break;
+      }
+      case nk_Assignment: {
+        Assignment *q = static_cast<Assignment *>(p);
+        if(i == 0) {
+          w->child(q->m_lhs);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          w->child(q->m_expr);
+          continue;
+        }
+        unsigned c2 = w->pop();
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_Assignment, q->m_attribute.lineno, 2);
+        w->field(at + 1, q->m_lhs, c1);
+        w->field(at + 2, q->m_expr, c2);
+        w->push(at);
+        break;
+      }
+      case nk_StringAssignment: {
+        StringAssignment *q = static_cast<StringAssignment *>(p);
+        if(i == 0) {
+          w->child(q->m_lhs);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          w->child(q->m_stringprimitive);
+        }
+        unsigned c2 = w->pop();
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_StringAssignment, q->m_attribute.lineno, 2);
+        w->field(at + 1, q->m_lhs, c1);
+        w->field(at + 2, q->m_stringprimitive, c2);
+        w->push(at);
+        break;
+      }
+      case nk_Call: {
+        Call *q = static_cast<Call *>(p);
+        if(i == 0) {
+          w->child(q->m_lhs);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          w->child(&q->m_symname);
+        }
+        if(i < q->m_expr_list->size()) {
+          w->child((*q->m_expr_list)[i]);
+          continue;
+        }
+        if(i == q->m_expr_list->size()) {
+          w->close(q->m_expr_list);
+        }
+        unsigned c3 = w->pop();
+        unsigned c2 = w->pop();
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_Call, q->m_attribute.lineno, 3);
+        w->field(at + 1, q->m_lhs, c1);
+        w->field(at + 2, &q->m_symname, c2);
+        w->field(at + 3, q->m_expr_list, c3);
+        w->push(at);
+        break;
+      }
+      case nk_IfNoElse: {
+        IfNoElse *q = static_cast<IfNoElse *>(p);
+        if(i == 0) {
+          w->child(q->m_expr);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          w->child(q->m_nested_block);
+          continue;
+        }
+        unsigned c2 = w->pop();
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_IfNoElse, q->m_attribute.lineno, 2);
+        w->field(at + 1, q->m_expr, c1);
+        w->field(at + 2, q->m_nested_block, c2);
+        w->push(at);
+        break;
+      }
+      case nk_IfWithElse: {
+        IfWithElse *q = static_cast<IfWithElse *>(p);
+        if(i == 0) {
+          w->child(q->m_expr);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          w->child(q->m_nested_block_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          w->child(q->m_nested_block_2);
+          continue;
+        }
+        unsigned c3 = w->pop();
+        unsigned c2 = w->pop();
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_IfWithElse, q->m_attribute.lineno, 3);
+        w->field(at + 1, q->m_expr, c1);
+        w->field(at + 2, q->m_nested_block_1, c2);
+        w->field(at + 3, q->m_nested_block_2, c3);
+        w->push(at);
+        break;
+      }
+      case nk_WhileLoop: {
+        WhileLoop *q = static_cast<WhileLoop *>(p);
+        if(i == 0) {
+          w->child(q->m_expr);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          w->child(q->m_nested_block);
+          continue;
+        }
+        unsigned c2 = w->pop();
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_WhileLoop, q->m_attribute.lineno, 2);
+        w->field(at + 1, q->m_expr, c1);
+        w->field(at + 2, q->m_nested_block, c2);
+        w->push(at);
+        break;
+      }
+      case nk_CodeBlock: {
+        CodeBlock *q = static_cast<CodeBlock *>(p);
+        if(i == 0) {
+          w->child(q->m_nested_block);
+          continue;
+        }
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_CodeBlock, q->m_attribute.lineno, 1);
+        w->field(at + 1, q->m_nested_block, c1);
+        w->push(at);
+        break;
+      }
+      case nk_Return: {
+        Return *q = static_cast<Return *>(p);
+        if(i == 0) {
+          w->child(q->m_expr);
+          continue;
+        }
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_Return, q->m_attribute.lineno, 1);
+        w->field(at + 1, q->m_expr, c1);
+        w->push(at);
+        break;
+      }
+      case nk_TInteger: {
+        TInteger *q = static_cast<TInteger *>(p);
+        unsigned at = w->node(nk_TInteger, q->m_attribute.lineno, 0);
+        w->push(at);
+        break;
+      }
+      case nk_TCharacter: {
+        TCharacter *q = static_cast<TCharacter *>(p);
+        unsigned at = w->node(nk_TCharacter, q->m_attribute.lineno, 0);
+        w->push(at);
+        break;
+      }
+      case nk_TBoolean: {
+        TBoolean *q = static_cast<TBoolean *>(p);
+        unsigned at = w->node(nk_TBoolean, q->m_attribute.lineno, 0);
+        w->push(at);
+        break;
+      }
+      case nk_TCharPtr: {
+        TCharPtr *q = static_cast<TCharPtr *>(p);
+        unsigned at = w->node(nk_TCharPtr, q->m_attribute.lineno, 0);
+        w->push(at);
+        break;
+      }
+      case nk_TIntPtr: {
+        TIntPtr *q = static_cast<TIntPtr *>(p);
+        unsigned at = w->node(nk_TIntPtr, q->m_attribute.lineno, 0);
+        w->push(at);
+        break;
+      }
+      case nk_TString: {
+        TString *q = static_cast<TString *>(p);
+        if(i == 0) {
+          w->child(&q->m_primitive);
+        }
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_TString, q->m_attribute.lineno, 1);
+        w->field(at + 1, &q->m_primitive, c1);
+        w->push(at);
+        break;
+      }
+      case nk_AbsoluteValue: {
+        AbsoluteValue *q = static_cast<AbsoluteValue *>(p);
+        if(i == 0) {
+          w->child(q->m_expr);
+          continue;
+        }
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_AbsoluteValue, q->m_attribute.lineno, 1);
+        w->field(at + 1, q->m_expr, c1);
+        w->push(at);
+        break;
+      }
+      case nk_AddressOf: {
+        AddressOf *q = static_cast<AddressOf *>(p);
+        if(i == 0) {
+          w->child(q->m_lhs);
+          continue;
+        }
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_AddressOf, q->m_attribute.lineno, 1);
+        w->field(at + 1, q->m_lhs, c1);
+        w->push(at);
+        break;
+      }
+      case nk_And: {
+        And *q = static_cast<And *>(p);
+        if(i == 0) {
+          w->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          w->child(q->m_expr_2);
+          continue;
+        }
+        unsigned c2 = w->pop();
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_And, q->m_attribute.lineno, 2);
+        w->field(at + 1, q->m_expr_1, c1);
+        w->field(at + 2, q->m_expr_2, c2);
+        w->push(at);
+        break;
+      }
+      case nk_Div: {
+        Div *q = static_cast<Div *>(p);
+        if(i == 0) {
+          w->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          w->child(q->m_expr_2);
+          continue;
+        }
+        unsigned c2 = w->pop();
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_Div, q->m_attribute.lineno, 2);
+        w->field(at + 1, q->m_expr_1, c1);
+        w->field(at + 2, q->m_expr_2, c2);
+        w->push(at);
+        break;
+      }
+      case nk_Compare: {
+        Compare *q = static_cast<Compare *>(p);
+        if(i == 0) {
+          w->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          w->child(q->m_expr_2);
+          continue;
+        }
+        unsigned c2 = w->pop();
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_Compare, q->m_attribute.lineno, 2);
+        w->field(at + 1, q->m_expr_1, c1);
+        w->field(at + 2, q->m_expr_2, c2);
+        w->push(at);
+        break;
+      }
+      case nk_Gt: {
+        Gt *q = static_cast<Gt *>(p);
+        if(i == 0) {
+          w->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          w->child(q->m_expr_2);
+          continue;
+        }
+        unsigned c2 = w->pop();
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_Gt, q->m_attribute.lineno, 2);
+        w->field(at + 1, q->m_expr_1, c1);
+        w->field(at + 2, q->m_expr_2, c2);
+        w->push(at);
+        break;
+      }
+      case nk_Gteq: {
+        Gteq *q = static_cast<Gteq *>(p);
+        if(i == 0) {
+          w->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          w->child(q->m_expr_2);
+          continue;
+        }
+        unsigned c2 = w->pop();
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_Gteq, q->m_attribute.lineno, 2);
+        w->field(at + 1, q->m_expr_1, c1);
+        w->field(at + 2, q->m_expr_2, c2);
+        w->push(at);
+        break;
+      }
+      case nk_Lt: {
+        Lt *q = static_cast<Lt *>(p);
+        if(i == 0) {
+          w->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          w->child(q->m_expr_2);
+          continue;
+        }
+        unsigned c2 = w->pop();
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_Lt, q->m_attribute.lineno, 2);
+        w->field(at + 1, q->m_expr_1, c1);
+        w->field(at + 2, q->m_expr_2, c2);
+        w->push(at);
+        break;
+      }
+      case nk_Lteq: {
+        Lteq *q = static_cast<Lteq *>(p);
+        if(i == 0) {
+          w->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          w->child(q->m_expr_2);
+          continue;
+        }
+        unsigned c2 = w->pop();
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_Lteq, q->m_attribute.lineno, 2);
+        w->field(at + 1, q->m_expr_1, c1);
+        w->field(at + 2, q->m_expr_2, c2);
+        w->push(at);
+        break;
+      }
+      case nk_Minus: {
+        Minus *q = static_cast<Minus *>(p);
+        if(i == 0) {
+          w->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          w->child(q->m_expr_2);
+          continue;
+        }
+        unsigned c2 = w->pop();
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_Minus, q->m_attribute.lineno, 2);
+        w->field(at + 1, q->m_expr_1, c1);
+        w->field(at + 2, q->m_expr_2, c2);
+        w->push(at);
+        break;
+      }
+      case nk_Noteq: {
+        Noteq *q = static_cast<Noteq *>(p);
+        if(i == 0) {
+          w->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          w->child(q->m_expr_2);
+          continue;
+        }
+        unsigned c2 = w->pop();
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_Noteq, q->m_attribute.lineno, 2);
+        w->field(at + 1, q->m_expr_1, c1);
+        w->field(at + 2, q->m_expr_2, c2);
+        w->push(at);
+        break;
+      }
+      case nk_Or: {
+        Or *q = static_cast<Or *>(p);
+        if(i == 0) {
+          w->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          w->child(q->m_expr_2);
+          continue;
+        }
+        unsigned c2 = w->pop();
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_Or, q->m_attribute.lineno, 2);
+        w->field(at + 1, q->m_expr_1, c1);
+        w->field(at + 2, q->m_expr_2, c2);
+        w->push(at);
+        break;
+      }
+      case nk_Plus: {
+        Plus *q = static_cast<Plus *>(p);
+        if(i == 0) {
+          w->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          w->child(q->m_expr_2);
+          continue;
+        }
+        unsigned c2 = w->pop();
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_Plus, q->m_attribute.lineno, 2);
+        w->field(at + 1, q->m_expr_1, c1);
+        w->field(at + 2, q->m_expr_2, c2);
+        w->push(at);
+        break;
+      }
+      case nk_Times: {
+        Times *q = static_cast<Times *>(p);
+        if(i == 0) {
+          w->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          w->child(q->m_expr_2);
+          continue;
+        }
+        unsigned c2 = w->pop();
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_Times, q->m_attribute.lineno, 2);
+        w->field(at + 1, q->m_expr_1, c1);
+        w->field(at + 2, q->m_expr_2, c2);
+        w->push(at);
+        break;
+      }
+      case nk_Not: {
+        Not *q = static_cast<Not *>(p);
+        if(i == 0) {
+          w->child(q->m_expr);
+          continue;
+        }
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_Not, q->m_attribute.lineno, 1);
+        w->field(at + 1, q->m_expr, c1);
+        w->push(at);
+        break;
+      }
+      case nk_Uminus: {
+        Uminus *q = static_cast<Uminus *>(p);
+        if(i == 0) {
+          w->child(q->m_expr);
+          continue;
+        }
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_Uminus, q->m_attribute.lineno, 1);
+        w->field(at + 1, q->m_expr, c1);
+        w->push(at);
+        break;
+      }
+      case nk_Ident: {
+        Ident *q = static_cast<Ident *>(p);
+        if(i == 0) {
+          w->child(&q->m_symname);
+        }
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_Ident, q->m_attribute.lineno, 1);
+        w->field(at + 1, &q->m_symname, c1);
+        w->push(at);
+        break;
+      }
+      case nk_ArrayAccess: {
+        ArrayAccess *q = static_cast<ArrayAccess *>(p);
+        if(i == 0) {
+          w->child(&q->m_symname);
+        }
+        if(i == 0) {
+          w->child(q->m_expr);
+          continue;
+        }
+        unsigned c2 = w->pop();
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_ArrayAccess, q->m_attribute.lineno, 2);
+        w->field(at + 1, &q->m_symname, c1);
+        w->field(at + 2, q->m_expr, c2);
+        w->push(at);
+        break;
+      }
+      case nk_IntLit: {
+        IntLit *q = static_cast<IntLit *>(p);
+        if(i == 0) {
+          w->child(&q->m_primitive);
+        }
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_IntLit, q->m_attribute.lineno, 1);
+        w->field(at + 1, &q->m_primitive, c1);
+        w->push(at);
+        break;
+      }
+      case nk_CharLit: {
+        CharLit *q = static_cast<CharLit *>(p);
+        if(i == 0) {
+          w->child(&q->m_primitive);
+        }
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_CharLit, q->m_attribute.lineno, 1);
+        w->field(at + 1, &q->m_primitive, c1);
+        w->push(at);
+        break;
+      }
+      case nk_BoolLit: {
+        BoolLit *q = static_cast<BoolLit *>(p);
+        if(i == 0) {
+          w->child(&q->m_primitive);
+        }
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_BoolLit, q->m_attribute.lineno, 1);
+        w->field(at + 1, &q->m_primitive, c1);
+        w->push(at);
+        break;
+      }
+      case nk_NullLit: {
+        NullLit *q = static_cast<NullLit *>(p);
+        unsigned at = w->node(nk_NullLit, q->m_attribute.lineno, 0);
+        w->push(at);
+        break;
+      }
+      case nk_Deref: {
+        Deref *q = static_cast<Deref *>(p);
+        if(i == 0) {
+          w->child(q->m_expr);
+          continue;
+        }
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_Deref, q->m_attribute.lineno, 1);
+        w->field(at + 1, q->m_expr, c1);
+        w->push(at);
+        break;
+      }
+      case nk_Variable: {
+        Variable *q = static_cast<Variable *>(p);
+        if(i == 0) {
+          w->child(&q->m_symname);
+        }
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_Variable, q->m_attribute.lineno, 1);
+        w->field(at + 1, &q->m_symname, c1);
+        w->push(at);
+        break;
+      }
+      case nk_DerefVariable: {
+        DerefVariable *q = static_cast<DerefVariable *>(p);
+        if(i == 0) {
+          w->child(&q->m_symname);
+        }
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_DerefVariable, q->m_attribute.lineno, 1);
+        w->field(at + 1, &q->m_symname, c1);
+        w->push(at);
+        break;
+      }
+      case nk_ArrayElement: {
+        ArrayElement *q = static_cast<ArrayElement *>(p);
+        if(i == 0) {
+          w->child(&q->m_symname);
+        }
+        if(i == 0) {
+          w->child(q->m_expr);
+          continue;
+        }
+        unsigned c2 = w->pop();
+        unsigned c1 = w->pop();
+        unsigned at = w->node(nk_ArrayElement, q->m_attribute.lineno, 2);
+        w->field(at + 1, &q->m_symname, c1);
+        w->field(at + 2, q->m_expr, c2);
+        w->push(at);
+        break;
+      }
+      case nk_count:
+        break;
+    }
+    stack.pop_back();
+  }
+  return w->pop();
+}
+
+Visitable *ast_read(AstReader *r, unsigned at)
+{
+  std::vector<AstReader::Frame> &stack = r->frames();
+  size_t bottom = stack.size();
+  stack.push_back(AstReader::Frame(at));
+  while(stack.size() > bottom) {
+    at = stack.back().m_at;
+    unsigned i = stack.back().m_next++;
+    switch(r->kind(at)) {
+      case nk_ProgramImpl: {
+        if(i < r->items(at + 1)) {
+          r->child(at + 1, i);
+          continue;
+        }
+        Proc_list *c1;
+        r->field(at + 1, &c1);
+        ProgramImpl *q = new ProgramImpl(c1);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_ProcImpl: {
+        if(i < r->items(at + 2)) {
+          r->child(at + 2, i);
+          continue;
+        }
+        i -= r->items(at + 2);
+        if(i == 0) {
+          r->child(at + 3);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          r->child(at + 4);
+          continue;
+        }
+        Procedure_block *c4;
+        r->field(at + 4, &c4);
+        Type *c3;
+        r->field(at + 3, &c3);
+        Decl_list *c2;
+        r->field(at + 2, &c2);
+        SymName c1;
+        r->field(at + 1, &c1);
+        ProcImpl *q = new ProcImpl(c1, c2, c3, c4);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_Procedure_blockImpl: {
+        if(i < r->items(at + 1)) {
+          r->child(at + 1, i);
+          continue;
+        }
+        i -= r->items(at + 1);
+        if(i < r->items(at + 2)) {
+          r->child(at + 2, i);
+          continue;
+        }
+        i -= r->items(at + 2);
+        if(i < r->items(at + 3)) {
+          r->child(at + 3, i);
+          continue;
+        }
+        i -= r->items(at + 3);
+        if(i == 0) {
+          r->child(at + 4);
+          continue;
+        }
+        Return_stat *c4;
+        r->field(at + 4, &c4);
+        Stat_list *c3;
+        r->field(at + 3, &c3);
+        Decl_list *c2;
+        r->field(at + 2, &c2);
+        Proc_list *c1;
+        r->field(at + 1, &c1);
+        Procedure_blockImpl *q = new Procedure_blockImpl(c1, c2, c3, c4);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_Nested_blockImpl: {
+        if(i < r->items(at + 1)) {
+          r->child(at + 1, i);
+          continue;
+        }
+        i -= r->items(at + 1);
+        if(i < r->items(at + 2)) {
+          r->child(at + 2, i);
+          continue;
+        }
+        Stat_list *c2;
+        r->field(at + 2, &c2);
+        Decl_list *c1;
+        r->field(at + 1, &c1);
+        Nested_blockImpl *q = new Nested_blockImpl(c1, c2);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_DeclImpl: {
+        if(i == 0) {
+          r->child(at + 2);
+          continue;
+        }
+        Type *c2;
+        r->field(at + 2, &c2);
+        SymName_list *c1;
+        r->field(at + 1, &c1);
+        DeclImpl *q = new DeclImpl(c1, c2);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_Assignment: {
+        if(i == 0) {
+          r->child(at + 1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          r->child(at + 2);
+          continue;
+        }
+        Expr *c2;
+        r->field(at + 2, &c2);
+        Lhs *c1;
+        r->field(at + 1, &c1);
+        Assignment *q = new Assignment(c1, c2);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_StringAssignment: {
+        if(i == 0) {
+          r->child(at + 1);
+          continue;
+        }
+        StringPrimitive *c2;
+        r->field(at + 2, &c2);
+        Lhs *c1;
+        r->field(at + 1, &c1);
+        StringAssignment *q = new StringAssignment(c1, c2);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_Call: {
+        if(i == 0) {
+          r->child(at + 1);
+          continue;
+        }
+        --i;
+        if(i < r->items(at + 3)) {
+          r->child(at + 3, i);
+          continue;
+        }
+        Expr_list *c3;
+        r->field(at + 3, &c3);
+        SymName c2;
+        r->field(at + 2, &c2);
+        Lhs *c1;
+        r->field(at + 1, &c1);
+        Call *q = new Call(c1, c2, c3);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_IfNoElse: {
+        if(i == 0) {
+          r->child(at + 1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          r->child(at + 2);
+          continue;
+        }
+        Nested_block *c2;
+        r->field(at + 2, &c2);
+        Expr *c1;
+        r->field(at + 1, &c1);
+        IfNoElse *q = new IfNoElse(c1, c2);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_IfWithElse: {
+        if(i == 0) {
+          r->child(at + 1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          r->child(at + 2);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          r->child(at + 3);
+          continue;
+        }
+        Nested_block *c3;
+        r->field(at + 3, &c3);
+        Nested_block *c2;
+        r->field(at + 2, &c2);
+        Expr *c1;
+        r->field(at + 1, &c1);
+        IfWithElse *q = new IfWithElse(c1, c2, c3);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_WhileLoop: {
+        if(i == 0) {
+          r->child(at + 1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          r->child(at + 2);
+          continue;
+        }
+        Nested_block *c2;
+        r->field(at + 2, &c2);
+        Expr *c1;
+        r->field(at + 1, &c1);
+        WhileLoop *q = new WhileLoop(c1, c2);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_CodeBlock: {
+        if(i == 0) {
+          r->child(at + 1);
+          continue;
+        }
+        Nested_block *c1;
+        r->field(at + 1, &c1);
+        CodeBlock *q = new CodeBlock(c1);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_Return: {
+        if(i == 0) {
+          r->child(at + 1);
+          continue;
+        }
+        Expr *c1;
+        r->field(at + 1, &c1);
+        Return *q = new Return(c1);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_TInteger: {
+        TInteger *q = new TInteger();
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_TCharacter: {
+        TCharacter *q = new TCharacter();
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_TBoolean: {
+        TBoolean *q = new TBoolean();
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_TCharPtr: {
+        TCharPtr *q = new TCharPtr();
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_TIntPtr: {
+        TIntPtr *q = new TIntPtr();
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_TString: {
+        Primitive c1;
+        r->field(at + 1, &c1);
+        TString *q = new TString(c1);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_AbsoluteValue: {
+        if(i == 0) {
+          r->child(at + 1);
+          continue;
+        }
+        Expr *c1;
+        r->field(at + 1, &c1);
+        AbsoluteValue *q = new AbsoluteValue(c1);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_AddressOf: {
+        if(i == 0) {
+          r->child(at + 1);
+          continue;
+        }
+        Lhs *c1;
+        r->field(at + 1, &c1);
+        AddressOf *q = new AddressOf(c1);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_And: {
+        if(i == 0) {
+          r->child(at + 1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          r->child(at + 2);
+          continue;
+        }
+        Expr *c2;
+        r->field(at + 2, &c2);
+        Expr *c1;
+        r->field(at + 1, &c1);
+        And *q = new And(c1, c2);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_Div: {
+        if(i == 0) {
+          r->child(at + 1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          r->child(at + 2);
+          continue;
+        }
+        Expr *c2;
+        r->field(at + 2, &c2);
+        Expr *c1;
+        r->field(at + 1, &c1);
+        Div *q = new Div(c1, c2);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_Compare: {
+        if(i == 0) {
+          r->child(at + 1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          r->child(at + 2);
+          continue;
+        }
+        Expr *c2;
+        r->field(at + 2, &c2);
+        Expr *c1;
+        r->field(at + 1, &c1);
+        Compare *q = new Compare(c1, c2);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_Gt: {
+        if(i == 0) {
+          r->child(at + 1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          r->child(at + 2);
+          continue;
+        }
+        Expr *c2;
+        r->field(at + 2, &c2);
+        Expr *c1;
+        r->field(at + 1, &c1);
+        Gt *q = new Gt(c1, c2);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_Gteq: {
+        if(i == 0) {
+          r->child(at + 1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          r->child(at + 2);
+          continue;
+        }
+        Expr *c2;
+        r->field(at + 2, &c2);
+        Expr *c1;
+        r->field(at + 1, &c1);
+        Gteq *q = new Gteq(c1, c2);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_Lt: {
+        if(i == 0) {
+          r->child(at + 1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          r->child(at + 2);
+          continue;
+        }
+        Expr *c2;
+        r->field(at + 2, &c2);
+        Expr *c1;
+        r->field(at + 1, &c1);
+        Lt *q = new Lt(c1, c2);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_Lteq: {
+        if(i == 0) {
+          r->child(at + 1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          r->child(at + 2);
+          continue;
+        }
+        Expr *c2;
+        r->field(at + 2, &c2);
+        Expr *c1;
+        r->field(at + 1, &c1);
+        Lteq *q = new Lteq(c1, c2);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_Minus: {
+        if(i == 0) {
+          r->child(at + 1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          r->child(at + 2);
+          continue;
+        }
+        Expr *c2;
+        r->field(at + 2, &c2);
+        Expr *c1;
+        r->field(at + 1, &c1);
+        Minus *q = new Minus(c1, c2);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_Noteq: {
+        if(i == 0) {
+          r->child(at + 1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          r->child(at + 2);
+          continue;
+        }
+        Expr *c2;
+        r->field(at + 2, &c2);
+        Expr *c1;
+        r->field(at + 1, &c1);
+        Noteq *q = new Noteq(c1, c2);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_Or: {
+        if(i == 0) {
+          r->child(at + 1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          r->child(at + 2);
+          continue;
+        }
+        Expr *c2;
+        r->field(at + 2, &c2);
+        Expr *c1;
+        r->field(at + 1, &c1);
+        Or *q = new Or(c1, c2);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_Plus: {
+        if(i == 0) {
+          r->child(at + 1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          r->child(at + 2);
+          continue;
+        }
+        Expr *c2;
+        r->field(at + 2, &c2);
+        Expr *c1;
+        r->field(at + 1, &c1);
+        Plus *q = new Plus(c1, c2);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_Times: {
+        if(i == 0) {
+          r->child(at + 1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          r->child(at + 2);
+          continue;
+        }
+        Expr *c2;
+        r->field(at + 2, &c2);
+        Expr *c1;
+        r->field(at + 1, &c1);
+        Times *q = new Times(c1, c2);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_Not: {
+        if(i == 0) {
+          r->child(at + 1);
+          continue;
+        }
+        Expr *c1;
+        r->field(at + 1, &c1);
+        Not *q = new Not(c1);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_Uminus: {
+        if(i == 0) {
+          r->child(at + 1);
+          continue;
+        }
+        Expr *c1;
+        r->field(at + 1, &c1);
+        Uminus *q = new Uminus(c1);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_Ident: {
+        SymName c1;
+        r->field(at + 1, &c1);
+        Ident *q = new Ident(c1);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_ArrayAccess: {
+        if(i == 0) {
+          r->child(at + 2);
+          continue;
+        }
+        Expr *c2;
+        r->field(at + 2, &c2);
+        SymName c1;
+        r->field(at + 1, &c1);
+        ArrayAccess *q = new ArrayAccess(c1, c2);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_IntLit: {
+        Primitive c1;
+        r->field(at + 1, &c1);
+        IntLit *q = new IntLit(c1);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_CharLit: {
+        Primitive c1;
+        r->field(at + 1, &c1);
+        CharLit *q = new CharLit(c1);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_BoolLit: {
+        Primitive c1;
+        r->field(at + 1, &c1);
+        BoolLit *q = new BoolLit(c1);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_NullLit: {
+        NullLit *q = new NullLit();
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_Deref: {
+        if(i == 0) {
+          r->child(at + 1);
+          continue;
+        }
+        Expr *c1;
+        r->field(at + 1, &c1);
+        Deref *q = new Deref(c1);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_Variable: {
+        SymName c1;
+        r->field(at + 1, &c1);
+        Variable *q = new Variable(c1);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_DerefVariable: {
+        SymName c1;
+        r->field(at + 1, &c1);
+        DerefVariable *q = new DerefVariable(c1);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_ArrayElement: {
+        if(i == 0) {
+          r->child(at + 2);
+          continue;
+        }
+        Expr *c2;
+        r->field(at + 2, &c2);
+        SymName c1;
+        r->field(at + 1, &c1);
+        ArrayElement *q = new ArrayElement(c1, c2);
+        q->m_attribute.lineno = r->lineno(at);
+        r->push(q);
+        break;
+      }
+      case nk_count:
+        stack.erase(stack.begin() + bottom, stack.end());
+        return NULL;
+    }
+    stack.pop_back();
+  }
+  return r->pop();
+}
+
+/********* Structural hashing ************/
+
+size_t ast_hash(AstHash *h, Visitable *p)
+{
+  std::vector<AstFrame> &stack = h->frames();
+  size_t bottom = stack.size();
+  stack.push_back(AstFrame(p));
+  while(stack.size() > bottom) {
+    p = stack.back().m_node;
+    unsigned i = stack.back().m_next++;
+    switch(p->kind()) {
+      case nk_ProgramImpl: {
+        ProgramImpl *q = static_cast<ProgramImpl *>(p);
+        if(i < q->m_proc_list->size()) {
+          h->child((*q->m_proc_list)[i]);
+          continue;
+        }
+        if(i == q->m_proc_list->size()) {
+          h->close(q->m_proc_list);
+        }
+        h->node(nk_ProgramImpl, 1);
+        break;
+      }
+      case nk_ProcImpl: {
+        ProcImpl *q = static_cast<ProcImpl *>(p);
+        if(i == 0) {
+          h->child(&q->m_symname);
+        }
+        if(i < q->m_decl_list->size()) {
+          h->child((*q->m_decl_list)[i]);
+          continue;
+        }
+        if(i == q->m_decl_list->size()) {
+          h->close(q->m_decl_list);
+        }
+        i -= q->m_decl_list->size();
+        if(i == 0) {
+          h->child(q->m_type);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          h->child(q->m_procedure_block);
+          continue;
+        }
+        h->node(nk_ProcImpl, 4);
+        break;
+      }
+      case nk_Procedure_blockImpl: {
+        Procedure_blockImpl *q = static_cast<Procedure_blockImpl *>(p);
+        if(i < q->m_proc_list->size()) {
+          h->child((*q->m_proc_list)[i]);
+          continue;
+        }
+        if(i == q->m_proc_list->size()) {
+          h->close(q->m_proc_list);
+        }
+        i -= q->m_proc_list->size();
+        if(i < q->m_decl_list->size()) {
+          h->child((*q->m_decl_list)[i]);
+          continue;
+        }
+        if(i == q->m_decl_list->size()) {
+          h->close(q->m_decl_list);
+        }
+        i -= q->m_decl_list->size();
+        if(i < q->m_stat_list->size()) {
+          h->child((*q->m_stat_list)[i]);
+          continue;
+        }
+        if(i == q->m_stat_list->size()) {
+          h->close(q->m_stat_list);
+        }
+        i -= q->m_stat_list->size();
+        if(i == 0) {
+          h->child(q->m_return_stat);
+          continue;
+        }
+        h->node(nk_Procedure_blockImpl, 4);
+        break;
+      }
+      case nk_Nested_blockImpl: {
+        Nested_blockImpl *q = static_cast<Nested_blockImpl *>(p);
+        if(i < q->m_decl_list->size()) {
+          h->child((*q->m_decl_list)[i]);
+          continue;
+        }
+        if(i == q->m_decl_list->size()) {
+          h->close(q->m_decl_list);
+        }
+        i -= q->m_decl_list->size();
+        if(i < q->m_stat_list->size()) {
+          h->child((*q->m_stat_list)[i]);
+          continue;
+        }
+        if(i == q->m_stat_list->size()) {
+          h->close(q->m_stat_list);
+        }
+        h->node(nk_Nested_blockImpl, 2);
+        break;
+      }
+      case nk_DeclImpl: {
+        DeclImpl *q = static_cast<DeclImpl *>(p);
+        if(i == 0) {
+          for(size_t k = 0; k < q->m_symname_list->size(); ++k) {
+            h->child((*q->m_symname_list)[k]);
+          }
+          h->close(q->m_symname_list);
+        }
+        if(i == 0) {
+          h->child(q->m_type);
+          continue;
+        }
+        h->node(nk_DeclImpl, 2);
+        break;
+      }
+      case nk_Assignment: {
+        Assignment *q = static_cast<Assignment *>(p);
+        if(i == 0) {
+          h->child(q->m_lhs);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          h->child(q->m_expr);
+          continue;
+        }
+        h->node(nk_Assignment, 2);
+        break;
+      }
+      case nk_StringAssignment: {
+        StringAssignment *q = static_cast<StringAssignment *>(p);
+        if(i == 0) {
+          h->child(q->m_lhs);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          h->child(q->m_stringprimitive);
+        }
+        h->node(nk_StringAssignment, 2);
+        break;
+      }
+      case nk_Call: {
+        Call *q = static_cast<Call *>(p);
+        if(i == 0) {
+          h->child(q->m_lhs);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          h->child(&q->m_symname);
+        }
+        if(i < q->m_expr_list->size()) {
+          h->child((*q->m_expr_list)[i]);
+          continue;
+        }
+        if(i == q->m_expr_list->size()) {
+          h->close(q->m_expr_list);
+        }
+        h->node(nk_Call, 3);
+        break;
+      }
+      case nk_IfNoElse: {
+        IfNoElse *q = static_cast<IfNoElse *>(p);
+        if(i == 0) {
+          h->child(q->m_expr);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          h->child(q->m_nested_block);
+          continue;
+        }
+        h->node(nk_IfNoElse, 2);
+        break;
+      }
+      case nk_IfWithElse: {
+        IfWithElse *q = static_cast<IfWithElse *>(p);
+        if(i == 0) {
+          h->child(q->m_expr);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          h->child(q->m_nested_block_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          h->child(q->m_nested_block_2);
+          continue;
+        }
+        h->node(nk_IfWithElse, 3);
+        break;
+      }
+      case nk_WhileLoop: {
+        WhileLoop *q = static_cast<WhileLoop *>(p);
+        if(i == 0) {
+          h->child(q->m_expr);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          h->child(q->m_nested_block);
+          continue;
+        }
+        h->node(nk_WhileLoop, 2);
+        break;
+      }
+      case nk_CodeBlock: {
+        CodeBlock *q = static_cast<CodeBlock *>(p);
+        if(i == 0) {
+          h->child(q->m_nested_block);
+          continue;
+        }
+        h->node(nk_CodeBlock, 1);
+        break;
+      }
+      case nk_Return: {
+        Return *q = static_cast<Return *>(p);
+        if(i == 0) {
+          h->child(q->m_expr);
+          continue;
+        }
+        h->node(nk_Return, 1);
+        break;
+      }
+      case nk_TInteger: {
+        h->node(nk_TInteger, 0);
+        break;
+      }
+      case nk_TCharacter: {
+        h->node(nk_TCharacter, 0);
+        break;
+      }
+      case nk_TBoolean: {
+        h->node(nk_TBoolean, 0);
+        break;
+      }
+      case nk_TCharPtr: {
+        h->node(nk_TCharPtr, 0);
+        break;
+      }
+      case nk_TIntPtr: {
+        h->node(nk_TIntPtr, 0);
+        break;
+      }
+      case nk_TString: {
+        TString *q = static_cast<TString *>(p);
+        if(i == 0) {
+          h->child(&q->m_primitive);
+        }
+        h->node(nk_TString, 1);
+        break;
+      }
+      case nk_AbsoluteValue: {
+        AbsoluteValue *q = static_cast<AbsoluteValue *>(p);
+        if(i == 0) {
+          h->child(q->m_expr);
+          continue;
+        }
+        h->node(nk_AbsoluteValue, 1);
+        break;
+      }
+      case nk_AddressOf: {
+        AddressOf *q = static_cast<AddressOf *>(p);
+        if(i == 0) {
+          h->child(q->m_lhs);
+          continue;
+        }
+        h->node(nk_AddressOf, 1);
+        break;
+      }
+      case nk_And: {
+        And *q = static_cast<And *>(p);
+        if(i == 0) {
+          h->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          h->child(q->m_expr_2);
+          continue;
+        }
+        h->node(nk_And, 2);
+        break;
+      }
+      case nk_Div: {
+        Div *q = static_cast<Div *>(p);
+        if(i == 0) {
+          h->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          h->child(q->m_expr_2);
+          continue;
+        }
+        h->node(nk_Div, 2);
+        break;
+      }
+      case nk_Compare: {
+        Compare *q = static_cast<Compare *>(p);
+        if(i == 0) {
+          h->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          h->child(q->m_expr_2);
+          continue;
+        }
+        h->node(nk_Compare, 2);
+        break;
+      }
+      case nk_Gt: {
+        Gt *q = static_cast<Gt *>(p);
+        if(i == 0) {
+          h->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          h->child(q->m_expr_2);
+          continue;
+        }
+        h->node(nk_Gt, 2);
+        break;
+      }
+      case nk_Gteq: {
+        Gteq *q = static_cast<Gteq *>(p);
+        if(i == 0) {
+          h->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          h->child(q->m_expr_2);
+          continue;
+        }
+        h->node(nk_Gteq, 2);
+        break;
+      }
+      case nk_Lt: {
+        Lt *q = static_cast<Lt *>(p);
+        if(i == 0) {
+          h->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          h->child(q->m_expr_2);
+          continue;
+        }
+        h->node(nk_Lt, 2);
+        break;
+      }
+      case nk_Lteq: {
+        Lteq *q = static_cast<Lteq *>(p);
+        if(i == 0) {
+          h->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          h->child(q->m_expr_2);
+          continue;
+        }
+        h->node(nk_Lteq, 2);
+        break;
+      }
+      case nk_Minus: {
+        Minus *q = static_cast<Minus *>(p);
+        if(i == 0) {
+          h->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          h->child(q->m_expr_2);
+          continue;
+        }
+        h->node(nk_Minus, 2);
+        break;
+      }
+      case nk_Noteq: {
+        Noteq *q = static_cast<Noteq *>(p);
+        if(i == 0) {
+          h->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          h->child(q->m_expr_2);
+          continue;
+        }
+        h->node(nk_Noteq, 2);
+        break;
+      }
+      case nk_Or: {
+        Or *q = static_cast<Or *>(p);
+        if(i == 0) {
+          h->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          h->child(q->m_expr_2);
+          continue;
+        }
+        h->node(nk_Or, 2);
+        break;
+      }
+      case nk_Plus: {
+        Plus *q = static_cast<Plus *>(p);
+        if(i == 0) {
+          h->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          h->child(q->m_expr_2);
+          continue;
+        }
+        h->node(nk_Plus, 2);
+        break;
+      }
+      case nk_Times: {
+        Times *q = static_cast<Times *>(p);
+        if(i == 0) {
+          h->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          h->child(q->m_expr_2);
+          continue;
+        }
+        h->node(nk_Times, 2);
+        break;
+      }
+      case nk_Not: {
+        Not *q = static_cast<Not *>(p);
+        if(i == 0) {
+          h->child(q->m_expr);
+          continue;
+        }
+        h->node(nk_Not, 1);
+        break;
+      }
+      case nk_Uminus: {
+        Uminus *q = static_cast<Uminus *>(p);
+        if(i == 0) {
+          h->child(q->m_expr);
+          continue;
+        }
+        h->node(nk_Uminus, 1);
+        break;
+      }
+      case nk_Ident: {
+        Ident *q = static_cast<Ident *>(p);
+        if(i == 0) {
+          h->child(&q->m_symname);
+        }
+        h->node(nk_Ident, 1);
+        break;
+      }
+      case nk_ArrayAccess: {
+        ArrayAccess *q = static_cast<ArrayAccess *>(p);
+        if(i == 0) {
+          h->child(&q->m_symname);
+        }
+        if(i == 0) {
+          h->child(q->m_expr);
+          continue;
+        }
+        h->node(nk_ArrayAccess, 2);
+        break;
+      }
+      case nk_IntLit: {
+        IntLit *q = static_cast<IntLit *>(p);
+        if(i == 0) {
+          h->child(&q->m_primitive);
+        }
+        h->node(nk_IntLit, 1);
+        break;
+      }
+      case nk_CharLit: {
+        CharLit *q = static_cast<CharLit *>(p);
+        if(i == 0) {
+          h->child(&q->m_primitive);
+        }
+        h->node(nk_CharLit, 1);
+        break;
+      }
+      case nk_BoolLit: {
+        BoolLit *q = static_cast<BoolLit *>(p);
+        if(i == 0) {
+          h->child(&q->m_primitive);
+        }
+        h->node(nk_BoolLit, 1);
+        break;
+      }
+      case nk_NullLit: {
+        h->node(nk_NullLit, 0);
+        break;
+      }
+      case nk_Deref: {
+        Deref *q = static_cast<Deref *>(p);
+        if(i == 0) {
+          h->child(q->m_expr);
+          continue;
+        }
+        h->node(nk_Deref, 1);
+        break;
+      }
+      case nk_Variable: {
+        Variable *q = static_cast<Variable *>(p);
+        if(i == 0) {
+          h->child(&q->m_symname);
+        }
+        h->node(nk_Variable, 1);
+        break;
+      }
+      case nk_DerefVariable: {
+        DerefVariable *q = static_cast<DerefVariable *>(p);
+        if(i == 0) {
+          h->child(&q->m_symname);
+        }
+        h->node(nk_DerefVariable, 1);
+        break;
+      }
+      case nk_ArrayElement: {
+        ArrayElement *q = static_cast<ArrayElement *>(p);
+        if(i == 0) {
+          h->child(&q->m_symname);
+        }
+        if(i == 0) {
+          h->child(q->m_expr);
+          continue;
+        }
+        h->node(nk_ArrayElement, 2);
+        break;
+      }
+      case nk_count:
+        break;
+    }
+    stack.pop_back();
+  }
+  return h->pop();
+}
+
+// a and b themselves: the children that are nodes are left on e's stack
+static bool ast_equal_node(AstEqual *e, Visitable *a, Visitable *b)
+{
+  if(a->kind() != b->kind()) {
+    return false;
+  }
+  switch(a->kind()) {
+    case nk_ProgramImpl: {
+      ProgramImpl *q = static_cast<ProgramImpl *>(a);
+      ProgramImpl *r = static_cast<ProgramImpl *>(b);
+      return e->child(q->m_proc_list, r->m_proc_list);
+    }
+    case nk_ProcImpl: {
+      ProcImpl *q = static_cast<ProcImpl *>(a);
+      ProcImpl *r = static_cast<ProcImpl *>(b);
+      return e->child(&q->m_symname, &r->m_symname)
+        && e->child(q->m_decl_list, r->m_decl_list)
+        && e->child(q->m_type, r->m_type)
+        && e->child(q->m_procedure_block, r->m_procedure_block);
+    }
+    case nk_Procedure_blockImpl: {
+      Procedure_blockImpl *q = static_cast<Procedure_blockImpl *>(a);
+      Procedure_blockImpl *r = static_cast<Procedure_blockImpl *>(b);
+      return e->child(q->m_proc_list, r->m_proc_list)
+        && e->child(q->m_decl_list, r->m_decl_list)
+        && e->child(q->m_stat_list, r->m_stat_list)
+        && e->child(q->m_return_stat, r->m_return_stat);
+    }
+    case nk_Nested_blockImpl: {
+      Nested_blockImpl *q = static_cast<Nested_blockImpl *>(a);
+      Nested_blockImpl *r = static_cast<Nested_blockImpl *>(b);
+      return e->child(q->m_decl_list, r->m_decl_list)
+        && e->child(q->m_stat_list, r->m_stat_list);
+    }
+    case nk_DeclImpl: {
+      DeclImpl *q = static_cast<DeclImpl *>(a);
+      DeclImpl *r = static_cast<DeclImpl *>(b);
+      return e->child(q->m_symname_list, r->m_symname_list)
+        && e->child(q->m_type, r->m_type);
+    }
+    case nk_Assignment: {
+      Assignment *q = static_cast<Assignment *>(a);
+      Assignment *r = static_cast<Assignment *>(b);
+      return e->child(q->m_lhs, r->m_lhs)
+        && e->child(q->m_expr, r->m_expr);
+    }
+    case nk_StringAssignment: {
+      StringAssignment *q = static_cast<StringAssignment *>(a);
+      StringAssignment *r = static_cast<StringAssignment *>(b);
+      return e->child(q->m_lhs, r->m_lhs)
+        && e->child(q->m_stringprimitive, r->m_stringprimitive);
+    }
+    case nk_Call: {
+      Call *q = static_cast<Call *>(a);
+      Call *r = static_cast<Call *>(b);
+      return e->child(q->m_lhs, r->m_lhs)
+        && e->child(&q->m_symname, &r->m_symname)
+        && e->child(q->m_expr_list, r->m_expr_list);
+    }
+    case nk_IfNoElse: {
+      IfNoElse *q = static_cast<IfNoElse *>(a);
+      IfNoElse *r = static_cast<IfNoElse *>(b);
+      return e->child(q->m_expr, r->m_expr)
+        && e->child(q->m_nested_block, r->m_nested_block);
+    }
+    case nk_IfWithElse: {
+      IfWithElse *q = static_cast<IfWithElse *>(a);
+      IfWithElse *r = static_cast<IfWithElse *>(b);
+      return e->child(q->m_expr, r->m_expr)
+        && e->child(q->m_nested_block_1, r->m_nested_block_1)
+        && e->child(q->m_nested_block_2, r->m_nested_block_2);
+    }
+    case nk_WhileLoop: {
+      WhileLoop *q = static_cast<WhileLoop *>(a);
+      WhileLoop *r = static_cast<WhileLoop *>(b);
+      return e->child(q->m_expr, r->m_expr)
+        && e->child(q->m_nested_block, r->m_nested_block);
+    }
+    case nk_CodeBlock: {
+      CodeBlock *q = static_cast<CodeBlock *>(a);
+      CodeBlock *r = static_cast<CodeBlock *>(b);
+      return e->child(q->m_nested_block, r->m_nested_block);
+    }
+    case nk_Return: {
+      Return *q = static_cast<Return *>(a);
+      Return *r = static_cast<Return *>(b);
+      return e->child(q->m_expr, r->m_expr);
+    }
+    case nk_TInteger: {
+      return true;
+    }
+    case nk_TCharacter: {
+      return true;
+    }
+    case nk_TBoolean: {
+      return true;
+    }
+    case nk_TCharPtr: {
+      return true;
+    }
+    case nk_TIntPtr: {
+      return true;
+    }
+    case nk_TString: {
+      TString *q = static_cast<TString *>(a);
+      TString *r = static_cast<TString *>(b);
+      return e->child(&q->m_primitive, &r->m_primitive);
+    }
+    case nk_AbsoluteValue: {
+      AbsoluteValue *q = static_cast<AbsoluteValue *>(a);
+      AbsoluteValue *r = static_cast<AbsoluteValue *>(b);
+      return e->child(q->m_expr, r->m_expr);
+    }
+    case nk_AddressOf: {
+      AddressOf *q = static_cast<AddressOf *>(a);
+      AddressOf *r = static_cast<AddressOf *>(b);
+      return e->child(q->m_lhs, r->m_lhs);
+    }
+    case nk_And: {
+      And *q = static_cast<And *>(a);
+      And *r = static_cast<And *>(b);
+      return e->child(q->m_expr_1, r->m_expr_1)
+        && e->child(q->m_expr_2, r->m_expr_2);
+    }
+    case nk_Div: {
+      Div *q = static_cast<Div *>(a);
+      Div *r = static_cast<Div *>(b);
+      return e->child(q->m_expr_1, r->m_expr_1)
+        && e->child(q->m_expr_2, r->m_expr_2);
+    }
+    case nk_Compare: {
+      Compare *q = static_cast<Compare *>(a);
+      Compare *r = static_cast<Compare *>(b);
+      return e->child(q->m_expr_1, r->m_expr_1)
+        && e->child(q->m_expr_2, r->m_expr_2);
+    }
+    case nk_Gt: {
+      Gt *q = static_cast<Gt *>(a);
+      Gt *r = static_cast<Gt *>(b);
+      return e->child(q->m_expr_1, r->m_expr_1)
+        && e->child(q->m_expr_2, r->m_expr_2);
+    }
+    case nk_Gteq: {
+      Gteq *q = static_cast<Gteq *>(a);
+      Gteq *r = static_cast<Gteq *>(b);
+      return e->child(q->m_expr_1, r->m_expr_1)
+        && e->child(q->m_expr_2, r->m_expr_2);
+    }
+    case nk_Lt: {
+      Lt *q = static_cast<Lt *>(a);
+      Lt *r = static_cast<Lt *>(b);
+      return e->child(q->m_expr_1, r->m_expr_1)
+        && e->child(q->m_expr_2, r->m_expr_2);
+    }
+    case nk_Lteq: {
+      Lteq *q = static_cast<Lteq *>(a);
+      Lteq *r = static_cast<Lteq *>(b);
+      return e->child(q->m_expr_1, r->m_expr_1)
+        && e->child(q->m_expr_2, r->m_expr_2);
+    }
+    case nk_Minus: {
+      Minus *q = static_cast<Minus *>(a);
+      Minus *r = static_cast<Minus *>(b);
+      return e->child(q->m_expr_1, r->m_expr_1)
+        && e->child(q->m_expr_2, r->m_expr_2);
+    }
+    case nk_Noteq: {
+      Noteq *q = static_cast<Noteq *>(a);
+      Noteq *r = static_cast<Noteq *>(b);
+      return e->child(q->m_expr_1, r->m_expr_1)
+        && e->child(q->m_expr_2, r->m_expr_2);
+    }
+    case nk_Or: {
+      Or *q = static_cast<Or *>(a);
+      Or *r = static_cast<Or *>(b);
+      return e->child(q->m_expr_1, r->m_expr_1)
+        && e->child(q->m_expr_2, r->m_expr_2);
+    }
+    case nk_Plus: {
+      Plus *q = static_cast<Plus *>(a);
+      Plus *r = static_cast<Plus *>(b);
+      return e->child(q->m_expr_1, r->m_expr_1)
+        && e->child(q->m_expr_2, r->m_expr_2);
+    }
+    case nk_Times: {
+      Times *q = static_cast<Times *>(a);
+      Times *r = static_cast<Times *>(b);
+      return e->child(q->m_expr_1, r->m_expr_1)
+        && e->child(q->m_expr_2, r->m_expr_2);
+    }
+    case nk_Not: {
+      Not *q = static_cast<Not *>(a);
+      Not *r = static_cast<Not *>(b);
+      return e->child(q->m_expr, r->m_expr);
+    }
+    case nk_Uminus: {
+      Uminus *q = static_cast<Uminus *>(a);
+      Uminus *r = static_cast<Uminus *>(b);
+      return e->child(q->m_expr, r->m_expr);
+    }
+    case nk_Ident: {
+      Ident *q = static_cast<Ident *>(a);
+      Ident *r = static_cast<Ident *>(b);
+      return e->child(&q->m_symname, &r->m_symname);
+    }
+    case nk_ArrayAccess: {
+      ArrayAccess *q = static_cast<ArrayAccess *>(a);
+      ArrayAccess *r = static_cast<ArrayAccess *>(b);
+      return e->child(&q->m_symname, &r->m_symname)
+        && e->child(q->m_expr, r->m_expr);
+    }
+    case nk_IntLit: {
+      IntLit *q = static_cast<IntLit *>(a);
+      IntLit *r = static_cast<IntLit *>(b);
+      return e->child(&q->m_primitive, &r->m_primitive);
+    }
+    case nk_CharLit: {
+      CharLit *q = static_cast<CharLit *>(a);
+      CharLit *r = static_cast<CharLit *>(b);
+      return e->child(&q->m_primitive, &r->m_primitive);
+    }
+    case nk_BoolLit: {
+      BoolLit *q = static_cast<BoolLit *>(a);
+      BoolLit *r = static_cast<BoolLit *>(b);
+      return e->child(&q->m_primitive, &r->m_primitive);
+    }
+    case nk_NullLit: {
+      return true;
+    }
+    case nk_Deref: {
+      Deref *q = static_cast<Deref *>(a);
+      Deref *r = static_cast<Deref *>(b);
+      return e->child(q->m_expr, r->m_expr);
+    }
+    case nk_Variable: {
+      Variable *q = static_cast<Variable *>(a);
+      Variable *r = static_cast<Variable *>(b);
+      return e->child(&q->m_symname, &r->m_symname);
+    }
+    case nk_DerefVariable: {
+      DerefVariable *q = static_cast<DerefVariable *>(a);
+      DerefVariable *r = static_cast<DerefVariable *>(b);
+      return e->child(&q->m_symname, &r->m_symname);
+    }
+    case nk_ArrayElement: {
+      ArrayElement *q = static_cast<ArrayElement *>(a);
+      ArrayElement *r = static_cast<ArrayElement *>(b);
+      return e->child(&q->m_symname, &r->m_symname)
+        && e->child(q->m_expr, r->m_expr);
+    }
+    case nk_count:
+      break;
+  }
+  assert(false);
+  return false;
+}
+
+bool ast_equal(AstEqual *e, Visitable *a, Visitable *b)
+{
+  std::vector<AstEqual::Pair> &stack = e->pairs();
+  size_t bottom = stack.size();
+  while(ast_equal_node(e, a, b)) {
+    if(stack.size() == bottom) {
+      return true;
+    }
+    a = stack.back().first;
+    b = stack.back().second;
+    stack.pop_back();
+  }
+  stack.resize(bottom);
+  return false;
+}
+
+void ast_release(ExprPool *pool, Visitable *p)
+{
+  switch(p->kind()) {
+    case nk_ProgramImpl: {
+      ProgramImpl *q = static_cast<ProgramImpl *>(p);
+      Proc_list *c1 = q->m_proc_list;
+      pool->give_back(q, sizeof(ProgramImpl));
+      pool->release(c1);
+      return;
+    }
+    case nk_ProcImpl: {
+      ProcImpl *q = static_cast<ProcImpl *>(p);
+      Decl_list *c2 = q->m_decl_list;
+      Type *c3 = q->m_type;
+      Procedure_block *c4 = q->m_procedure_block;
+      pool->give_back(q, sizeof(ProcImpl));
+      pool->release(c2);
+      pool->release(c3);
+      pool->release(c4);
+      return;
+    }
+    case nk_Procedure_blockImpl: {
+      Procedure_blockImpl *q = static_cast<Procedure_blockImpl *>(p);
+      Proc_list *c1 = q->m_proc_list;
+      Decl_list *c2 = q->m_decl_list;
+      Stat_list *c3 = q->m_stat_list;
+      Return_stat *c4 = q->m_return_stat;
+      pool->give_back(q, sizeof(Procedure_blockImpl));
+      pool->release(c1);
+      pool->release(c2);
+      pool->release(c3);
+      pool->release(c4);
+      return;
+    }
+    case nk_Nested_blockImpl: {
+      Nested_blockImpl *q = static_cast<Nested_blockImpl *>(p);
+      Decl_list *c1 = q->m_decl_list;
+      Stat_list *c2 = q->m_stat_list;
+      pool->give_back(q, sizeof(Nested_blockImpl));
+      pool->release(c1);
+      pool->release(c2);
+      return;
+    }
+    case nk_DeclImpl: {
+      DeclImpl *q = static_cast<DeclImpl *>(p);
+      SymName_list *c1 = q->m_symname_list;
+      Type *c2 = q->m_type;
+      pool->give_back(q, sizeof(DeclImpl));
+      pool->release(c1);
+      pool->release(c2);
+      return;
+    }
+    case nk_Assignment: {
+      Assignment *q = static_cast<Assignment *>(p);
+      Lhs *c1 = q->m_lhs;
+      Expr *c2 = q->m_expr;
+      pool->give_back(q, sizeof(Assignment));
+      pool->release(c1);
+      pool->release(c2);
+      return;
+    }
+    case nk_StringAssignment: {
+      StringAssignment *q = static_cast<StringAssignment *>(p);
+      Lhs *c1 = q->m_lhs;
+      StringPrimitive *c2 = q->m_stringprimitive;
+      pool->give_back(q, sizeof(StringAssignment));
+      pool->release(c1);
+      pool->release(c2);
+      return;
+    }
+    case nk_Call: {
+      Call *q = static_cast<Call *>(p);
+      Lhs *c1 = q->m_lhs;
+      Expr_list *c3 = q->m_expr_list;
+      pool->give_back(q, sizeof(Call));
+      pool->release(c1);
+      pool->release(c3);
+      return;
+    }
+    case nk_IfNoElse: {
+      IfNoElse *q = static_cast<IfNoElse *>(p);
+      Expr *c1 = q->m_expr;
+      Nested_block *c2 = q->m_nested_block;
+      pool->give_back(q, sizeof(IfNoElse));
+      pool->release(c1);
+      pool->release(c2);
+      return;
+    }
+    case nk_IfWithElse: {
+      IfWithElse *q = static_cast<IfWithElse *>(p);
+      Expr *c1 = q->m_expr;
+      Nested_block *c2 = q->m_nested_block_1;
+      Nested_block *c3 = q->m_nested_block_2;
+      pool->give_back(q, sizeof(IfWithElse));
+      pool->release(c1);
+      pool->release(c2);
+      pool->release(c3);
+      return;
+    }
+    case nk_WhileLoop: {
+      WhileLoop *q = static_cast<WhileLoop *>(p);
+      Expr *c1 = q->m_expr;
+      Nested_block *c2 = q->m_nested_block;
+      pool->give_back(q, sizeof(WhileLoop));
+      pool->release(c1);
+      pool->release(c2);
+      return;
+    }
+    case nk_CodeBlock: {
+      CodeBlock *q = static_cast<CodeBlock *>(p);
+      Nested_block *c1 = q->m_nested_block;
+      pool->give_back(q, sizeof(CodeBlock));
+      pool->release(c1);
+      return;
+    }
+    case nk_Return: {
+      Return *q = static_cast<Return *>(p);
+      Expr *c1 = q->m_expr;
+      pool->give_back(q, sizeof(Return));
+      pool->release(c1);
+      return;
+    }
+    case nk_TInteger: {
+      TInteger *q = static_cast<TInteger *>(p);
+      pool->give_back(q, sizeof(TInteger));
+      return;
+    }
+    case nk_TCharacter: {
+      TCharacter *q = static_cast<TCharacter *>(p);
+      pool->give_back(q, sizeof(TCharacter));
+      return;
+    }
+    case nk_TBoolean: {
+      TBoolean *q = static_cast<TBoolean *>(p);
+      pool->give_back(q, sizeof(TBoolean));
+      return;
+    }
+    case nk_TCharPtr: {
+      TCharPtr *q = static_cast<TCharPtr *>(p);
+      pool->give_back(q, sizeof(TCharPtr));
+      return;
+    }
+    case nk_TIntPtr: {
+      TIntPtr *q = static_cast<TIntPtr *>(p);
+      pool->give_back(q, sizeof(TIntPtr));
+      return;
+    }
+    case nk_TString: {
+      TString *q = static_cast<TString *>(p);
+      pool->give_back(q, sizeof(TString));
+      return;
+    }
+    case nk_AbsoluteValue: {
+      AbsoluteValue *q = static_cast<AbsoluteValue *>(p);
+      Expr *c1 = q->m_expr;
+      pool->give_back(q, sizeof(AbsoluteValue));
+      pool->release(c1);
+      return;
+    }
+    case nk_AddressOf: {
+      AddressOf *q = static_cast<AddressOf *>(p);
+      Lhs *c1 = q->m_lhs;
+      pool->give_back(q, sizeof(AddressOf));
+      pool->release(c1);
+      return;
+    }
+    case nk_And: {
+      And *q = static_cast<And *>(p);
+      Expr *c1 = q->m_expr_1;
+      Expr *c2 = q->m_expr_2;
+      pool->give_back(q, sizeof(And));
+      pool->release(c1);
+      pool->release(c2);
+      return;
+    }
+    case nk_Div: {
+      Div *q = static_cast<Div *>(p);
+      Expr *c1 = q->m_expr_1;
+      Expr *c2 = q->m_expr_2;
+      pool->give_back(q, sizeof(Div));
+      pool->release(c1);
+      pool->release(c2);
+      return;
+    }
+    case nk_Compare: {
+      Compare *q = static_cast<Compare *>(p);
+      Expr *c1 = q->m_expr_1;
+      Expr *c2 = q->m_expr_2;
+      pool->give_back(q, sizeof(Compare));
+      pool->release(c1);
+      pool->release(c2);
+      return;
+    }
+    case nk_Gt: {
+      Gt *q = static_cast<Gt *>(p);
+      Expr *c1 = q->m_expr_1;
+      Expr *c2 = q->m_expr_2;
+      pool->give_back(q, sizeof(Gt));
+      pool->release(c1);
+      pool->release(c2);
+      return;
+    }
+    case nk_Gteq: {
+      Gteq *q = static_cast<Gteq *>(p);
+      Expr *c1 = q->m_expr_1;
+      Expr *c2 = q->m_expr_2;
+      pool->give_back(q, sizeof(Gteq));
+      pool->release(c1);
+      pool->release(c2);
+      return;
+    }
+    case nk_Lt: {
+      Lt *q = static_cast<Lt *>(p);
+      Expr *c1 = q->m_expr_1;
+      Expr *c2 = q->m_expr_2;
+      pool->give_back(q, sizeof(Lt));
+      pool->release(c1);
+      pool->release(c2);
+      return;
+    }
+    case nk_Lteq: {
+      Lteq *q = static_cast<Lteq *>(p);
+      Expr *c1 = q->m_expr_1;
+      Expr *c2 = q->m_expr_2;
+      pool->give_back(q, sizeof(Lteq));
+      pool->release(c1);
+      pool->release(c2);
+      return;
+    }
+    case nk_Minus: {
+      Minus *q = static_cast<Minus *>(p);
+      Expr *c1 = q->m_expr_1;
+      Expr *c2 = q->m_expr_2;
+      pool->give_back(q, sizeof(Minus));
+      pool->release(c1);
+      pool->release(c2);
+      return;
+    }
+    case nk_Noteq: {
+      Noteq *q = static_cast<Noteq *>(p);
+      Expr *c1 = q->m_expr_1;
+      Expr *c2 = q->m_expr_2;
+      pool->give_back(q, sizeof(Noteq));
+      pool->release(c1);
+      pool->release(c2);
+      return;
+    }
+    case nk_Or: {
+      Or *q = static_cast<Or *>(p);
+      Expr *c1 = q->m_expr_1;
+      Expr *c2 = q->m_expr_2;
+      pool->give_back(q, sizeof(Or));
+      pool->release(c1);
+      pool->release(c2);
+      return;
+    }
+    case nk_Plus: {
+      Plus *q = static_cast<Plus *>(p);
+      Expr *c1 = q->m_expr_1;
+      Expr *c2 = q->m_expr_2;
+      pool->give_back(q, sizeof(Plus));
+      pool->release(c1);
+      pool->release(c2);
+      return;
+    }
+    case nk_Times: {
+      Times *q = static_cast<Times *>(p);
+      Expr *c1 = q->m_expr_1;
+      Expr *c2 = q->m_expr_2;
+      pool->give_back(q, sizeof(Times));
+      pool->release(c1);
+      pool->release(c2);
+      return;
+    }
+    case nk_Not: {
+      Not *q = static_cast<Not *>(p);
+      Expr *c1 = q->m_expr;
+      pool->give_back(q, sizeof(Not));
+      pool->release(c1);
+      return;
+    }
+    case nk_Uminus: {
+      Uminus *q = static_cast<Uminus *>(p);
+      Expr *c1 = q->m_expr;
+      pool->give_back(q, sizeof(Uminus));
+      pool->release(c1);
+      return;
+    }
+    case nk_Ident: {
+      Ident *q = static_cast<Ident *>(p);
+      pool->give_back(q, sizeof(Ident));
+      return;
+    }
+    case nk_ArrayAccess: {
+      ArrayAccess *q = static_cast<ArrayAccess *>(p);
+      Expr *c2 = q->m_expr;
+      pool->give_back(q, sizeof(ArrayAccess));
+      pool->release(c2);
+      return;
+    }
+    case nk_IntLit: {
+      IntLit *q = static_cast<IntLit *>(p);
+      pool->give_back(q, sizeof(IntLit));
+      return;
+    }
+    case nk_CharLit: {
+      CharLit *q = static_cast<CharLit *>(p);
+      pool->give_back(q, sizeof(CharLit));
+      return;
+    }
+    case nk_BoolLit: {
+      BoolLit *q = static_cast<BoolLit *>(p);
+      pool->give_back(q, sizeof(BoolLit));
+      return;
+    }
+    case nk_NullLit: {
+      NullLit *q = static_cast<NullLit *>(p);
+      pool->give_back(q, sizeof(NullLit));
+      return;
+    }
+    case nk_Deref: {
+      Deref *q = static_cast<Deref *>(p);
+      Expr *c1 = q->m_expr;
+      pool->give_back(q, sizeof(Deref));
+      pool->release(c1);
+      return;
+    }
+    case nk_Variable: {
+      Variable *q = static_cast<Variable *>(p);
+      pool->give_back(q, sizeof(Variable));
+      return;
+    }
+    case nk_DerefVariable: {
+      DerefVariable *q = static_cast<DerefVariable *>(p);
+      pool->give_back(q, sizeof(DerefVariable));
+      return;
+    }
+    case nk_ArrayElement: {
+      ArrayElement *q = static_cast<ArrayElement *>(p);
+      Expr *c2 = q->m_expr;
+      pool->give_back(q, sizeof(ArrayElement));
+      pool->release(c2);
+      return;
+    }
+    case nk_count:
+      break;
+  }
+  assert(false);
+}
+
+Visitable *ast_remake(Visitable *p)
+{
+  switch(p->kind()) {
+    case nk_ProgramImpl: {
+      ProgramImpl *q = static_cast<ProgramImpl *>(p);
+      return new ProgramImpl(q->m_proc_list);
+    }
+    case nk_ProcImpl: {
+      ProcImpl *q = static_cast<ProcImpl *>(p);
+      return new ProcImpl(q->m_symname, q->m_decl_list, q->m_type, q->m_procedure_block);
+    }
+    case nk_Procedure_blockImpl: {
+      Procedure_blockImpl *q = static_cast<Procedure_blockImpl *>(p);
+      return new Procedure_blockImpl(q->m_proc_list, q->m_decl_list, q->m_stat_list, q->m_return_stat);
+    }
+    case nk_Nested_blockImpl: {
+      Nested_blockImpl *q = static_cast<Nested_blockImpl *>(p);
+      return new Nested_blockImpl(q->m_decl_list, q->m_stat_list);
+    }
+    case nk_DeclImpl: {
+      DeclImpl *q = static_cast<DeclImpl *>(p);
+      return new DeclImpl(q->m_symname_list, q->m_type);
+    }
+    case nk_Assignment: {
+      Assignment *q = static_cast<Assignment *>(p);
+      return new Assignment(q->m_lhs, q->m_expr);
+    }
+    case nk_StringAssignment: {
+      StringAssignment *q = static_cast<StringAssignment *>(p);
+      return new StringAssignment(q->m_lhs, q->m_stringprimitive);
+    }
+    case nk_Call: {
+      Call *q = static_cast<Call *>(p);
+      return new Call(q->m_lhs, q->m_symname, q->m_expr_list);
+    }
+    case nk_IfNoElse: {
+      IfNoElse *q = static_cast<IfNoElse *>(p);
+      return new IfNoElse(q->m_expr, q->m_nested_block);
+    }
+    case nk_IfWithElse: {
+      IfWithElse *q = static_cast<IfWithElse *>(p);
+      return new IfWithElse(q->m_expr, q->m_nested_block_1, q->m_nested_block_2);
+    }
+    case nk_WhileLoop: {
+      WhileLoop *q = static_cast<WhileLoop *>(p);
+      return new WhileLoop(q->m_expr, q->m_nested_block);
+    }
+    case nk_CodeBlock: {
+      CodeBlock *q = static_cast<CodeBlock *>(p);
+      return new CodeBlock(q->m_nested_block);
+    }
+    case nk_Return: {
+      Return *q = static_cast<Return *>(p);
+      return new Return(q->m_expr);
+    }
+    case nk_TInteger: {
+      return new TInteger();
+    }
+    case nk_TCharacter: {
+      return new TCharacter();
+    }
+    case nk_TBoolean: {
+      return new TBoolean();
+    }
+    case nk_TCharPtr: {
+      return new TCharPtr();
+    }
+    case nk_TIntPtr: {
+      return new TIntPtr();
+    }
+    case nk_TString: {
+      TString *q = static_cast<TString *>(p);
+      return new TString(q->m_primitive);
+    }
+    case nk_AbsoluteValue: {
+      AbsoluteValue *q = static_cast<AbsoluteValue *>(p);
+      return new AbsoluteValue(q->m_expr);
+    }
+    case nk_AddressOf: {
+      AddressOf *q = static_cast<AddressOf *>(p);
+      return new AddressOf(q->m_lhs);
+    }
+    case nk_And: {
+      And *q = static_cast<And *>(p);
+      return new And(q->m_expr_1, q->m_expr_2);
+    }
+    case nk_Div: {
+      Div *q = static_cast<Div *>(p);
+      return new Div(q->m_expr_1, q->m_expr_2);
+    }
+    case nk_Compare: {
+      Compare *q = static_cast<Compare *>(p);
+      return new Compare(q->m_expr_1, q->m_expr_2);
+    }
+    case nk_Gt: {
+      Gt *q = static_cast<Gt *>(p);
+      return new Gt(q->m_expr_1, q->m_expr_2);
+    }
+    case nk_Gteq: {
+      Gteq *q = static_cast<Gteq *>(p);
+      return new Gteq(q->m_expr_1, q->m_expr_2);
+    }
+    case nk_Lt: {
+      Lt *q = static_cast<Lt *>(p);
+      return new Lt(q->m_expr_1, q->m_expr_2);
+    }
+    case nk_Lteq: {
+      Lteq *q = static_cast<Lteq *>(p);
+      return new Lteq(q->m_expr_1, q->m_expr_2);
+    }
+    case nk_Minus: {
+      Minus *q = static_cast<Minus *>(p);
+      return new Minus(q->m_expr_1, q->m_expr_2);
+    }
+    case nk_Noteq: {
+      Noteq *q = static_cast<Noteq *>(p);
+      return new Noteq(q->m_expr_1, q->m_expr_2);
+    }
+    case nk_Or: {
+      Or *q = static_cast<Or *>(p);
+      return new Or(q->m_expr_1, q->m_expr_2);
+    }
+    case nk_Plus: {
+      Plus *q = static_cast<Plus *>(p);
+      return new Plus(q->m_expr_1, q->m_expr_2);
+    }
+    case nk_Times: {
+      Times *q = static_cast<Times *>(p);
+      return new Times(q->m_expr_1, q->m_expr_2);
+    }
+    case nk_Not: {
+      Not *q = static_cast<Not *>(p);
+      return new Not(q->m_expr);
+    }
+    case nk_Uminus: {
+      Uminus *q = static_cast<Uminus *>(p);
+      return new Uminus(q->m_expr);
+    }
+    case nk_Ident: {
+      Ident *q = static_cast<Ident *>(p);
+      return new Ident(q->m_symname);
+    }
+    case nk_ArrayAccess: {
+      ArrayAccess *q = static_cast<ArrayAccess *>(p);
+      return new ArrayAccess(q->m_symname, q->m_expr);
+    }
+    case nk_IntLit: {
+      IntLit *q = static_cast<IntLit *>(p);
+      return new IntLit(q->m_primitive);
+    }
+    case nk_CharLit: {
+      CharLit *q = static_cast<CharLit *>(p);
+      return new CharLit(q->m_primitive);
+    }
+    case nk_BoolLit: {
+      BoolLit *q = static_cast<BoolLit *>(p);
+      return new BoolLit(q->m_primitive);
+    }
+    case nk_NullLit: {
+      return new NullLit();
+    }
+    case nk_Deref: {
+      Deref *q = static_cast<Deref *>(p);
+      return new Deref(q->m_expr);
+    }
+    case nk_Variable: {
+      Variable *q = static_cast<Variable *>(p);
+      return new Variable(q->m_symname);
+    }
+    case nk_DerefVariable: {
+      DerefVariable *q = static_cast<DerefVariable *>(p);
+      return new DerefVariable(q->m_symname);
+    }
+    case nk_ArrayElement: {
+      ArrayElement *q = static_cast<ArrayElement *>(p);
+      return new ArrayElement(q->m_symname, q->m_expr);
+    }
+    case nk_count:
+      break;
+  }
+  assert(false);
+  return NULL;
+}
+
+/********* Flat tree ************/
+
+FlatNode ast_flatten(FlatAst *f, Visitable *p)
+{
+  FlatNode root = f->size();
+  std::vector<AstFrame> &stack = f->frames();
+  size_t bottom = stack.size();
+  stack.push_back(AstFrame(p));
+  while(stack.size() > bottom) {
+    p = stack.back().m_node;
+    unsigned i = stack.back().m_next++;
+    switch(p->kind()) {
+      case nk_ProgramImpl: {
+        ProgramImpl *q = static_cast<ProgramImpl *>(p);
+        if(i == 0) {
+          f->enter(nk_ProgramImpl, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->open(q->m_proc_list);
+        }
+        if(i < q->m_proc_list->size()) {
+          f->child((*q->m_proc_list)[i]);
+          continue;
+        }
+        if(i == q->m_proc_list->size()) {
+          f->close(q->m_proc_list);
+        }
+        f->leave();
+        break;
+      }
+      case nk_ProcImpl: {
+        ProcImpl *q = static_cast<ProcImpl *>(p);
+        if(i == 0) {
+          f->enter(nk_ProcImpl, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(&q->m_symname);
+        }
+        if(i == 0) {
+          f->open(q->m_decl_list);
+        }
+        if(i < q->m_decl_list->size()) {
+          f->child((*q->m_decl_list)[i]);
+          continue;
+        }
+        if(i == q->m_decl_list->size()) {
+          f->close(q->m_decl_list);
+        }
+        i -= q->m_decl_list->size();
+        if(i == 0) {
+          f->child(q->m_type);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          f->child(q->m_procedure_block);
+          continue;
+        }
+        f->leave();
+        break;
+      }
+      case nk_Procedure_blockImpl: {
+        Procedure_blockImpl *q = static_cast<Procedure_blockImpl *>(p);
+        if(i == 0) {
+          f->enter(nk_Procedure_blockImpl, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->open(q->m_proc_list);
+        }
+        if(i < q->m_proc_list->size()) {
+          f->child((*q->m_proc_list)[i]);
+          continue;
+        }
+        if(i == q->m_proc_list->size()) {
+          f->close(q->m_proc_list);
+        }
+        i -= q->m_proc_list->size();
+        if(i == 0) {
+          f->open(q->m_decl_list);
+        }
+        if(i < q->m_decl_list->size()) {
+          f->child((*q->m_decl_list)[i]);
+          continue;
+        }
+        if(i == q->m_decl_list->size()) {
+          f->close(q->m_decl_list);
+        }
+        i -= q->m_decl_list->size();
+        if(i == 0) {
+          f->open(q->m_stat_list);
+        }
+        if(i < q->m_stat_list->size()) {
+          f->child((*q->m_stat_list)[i]);
+          continue;
+        }
+        if(i == q->m_stat_list->size()) {
+          f->close(q->m_stat_list);
+        }
+        i -= q->m_stat_list->size();
+        if(i == 0) {
+          f->child(q->m_return_stat);
+          continue;
+        }
+        f->leave();
+        break;
+      }
+      case nk_Nested_blockImpl: {
+        Nested_blockImpl *q = static_cast<Nested_blockImpl *>(p);
+        if(i == 0) {
+          f->enter(nk_Nested_blockImpl, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->open(q->m_decl_list);
+        }
+        if(i < q->m_decl_list->size()) {
+          f->child((*q->m_decl_list)[i]);
+          continue;
+        }
+        if(i == q->m_decl_list->size()) {
+          f->close(q->m_decl_list);
+        }
+        i -= q->m_decl_list->size();
+        if(i == 0) {
+          f->open(q->m_stat_list);
+        }
+        if(i < q->m_stat_list->size()) {
+          f->child((*q->m_stat_list)[i]);
+          continue;
+        }
+        if(i == q->m_stat_list->size()) {
+          f->close(q->m_stat_list);
+        }
+        f->leave();
+        break;
+      }
+      case nk_DeclImpl: {
+        DeclImpl *q = static_cast<DeclImpl *>(p);
+        if(i == 0) {
+          f->enter(nk_DeclImpl, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->open(q->m_symname_list);
+          for(size_t k = 0; k < q->m_symname_list->size(); ++k) {
+            f->child((*q->m_symname_list)[k]);
+          }
+          f->close(q->m_symname_list);
+        }
+        if(i == 0) {
+          f->child(q->m_type);
+          continue;
+        }
+        f->leave();
+        break;
+      }
+      case nk_Assignment: {
+        Assignment *q = static_cast<Assignment *>(p);
+        if(i == 0) {
+          f->enter(nk_Assignment, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(q->m_lhs);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          f->child(q->m_expr);
+          continue;
+        }
+        f->leave();
+        break;
+      }
+      case nk_StringAssignment: {
+        StringAssignment *q = static_cast<StringAssignment *>(p);
+        if(i == 0) {
+          f->enter(nk_StringAssignment, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(q->m_lhs);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          f->child(q->m_stringprimitive);
+        }
+        f->leave();
+        break;
+      }
+      case nk_Call: {
+        Call *q = static_cast<Call *>(p);
+        if(i == 0) {
+          f->enter(nk_Call, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(q->m_lhs);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          f->child(&q->m_symname);
+        }
+        if(i == 0) {
+          f->open(q->m_expr_list);
+        }
+        if(i < q->m_expr_list->size()) {
+          f->child((*q->m_expr_list)[i]);
+          continue;
+        }
+        if(i == q->m_expr_list->size()) {
+          f->close(q->m_expr_list);
+        }
+        f->leave();
+        break;
+      }
+      case nk_IfNoElse: {
+        IfNoElse *q = static_cast<IfNoElse *>(p);
+        if(i == 0) {
+          f->enter(nk_IfNoElse, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(q->m_expr);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          f->child(q->m_nested_block);
+          continue;
+        }
+        f->leave();
+        break;
+      }
+      case nk_IfWithElse: {
+        IfWithElse *q = static_cast<IfWithElse *>(p);
+        if(i == 0) {
+          f->enter(nk_IfWithElse, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(q->m_expr);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          f->child(q->m_nested_block_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          f->child(q->m_nested_block_2);
+          continue;
+        }
+        f->leave();
+        break;
+      }
+      case nk_WhileLoop: {
+        WhileLoop *q = static_cast<WhileLoop *>(p);
+        if(i == 0) {
+          f->enter(nk_WhileLoop, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(q->m_expr);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          f->child(q->m_nested_block);
+          continue;
+        }
+        f->leave();
+        break;
+      }
+      case nk_CodeBlock: {
+        CodeBlock *q = static_cast<CodeBlock *>(p);
+        if(i == 0) {
+          f->enter(nk_CodeBlock, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(q->m_nested_block);
+          continue;
+        }
+        f->leave();
+        break;
+      }
+      case nk_Return: {
+        Return *q = static_cast<Return *>(p);
+        if(i == 0) {
+          f->enter(nk_Return, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(q->m_expr);
+          continue;
+        }
+        f->leave();
+        break;
+      }
+      case nk_TInteger: {
+        TInteger *q = static_cast<TInteger *>(p);
+        if(i == 0) {
+          f->enter(nk_TInteger, q->m_attribute.lineno);
+        }
+        f->leave();
+        break;
+      }
+      case nk_TCharacter: {
+        TCharacter *q = static_cast<TCharacter *>(p);
+        if(i == 0) {
+          f->enter(nk_TCharacter, q->m_attribute.lineno);
+        }
+        f->leave();
+        break;
+      }
+      case nk_TBoolean: {
+        TBoolean *q = static_cast<TBoolean *>(p);
+        if(i == 0) {
+          f->enter(nk_TBoolean, q->m_attribute.lineno);
+        }
+        f->leave();
+        break;
+      }
+      case nk_TCharPtr: {
+        TCharPtr *q = static_cast<TCharPtr *>(p);
+        if(i == 0) {
+          f->enter(nk_TCharPtr, q->m_attribute.lineno);
+        }
+        f->leave();
+        break;
+      }
+      case nk_TIntPtr: {
+        TIntPtr *q = static_cast<TIntPtr *>(p);
+        if(i == 0) {
+          f->enter(nk_TIntPtr, q->m_attribute.lineno);
+        }
+        f->leave();
+        break;
+      }
+      case nk_TString: {
+        TString *q = static_cast<TString *>(p);
+        if(i == 0) {
+          f->enter(nk_TString, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(&q->m_primitive);
+        }
+        f->leave();
+        break;
+      }
+      case nk_AbsoluteValue: {
+        AbsoluteValue *q = static_cast<AbsoluteValue *>(p);
+        if(i == 0) {
+          f->enter(nk_AbsoluteValue, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(q->m_expr);
+          continue;
+        }
+        f->leave();
+        break;
+      }
+      case nk_AddressOf: {
+        AddressOf *q = static_cast<AddressOf *>(p);
+        if(i == 0) {
+          f->enter(nk_AddressOf, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(q->m_lhs);
+          continue;
+        }
+        f->leave();
+        break;
+      }
+      case nk_And: {
+        And *q = static_cast<And *>(p);
+        if(i == 0) {
+          f->enter(nk_And, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          f->child(q->m_expr_2);
+          continue;
+        }
+        f->leave();
+        break;
+      }
+      case nk_Div: {
+        Div *q = static_cast<Div *>(p);
+        if(i == 0) {
+          f->enter(nk_Div, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          f->child(q->m_expr_2);
+          continue;
+        }
+        f->leave();
+        break;
+      }
+      case nk_Compare: {
+        Compare *q = static_cast<Compare *>(p);
+        if(i == 0) {
+          f->enter(nk_Compare, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          f->child(q->m_expr_2);
+          continue;
+        }
+        f->leave();
+        break;
+      }
+      case nk_Gt: {
+        Gt *q = static_cast<Gt *>(p);
+        if(i == 0) {
+          f->enter(nk_Gt, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          f->child(q->m_expr_2);
+          continue;
+        }
+        f->leave();
+        break;
+      }
+      case nk_Gteq: {
+        Gteq *q = static_cast<Gteq *>(p);
+        if(i == 0) {
+          f->enter(nk_Gteq, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          f->child(q->m_expr_2);
+          continue;
+        }
+        f->leave();
+        break;
+      }
+      case nk_Lt: {
+        Lt *q = static_cast<Lt *>(p);
+        if(i == 0) {
+          f->enter(nk_Lt, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          f->child(q->m_expr_2);
+          continue;
+        }
+        f->leave();
+        break;
+      }
+      case nk_Lteq: {
+        Lteq *q = static_cast<Lteq *>(p);
+        if(i == 0) {
+          f->enter(nk_Lteq, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          f->child(q->m_expr_2);
+          continue;
+        }
+        f->leave();
+        break;
+      }
+      case nk_Minus: {
+        Minus *q = static_cast<Minus *>(p);
+        if(i == 0) {
+          f->enter(nk_Minus, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          f->child(q->m_expr_2);
+          continue;
+        }
+        f->leave();
+        break;
+      }
+      case nk_Noteq: {
+        Noteq *q = static_cast<Noteq *>(p);
+        if(i == 0) {
+          f->enter(nk_Noteq, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          f->child(q->m_expr_2);
+          continue;
+        }
+        f->leave();
+        break;
+      }
+      case nk_Or: {
+        Or *q = static_cast<Or *>(p);
+        if(i == 0) {
+          f->enter(nk_Or, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          f->child(q->m_expr_2);
+          continue;
+        }
+        f->leave();
+        break;
+      }
+      case nk_Plus: {
+        Plus *q = static_cast<Plus *>(p);
+        if(i == 0) {
+          f->enter(nk_Plus, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          f->child(q->m_expr_2);
+          continue;
+        }
+        f->leave();
+        break;
+      }
+      case nk_Times: {
+        Times *q = static_cast<Times *>(p);
+        if(i == 0) {
+          f->enter(nk_Times, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(q->m_expr_1);
+          continue;
+        }
+        --i;
+        if(i == 0) {
+          f->child(q->m_expr_2);
+          continue;
+        }
+        f->leave();
+        break;
+      }
+      case nk_Not: {
+        Not *q = static_cast<Not *>(p);
+        if(i == 0) {
+          f->enter(nk_Not, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(q->m_expr);
+          continue;
+        }
+        f->leave();
+        break;
+      }
+      case nk_Uminus: {
+        Uminus *q = static_cast<Uminus *>(p);
+        if(i == 0) {
+          f->enter(nk_Uminus, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(q->m_expr);
+          continue;
+        }
+        f->leave();
+        break;
+      }
+      case nk_Ident: {
+        Ident *q = static_cast<Ident *>(p);
+        if(i == 0) {
+          f->enter(nk_Ident, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(&q->m_symname);
+        }
+        f->leave();
+        break;
+      }
+      case nk_ArrayAccess: {
+        ArrayAccess *q = static_cast<ArrayAccess *>(p);
+        if(i == 0) {
+          f->enter(nk_ArrayAccess, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(&q->m_symname);
+        }
+        if(i == 0) {
+          f->child(q->m_expr);
+          continue;
+        }
+        f->leave();
+        break;
+      }
+      case nk_IntLit: {
+        IntLit *q = static_cast<IntLit *>(p);
+        if(i == 0) {
+          f->enter(nk_IntLit, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(&q->m_primitive);
+        }
+        f->leave();
+        break;
+      }
+      case nk_CharLit: {
+        CharLit *q = static_cast<CharLit *>(p);
+        if(i == 0) {
+          f->enter(nk_CharLit, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(&q->m_primitive);
+        }
+        f->leave();
+        break;
+      }
+      case nk_BoolLit: {
+        BoolLit *q = static_cast<BoolLit *>(p);
+        if(i == 0) {
+          f->enter(nk_BoolLit, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(&q->m_primitive);
+        }
+        f->leave();
+        break;
+      }
+      case nk_NullLit: {
+        NullLit *q = static_cast<NullLit *>(p);
+        if(i == 0) {
+          f->enter(nk_NullLit, q->m_attribute.lineno);
+        }
+        f->leave();
+        break;
+      }
+      case nk_Deref: {
+        Deref *q = static_cast<Deref *>(p);
+        if(i == 0) {
+          f->enter(nk_Deref, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(q->m_expr);
+          continue;
+        }
+        f->leave();
+        break;
+      }
+      case nk_Variable: {
+        Variable *q = static_cast<Variable *>(p);
+        if(i == 0) {
+          f->enter(nk_Variable, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(&q->m_symname);
+        }
+        f->leave();
+        break;
+      }
+      case nk_DerefVariable: {
+        DerefVariable *q = static_cast<DerefVariable *>(p);
+        if(i == 0) {
+          f->enter(nk_DerefVariable, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(&q->m_symname);
+        }
+        f->leave();
+        break;
+      }
+      case nk_ArrayElement: {
+        ArrayElement *q = static_cast<ArrayElement *>(p);
+        if(i == 0) {
+          f->enter(nk_ArrayElement, q->m_attribute.lineno);
+        }
+        if(i == 0) {
+          f->child(&q->m_symname);
+        }
+        if(i == 0) {
+          f->child(q->m_expr);
+          continue;
+        }
+        f->leave();
+        break;
+      }
+      case nk_count:
+        break;
+    }
+    stack.pop_back();
+  }
+  return root;
+}
@@ -3,12 +3,19 @@
 
 //Automatically Generated C++ Abstract Syntax Tree Interface
 
-#include <list>
+#include <cassert>
+#include <vector>
+#include "arena.hpp"
 #include "attribute.hpp"
+#include "symtab.hpp"
+#include "primitive.hpp"
 
 
 /********** Forward Declarations **********/
 
+class SymName;
+class Primitive;
+class StringPrimitive;
 class ProgramImpl;
 class Program;
 class ProcImpl;
@@ -64,9 +71,6 @@ class Variable;
 class Lhs;
 class DerefVariable;
 class ArrayElement;
-class SymName;
-class Primitive;
-class StringPrimitive;
 
 
 /********** Pointer Typedefs **********/
@@ -74,10 +78,15 @@ class StringPrimitive;
 typedef Program* Program_ptr;
 
 typedef Proc* Proc_ptr;
+typedef ArenaVector<Proc_ptr, 1> Proc_list;
 typedef Decl* Decl_ptr;
+typedef ArenaVector<Decl_ptr, 2> Decl_list;
 typedef Stat* Stat_ptr;
+typedef ArenaVector<Stat_ptr, 4> Stat_list;
 typedef SymName* SymName_ptr;
+typedef ArenaVector<SymName_ptr, 2> SymName_list;
 typedef Expr* Expr_ptr;
+typedef ArenaVector<Expr_ptr, 4> Expr_list;
 
 
 /********** Union Type (from parse) **********/
@@ -87,36 +96,94 @@ typedef Expr* Expr_ptr;
 #endif
 typedef union
 {
-std::list<Proc_ptr>* u_proc_list;
+SymName* u_symname;
+Primitive* u_primitive;
+StringPrimitive* u_stringprimitive;
+Proc_list* u_proc_list;
 Program* u_program;
-std::list<Decl_ptr>* u_decl_list;
+Decl_list* u_decl_list;
 Proc* u_proc;
-std::list<Stat_ptr>* u_stat_list;
+Stat_list* u_stat_list;
 Procedure_block* u_procedure_block;
 Nested_block* u_nested_block;
-std::list<SymName_ptr>* u_symname_list;
+SymName_list* u_symname_list;
 Decl* u_decl;
 Stat* u_stat;
-std::list<Expr_ptr>* u_expr_list;
+Expr_list* u_expr_list;
 Return_stat* u_return_stat;
 Type* u_type;
 Expr* u_expr;
 Lhs* u_lhs;
-SymName* u_symname;
-Primitive* u_primitive;
-StringPrimitive* u_stringprimitive;
 
 // a couple of hardcoded types
-char* u_base_charptr;
+const char* u_base_charptr;
 int u_base_int;
 } classunion_stype;
 #define YYSTYPE classunion_stype
 
+/********** Node Kinds **********/
+
+// One for each concrete class, which its kind() gives, and how many
+// there are
+enum NodeKind
+{
+  nk_ProgramImpl,
+  nk_ProcImpl,
+  nk_Procedure_blockImpl,
+  nk_Nested_blockImpl,
+  nk_DeclImpl,
+  nk_Assignment,
+  nk_StringAssignment,
+  nk_Call,
+  nk_IfNoElse,
+  nk_IfWithElse,
+  nk_WhileLoop,
+  nk_CodeBlock,
+  nk_Return,
+  nk_TInteger,
+  nk_TCharacter,
+  nk_TBoolean,
+  nk_TCharPtr,
+  nk_TIntPtr,
+  nk_TString,
+  nk_AbsoluteValue,
+  nk_AddressOf,
+  nk_And,
+  nk_Div,
+  nk_Compare,
+  nk_Gt,
+  nk_Gteq,
+  nk_Lt,
+  nk_Lteq,
+  nk_Minus,
+  nk_Noteq,
+  nk_Or,
+  nk_Plus,
+  nk_Times,
+  nk_Not,
+  nk_Uminus,
+  nk_Ident,
+  nk_ArrayAccess,
+  nk_IntLit,
+  nk_CharLit,
+  nk_BoolLit,
+  nk_NullLit,
+  nk_Deref,
+  nk_Variable,
+  nk_DerefVariable,
+  nk_ArrayElement,
+  nk_count
+};
+
+
 /********** Visitor Interfaces **********/
 
 class Visitor{
  public:
   virtual ~Visitor() {}
+virtual void visitSymName(SymName *p) = 0;
+virtual void visitPrimitive(Primitive *p) = 0;
+virtual void visitStringPrimitive(StringPrimitive *p) = 0;
 virtual void visitProgramImpl(ProgramImpl *p) = 0;
 virtual void visitProcImpl(ProcImpl *p) = 0;
 virtual void visitProcedure_blockImpl(Procedure_blockImpl *p) = 0;
@@ -162,91 +229,105 @@ virtual void visitDeref(Deref *p) = 0;
 virtual void visitVariable(Variable *p) = 0;
 virtual void visitDerefVariable(DerefVariable *p) = 0;
 virtual void visitArrayElement(ArrayElement *p) = 0;
-virtual void visitSymName(SymName *p) = 0;
-virtual void visitPrimitive(Primitive *p) = 0;
-virtual void visitStringPrimitive(StringPrimitive *p) = 0;
 
 };
 
-class Visitable
+// Every node is made in the current Arena and freed with the rest of
+// it (see arena.hpp), so there are no destructors to free the children
+class Visitable : public ArenaObject
 {
  public:
   virtual ~Visitable() {}
   virtual void visit_children(Visitor *v) = 0;
   virtual void accept(Visitor *v) = 0;
+  // Together in the word after the vtable pointer (see attribute.hpp)
+  Attribute m_attribute;
+  unsigned char m_kind;  // a NodeKind, set by each constructor
+  NodeKind kind() const { return (NodeKind) m_kind; }
 };
 
+// isa<Assignment>(p) says whether p is an Assignment, cast<Assignment>(p)
+// makes it one when it has to be, and dyn_cast<Assignment>(p) makes it
+// one if it is and gives NULL if it is not (or p is NULL), all by looking
+// at the node's kind rather than with dynamic_cast.  The abstract classes
+// work too: isa<Expr>(p) says whether p is any of the expressions.
+template<class T> bool isa(const Visitable *p)
+{
+  return T::classof(p);
+}
+
+template<class T> T *cast(Visitable *p)
+{
+  assert(isa<T>(p));
+  return static_cast<T *>(p);
+}
+
+template<class T> T *dyn_cast(Visitable *p)
+{
+  return p && isa<T>(p) ? static_cast<T *>(p) : NULL;
+}
+
 
 /********** Abstract Syntax Classes **********/
 
 class Program : public Visitable {
 public:
-   Attribute m_attribute;
-   Attribute* m_parent_attribute;
    virtual Program *clone() const = 0;
+   static bool classof(const Visitable *p);
 };
 
 class Proc : public Visitable {
 public:
-   Attribute m_attribute;
-   Attribute* m_parent_attribute;
    virtual Proc *clone() const = 0;
+   static bool classof(const Visitable *p);
 };
 
 class Procedure_block : public Visitable {
 public:
-   Attribute m_attribute;
-   Attribute* m_parent_attribute;
    virtual Procedure_block *clone() const = 0;
+   static bool classof(const Visitable *p);
 };
 
 class Nested_block : public Visitable {
 public:
-   Attribute m_attribute;
-   Attribute* m_parent_attribute;
    virtual Nested_block *clone() const = 0;
+   static bool classof(const Visitable *p);
 };
 
 class Decl : public Visitable {
 public:
-   Attribute m_attribute;
-   Attribute* m_parent_attribute;
    virtual Decl *clone() const = 0;
+   static bool classof(const Visitable *p);
 };
 
 class Stat : public Visitable {
 public:
-   Attribute m_attribute;
-   Attribute* m_parent_attribute;
    virtual Stat *clone() const = 0;
+   static bool classof(const Visitable *p);
 };
 
 class Return_stat : public Visitable {
 public:
-   Attribute m_attribute;
-   Attribute* m_parent_attribute;
    virtual Return_stat *clone() const = 0;
+   static bool classof(const Visitable *p);
 };
 
 class Type : public Visitable {
 public:
-   Attribute m_attribute;
-   Attribute* m_parent_attribute;
    virtual Type *clone() const = 0;
+   static bool classof(const Visitable *p);
 };
 
 class Expr : public Visitable {
 public:
-   Attribute m_attribute;
-   Attribute* m_parent_attribute;
    virtual Expr *clone() const = 0;
+   static bool classof(const Visitable *p);
 };
 
 class Lhs : public Visitable {
 public:
-   Attribute m_attribute;
-   Attribute* m_parent_attribute;
    virtual Lhs *clone() const = 0;
+   static bool classof(const Visitable *p);
 };
 
 
@@ -254,15 +335,15 @@ public:
 class ProgramImpl : public Program
 {
   public:
-  std::list<Proc_ptr> *m_proc_list;
+  Proc_list *m_proc_list;
 
   ProgramImpl(const ProgramImpl &);
   ProgramImpl &operator=(const ProgramImpl &);
-  ProgramImpl(std::list<Proc_ptr> *p1);
-  ~ProgramImpl();
+  ProgramImpl(Proc_list *p1);
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  ProgramImpl  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_ProgramImpl; }
   void swap(ProgramImpl &);
 };
 
@@ -270,18 +351,18 @@ class ProgramImpl : public Program
 class ProcImpl : public Proc
 {
   public:
-  SymName *m_symname;
-  std::list<Decl_ptr> *m_decl_list;
+  SymName m_symname;
+  Decl_list *m_decl_list;
   Type *m_type;
   Procedure_block *m_procedure_block;
 
   ProcImpl(const ProcImpl &);
   ProcImpl &operator=(const ProcImpl &);
-  ProcImpl(SymName *p1, std::list<Decl_ptr> *p2, Type *p3, Procedure_block *p4);
-  ~ProcImpl();
+  ProcImpl(const SymName &p1, Decl_list *p2, Type *p3, Procedure_block *p4);
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  ProcImpl  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_ProcImpl; }
   void swap(ProcImpl &);
 };
 
@@ -289,18 +370,18 @@ class ProcImpl : public Proc
 class Procedure_blockImpl : public Procedure_block
 {
   public:
-  std::list<Proc_ptr> *m_proc_list;
-  std::list<Decl_ptr> *m_decl_list;
-  std::list<Stat_ptr> *m_stat_list;
+  Proc_list *m_proc_list;
+  Decl_list *m_decl_list;
+  Stat_list *m_stat_list;
   Return_stat *m_return_stat;
 
   Procedure_blockImpl(const Procedure_blockImpl &);
   Procedure_blockImpl &operator=(const Procedure_blockImpl &);
-  Procedure_blockImpl(std::list<Proc_ptr> *p1, std::list<Decl_ptr> *p2, std::list<Stat_ptr> *p3, Return_stat *p4);
-  ~Procedure_blockImpl();
+  Procedure_blockImpl(Proc_list *p1, Decl_list *p2, Stat_list *p3, Return_stat *p4);
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  Procedure_blockImpl  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_Procedure_blockImpl; }
   void swap(Procedure_blockImpl &);
 };
 
@@ -308,16 +389,16 @@ class Procedure_blockImpl : public Procedure_block
 class Nested_blockImpl : public Nested_block
 {
   public:
-  std::list<Decl_ptr> *m_decl_list;
-  std::list<Stat_ptr> *m_stat_list;
+  Decl_list *m_decl_list;
+  Stat_list *m_stat_list;
 
   Nested_blockImpl(const Nested_blockImpl &);
   Nested_blockImpl &operator=(const Nested_blockImpl &);
-  Nested_blockImpl(std::list<Decl_ptr> *p1, std::list<Stat_ptr> *p2);
-  ~Nested_blockImpl();
+  Nested_blockImpl(Decl_list *p1, Stat_list *p2);
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  Nested_blockImpl  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_Nested_blockImpl; }
   void swap(Nested_blockImpl &);
 };
 
@@ -325,16 +406,16 @@ class Nested_blockImpl : public Nested_block
 class DeclImpl : public Decl
 {
   public:
-  std::list<SymName_ptr> *m_symname_list;
+  SymName_list *m_symname_list;
   Type *m_type;
 
   DeclImpl(const DeclImpl &);
   DeclImpl &operator=(const DeclImpl &);
-  DeclImpl(std::list<SymName_ptr> *p1, Type *p2);
-  ~DeclImpl();
+  DeclImpl(SymName_list *p1, Type *p2);
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  DeclImpl  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_DeclImpl; }
   void swap(DeclImpl &);
 };
 
@@ -348,10 +429,10 @@ class Assignment : public Stat
   Assignment(const Assignment &);
   Assignment &operator=(const Assignment &);
   Assignment(Lhs *p1, Expr *p2);
-  ~Assignment();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  Assignment  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_Assignment; }
   void swap(Assignment &);
 };
 
@@ -365,10 +446,10 @@ class StringAssignment : public Stat
   StringAssignment(const StringAssignment &);
   StringAssignment &operator=(const StringAssignment &);
   StringAssignment(Lhs *p1, StringPrimitive *p2);
-  ~StringAssignment();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  StringAssignment  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_StringAssignment; }
   void swap(StringAssignment &);
 };
 
@@ -377,16 +458,16 @@ class Call : public Stat
 {
   public:
   Lhs *m_lhs;
-  SymName *m_symname;
-  std::list<Expr_ptr> *m_expr_list;
+  SymName m_symname;
+  Expr_list *m_expr_list;
 
   Call(const Call &);
   Call &operator=(const Call &);
-  Call(Lhs *p1, SymName *p2, std::list<Expr_ptr> *p3);
-  ~Call();
+  Call(Lhs *p1, const SymName &p2, Expr_list *p3);
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  Call  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_Call; }
   void swap(Call &);
 };
 
@@ -400,10 +481,10 @@ class IfNoElse : public Stat
   IfNoElse(const IfNoElse &);
   IfNoElse &operator=(const IfNoElse &);
   IfNoElse(Expr *p1, Nested_block *p2);
-  ~IfNoElse();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  IfNoElse  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_IfNoElse; }
   void swap(IfNoElse &);
 };
 
@@ -418,10 +499,10 @@ class IfWithElse : public Stat
   IfWithElse(const IfWithElse &);
   IfWithElse &operator=(const IfWithElse &);
   IfWithElse(Expr *p1, Nested_block *p2, Nested_block *p3);
-  ~IfWithElse();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  IfWithElse  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_IfWithElse; }
   void swap(IfWithElse &);
 };
 
@@ -435,10 +516,10 @@ class WhileLoop : public Stat
   WhileLoop(const WhileLoop &);
   WhileLoop &operator=(const WhileLoop &);
   WhileLoop(Expr *p1, Nested_block *p2);
-  ~WhileLoop();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  WhileLoop  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_WhileLoop; }
   void swap(WhileLoop &);
 };
 
@@ -451,10 +532,10 @@ class CodeBlock : public Stat
   CodeBlock(const CodeBlock &);
   CodeBlock &operator=(const CodeBlock &);
   CodeBlock(Nested_block *p1);
-  ~CodeBlock();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  CodeBlock  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_CodeBlock; }
   void swap(CodeBlock &);
 };
 
@@ -467,10 +548,10 @@ class Return : public Return_stat
   Return(const Return &);
   Return &operator=(const Return &);
   Return(Expr *p1);
-  ~Return();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  Return  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_Return; }
   void swap(Return &);
 };
 
@@ -482,10 +563,10 @@ class TInteger : public Type
   TInteger(const TInteger &);
   TInteger &operator=(const TInteger &);
   TInteger();
-  ~TInteger();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  TInteger  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_TInteger; }
   void swap(TInteger &);
 };
 
@@ -497,10 +578,10 @@ class TCharacter : public Type
   TCharacter(const TCharacter &);
   TCharacter &operator=(const TCharacter &);
   TCharacter();
-  ~TCharacter();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  TCharacter  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_TCharacter; }
   void swap(TCharacter &);
 };
 
@@ -512,10 +593,10 @@ class TBoolean : public Type
   TBoolean(const TBoolean &);
   TBoolean &operator=(const TBoolean &);
   TBoolean();
-  ~TBoolean();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  TBoolean  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_TBoolean; }
   void swap(TBoolean &);
 };
 
@@ -527,10 +608,10 @@ class TCharPtr : public Type
   TCharPtr(const TCharPtr &);
   TCharPtr &operator=(const TCharPtr &);
   TCharPtr();
-  ~TCharPtr();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  TCharPtr  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_TCharPtr; }
   void swap(TCharPtr &);
 };
 
@@ -542,10 +623,10 @@ class TIntPtr : public Type
   TIntPtr(const TIntPtr &);
   TIntPtr &operator=(const TIntPtr &);
   TIntPtr();
-  ~TIntPtr();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  TIntPtr  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_TIntPtr; }
   void swap(TIntPtr &);
 };
 
@@ -553,15 +634,15 @@ class TIntPtr : public Type
 class TString : public Type
 {
   public:
-  Primitive *m_primitive;
+  Primitive m_primitive;
 
   TString(const TString &);
   TString &operator=(const TString &);
-  TString(Primitive *p1);
-  ~TString();
+  TString(const Primitive &p1);
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  TString  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_TString; }
   void swap(TString &);
 };
 
@@ -574,10 +655,10 @@ class AbsoluteValue : public Expr
   AbsoluteValue(const AbsoluteValue &);
   AbsoluteValue &operator=(const AbsoluteValue &);
   AbsoluteValue(Expr *p1);
-  ~AbsoluteValue();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  AbsoluteValue  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_AbsoluteValue; }
   void swap(AbsoluteValue &);
 };
 
@@ -590,10 +671,10 @@ class AddressOf : public Expr
   AddressOf(const AddressOf &);
   AddressOf &operator=(const AddressOf &);
   AddressOf(Lhs *p1);
-  ~AddressOf();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  AddressOf  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_AddressOf; }
   void swap(AddressOf &);
 };
 
@@ -607,10 +688,10 @@ class And : public Expr
   And(const And &);
   And &operator=(const And &);
   And(Expr *p1, Expr *p2);
-  ~And();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  And  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_And; }
   void swap(And &);
 };
 
@@ -624,10 +705,10 @@ class Div : public Expr
   Div(const Div &);
   Div &operator=(const Div &);
   Div(Expr *p1, Expr *p2);
-  ~Div();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  Div  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_Div; }
   void swap(Div &);
 };
 
@@ -641,10 +722,10 @@ class Compare : public Expr
   Compare(const Compare &);
   Compare &operator=(const Compare &);
   Compare(Expr *p1, Expr *p2);
-  ~Compare();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  Compare  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_Compare; }
   void swap(Compare &);
 };
 
@@ -658,10 +739,10 @@ class Gt : public Expr
   Gt(const Gt &);
   Gt &operator=(const Gt &);
   Gt(Expr *p1, Expr *p2);
-  ~Gt();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  Gt  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_Gt; }
   void swap(Gt &);
 };
 
@@ -675,10 +756,10 @@ class Gteq : public Expr
   Gteq(const Gteq &);
   Gteq &operator=(const Gteq &);
   Gteq(Expr *p1, Expr *p2);
-  ~Gteq();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  Gteq  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_Gteq; }
   void swap(Gteq &);
 };
 
@@ -692,10 +773,10 @@ class Lt : public Expr
   Lt(const Lt &);
   Lt &operator=(const Lt &);
   Lt(Expr *p1, Expr *p2);
-  ~Lt();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  Lt  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_Lt; }
   void swap(Lt &);
 };
 
@@ -709,10 +790,10 @@ class Lteq : public Expr
   Lteq(const Lteq &);
   Lteq &operator=(const Lteq &);
   Lteq(Expr *p1, Expr *p2);
-  ~Lteq();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  Lteq  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_Lteq; }
   void swap(Lteq &);
 };
 
@@ -726,10 +807,10 @@ class Minus : public Expr
   Minus(const Minus &);
   Minus &operator=(const Minus &);
   Minus(Expr *p1, Expr *p2);
-  ~Minus();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  Minus  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_Minus; }
   void swap(Minus &);
 };
 
@@ -743,10 +824,10 @@ class Noteq : public Expr
   Noteq(const Noteq &);
   Noteq &operator=(const Noteq &);
   Noteq(Expr *p1, Expr *p2);
-  ~Noteq();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  Noteq  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_Noteq; }
   void swap(Noteq &);
 };
 
@@ -760,10 +841,10 @@ class Or : public Expr
   Or(const Or &);
   Or &operator=(const Or &);
   Or(Expr *p1, Expr *p2);
-  ~Or();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  Or  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_Or; }
   void swap(Or &);
 };
 
@@ -777,10 +858,10 @@ class Plus : public Expr
   Plus(const Plus &);
   Plus &operator=(const Plus &);
   Plus(Expr *p1, Expr *p2);
-  ~Plus();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  Plus  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_Plus; }
   void swap(Plus &);
 };
 
@@ -794,10 +875,10 @@ class Times : public Expr
   Times(const Times &);
   Times &operator=(const Times &);
   Times(Expr *p1, Expr *p2);
-  ~Times();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  Times  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_Times; }
   void swap(Times &);
 };
 
@@ -810,10 +891,10 @@ class Not : public Expr
   Not(const Not &);
   Not &operator=(const Not &);
   Not(Expr *p1);
-  ~Not();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  Not  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_Not; }
   void swap(Not &);
 };
 
@@ -826,10 +907,10 @@ class Uminus : public Expr
   Uminus(const Uminus &);
   Uminus &operator=(const Uminus &);
   Uminus(Expr *p1);
-  ~Uminus();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  Uminus  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_Uminus; }
   void swap(Uminus &);
 };
 
@@ -837,15 +918,15 @@ class Uminus : public Expr
 class Ident : public Expr
 {
   public:
-  SymName *m_symname;
+  SymName m_symname;
 
   Ident(const Ident &);
   Ident &operator=(const Ident &);
-  Ident(SymName *p1);
-  ~Ident();
+  Ident(const SymName &p1);
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  Ident  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_Ident; }
   void swap(Ident &);
 };
 
@@ -853,16 +934,16 @@ class Ident : public Expr
 class ArrayAccess : public Expr
 {
   public:
-  SymName *m_symname;
+  SymName m_symname;
   Expr *m_expr;
 
   ArrayAccess(const ArrayAccess &);
   ArrayAccess &operator=(const ArrayAccess &);
-  ArrayAccess(SymName *p1, Expr *p2);
-  ~ArrayAccess();
+  ArrayAccess(const SymName &p1, Expr *p2);
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  ArrayAccess  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_ArrayAccess; }
   void swap(ArrayAccess &);
 };
 
@@ -870,15 +951,15 @@ class ArrayAccess : public Expr
 class IntLit : public Expr
 {
   public:
-  Primitive *m_primitive;
+  Primitive m_primitive;
 
   IntLit(const IntLit &);
   IntLit &operator=(const IntLit &);
-  IntLit(Primitive *p1);
-  ~IntLit();
+  IntLit(const Primitive &p1);
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  IntLit  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_IntLit; }
   void swap(IntLit &);
 };
 
@@ -886,15 +967,15 @@ class IntLit : public Expr
 class CharLit : public Expr
 {
   public:
-  Primitive *m_primitive;
+  Primitive m_primitive;
 
   CharLit(const CharLit &);
   CharLit &operator=(const CharLit &);
-  CharLit(Primitive *p1);
-  ~CharLit();
+  CharLit(const Primitive &p1);
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  CharLit  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_CharLit; }
   void swap(CharLit &);
 };
 
@@ -902,15 +983,15 @@ class CharLit : public Expr
 class BoolLit : public Expr
 {
   public:
-  Primitive *m_primitive;
+  Primitive m_primitive;
 
   BoolLit(const BoolLit &);
   BoolLit &operator=(const BoolLit &);
-  BoolLit(Primitive *p1);
-  ~BoolLit();
+  BoolLit(const Primitive &p1);
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  BoolLit  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_BoolLit; }
   void swap(BoolLit &);
 };
 
@@ -922,10 +1003,10 @@ class NullLit : public Expr
   NullLit(const NullLit &);
   NullLit &operator=(const NullLit &);
   NullLit();
-  ~NullLit();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  NullLit  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_NullLit; }
   void swap(NullLit &);
 };
 
@@ -938,10 +1019,10 @@ class Deref : public Expr
   Deref(const Deref &);
   Deref &operator=(const Deref &);
   Deref(Expr *p1);
-  ~Deref();
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  Deref  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_Deref; }
   void swap(Deref &);
 };
 
@@ -949,15 +1030,15 @@ class Deref : public Expr
 class Variable : public Lhs
 {
   public:
-  SymName *m_symname;
+  SymName m_symname;
 
   Variable(const Variable &);
   Variable &operator=(const Variable &);
-  Variable(SymName *p1);
-  ~Variable();
+  Variable(const SymName &p1);
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  Variable  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_Variable; }
   void swap(Variable &);
 };
 
@@ -965,15 +1046,15 @@ class Variable : public Lhs
 class DerefVariable : public Lhs
 {
   public:
-  SymName *m_symname;
+  SymName m_symname;
 
   DerefVariable(const DerefVariable &);
   DerefVariable &operator=(const DerefVariable &);
-  DerefVariable(SymName *p1);
-  ~DerefVariable();
+  DerefVariable(const SymName &p1);
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  DerefVariable  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_DerefVariable; }
   void swap(DerefVariable &);
 };
 
@@ -981,20 +1062,1704 @@ class DerefVariable : public Lhs
 class ArrayElement : public Lhs
 {
   public:
-  SymName *m_symname;
+  SymName m_symname;
   Expr *m_expr;
 
   ArrayElement(const ArrayElement &);
   ArrayElement &operator=(const ArrayElement &);
-  ArrayElement(SymName *p1, Expr *p2);
-  ~ArrayElement();
+  ArrayElement(const SymName &p1, Expr *p2);
   virtual void visit_children( Visitor* v );
   virtual void accept(Visitor *v);
   virtual  ArrayElement  *clone() const;
+  static bool classof(const Visitable *p) { return p->kind() == nk_ArrayElement; }
   void swap(ArrayElement &);
 };
 
 
+inline bool Program::classof(const Visitable *p)
+{
+  switch(p->kind()) {
+    case nk_ProgramImpl:
+      return true;
+    default:
+      return false;
+  }
+}
+
+inline bool Proc::classof(const Visitable *p)
+{
+  switch(p->kind()) {
+    case nk_ProcImpl:
+      return true;
+    default:
+      return false;
+  }
+}
+
+inline bool Procedure_block::classof(const Visitable *p)
+{
+  switch(p->kind()) {
+    case nk_Procedure_blockImpl:
+      return true;
+    default:
+      return false;
+  }
+}
+
+inline bool Nested_block::classof(const Visitable *p)
+{
+  switch(p->kind()) {
+    case nk_Nested_blockImpl:
+      return true;
+    default:
+      return false;
+  }
+}
+
+inline bool Decl::classof(const Visitable *p)
+{
+  switch(p->kind()) {
+    case nk_DeclImpl:
+      return true;
+    default:
+      return false;
+  }
+}
+
+inline bool Stat::classof(const Visitable *p)
+{
+  switch(p->kind()) {
+    case nk_Assignment:
+    case nk_StringAssignment:
+    case nk_Call:
+    case nk_IfNoElse:
+    case nk_IfWithElse:
+    case nk_WhileLoop:
+    case nk_CodeBlock:
+      return true;
+    default:
+      return false;
+  }
+}
+
+inline bool Return_stat::classof(const Visitable *p)
+{
+  switch(p->kind()) {
+    case nk_Return:
+      return true;
+    default:
+      return false;
+  }
+}
+
+inline bool Type::classof(const Visitable *p)
+{
+  switch(p->kind()) {
+    case nk_TInteger:
+    case nk_TCharacter:
+    case nk_TBoolean:
+    case nk_TCharPtr:
+    case nk_TIntPtr:
+    case nk_TString:
+      return true;
+    default:
+      return false;
+  }
+}
+
+inline bool Expr::classof(const Visitable *p)
+{
+  switch(p->kind()) {
+    case nk_AbsoluteValue:
+    case nk_AddressOf:
+    case nk_And:
+    case nk_Div:
+    case nk_Compare:
+    case nk_Gt:
+    case nk_Gteq:
+    case nk_Lt:
+    case nk_Lteq:
+    case nk_Minus:
+    case nk_Noteq:
+    case nk_Or:
+    case nk_Plus:
+    case nk_Times:
+    case nk_Not:
+    case nk_Uminus:
+    case nk_Ident:
+    case nk_ArrayAccess:
+    case nk_IntLit:
+    case nk_CharLit:
+    case nk_BoolLit:
+    case nk_NullLit:
+    case nk_Deref:
+      return true;
+    default:
+      return false;
+  }
+}
+
+inline bool Lhs::classof(const Visitable *p)
+{
+  switch(p->kind()) {
+    case nk_Variable:
+    case nk_DerefVariable:
+    case nk_ArrayElement:
+      return true;
+    default:
+      return false;
+  }
+}
+
+
+/********** Walks without recursion **********/
+
+// A node ast_write, ast_hash or ast_flatten is in, and the child it is at.
+// Like StackVisitor, they keep these on a stack in memory rather than the
+// C++ stack, so a tree can be as deep as it likes; the class each walks
+// for keeps the stack, so that it is there for the next walk.
+struct AstFrame
+{
+  Visitable *m_node;
+  unsigned m_next;      // the step to take next
+
+  AstFrame(Visitable *node) : m_node(node), m_next(0) {}
+};
+
+/********** AST cache **********/
+
+class AstWriter;
+class AstReader;
+
+// The rules the classes were made from, which a cached tree has to have
+// been written with (see astcache.hpp)
+extern const char ast_layout[];
+
+// Writes the tree under p, children first, and gives where p's record is
+unsigned ast_write(AstWriter *w, Visitable *p);
+// Makes the tree whose root's record is at at
+Visitable *ast_read(AstReader *r, unsigned at);
+
+/********** Structural hashing **********/
+
+class AstHash;
+class AstEqual;
+class ExprPool;
+
+// The hash of the tree under p, and whether the trees under a and b are
+// the same, line numbers aside (see exprpool.hpp)
+size_t ast_hash(AstHash *h, Visitable *p);
+bool ast_equal(AstEqual *e, Visitable *a, Visitable *b);
+// Gives back a node that was just made, and the children only it has
+void ast_release(ExprPool *pool, Visitable *p);
+// A node like p with the same children, not copies of them
+Visitable *ast_remake(Visitable *p);
+
+/********** Flat tree **********/
+
+class FlatAst;
+typedef unsigned FlatNode;
+
+// Adds the tree under p to f, and gives its root (see flatast.hpp)
+FlatNode ast_flatten(FlatAst *f, Visitable *p);
+
+/********** Static Visitor **********/
+
+// The same walk as Visitor without a virtual call for each visit.  A pass
+// derives from StaticVisitor<Pass> and defines visitAssignment and the rest
+// for the nodes it cares about; the others visit their children.  visit(p)
+// switches on p->kind() and calls the pass directly, so the compiler can
+// inline the pass into the walk.  A pass should not define visit or
+// visit_children, which would hide these.
+template<class Derived> class StaticVisitor
+{
+ private:
+  Derived *self() { return static_cast<Derived *>(this); }
+
+ public:
+  void visit(Visitable *p) {
+    switch(p->kind()) {
+      case nk_ProgramImpl:
+        self()->visitProgramImpl(static_cast<ProgramImpl *>(p));
+        break;
+      case nk_ProcImpl:
+        self()->visitProcImpl(static_cast<ProcImpl *>(p));
+        break;
+      case nk_Procedure_blockImpl:
+        self()->visitProcedure_blockImpl(static_cast<Procedure_blockImpl *>(p));
+        break;
+      case nk_Nested_blockImpl:
+        self()->visitNested_blockImpl(static_cast<Nested_blockImpl *>(p));
+        break;
+      case nk_DeclImpl:
+        self()->visitDeclImpl(static_cast<DeclImpl *>(p));
+        break;
+      case nk_Assignment:
+        self()->visitAssignment(static_cast<Assignment *>(p));
+        break;
+      case nk_StringAssignment:
+        self()->visitStringAssignment(static_cast<StringAssignment *>(p));
+        break;
+      case nk_Call:
+        self()->visitCall(static_cast<Call *>(p));
+        break;
+      case nk_IfNoElse:
+        self()->visitIfNoElse(static_cast<IfNoElse *>(p));
+        break;
+      case nk_IfWithElse:
+        self()->visitIfWithElse(static_cast<IfWithElse *>(p));
+        break;
+      case nk_WhileLoop:
+        self()->visitWhileLoop(static_cast<WhileLoop *>(p));
+        break;
+      case nk_CodeBlock:
+        self()->visitCodeBlock(static_cast<CodeBlock *>(p));
+        break;
+      case nk_Return:
+        self()->visitReturn(static_cast<Return *>(p));
+        break;
+      case nk_TInteger:
+        self()->visitTInteger(static_cast<TInteger *>(p));
+        break;
+      case nk_TCharacter:
+        self()->visitTCharacter(static_cast<TCharacter *>(p));
+        break;
+      case nk_TBoolean:
+        self()->visitTBoolean(static_cast<TBoolean *>(p));
+        break;
+      case nk_TCharPtr:
+        self()->visitTCharPtr(static_cast<TCharPtr *>(p));
+        break;
+      case nk_TIntPtr:
+        self()->visitTIntPtr(static_cast<TIntPtr *>(p));
+        break;
+      case nk_TString:
+        self()->visitTString(static_cast<TString *>(p));
+        break;
+      case nk_AbsoluteValue:
+        self()->visitAbsoluteValue(static_cast<AbsoluteValue *>(p));
+        break;
+      case nk_AddressOf:
+        self()->visitAddressOf(static_cast<AddressOf *>(p));
+        break;
+      case nk_And:
+        self()->visitAnd(static_cast<And *>(p));
+        break;
+      case nk_Div:
+        self()->visitDiv(static_cast<Div *>(p));
+        break;
+      case nk_Compare:
+        self()->visitCompare(static_cast<Compare *>(p));
+        break;
+      case nk_Gt:
+        self()->visitGt(static_cast<Gt *>(p));
+        break;
+      case nk_Gteq:
+        self()->visitGteq(static_cast<Gteq *>(p));
+        break;
+      case nk_Lt:
+        self()->visitLt(static_cast<Lt *>(p));
+        break;
+      case nk_Lteq:
+        self()->visitLteq(static_cast<Lteq *>(p));
+        break;
+      case nk_Minus:
+        self()->visitMinus(static_cast<Minus *>(p));
+        break;
+      case nk_Noteq:
+        self()->visitNoteq(static_cast<Noteq *>(p));
+        break;
+      case nk_Or:
+        self()->visitOr(static_cast<Or *>(p));
+        break;
+      case nk_Plus:
+        self()->visitPlus(static_cast<Plus *>(p));
+        break;
+      case nk_Times:
+        self()->visitTimes(static_cast<Times *>(p));
+        break;
+      case nk_Not:
+        self()->visitNot(static_cast<Not *>(p));
+        break;
+      case nk_Uminus:
+        self()->visitUminus(static_cast<Uminus *>(p));
+        break;
+      case nk_Ident:
+        self()->visitIdent(static_cast<Ident *>(p));
+        break;
+      case nk_ArrayAccess:
+        self()->visitArrayAccess(static_cast<ArrayAccess *>(p));
+        break;
+      case nk_IntLit:
+        self()->visitIntLit(static_cast<IntLit *>(p));
+        break;
+      case nk_CharLit:
+        self()->visitCharLit(static_cast<CharLit *>(p));
+        break;
+      case nk_BoolLit:
+        self()->visitBoolLit(static_cast<BoolLit *>(p));
+        break;
+      case nk_NullLit:
+        self()->visitNullLit(static_cast<NullLit *>(p));
+        break;
+      case nk_Deref:
+        self()->visitDeref(static_cast<Deref *>(p));
+        break;
+      case nk_Variable:
+        self()->visitVariable(static_cast<Variable *>(p));
+        break;
+      case nk_DerefVariable:
+        self()->visitDerefVariable(static_cast<DerefVariable *>(p));
+        break;
+      case nk_ArrayElement:
+        self()->visitArrayElement(static_cast<ArrayElement *>(p));
+        break;
+      case nk_count:
+        break;
+    }
+  }
+
+  void visit(SymName *p) { self()->visitSymName(p); }
+  void visit(Primitive *p) { self()->visitPrimitive(p); }
+  void visit(StringPrimitive *p) { self()->visitStringPrimitive(p); }
+
+  void visit_children(ProgramImpl *p) {
+    for(Proc_list::iterator it = p->m_proc_list->begin(), end = p->m_proc_list->end();
+        it != end; ++it) {
+      visit(*it);
+    }
+  }
+  void visit_children(ProcImpl *p) {
+    visit(&p->m_symname);
+    for(Decl_list::iterator it = p->m_decl_list->begin(), end = p->m_decl_list->end();
+        it != end; ++it) {
+      visit(*it);
+    }
+    visit(p->m_type);
+    visit(p->m_procedure_block);
+  }
+  void visit_children(Procedure_blockImpl *p) {
+    for(Proc_list::iterator it = p->m_proc_list->begin(), end = p->m_proc_list->end();
+        it != end; ++it) {
+      visit(*it);
+    }
+    for(Decl_list::iterator it = p->m_decl_list->begin(), end = p->m_decl_list->end();
+        it != end; ++it) {
+      visit(*it);
+    }
+    for(Stat_list::iterator it = p->m_stat_list->begin(), end = p->m_stat_list->end();
+        it != end; ++it) {
+      visit(*it);
+    }
+    visit(p->m_return_stat);
+  }
+  void visit_children(Nested_blockImpl *p) {
+    for(Decl_list::iterator it = p->m_decl_list->begin(), end = p->m_decl_list->end();
+        it != end; ++it) {
+      visit(*it);
+    }
+    for(Stat_list::iterator it = p->m_stat_list->begin(), end = p->m_stat_list->end();
+        it != end; ++it) {
+      visit(*it);
+    }
+  }
+  void visit_children(DeclImpl *p) {
+    for(SymName_list::iterator it = p->m_symname_list->begin(), end = p->m_symname_list->end();
+        it != end; ++it) {
+      visit(*it);
+    }
+    visit(p->m_type);
+  }
+  void visit_children(Assignment *p) {
+    visit(p->m_lhs);
+    visit(p->m_expr);
+  }
+  void visit_children(StringAssignment *p) {
+    visit(p->m_lhs);
+    visit(p->m_stringprimitive);
+  }
+  void visit_children(Call *p) {
+    visit(p->m_lhs);
+    visit(&p->m_symname);
+    for(Expr_list::iterator it = p->m_expr_list->begin(), end = p->m_expr_list->end();
+        it != end; ++it) {
+      visit(*it);
+    }
+  }
+  void visit_children(IfNoElse *p) {
+    visit(p->m_expr);
+    visit(p->m_nested_block);
+  }
+  void visit_children(IfWithElse *p) {
+    visit(p->m_expr);
+    visit(p->m_nested_block_1);
+    visit(p->m_nested_block_2);
+  }
+  void visit_children(WhileLoop *p) {
+    visit(p->m_expr);
+    visit(p->m_nested_block);
+  }
+  void visit_children(CodeBlock *p) {
+    visit(p->m_nested_block);
+  }
+  void visit_children(Return *p) {
+    visit(p->m_expr);
+  }
+  void visit_children(TInteger *) {
+  }
+  void visit_children(TCharacter *) {
+  }
+  void visit_children(TBoolean *) {
+  }
+  void visit_children(TCharPtr *) {
+  }
+  void visit_children(TIntPtr *) {
+  }
+  void visit_children(TString *p) {
+    visit(&p->m_primitive);
+  }
+  void visit_children(AbsoluteValue *p) {
+    visit(p->m_expr);
+  }
+  void visit_children(AddressOf *p) {
+    visit(p->m_lhs);
+  }
+  void visit_children(And *p) {
+    visit(p->m_expr_1);
+    visit(p->m_expr_2);
+  }
+  void visit_children(Div *p) {
+    visit(p->m_expr_1);
+    visit(p->m_expr_2);
+  }
+  void visit_children(Compare *p) {
+    visit(p->m_expr_1);
+    visit(p->m_expr_2);
+  }
+  void visit_children(Gt *p) {
+    visit(p->m_expr_1);
+    visit(p->m_expr_2);
+  }
+  void visit_children(Gteq *p) {
+    visit(p->m_expr_1);
+    visit(p->m_expr_2);
+  }
+  void visit_children(Lt *p) {
+    visit(p->m_expr_1);
+    visit(p->m_expr_2);
+  }
+  void visit_children(Lteq *p) {
+    visit(p->m_expr_1);
+    visit(p->m_expr_2);
+  }
+  void visit_children(Minus *p) {
+    visit(p->m_expr_1);
+    visit(p->m_expr_2);
+  }
+  void visit_children(Noteq *p) {
+    visit(p->m_expr_1);
+    visit(p->m_expr_2);
+  }
+  void visit_children(Or *p) {
+    visit(p->m_expr_1);
+    visit(p->m_expr_2);
+  }
+  void visit_children(Plus *p) {
+    visit(p->m_expr_1);
+    visit(p->m_expr_2);
+  }
+  void visit_children(Times *p) {
+    visit(p->m_expr_1);
+    visit(p->m_expr_2);
+  }
+  void visit_children(Not *p) {
+    visit(p->m_expr);
+  }
+  void visit_children(Uminus *p) {
+    visit(p->m_expr);
+  }
+  void visit_children(Ident *p) {
+    visit(&p->m_symname);
+  }
+  void visit_children(ArrayAccess *p) {
+    visit(&p->m_symname);
+    visit(p->m_expr);
+  }
+  void visit_children(IntLit *p) {
+    visit(&p->m_primitive);
+  }
+  void visit_children(CharLit *p) {
+    visit(&p->m_primitive);
+  }
+  void visit_children(BoolLit *p) {
+    visit(&p->m_primitive);
+  }
+  void visit_children(NullLit *) {
+  }
+  void visit_children(Deref *p) {
+    visit(p->m_expr);
+  }
+  void visit_children(Variable *p) {
+    visit(&p->m_symname);
+  }
+  void visit_children(DerefVariable *p) {
+    visit(&p->m_symname);
+  }
+  void visit_children(ArrayElement *p) {
+    visit(&p->m_symname);
+    visit(p->m_expr);
+  }
+
+  void visitSymName(SymName *) {}
+  void visitPrimitive(Primitive *) {}
+  void visitStringPrimitive(StringPrimitive *) {}
+  void visitProgramImpl(ProgramImpl *p) { visit_children(p); }
+  void visitProcImpl(ProcImpl *p) { visit_children(p); }
+  void visitProcedure_blockImpl(Procedure_blockImpl *p) { visit_children(p); }
+  void visitNested_blockImpl(Nested_blockImpl *p) { visit_children(p); }
+  void visitDeclImpl(DeclImpl *p) { visit_children(p); }
+  void visitAssignment(Assignment *p) { visit_children(p); }
+  void visitStringAssignment(StringAssignment *p) { visit_children(p); }
+  void visitCall(Call *p) { visit_children(p); }
+  void visitIfNoElse(IfNoElse *p) { visit_children(p); }
+  void visitIfWithElse(IfWithElse *p) { visit_children(p); }
+  void visitWhileLoop(WhileLoop *p) { visit_children(p); }
+  void visitCodeBlock(CodeBlock *p) { visit_children(p); }
+  void visitReturn(Return *p) { visit_children(p); }
+  void visitTInteger(TInteger *p) { visit_children(p); }
+  void visitTCharacter(TCharacter *p) { visit_children(p); }
+  void visitTBoolean(TBoolean *p) { visit_children(p); }
+  void visitTCharPtr(TCharPtr *p) { visit_children(p); }
+  void visitTIntPtr(TIntPtr *p) { visit_children(p); }
+  void visitTString(TString *p) { visit_children(p); }
+  void visitAbsoluteValue(AbsoluteValue *p) { visit_children(p); }
+  void visitAddressOf(AddressOf *p) { visit_children(p); }
+  void visitAnd(And *p) { visit_children(p); }
+  void visitDiv(Div *p) { visit_children(p); }
+  void visitCompare(Compare *p) { visit_children(p); }
+  void visitGt(Gt *p) { visit_children(p); }
+  void visitGteq(Gteq *p) { visit_children(p); }
+  void visitLt(Lt *p) { visit_children(p); }
+  void visitLteq(Lteq *p) { visit_children(p); }
+  void visitMinus(Minus *p) { visit_children(p); }
+  void visitNoteq(Noteq *p) { visit_children(p); }
+  void visitOr(Or *p) { visit_children(p); }
+  void visitPlus(Plus *p) { visit_children(p); }
+  void visitTimes(Times *p) { visit_children(p); }
+  void visitNot(Not *p) { visit_children(p); }
+  void visitUminus(Uminus *p) { visit_children(p); }
+  void visitIdent(Ident *p) { visit_children(p); }
+  void visitArrayAccess(ArrayAccess *p) { visit_children(p); }
+  void visitIntLit(IntLit *p) { visit_children(p); }
+  void visitCharLit(CharLit *p) { visit_children(p); }
+  void visitBoolLit(BoolLit *p) { visit_children(p); }
+  void visitNullLit(NullLit *p) { visit_children(p); }
+  void visitDeref(Deref *p) { visit_children(p); }
+  void visitVariable(Variable *p) { visit_children(p); }
+  void visitDerefVariable(DerefVariable *p) { visit_children(p); }
+  void visitArrayElement(ArrayElement *p) { visit_children(p); }
+};
+
+/********** Stack Visitor **********/
+
+// The same walk again without recursion, for a tree of any depth: where
+// Visitor and StaticVisitor take a C++ stack frame or two for each level,
+// and a long enough a + a + ... runs out of stack, walk(p) keeps the nodes
+// it is in on a stack of its own, in memory.  For each node X it calls
+//
+//   preX(p)       before the children; false leaves out the children and
+//                 postX
+//   stepX(p, i)   for the i-th child, from 0, which it gives to child():
+//                 a node is walked next, a SymName or a Primitive visited
+//                 (visitSymName and the rest).  false once there are no
+//                 more.
+//   postX(p)      after the children
+//
+// A pass derives from StackVisitor<Pass> and defines the ones it needs.
+// preX and postX call pre(Visitable *) and post(Visitable *), which do
+// nothing unless the pass defines them, for what it does the same for
+// every node; stepX goes through the children in the order of ast.cdef,
+// each item of a list a child.  A pass that does something between two
+// children, or goes through them another way, defines stepX itself, and
+// can call StackVisitor<Pass>::stepX for the usual child.  A step gives
+// child() one node at most, as the last thing it does.  A pass should not
+// define walk, child or resume.
+template<class Derived> class StackVisitor
+{
+ private:
+  struct Frame
+  {
+    Visitable *m_node;
+    unsigned m_next;      // the step to take next
+
+    Frame(Visitable *node) : m_node(node), m_next(0) {}
+  };
+
+  std::vector<Frame> m_stack;
+
+  Derived *self() { return static_cast<Derived *>(this); }
+
+  // Takes step i of p, with pre before the first and post after the
+  // last, and says whether p has more to come
+  bool resume(Visitable *p, unsigned i) {
+    switch(p->kind()) {
+      case nk_ProgramImpl: {
+        ProgramImpl *q = static_cast<ProgramImpl *>(p);
+        if(i == 0 && !self()->preProgramImpl(q)) {
+          return false;
+        }
+        if(self()->stepProgramImpl(q, i)) {
+          return true;
+        }
+        self()->postProgramImpl(q);
+        return false;
+      }
+      case nk_ProcImpl: {
+        ProcImpl *q = static_cast<ProcImpl *>(p);
+        if(i == 0 && !self()->preProcImpl(q)) {
+          return false;
+        }
+        if(self()->stepProcImpl(q, i)) {
+          return true;
+        }
+        self()->postProcImpl(q);
+        return false;
+      }
+      case nk_Procedure_blockImpl: {
+        Procedure_blockImpl *q = static_cast<Procedure_blockImpl *>(p);
+        if(i == 0 && !self()->preProcedure_blockImpl(q)) {
+          return false;
+        }
+        if(self()->stepProcedure_blockImpl(q, i)) {
+          return true;
+        }
+        self()->postProcedure_blockImpl(q);
+        return false;
+      }
+      case nk_Nested_blockImpl: {
+        Nested_blockImpl *q = static_cast<Nested_blockImpl *>(p);
+        if(i == 0 && !self()->preNested_blockImpl(q)) {
+          return false;
+        }
+        if(self()->stepNested_blockImpl(q, i)) {
+          return true;
+        }
+        self()->postNested_blockImpl(q);
+        return false;
+      }
+      case nk_DeclImpl: {
+        DeclImpl *q = static_cast<DeclImpl *>(p);
+        if(i == 0 && !self()->preDeclImpl(q)) {
+          return false;
+        }
+        if(self()->stepDeclImpl(q, i)) {
+          return true;
+        }
+        self()->postDeclImpl(q);
+        return false;
+      }
+      case nk_Assignment: {
+        Assignment *q = static_cast<Assignment *>(p);
+        if(i == 0 && !self()->preAssignment(q)) {
+          return false;
+        }
+        if(self()->stepAssignment(q, i)) {
+          return true;
+        }
+        self()->postAssignment(q);
+        return false;
+      }
+      case nk_StringAssignment: {
+        StringAssignment *q = static_cast<StringAssignment *>(p);
+        if(i == 0 && !self()->preStringAssignment(q)) {
+          return false;
+        }
+        if(self()->stepStringAssignment(q, i)) {
+          return true;
+        }
+        self()->postStringAssignment(q);
+        return false;
+      }
+      case nk_Call: {
+        Call *q = static_cast<Call *>(p);
+        if(i == 0 && !self()->preCall(q)) {
+          return false;
+        }
+        if(self()->stepCall(q, i)) {
+          return true;
+        }
+        self()->postCall(q);
+        return false;
+      }
+      case nk_IfNoElse: {
+        IfNoElse *q = static_cast<IfNoElse *>(p);
+        if(i == 0 && !self()->preIfNoElse(q)) {
+          return false;
+        }
+        if(self()->stepIfNoElse(q, i)) {
+          return true;
+        }
+        self()->postIfNoElse(q);
+        return false;
+      }
+      case nk_IfWithElse: {
+        IfWithElse *q = static_cast<IfWithElse *>(p);
+        if(i == 0 && !self()->preIfWithElse(q)) {
+          return false;
+        }
+        if(self()->stepIfWithElse(q, i)) {
+          return true;
+        }
+        self()->postIfWithElse(q);
+        return false;
+      }
+      case nk_WhileLoop: {
+        WhileLoop *q = static_cast<WhileLoop *>(p);
+        if(i == 0 && !self()->preWhileLoop(q)) {
+          return false;
+        }
+        if(self()->stepWhileLoop(q, i)) {
+          return true;
+        }
+        self()->postWhileLoop(q);
+        return false;
+      }
+      case nk_CodeBlock: {
+        CodeBlock *q = static_cast<CodeBlock *>(p);
+        if(i == 0 && !self()->preCodeBlock(q)) {
+          return false;
+        }
+        if(self()->stepCodeBlock(q, i)) {
+          return true;
+        }
+        self()->postCodeBlock(q);
+        return false;
+      }
+      case nk_Return: {
+        Return *q = static_cast<Return *>(p);
+        if(i == 0 && !self()->preReturn(q)) {
+          return false;
+        }
+        if(self()->stepReturn(q, i)) {
+          return true;
+        }
+        self()->postReturn(q);
+        return false;
+      }
+      case nk_TInteger: {
+        TInteger *q = static_cast<TInteger *>(p);
+        if(i == 0 && !self()->preTInteger(q)) {
+          return false;
+        }
+        if(self()->stepTInteger(q, i)) {
+          return true;
+        }
+        self()->postTInteger(q);
+        return false;
+      }
+      case nk_TCharacter: {
+        TCharacter *q = static_cast<TCharacter *>(p);
+        if(i == 0 && !self()->preTCharacter(q)) {
+          return false;
+        }
+        if(self()->stepTCharacter(q, i)) {
+          return true;
+        }
+        self()->postTCharacter(q);
+        return false;
+      }
+      case nk_TBoolean: {
+        TBoolean *q = static_cast<TBoolean *>(p);
+        if(i == 0 && !self()->preTBoolean(q)) {
+          return false;
+        }
+        if(self()->stepTBoolean(q, i)) {
+          return true;
+        }
+        self()->postTBoolean(q);
+        return false;
+      }
+      case nk_TCharPtr: {
+        TCharPtr *q = static_cast<TCharPtr *>(p);
+        if(i == 0 && !self()->preTCharPtr(q)) {
+          return false;
+        }
+        if(self()->stepTCharPtr(q, i)) {
+          return true;
+        }
+        self()->postTCharPtr(q);
+        return false;
+      }
+      case nk_TIntPtr: {
+        TIntPtr *q = static_cast<TIntPtr *>(p);
+        if(i == 0 && !self()->preTIntPtr(q)) {
+          return false;
+        }
+        if(self()->stepTIntPtr(q, i)) {
+          return true;
+        }
+        self()->postTIntPtr(q);
+        return false;
+      }
+      case nk_TString: {
+        TString *q = static_cast<TString *>(p);
+        if(i == 0 && !self()->preTString(q)) {
+          return false;
+        }
+        if(self()->stepTString(q, i)) {
+          return true;
+        }
+        self()->postTString(q);
+        return false;
+      }
+      case nk_AbsoluteValue: {
+        AbsoluteValue *q = static_cast<AbsoluteValue *>(p);
+        if(i == 0 && !self()->preAbsoluteValue(q)) {
+          return false;
+        }
+        if(self()->stepAbsoluteValue(q, i)) {
+          return true;
+        }
+        self()->postAbsoluteValue(q);
+        return false;
+      }
+      case nk_AddressOf: {
+        AddressOf *q = static_cast<AddressOf *>(p);
+        if(i == 0 && !self()->preAddressOf(q)) {
+          return false;
+        }
+        if(self()->stepAddressOf(q, i)) {
+          return true;
+        }
+        self()->postAddressOf(q);
+        return false;
+      }
+      case nk_And: {
+        And *q = static_cast<And *>(p);
+        if(i == 0 && !self()->preAnd(q)) {
+          return false;
+        }
+        if(self()->stepAnd(q, i)) {
+          return true;
+        }
+        self()->postAnd(q);
+        return false;
+      }
+      case nk_Div: {
+        Div *q = static_cast<Div *>(p);
+        if(i == 0 && !self()->preDiv(q)) {
+          return false;
+        }
+        if(self()->stepDiv(q, i)) {
+          return true;
+        }
+        self()->postDiv(q);
+        return false;
+      }
+      case nk_Compare: {
+        Compare *q = static_cast<Compare *>(p);
+        if(i == 0 && !self()->preCompare(q)) {
+          return false;
+        }
+        if(self()->stepCompare(q, i)) {
+          return true;
+        }
+        self()->postCompare(q);
+        return false;
+      }
+      case nk_Gt: {
+        Gt *q = static_cast<Gt *>(p);
+        if(i == 0 && !self()->preGt(q)) {
+          return false;
+        }
+        if(self()->stepGt(q, i)) {
+          return true;
+        }
+        self()->postGt(q);
+        return false;
+      }
+      case nk_Gteq: {
+        Gteq *q = static_cast<Gteq *>(p);
+        if(i == 0 && !self()->preGteq(q)) {
+          return false;
+        }
+        if(self()->stepGteq(q, i)) {
+          return true;
+        }
+        self()->postGteq(q);
+        return false;
+      }
+      case nk_Lt: {
+        Lt *q = static_cast<Lt *>(p);
+        if(i == 0 && !self()->preLt(q)) {
+          return false;
+        }
+        if(self()->stepLt(q, i)) {
+          return true;
+        }
+        self()->postLt(q);
+        return false;
+      }
+      case nk_Lteq: {
+        Lteq *q = static_cast<Lteq *>(p);
+        if(i == 0 && !self()->preLteq(q)) {
+          return false;
+        }
+        if(self()->stepLteq(q, i)) {
+          return true;
+        }
+        self()->postLteq(q);
+        return false;
+      }
+      case nk_Minus: {
+        Minus *q = static_cast<Minus *>(p);
+        if(i == 0 && !self()->preMinus(q)) {
+          return false;
+        }
+        if(self()->stepMinus(q, i)) {
+          return true;
+        }
+        self()->postMinus(q);
+        return false;
+      }
+      case nk_Noteq: {
+        Noteq *q = static_cast<Noteq *>(p);
+        if(i == 0 && !self()->preNoteq(q)) {
+          return false;
+        }
+        if(self()->stepNoteq(q, i)) {
+          return true;
+        }
+        self()->postNoteq(q);
+        return false;
+      }
+      case nk_Or: {
+        Or *q = static_cast<Or *>(p);
+        if(i == 0 && !self()->preOr(q)) {
+          return false;
+        }
+        if(self()->stepOr(q, i)) {
+          return true;
+        }
+        self()->postOr(q);
+        return false;
+      }
+      case nk_Plus: {
+        Plus *q = static_cast<Plus *>(p);
+        if(i == 0 && !self()->prePlus(q)) {
+          return false;
+        }
+        if(self()->stepPlus(q, i)) {
+          return true;
+        }
+        self()->postPlus(q);
+        return false;
+      }
+      case nk_Times: {
+        Times *q = static_cast<Times *>(p);
+        if(i == 0 && !self()->preTimes(q)) {
+          return false;
+        }
+        if(self()->stepTimes(q, i)) {
+          return true;
+        }
+        self()->postTimes(q);
+        return false;
+      }
+      case nk_Not: {
+        Not *q = static_cast<Not *>(p);
+        if(i == 0 && !self()->preNot(q)) {
+          return false;
+        }
+        if(self()->stepNot(q, i)) {
+          return true;
+        }
+        self()->postNot(q);
+        return false;
+      }
+      case nk_Uminus: {
+        Uminus *q = static_cast<Uminus *>(p);
+        if(i == 0 && !self()->preUminus(q)) {
+          return false;
+        }
+        if(self()->stepUminus(q, i)) {
+          return true;
+        }
+        self()->postUminus(q);
+        return false;
+      }
+      case nk_Ident: {
+        Ident *q = static_cast<Ident *>(p);
+        if(i == 0 && !self()->preIdent(q)) {
+          return false;
+        }
+        if(self()->stepIdent(q, i)) {
+          return true;
+        }
+        self()->postIdent(q);
+        return false;
+      }
+      case nk_ArrayAccess: {
+        ArrayAccess *q = static_cast<ArrayAccess *>(p);
+        if(i == 0 && !self()->preArrayAccess(q)) {
+          return false;
+        }
+        if(self()->stepArrayAccess(q, i)) {
+          return true;
+        }
+        self()->postArrayAccess(q);
+        return false;
+      }
+      case nk_IntLit: {
+        IntLit *q = static_cast<IntLit *>(p);
+        if(i == 0 && !self()->preIntLit(q)) {
+          return false;
+        }
+        if(self()->stepIntLit(q, i)) {
+          return true;
+        }
+        self()->postIntLit(q);
+        return false;
+      }
+      case nk_CharLit: {
+        CharLit *q = static_cast<CharLit *>(p);
+        if(i == 0 && !self()->preCharLit(q)) {
+          return false;
+        }
+        if(self()->stepCharLit(q, i)) {
+          return true;
+        }
+        self()->postCharLit(q);
+        return false;
+      }
+      case nk_BoolLit: {
+        BoolLit *q = static_cast<BoolLit *>(p);
+        if(i == 0 && !self()->preBoolLit(q)) {
+          return false;
+        }
+        if(self()->stepBoolLit(q, i)) {
+          return true;
+        }
+        self()->postBoolLit(q);
+        return false;
+      }
+      case nk_NullLit: {
+        NullLit *q = static_cast<NullLit *>(p);
+        if(i == 0 && !self()->preNullLit(q)) {
+          return false;
+        }
+        if(self()->stepNullLit(q, i)) {
+          return true;
+        }
+        self()->postNullLit(q);
+        return false;
+      }
+      case nk_Deref: {
+        Deref *q = static_cast<Deref *>(p);
+        if(i == 0 && !self()->preDeref(q)) {
+          return false;
+        }
+        if(self()->stepDeref(q, i)) {
+          return true;
+        }
+        self()->postDeref(q);
+        return false;
+      }
+      case nk_Variable: {
+        Variable *q = static_cast<Variable *>(p);
+        if(i == 0 && !self()->preVariable(q)) {
+          return false;
+        }
+        if(self()->stepVariable(q, i)) {
+          return true;
+        }
+        self()->postVariable(q);
+        return false;
+      }
+      case nk_DerefVariable: {
+        DerefVariable *q = static_cast<DerefVariable *>(p);
+        if(i == 0 && !self()->preDerefVariable(q)) {
+          return false;
+        }
+        if(self()->stepDerefVariable(q, i)) {
+          return true;
+        }
+        self()->postDerefVariable(q);
+        return false;
+      }
+      case nk_ArrayElement: {
+        ArrayElement *q = static_cast<ArrayElement *>(p);
+        if(i == 0 && !self()->preArrayElement(q)) {
+          return false;
+        }
+        if(self()->stepArrayElement(q, i)) {
+          return true;
+        }
+        self()->postArrayElement(q);
+        return false;
+      }
+      case nk_count:
+        break;
+    }
+    return false;
+  }
+
+ public:
+  void walk(Visitable *p) {
+    size_t bottom = m_stack.size();
+    child(p);
+    while(m_stack.size() > bottom) {
+      Frame &f = m_stack.back();
+      if(!resume(f.m_node, f.m_next++)) {
+        m_stack.pop_back();
+      }
+    }
+  }
+
+  void child(Visitable *p) {
+    m_stack.push_back(Frame(p));
+  }
+  void child(SymName *p) { self()->visitSymName(p); }
+  void child(Primitive *p) { self()->visitPrimitive(p); }
+  void child(StringPrimitive *p) { self()->visitStringPrimitive(p); }
+  bool pre(Visitable *) { return true; }
+  void post(Visitable *) {}
+
+  bool stepProgramImpl(ProgramImpl *p, unsigned i) {
+    if(i < p->m_proc_list->size()) {
+      child((*p->m_proc_list)[i]);
+      return true;
+    }
+    return false;
+  }
+  bool stepProcImpl(ProcImpl *p, unsigned i) {
+    if(i == 0) {
+      child(&p->m_symname);
+      return true;
+    }
+    --i;
+    if(i < p->m_decl_list->size()) {
+      child((*p->m_decl_list)[i]);
+      return true;
+    }
+    i -= p->m_decl_list->size();
+    if(i == 0) {
+      child(p->m_type);
+      return true;
+    }
+    --i;
+    if(i == 0) {
+      child(p->m_procedure_block);
+      return true;
+    }
+    return false;
+  }
+  bool stepProcedure_blockImpl(Procedure_blockImpl *p, unsigned i) {
+    if(i < p->m_proc_list->size()) {
+      child((*p->m_proc_list)[i]);
+      return true;
+    }
+    i -= p->m_proc_list->size();
+    if(i < p->m_decl_list->size()) {
+      child((*p->m_decl_list)[i]);
+      return true;
+    }
+    i -= p->m_decl_list->size();
+    if(i < p->m_stat_list->size()) {
+      child((*p->m_stat_list)[i]);
+      return true;
+    }
+    i -= p->m_stat_list->size();
+    if(i == 0) {
+      child(p->m_return_stat);
+      return true;
+    }
+    return false;
+  }
+  bool stepNested_blockImpl(Nested_blockImpl *p, unsigned i) {
+    if(i < p->m_decl_list->size()) {
+      child((*p->m_decl_list)[i]);
+      return true;
+    }
+    i -= p->m_decl_list->size();
+    if(i < p->m_stat_list->size()) {
+      child((*p->m_stat_list)[i]);
+      return true;
+    }
+    return false;
+  }
+  bool stepDeclImpl(DeclImpl *p, unsigned i) {
+    if(i < p->m_symname_list->size()) {
+      child((*p->m_symname_list)[i]);
+      return true;
+    }
+    i -= p->m_symname_list->size();
+    if(i == 0) {
+      child(p->m_type);
+      return true;
+    }
+    return false;
+  }
+  bool stepAssignment(Assignment *p, unsigned i) {
+    if(i == 0) {
+      child(p->m_lhs);
+      return true;
+    }
+    --i;
+    if(i == 0) {
+      child(p->m_expr);
+      return true;
+    }
+    return false;
+  }
+  bool stepStringAssignment(StringAssignment *p, unsigned i) {
+    if(i == 0) {
+      child(p->m_lhs);
+      return true;
+    }
+    --i;
+    if(i == 0) {
+      child(p->m_stringprimitive);
+      return true;
+    }
+    return false;
+  }
+  bool stepCall(Call *p, unsigned i) {
+    if(i == 0) {
+      child(p->m_lhs);
+      return true;
+    }
+    --i;
+    if(i == 0) {
+      child(&p->m_symname);
+      return true;
+    }
+    --i;
+    if(i < p->m_expr_list->size()) {
+      child((*p->m_expr_list)[i]);
+      return true;
+    }
+    return false;
+  }
+  bool stepIfNoElse(IfNoElse *p, unsigned i) {
+    if(i == 0) {
+      child(p->m_expr);
+      return true;
+    }
+    --i;
+    if(i == 0) {
+      child(p->m_nested_block);
+      return true;
+    }
+    return false;
+  }
+  bool stepIfWithElse(IfWithElse *p, unsigned i) {
+    if(i == 0) {
+      child(p->m_expr);
+      return true;
+    }
+    --i;
+    if(i == 0) {
+      child(p->m_nested_block_1);
+      return true;
+    }
+    --i;
+    if(i == 0) {
+      child(p->m_nested_block_2);
+      return true;
+    }
+    return false;
+  }
+  bool stepWhileLoop(WhileLoop *p, unsigned i) {
+    if(i == 0) {
+      child(p->m_expr);
+      return true;
+    }
+    --i;
+    if(i == 0) {
+      child(p->m_nested_block);
+      return true;
+    }
+    return false;
+  }
+  bool stepCodeBlock(CodeBlock *p, unsigned i) {
+    if(i == 0) {
+      child(p->m_nested_block);
+      return true;
+    }
+    return false;
+  }
+  bool stepReturn(Return *p, unsigned i) {
+    if(i == 0) {
+      child(p->m_expr);
+      return true;
+    }
+    return false;
+  }
+  bool stepTInteger(TInteger *, unsigned) {
+    return false;
+  }
+  bool stepTCharacter(TCharacter *, unsigned) {
+    return false;
+  }
+  bool stepTBoolean(TBoolean *, unsigned) {
+    return false;
+  }
+  bool stepTCharPtr(TCharPtr *, unsigned) {
+    return false;
+  }
+  bool stepTIntPtr(TIntPtr *, unsigned) {
+    return false;
+  }
+  bool stepTString(TString *p, unsigned i) {
+    if(i == 0) {
+      child(&p->m_primitive);
+      return true;
+    }
+    return false;
+  }
+  bool stepAbsoluteValue(AbsoluteValue *p, unsigned i) {
+    if(i == 0) {
+      child(p->m_expr);
+      return true;
+    }
+    return false;
+  }
+  bool stepAddressOf(AddressOf *p, unsigned i) {
+    if(i == 0) {
+      child(p->m_lhs);
+      return true;
+    }
+    return false;
+  }
+  bool stepAnd(And *p, unsigned i) {
+    if(i == 0) {
+      child(p->m_expr_1);
+      return true;
+    }
+    --i;
+    if(i == 0) {
+      child(p->m_expr_2);
+      return true;
+    }
+    return false;
+  }
+  bool stepDiv(Div *p, unsigned i) {
+    if(i == 0) {
+      child(p->m_expr_1);
+      return true;
+    }
+    --i;
+    if(i == 0) {
+      child(p->m_expr_2);
+      return true;
+    }
+    return false;
+  }
+  bool stepCompare(Compare *p, unsigned i) {
+    if(i == 0) {
+      child(p->m_expr_1);
+      return true;
+    }
+    --i;
+    if(i == 0) {
+      child(p->m_expr_2);
+      return true;
+    }
+    return false;
+  }
+  bool stepGt(Gt *p, unsigned i) {
+    if(i == 0) {
+      child(p->m_expr_1);
+      return true;
+    }
+    --i;
+    if(i == 0) {
+      child(p->m_expr_2);
+      return true;
+    }
+    return false;
+  }
+  bool stepGteq(Gteq *p, unsigned i) {
+    if(i == 0) {
+      child(p->m_expr_1);
+      return true;
+    }
+    --i;
+    if(i == 0) {
+      child(p->m_expr_2);
+      return true;
+    }
+    return false;
+  }
+  bool stepLt(Lt *p, unsigned i) {
+    if(i == 0) {
+      child(p->m_expr_1);
+      return true;
+    }
+    --i;
+    if(i == 0) {
+      child(p->m_expr_2);
+      return true;
+    }
+    return false;
+  }
+  bool stepLteq(Lteq *p, unsigned i) {
+    if(i == 0) {
+      child(p->m_expr_1);
+      return true;
+    }
+    --i;
+    if(i == 0) {
+      child(p->m_expr_2);
+      return true;
+    }
+    return false;
+  }
+  bool stepMinus(Minus *p, unsigned i) {
+    if(i == 0) {
+      child(p->m_expr_1);
+      return true;
+    }
+    --i;
+    if(i == 0) {
+      child(p->m_expr_2);
+      return true;
+    }
+    return false;
+  }
+  bool stepNoteq(Noteq *p, unsigned i) {
+    if(i == 0) {
+      child(p->m_expr_1);
+      return true;
+    }
+    --i;
+    if(i == 0) {
+      child(p->m_expr_2);
+      return true;
+    }
+    return false;
+  }
+  bool stepOr(Or *p, unsigned i) {
+    if(i == 0) {
+      child(p->m_expr_1);
+      return true;
+    }
+    --i;
+    if(i == 0) {
+      child(p->m_expr_2);
+      return true;
+    }
+    return false;
+  }
+  bool stepPlus(Plus *p, unsigned i) {
+    if(i == 0) {
+      child(p->m_expr_1);
+      return true;
+    }
+    --i;
+    if(i == 0) {
+      child(p->m_expr_2);
+      return true;
+    }
+    return false;
+  }
+  bool stepTimes(Times *p, unsigned i) {
+    if(i == 0) {
+      child(p->m_expr_1);
+      return true;
+    }
+    --i;
+    if(i == 0) {
+      child(p->m_expr_2);
+      return true;
+    }
+    return false;
+  }
+  bool stepNot(Not *p, unsigned i) {
+    if(i == 0) {
+      child(p->m_expr);
+      return true;
+    }
+    return false;
+  }
+  bool stepUminus(Uminus *p, unsigned i) {
+    if(i == 0) {
+      child(p->m_expr);
+      return true;
+    }
+    return false;
+  }
+  bool stepIdent(Ident *p, unsigned i) {
+    if(i == 0) {
+      child(&p->m_symname);
+      return true;
+    }
+    return false;
+  }
+  bool stepArrayAccess(ArrayAccess *p, unsigned i) {
+    if(i == 0) {
+      child(&p->m_symname);
+      return true;
+    }
+    --i;
+    if(i == 0) {
+      child(p->m_expr);
+      return true;
+    }
+    return false;
+  }
+  bool stepIntLit(IntLit *p, unsigned i) {
+    if(i == 0) {
+      child(&p->m_primitive);
+      return true;
+    }
+    return false;
+  }
+  bool stepCharLit(CharLit *p, unsigned i) {
+    if(i == 0) {
+      child(&p->m_primitive);
+      return true;
+    }
+    return false;
+  }
+  bool stepBoolLit(BoolLit *p, unsigned i) {
+    if(i == 0) {
+      child(&p->m_primitive);
+      return true;
+    }
+    return false;
+  }
+  bool stepNullLit(NullLit *, unsigned) {
+    return false;
+  }
+  bool stepDeref(Deref *p, unsigned i) {
+    if(i == 0) {
+      child(p->m_expr);
+      return true;
+    }
+    return false;
+  }
+  bool stepVariable(Variable *p, unsigned i) {
+    if(i == 0) {
+      child(&p->m_symname);
+      return true;
+    }
+    return false;
+  }
+  bool stepDerefVariable(DerefVariable *p, unsigned i) {
+    if(i == 0) {
+      child(&p->m_symname);
+      return true;
+    }
+    return false;
+  }
+  bool stepArrayElement(ArrayElement *p, unsigned i) {
+    if(i == 0) {
+      child(&p->m_symname);
+      return true;
+    }
+    --i;
+    if(i == 0) {
+      child(p->m_expr);
+      return true;
+    }
+    return false;
+  }
+  void visitSymName(SymName *) {}
+  void visitPrimitive(Primitive *) {}
+  void visitStringPrimitive(StringPrimitive *) {}
+  bool preProgramImpl(ProgramImpl *p) { return self()->pre(p); }
+  void postProgramImpl(ProgramImpl *p) { self()->post(p); }
+  bool preProcImpl(ProcImpl *p) { return self()->pre(p); }
+  void postProcImpl(ProcImpl *p) { self()->post(p); }
+  bool preProcedure_blockImpl(Procedure_blockImpl *p) { return self()->pre(p); }
+  void postProcedure_blockImpl(Procedure_blockImpl *p) { self()->post(p); }
+  bool preNested_blockImpl(Nested_blockImpl *p) { return self()->pre(p); }
+  void postNested_blockImpl(Nested_blockImpl *p) { self()->post(p); }
+  bool preDeclImpl(DeclImpl *p) { return self()->pre(p); }
+  void postDeclImpl(DeclImpl *p) { self()->post(p); }
+  bool preAssignment(Assignment *p) { return self()->pre(p); }
+  void postAssignment(Assignment *p) { self()->post(p); }
+  bool preStringAssignment(StringAssignment *p) { return self()->pre(p); }
+  void postStringAssignment(StringAssignment *p) { self()->post(p); }
+  bool preCall(Call *p) { return self()->pre(p); }
+  void postCall(Call *p) { self()->post(p); }
+  bool preIfNoElse(IfNoElse *p) { return self()->pre(p); }
+  void postIfNoElse(IfNoElse *p) { self()->post(p); }
+  bool preIfWithElse(IfWithElse *p) { return self()->pre(p); }
+  void postIfWithElse(IfWithElse *p) { self()->post(p); }
+  bool preWhileLoop(WhileLoop *p) { return self()->pre(p); }
+  void postWhileLoop(WhileLoop *p) { self()->post(p); }
+  bool preCodeBlock(CodeBlock *p) { return self()->pre(p); }
+  void postCodeBlock(CodeBlock *p) { self()->post(p); }
+  bool preReturn(Return *p) { return self()->pre(p); }
+  void postReturn(Return *p) { self()->post(p); }
+  bool preTInteger(TInteger *p) { return self()->pre(p); }
+  void postTInteger(TInteger *p) { self()->post(p); }
+  bool preTCharacter(TCharacter *p) { return self()->pre(p); }
+  void postTCharacter(TCharacter *p) { self()->post(p); }
+  bool preTBoolean(TBoolean *p) { return self()->pre(p); }
+  void postTBoolean(TBoolean *p) { self()->post(p); }
+  bool preTCharPtr(TCharPtr *p) { return self()->pre(p); }
+  void postTCharPtr(TCharPtr *p) { self()->post(p); }
+  bool preTIntPtr(TIntPtr *p) { return self()->pre(p); }
+  void postTIntPtr(TIntPtr *p) { self()->post(p); }
+  bool preTString(TString *p) { return self()->pre(p); }
+  void postTString(TString *p) { self()->post(p); }
+  bool preAbsoluteValue(AbsoluteValue *p) { return self()->pre(p); }
+  void postAbsoluteValue(AbsoluteValue *p) { self()->post(p); }
+  bool preAddressOf(AddressOf *p) { return self()->pre(p); }
+  void postAddressOf(AddressOf *p) { self()->post(p); }
+  bool preAnd(And *p) { return self()->pre(p); }
+  void postAnd(And *p) { self()->post(p); }
+  bool preDiv(Div *p) { return self()->pre(p); }
+  void postDiv(Div *p) { self()->post(p); }
+  bool preCompare(Compare *p) { return self()->pre(p); }
+  void postCompare(Compare *p) { self()->post(p); }
+  bool preGt(Gt *p) { return self()->pre(p); }
+  void postGt(Gt *p) { self()->post(p); }
+  bool preGteq(Gteq *p) { return self()->pre(p); }
+  void postGteq(Gteq *p) { self()->post(p); }
+  bool preLt(Lt *p) { return self()->pre(p); }
+  void postLt(Lt *p) { self()->post(p); }
+  bool preLteq(Lteq *p) { return self()->pre(p); }
+  void postLteq(Lteq *p) { self()->post(p); }
+  bool preMinus(Minus *p) { return self()->pre(p); }
+  void postMinus(Minus *p) { self()->post(p); }
+  bool preNoteq(Noteq *p) { return self()->pre(p); }
+  void postNoteq(Noteq *p) { self()->post(p); }
+  bool preOr(Or *p) { return self()->pre(p); }
+  void postOr(Or *p) { self()->post(p); }
+  bool prePlus(Plus *p) { return self()->pre(p); }
+  void postPlus(Plus *p) { self()->post(p); }
+  bool preTimes(Times *p) { return self()->pre(p); }
+  void postTimes(Times *p) { self()->post(p); }
+  bool preNot(Not *p) { return self()->pre(p); }
+  void postNot(Not *p) { self()->post(p); }
+  bool preUminus(Uminus *p) { return self()->pre(p); }
+  void postUminus(Uminus *p) { self()->post(p); }
+  bool preIdent(Ident *p) { return self()->pre(p); }
+  void postIdent(Ident *p) { self()->post(p); }
+  bool preArrayAccess(ArrayAccess *p) { return self()->pre(p); }
+  void postArrayAccess(ArrayAccess *p) { self()->post(p); }
+  bool preIntLit(IntLit *p) { return self()->pre(p); }
+  void postIntLit(IntLit *p) { self()->post(p); }
+  bool preCharLit(CharLit *p) { return self()->pre(p); }
+  void postCharLit(CharLit *p) { self()->post(p); }
+  bool preBoolLit(BoolLit *p) { return self()->pre(p); }
+  void postBoolLit(BoolLit *p) { self()->post(p); }
+  bool preNullLit(NullLit *p) { return self()->pre(p); }
+  void postNullLit(NullLit *p) { self()->post(p); }
+  bool preDeref(Deref *p) { return self()->pre(p); }
+  void postDeref(Deref *p) { self()->post(p); }
+  bool preVariable(Variable *p) { return self()->pre(p); }
+  void postVariable(Variable *p) { self()->post(p); }
+  bool preDerefVariable(DerefVariable *p) { return self()->pre(p); }
+  void postDerefVariable(DerefVariable *p) { self()->post(p); }
+  bool preArrayElement(ArrayElement *p) { return self()->pre(p); }
+  void postArrayElement(ArrayElement *p) { self()->post(p); }
+};
 
 
 #endif //AST_HEADER
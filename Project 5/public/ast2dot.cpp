@@ -5,7 +5,10 @@
 #include <cstdio>
 #include <stack>
 
-class Ast2dot : public Visitor
+// Each node is drawn before its children (preX), and is their parent
+// until it is done with them (post).  The walk is a StackVisitor's, so a
+// deep expression does not run out of stack.
+class Ast2dot : public StackVisitor<Ast2dot>
 {
     private:
     FILE *m_out;        // File for writting output
@@ -37,13 +40,17 @@ class Ast2dot : public Visitor
         std::fprintf(m_out, "\"%d\" [label=\"%s\"]\n" , c, n);
     }
 
-    void draw(const char* n, Visitable* p)
+    bool draw(const char* n, Visitable*)
     {
        count++;                         // Each node gets a unique number
        add_edge(s.top(), count);        // From parent to this
        add_node(count, n);              // Name the this node
        s.push(count);                   // This node is the parent
-       p->visit_children(this);
+       return true;
+    }
+
+    void post(Visitable*)
+    {
        s.pop();                         // Restore old parent
     }
 
@@ -69,56 +76,56 @@ class Ast2dot : public Visitor
        std::fprintf(m_out, "\"%d\" [label=\"%s\\n\\\"%s\\\"\"]\n" , count, n, p->m_string);
     }
 
-    void visitProgramImpl(ProgramImpl *p) { draw("ProgramImpl", p); }
-    void visitProcImpl(ProcImpl *p) { draw("ProcImpl", p); }
-    void visitProcedure_blockImpl(Procedure_blockImpl *p) { draw("ProcedureBlockImpl", p); }
-    void visitNested_blockImpl(Nested_blockImpl *p) { draw("NestedBlockImpl", p); }
-    void visitDeclImpl(DeclImpl *p) { draw("DeclImpl", p); }
-    void visitAssignment(Assignment *p) { draw("Assignment", p); }
-    void visitStringAssignment(StringAssignment *p) { draw("StringAssignment", p); }
-    void visitCall(Call *p) { draw("Call", p); }
-    void visitReturn(Return *p) { draw("Return", p); }
-    void visitIfNoElse(IfNoElse *p) { draw("IfNoElse", p); }
-    void visitIfWithElse(IfWithElse *p) { draw("IfWithElse", p); }
-    void visitWhileLoop(WhileLoop *p) { draw("WhileLoop", p); }
-    void visitCodeBlock(CodeBlock *p) { draw("CodeBlock", p); }
-
-    void visitTInteger(TInteger *p) { draw("TInteger", p); }
-    void visitTIntPtr(TIntPtr *p) { draw("TIntPtr", p); };
-    void visitTBoolean(TBoolean *p) { draw("TBoolean", p); }
-    void visitTCharacter(TCharacter *p) { draw("TCharacter", p); }
-    void visitTCharPtr(TCharPtr *p) { draw("TCharPtr", p); };
-    void visitTString(TString *p) { draw("TString", p); }
-
-    void visitAbsoluteValue(AbsoluteValue *p) { draw("AbsoluteValue", p); };
-    void visitAddressOf(AddressOf *p) { draw("AddressOf", p); };
-    void visitAnd(And *p) { draw("And", p); }
-    void visitDiv(Div *p) { draw("Div", p); }
-    void visitCompare(Compare *p) { draw("Compare", p); }
-    void visitGt(Gt *p) { draw("Gt", p); }
-    void visitGteq(Gteq *p) { draw("Gteq", p); }
-    void visitLt(Lt *p) { draw("Lt", p); }
-    void visitLteq(Lteq *p) { draw("Lteq", p); }
-    void visitMinus(Minus *p) { draw("Minus", p); }
-    void visitNoteq(Noteq *p) { draw("Noteq", p); }
-    void visitOr(Or *p) { draw("Or", p); }
-    void visitPlus(Plus *p) { draw("Plus", p); }
-    void visitTimes(Times *p) { draw("Times", p); }
-    void visitNot(Not *p) { draw("Not", p); }
-    void visitUminus(Uminus *p) { draw("Uminus", p); }
-
-    void visitIdent(Ident *p) { draw("Ident", p); }
-    void visitArrayAccess(ArrayAccess *p) { draw("ArrayAccess", p); }
-    void visitIntLit(IntLit *p) { draw("IntLit", p); }
-    void visitCharLit(CharLit *p) { draw("CharLit", p); }
-    void visitBoolLit(BoolLit *p) { draw("BoolLit", p); }
-    void visitNullLit(NullLit *p) { draw("NullLit", p); }
+    bool preProgramImpl(ProgramImpl *p) { return draw("ProgramImpl", p); }
+    bool preProcImpl(ProcImpl *p) { return draw("ProcImpl", p); }
+    bool preProcedure_blockImpl(Procedure_blockImpl *p) { return draw("ProcedureBlockImpl", p); }
+    bool preNested_blockImpl(Nested_blockImpl *p) { return draw("NestedBlockImpl", p); }
+    bool preDeclImpl(DeclImpl *p) { return draw("DeclImpl", p); }
+    bool preAssignment(Assignment *p) { return draw("Assignment", p); }
+    bool preStringAssignment(StringAssignment *p) { return draw("StringAssignment", p); }
+    bool preCall(Call *p) { return draw("Call", p); }
+    bool preReturn(Return *p) { return draw("Return", p); }
+    bool preIfNoElse(IfNoElse *p) { return draw("IfNoElse", p); }
+    bool preIfWithElse(IfWithElse *p) { return draw("IfWithElse", p); }
+    bool preWhileLoop(WhileLoop *p) { return draw("WhileLoop", p); }
+    bool preCodeBlock(CodeBlock *p) { return draw("CodeBlock", p); }
+
+    bool preTInteger(TInteger *p) { return draw("TInteger", p); }
+    bool preTIntPtr(TIntPtr *p) { return draw("TIntPtr", p); };
+    bool preTBoolean(TBoolean *p) { return draw("TBoolean", p); }
+    bool preTCharacter(TCharacter *p) { return draw("TCharacter", p); }
+    bool preTCharPtr(TCharPtr *p) { return draw("TCharPtr", p); };
+    bool preTString(TString *p) { return draw("TString", p); }
+
+    bool preAbsoluteValue(AbsoluteValue *p) { return draw("AbsoluteValue", p); };
+    bool preAddressOf(AddressOf *p) { return draw("AddressOf", p); };
+    bool preAnd(And *p) { return draw("And", p); }
+    bool preDiv(Div *p) { return draw("Div", p); }
+    bool preCompare(Compare *p) { return draw("Compare", p); }
+    bool preGt(Gt *p) { return draw("Gt", p); }
+    bool preGteq(Gteq *p) { return draw("Gteq", p); }
+    bool preLt(Lt *p) { return draw("Lt", p); }
+    bool preLteq(Lteq *p) { return draw("Lteq", p); }
+    bool preMinus(Minus *p) { return draw("Minus", p); }
+    bool preNoteq(Noteq *p) { return draw("Noteq", p); }
+    bool preOr(Or *p) { return draw("Or", p); }
+    bool prePlus(Plus *p) { return draw("Plus", p); }
+    bool preTimes(Times *p) { return draw("Times", p); }
+    bool preNot(Not *p) { return draw("Not", p); }
+    bool preUminus(Uminus *p) { return draw("Uminus", p); }
+
+    bool preIdent(Ident *p) { return draw("Ident", p); }
+    bool preArrayAccess(ArrayAccess *p) { return draw("ArrayAccess", p); }
+    bool preIntLit(IntLit *p) { return draw("IntLit", p); }
+    bool preCharLit(CharLit *p) { return draw("CharLit", p); }
+    bool preBoolLit(BoolLit *p) { return draw("BoolLit", p); }
+    bool preNullLit(NullLit *p) { return draw("NullLit", p); }
 
     /* LHS */
-    void visitDeref(Deref *p) { draw("Deref", p); };
-    void visitVariable(Variable *p) { draw("Variable", p); };
-    void visitDerefVariable(DerefVariable *p) { draw("DerefVariable", p); };
-    void visitArrayElement(ArrayElement *p) { draw("ArrayElement", p); };
+    bool preDeref(Deref *p) { return draw("Deref", p); };
+    bool preVariable(Variable *p) { return draw("Variable", p); };
+    bool preDerefVariable(DerefVariable *p) { return draw("DerefVariable", p); };
+    bool preArrayElement(ArrayElement *p) { return draw("ArrayElement", p); };
 
     // Special cases
     void visitSymName(SymName *p) { draw_symname("SymName",p); }
@@ -126,10 +133,10 @@ class Ast2dot : public Visitor
     void visitStringPrimitive(StringPrimitive *p) { draw_string_primitive("StringPrimitive",p); }
 };
 
-void dopass_ast2dot(Program_ptr ast)
+void dopass_ast2dot(Program_ptr ast, FILE* out)
 {
-    Ast2dot* ast2dot = new Ast2dot(stdout);     // Create new visitor
-    ast->accept(ast2dot);                       // Walk the tree with the visitor above
+    Ast2dot* ast2dot = new Ast2dot(out);        // Create new visitor
+    ast2dot->walk(ast);                         // Walk the tree with the visitor above
     ast2dot->finish();                          // Finalize printout
     delete ast2dot;
 }
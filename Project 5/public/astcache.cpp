@@ -0,0 +1,265 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "astcache.hpp"
+#include "strpool.hpp"
+
+// Changes whenever the format does; a change to ast.cdef changes
+// ast_layout instead
+static const char MAGIC[8] = { 'c', 's', 'a', 's', 't', '0', '0', '1' };
+
+// FNV-1a, 64 bits
+unsigned long long ast_cache_key(const char* text, size_t size)
+{
+    unsigned long long h = 14695981039346656037ULL;
+    for(size_t i = 0; i < size; ++i) {
+        h = (h ^ (unsigned char) text[i]) * 1099511628211ULL;
+    }
+    return h;
+}
+
+static unsigned long long layout_key()
+{
+    return ast_cache_key(ast_layout, strlen(ast_layout));
+}
+
+AstWriter::AstWriter()
+{
+    m_too_big = false;
+}
+
+unsigned AstWriter::string(const char* s)
+{
+    m_strings.push_back(m_chars.size());
+    m_chars.append(s, strlen(s) + 1);
+    return m_strings.size() - 1;
+}
+
+// The spellings are interned, so each name is looked up by its pointer
+unsigned AstWriter::write(SymName* p)
+{
+    const char* spelling = p->spelling();
+    std::unordered_map<const char*, unsigned>::iterator it =
+        m_names.find(spelling);
+    if(it != m_names.end()) {
+        return it->second;
+    }
+    unsigned i = string(spelling);
+    m_names[spelling] = i;
+    return i;
+}
+
+unsigned AstWriter::write(Primitive* p)
+{
+    return p->m_data;
+}
+
+unsigned AstWriter::write(StringPrimitive* p)
+{
+    std::string s(p->m_string);
+    std::unordered_map<std::string, unsigned>::iterator it =
+        m_literals.find(s);
+    if(it != m_literals.end()) {
+        return it->second;
+    }
+    unsigned i = string(p->m_string);
+    m_literals[s] = i;
+    return i;
+}
+
+unsigned AstWriter::node(NodeKind kind, int lineno, int children)
+{
+    if(lineno < 0 || lineno >= 1 << 24) {
+        m_too_big = true;
+    }
+    unsigned at = m_words.size();
+    m_words.push_back(kind | (unsigned) lineno << 8);
+    m_words.resize(at + 1 + children);
+    return at;
+}
+
+bool AstWriter::save(const char* path, Program_ptr ast,
+                     unsigned long long key, size_t size, unsigned flags,
+                     const std::string& output)
+{
+    AstCacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.layout = layout_key();
+    header.source = key;
+    header.source_size = size;
+    header.flags = flags;
+    header.root = ast_write(this, ast);
+    if(m_too_big || m_words.size() >= 1u << 31 || m_chars.size() >= 1u << 31
+       || output.size() >= 1u << 31) {
+        return false;
+    }
+    header.words = m_words.size();
+    header.strings = m_strings.size();
+    header.chars = m_chars.size();
+    header.output = output.size();
+
+    std::string temp = std::string(path) + ".XXXXXX";
+    int fd = mkstemp(&temp[0]);
+    if(fd < 0) {
+        return false;
+    }
+    FILE* f = fdopen(fd, "wb");
+    if(f == NULL) {
+        ::close(fd);
+        unlink(temp.c_str());
+        return false;
+    }
+    fwrite(&header, sizeof(header), 1, f);
+    fwrite(m_words.data(), sizeof(unsigned), m_words.size(), f);
+    fwrite(m_strings.data(), sizeof(unsigned), m_strings.size(), f);
+    fwrite(m_chars.data(), 1, m_chars.size(), f);
+    fwrite(output.data(), 1, output.size(), f);
+    bool ok = !ferror(f);
+    ok = fclose(f) == 0 && ok;
+    if(!ok || rename(temp.c_str(), path) != 0) {
+        unlink(temp.c_str());
+        return false;
+    }
+    return true;
+}
+
+AstReader::AstReader(StringPool* strpool)
+{
+    m_strpool = strpool;
+    m_map = NULL;
+    m_map_size = 0;
+    m_header = NULL;
+    m_words = NULL;
+    m_strings = NULL;
+    m_chars = NULL;
+    m_failed = false;
+}
+
+AstReader::~AstReader()
+{
+    if(m_map) {
+        munmap(m_map, m_map_size);
+    }
+}
+
+bool AstReader::open(const char* path, unsigned long long key, size_t size,
+                     unsigned flags)
+{
+    int fd = ::open(path, O_RDONLY);
+    if(fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if(fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(AstCacheHeader)) {
+        close(fd);
+        return false;
+    }
+    void* map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if(map == MAP_FAILED) {
+        return false;
+    }
+
+    const AstCacheHeader* header = (const AstCacheHeader*) map;
+    size_t needed = sizeof(AstCacheHeader)
+        + ((size_t) header->words + header->strings) * sizeof(unsigned)
+        + header->chars + header->output;
+    if(memcmp(header->magic, MAGIC, sizeof(MAGIC))
+       || header->layout != layout_key()
+       || header->source != key || header->source_size != size
+       || header->flags != flags || needed != (size_t) st.st_size
+       || header->root >= header->words) {
+        munmap(map, st.st_size);
+        return false;
+    }
+
+    // Every string must start, and end, among the characters
+    const unsigned* strings = (const unsigned*) (header + 1) + header->words;
+    const char* chars = (const char*) (strings + header->strings);
+    bool ok = header->chars == 0 || chars[header->chars - 1] == '\0';
+    for(unsigned i = 0; ok && i < header->strings; ++i) {
+        ok = strings[i] < header->chars;
+    }
+    if(!ok) {
+        munmap(map, st.st_size);
+        return false;
+    }
+
+    m_map = map;
+    m_map_size = st.st_size;
+    m_header = header;
+    m_words = (const unsigned*) (header + 1);
+    m_strings = m_words + header->words;
+    m_chars = (const char*) (m_strings + header->strings);
+    m_names.assign(header->strings, NULL);
+    m_read.assign(header->words, 0);
+    m_failed = false;
+    return true;
+}
+
+Program_ptr AstReader::root()
+{
+    m_read[m_header->root] = 1;
+    ProgramImpl* program = dyn_cast<ProgramImpl>(ast_read(this,
+                                                          m_header->root));
+    if(!check(program != NULL)) {
+        m_frames.clear();
+        m_made.clear();
+        return NULL;
+    }
+    return program;
+}
+
+const char* AstReader::output()
+{
+    return m_chars + m_header->chars;
+}
+
+size_t AstReader::output_size()
+{
+    return m_header->output;
+}
+
+// A name that is not in the table is the empty one, and the file is wrong
+const char* AstReader::name(unsigned at)
+{
+    if(!check(at < m_header->words && m_words[at] < m_header->strings)) {
+        return "";
+    }
+    unsigned i = m_words[at];
+    if(m_names[i] == NULL) {
+        m_names[i] = m_strpool->intern(m_chars + m_strings[i]);
+    }
+    return m_names[i];
+}
+
+void AstReader::field(unsigned at, SymName** child)
+{
+    *child = new SymName(name(at));
+}
+
+void AstReader::field(unsigned at, SymName* child)
+{
+    *child = SymName(name(at));
+}
+
+void AstReader::field(unsigned at, Primitive* child)
+{
+    *child = Primitive(check(at < m_header->words) ? (int) m_words[at] : 0);
+}
+
+void AstReader::field(unsigned at, StringPrimitive** child)
+{
+    const char* s = "";
+    if(check(at < m_header->words && m_words[at] < m_header->strings)) {
+        s = m_chars + m_strings[m_words[at]];
+    }
+    *child = new StringPrimitive(s);
+}
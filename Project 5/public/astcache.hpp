@@ -0,0 +1,332 @@
+#ifndef ASTCACHE_HPP
+#define ASTCACHE_HPP
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "ast.hpp"
+#include "primitive.hpp"
+#include "symtab.hpp"
+
+class StringPool;
+
+// A parsed program saved to a file, so that compiling the same program
+// again can skip the scanner and the parser: the file is mapped and the
+// tree is made straight from it (see compile.cpp and csimple -c).
+//
+// The file is a header, the records of the nodes, a table of strings, and
+// what the scanner wrote to the output while it lexed the program (the
+// characters it did not know).  The records are 32 bit words:
+//
+//   node      kind | lineno << 8, then one word for each child in ast.cdef
+//   child     where its record is, in words from this word, so the records
+//             can be anywhere in memory and still make sense
+//   list      a record of its own: how many items, and where each one is
+//   SymName   which string in the table, one for each different name
+//   Primitive the value itself
+//   StringPrimitive   which string in the table
+//
+// ast_write and ast_read, generated from ast.cdef into ast.cpp, go
+// through the classes, on a stack of their own rather than by recursion,
+// so a tree of any depth can be saved; AstWriter and AstReader know the
+// format and keep the stacks.  A file is
+// used only if it was written for the same program text, by a compiler
+// with the same ast.cdef (ast_layout), and with the same options that
+// change the tree (m_lazy_bodies).  A file that has been damaged since is
+// still caught as it is read: every kind, child, list and string is checked
+// against the header, and each record can be read only once, so the file
+// must be a tree; ast_read then gives NULL and the program is parsed.
+
+// What identifies a program's text
+unsigned long long ast_cache_key(const char* text, size_t size);
+
+// The flags a file is saved with, for the options that change the tree
+enum {
+    AST_CACHE_LAZY = 1          // only what Main can get to (csimple -l)
+};
+
+struct AstCacheHeader
+{
+    char magic[8];
+    unsigned long long layout;      // ast_cache_key of ast_layout
+    unsigned long long source;      // and of the program
+    unsigned long long source_size;
+    unsigned flags;
+    unsigned root;                  // the Program's record
+    unsigned words;                 // then the records,
+    unsigned strings;               // how many strings,
+    unsigned chars;                 // their characters,
+    unsigned output;                // and the output's characters
+};
+
+class AstWriter
+{
+  private:
+    std::vector<unsigned> m_words;
+    std::vector<AstFrame> m_frames;         // the nodes being written,
+    std::vector<unsigned> m_written;        // and what was written for
+                                            // their children so far
+    std::vector<unsigned> m_strings;        // where each one starts
+    std::string m_chars;
+    std::unordered_map<const char*, unsigned> m_names;
+    std::unordered_map<std::string, unsigned> m_literals;
+    bool m_too_big;                 // a line number did not fit
+
+    unsigned string(const char* s);
+
+  public:
+    AstWriter();
+
+    // Writes the tree and what the scanner wrote out to path, for the
+    // program with key and size.  False if it could not, or the tree does
+    // not fit in the format.  The file is written under another name and
+    // then renamed, so a compilation running at the same time sees the
+    // old file or the new one, never half of one.
+    bool save(const char* path, Program_ptr ast, unsigned long long key,
+              size_t size, unsigned flags, const std::string& output);
+
+    /*** For ast_write ***/
+
+    std::vector<AstFrame>& frames() {
+        return m_frames;
+    }
+
+    // A node is written when ast_write comes back up to it, after its
+    // children; the rest at once.  Either way what was written for it
+    // ends up on top of m_written.
+    void child(Visitable* p) {
+        m_frames.push_back(AstFrame(p));
+    }
+
+    void child(SymName* p) {
+        push(write(p));
+    }
+
+    void child(Primitive* p) {
+        push(write(p));
+    }
+
+    void child(StringPrimitive* p) {
+        push(write(p));
+    }
+
+    // Writes the record of a list whose items were just written, in place
+    // of them
+    template<class T, size_t N> void close(ArenaVector<T, N>* list) {
+        size_t mark = m_written.size() - list->size();
+        unsigned at = m_words.size();
+        m_words.resize(at + 1 + list->size());
+        m_words[at] = list->size();
+        for(size_t i = 0; i < list->size(); ++i) {
+            field(at + 1 + i, (*list)[i], m_written[mark + i]);
+        }
+        m_written.resize(mark);
+        push(at);
+    }
+
+    void push(unsigned written) {
+        m_written.push_back(written);
+    }
+
+    unsigned pop() {
+        unsigned written = m_written.back();
+        m_written.pop_back();
+        return written;
+    }
+
+    unsigned write(SymName* p);
+    unsigned write(Primitive* p);
+    unsigned write(StringPrimitive* p);
+
+    // Starts a node's record, with room for its children, and gives where
+    // it is
+    unsigned node(NodeKind kind, int lineno, int children);
+
+    // Fills in a child of the node, given what write gave for it (the
+    // child itself only picks the overload)
+    template<class T> void field(unsigned at, T*, unsigned written) {
+        m_words[at] = written - at;
+    }
+
+    void field(unsigned at, SymName*, unsigned written) {
+        m_words[at] = written;
+    }
+
+    void field(unsigned at, Primitive*, unsigned written) {
+        m_words[at] = written;
+    }
+
+    void field(unsigned at, StringPrimitive*, unsigned written) {
+        m_words[at] = written;
+    }
+};
+
+class AstReader
+{
+  private:
+    StringPool* m_strpool;
+    void* m_map;
+    size_t m_map_size;
+    const AstCacheHeader* m_header;
+    const unsigned* m_words;
+    const unsigned* m_strings;
+    const char* m_chars;
+    std::vector<const char*> m_names;   // interned as they are needed
+    std::vector<char> m_read;           // the records read so far
+    bool m_failed;                      // something in the file was wrong
+
+  public:
+    // A record ast_read is in, and the child it is at
+    struct Frame
+    {
+        unsigned m_at;
+        unsigned m_next;
+
+        Frame(unsigned at) : m_at(at), m_next(0) {}
+    };
+
+  private:
+    std::vector<Frame> m_frames;        // the records being read,
+    std::vector<Visitable*> m_made;     // and the nodes made from them that
+                                        // their parents have not taken
+
+    const char* name(unsigned at);
+
+    // False, once and for all, if the file is wrong
+    bool check(bool ok) {
+        m_failed = m_failed || !ok;
+        return !m_failed;
+    }
+
+    // Where the record the child at at points to is, if that is a word
+    // of the file; otherwise the number of words, and the file is wrong
+    unsigned target(unsigned at) {
+        unsigned words = m_header->words;
+        if(!check(at < words)) {
+            return words;
+        }
+        unsigned to = at + m_words[at];
+        check(to < words);
+        return m_failed ? words : to;
+    }
+
+  public:
+    // Names are interned in strpool, like the scanner does
+    AstReader(StringPool* strpool);
+    // The strings in the tree point into the file, so the tree can only be
+    // used while the reader is around
+    ~AstReader();
+
+    // Maps path, if it has a tree for the program with key and size.  The
+    // tree is made in the current Arena.
+    bool open(const char* path, unsigned long long key, size_t size,
+              unsigned flags);
+    // NULL if the records turn out to be wrong; what the file had in it
+    // is not to be used then, output() included
+    Program_ptr root();
+
+    // What the scanner wrote out
+    const char* output();
+    size_t output_size();
+
+    /*** For ast_read ***/
+
+    std::vector<Frame>& frames() {
+        return m_frames;
+    }
+
+    // nk_count if the file is wrong, which stops ast_read
+    NodeKind kind(unsigned at) {
+        if(m_failed || !check(at < m_header->words
+                              && (m_words[at] & 0xff) < nk_count)) {
+            return nk_count;
+        }
+        return (NodeKind) (m_words[at] & 0xff);
+    }
+
+    int lineno(unsigned at) {
+        return m_words[at] >> 8;
+    }
+
+    // The node the child at at points to, or the i-th item of the list it
+    // points to, is read next; once it is made it is on top of m_made
+    void child(unsigned at) {
+        unsigned to = target(at);
+        if(!m_failed && check(!m_read[to])) {
+            m_read[to] = 1;
+            m_frames.push_back(Frame(to));
+        }
+    }
+
+    void child(unsigned at, unsigned i) {
+        child(target(at) + 1 + i);
+    }
+
+    // How many items the list the child at at points to has; none if
+    // they are not all in the file
+    unsigned items(unsigned at) {
+        unsigned list = target(at);
+        if(m_failed || !check(m_words[list] < m_header->words - list)) {
+            return 0;
+        }
+        return m_words[list];
+    }
+
+    void push(Visitable* p) {
+        m_made.push_back(p);
+    }
+
+    Visitable* pop() {
+        Visitable* p = m_made.back();
+        m_made.pop_back();
+        return p;
+    }
+
+    // A node child, which is the last node made, and must be a T
+    template<class T> void field(unsigned, T** child) {
+        *child = dyn_cast<T>(pop());
+        check(*child != NULL);
+    }
+
+    // A list of nodes, whose items are the last nodes made, in order
+    template<class T, size_t N> void field(unsigned at,
+                                           ArenaVector<T, N>** child) {
+        typedef typename std::remove_pointer<T>::type Item;
+        size_t mark = m_made.size() - items(at);
+        ArenaVector<T, N>* list = new ArenaVector<T, N>();
+        list->reserve(m_made.size() - mark);
+        for(size_t i = mark; i < m_made.size(); ++i) {
+            list->push_back(dyn_cast<Item>(m_made[i]));
+            check(list->back() != NULL);
+        }
+        m_made.resize(mark);
+        *child = list;
+    }
+
+    // A list of names, which are read from the list's record
+    template<size_t N> void field(unsigned at,
+                                  ArenaVector<SymName*, N>** child) {
+        unsigned n = items(at);
+        unsigned list = target(at);
+        ArenaVector<SymName*, N>* names = new ArenaVector<SymName*, N>();
+        names->reserve(n);
+        for(unsigned i = 1; i <= n; ++i) {
+            SymName* name;
+            field(list + i, &name);
+            names->push_back(name);
+        }
+        *child = names;
+    }
+
+    // The names in a list are made in the arena; the rest, and the
+    // Primitives, are kept in their node
+    void field(unsigned at, SymName** child);
+    void field(unsigned at, SymName* child);
+    void field(unsigned at, Primitive* child);
+    void field(unsigned at, StringPrimitive** child);
+};
+
+#endif //ASTCACHE_HPP
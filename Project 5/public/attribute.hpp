@@ -21,19 +21,23 @@ enum Basetype
 };
 
 
+// Every node has one, so it is packed into a word.  Visitable keeps it
+// right before the node's kind, so the two fill what the vtable pointer
+// leaves of the first 16 bytes however the compiler lays out the classes
+// derived from it, and a node is no bigger for having a kind.  A line past
+// 16777215 is not told apart from the ones 2^24 before it, which is where
+// a saved tree (astcache.hpp) gives up too.  The scope a name is looked up
+// in is kept with the name (SymName::m_scope), as only the nodes with names
+// need one.
 class Attribute
 {
   public:
-  Basetype m_basetype;  // Type of the subtree
-  int m_place;          // Register where this value is stored
-  SymScope* m_scope;    // The scope of the current symbol
-  int lineno;           // Line number on which that ast node resides
+  Basetype m_basetype : 8;  // Type of the subtree
+  unsigned lineno : 24;     // Line number on which that ast node resides
 
   Attribute() {
     m_basetype = bt_undef;
     lineno = 0;
-    m_scope = NULL;
-    int m_place = -1;   // Should never actually be negative
   }
 };
 
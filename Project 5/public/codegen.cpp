@@ -5,9 +5,13 @@
 #include "symtab.hpp"
 #include "primitive.hpp"
 #include <cstring>
+#include <vector>
 
 
-class Codegen : public Visitor
+// The code for a node comes out around its children: before them (preX),
+// between two of them (stepX) and after them (postX).  The walk is a
+// StackVisitor's, so a deep expression does not run out of stack.
+class Codegen : public StackVisitor<Codegen>
 {
   private:
     FILE* m_outputfile;
@@ -18,6 +22,10 @@ class Codegen : public Visitor
 
     int label_count; // Access with new_label
 
+    // The labels of the nodes the walk is in that have one, the innermost
+    // last
+    std::vector<int> m_labels;
+
     // Helpers
     // This is used to get new unique labels (cleverly names label1, label2, ...)
     int new_label()
@@ -25,6 +33,21 @@ class Codegen : public Visitor
         return label_count++;
     }
 
+    // A new label for a node, before its children, which it keeps until
+    // pop_label after them
+    bool push_label()
+    {
+        m_labels.push_back(new_label());
+        return true;
+    }
+
+    int pop_label()
+    {
+        int label_num = m_labels.back();
+        m_labels.pop_back();
+        return label_num;
+    }
+
     void set_text_mode()
     {
         fprintf(m_outputfile, ".text\n\n");
@@ -175,88 +198,120 @@ class Codegen : public Visitor
 
   public:
 
-    Codegen(FILE* outputfile, SymTab* st)
+    Codegen(FILE* outputfile, SymTab* st, int first_label = 0)
     {
         m_outputfile = outputfile;
         m_st = st;
-        label_count = 0;
+        label_count = first_label;
     }
 
-    void visitProgramImpl(ProgramImpl* p)
+    bool preProgramImpl(ProgramImpl*)
+    {
+        begin_program();
+        return true;
+    }
+
+    // What comes before the first procedure
+    void begin_program()
     {
         set_text_mode(); 
-        p->visit_children(this);
     }
 
-    void visitProcImpl(ProcImpl* p)
+    // The next label new_label would give out
+    int next_label()
     {
-        emit_prologue(p->m_symname, m_st->scopesize(p->m_attribute.m_scope), p->m_decl_list->size()); //num args will need to be changed
-        p->visit_children(this);
-        emit_epilogue(); 
+        return label_count;
     }
 
-    void visitProcedure_blockImpl(Procedure_blockImpl* p)
+    bool preProcImpl(ProcImpl* p)
     {
-        p->visit_children(this);
+        emit_prologue(&p->m_symname, m_st->scopesize(p->m_symname.m_scope), p->m_decl_list->size()); //num args will need to be changed
+        return true;
     }
 
-    void visitNested_blockImpl(Nested_blockImpl* p)
+    void postProcImpl(ProcImpl*)
     {
-        p->visit_children(this);
+        emit_epilogue(); 
     }
 
-    void visitAssignment(Assignment* p)
+    // The lhs, then where it is, then the expression; an array element
+    // only has the code for its index
+    bool stepAssignment(Assignment* p, unsigned i)
     {
-        //p->visit_children(this);
-        p->m_lhs->accept(this);
-        if(Variable* lhs_var = dynamic_cast<Variable*>(p->m_lhs))
+        if(i == 1)
         {
-            int offset = -(m_st->lookup(lhs_var->m_attribute.m_scope, lhs_var->m_symname->spelling())->get_offset() + 4); 
-            fprintf(m_outputfile, "\tmovl\t$%d,%%eax\n", offset); //Get offset
-            fprintf(m_outputfile, "\tpushl\t%%eax\n"); //Push onto stack for later
+            if(Variable* lhs_var = dyn_cast<Variable>(p->m_lhs))
+            {
+                int offset = -(m_st->lookup(lhs_var->m_symname.m_scope, lhs_var->m_symname.spelling())->get_offset() + 4); 
+                fprintf(m_outputfile, "\tmovl\t$%d,%%eax\n", offset); //Get offset
+                fprintf(m_outputfile, "\tpushl\t%%eax\n"); //Push onto stack for later
+            }
+            else if(DerefVariable* lhs_var = dyn_cast<DerefVariable>(p->m_lhs))
+            {
+                int offset = -(m_st->lookup(lhs_var->m_symname.m_scope, lhs_var->m_symname.spelling())->get_offset() + 4); 
+                fprintf(m_outputfile, "\tmovl %d(%%ebp), %%eax", offset); //Get address stored at offset
+                fprintf(m_outputfile, "\tpushl\t%%eax\n"); //Push onto stack for later
+            }
+            else
+            {
+                return false;
+            }
+        }
+        return StackVisitor<Codegen>::stepAssignment(p, i);
+    }
 
-            p->m_expr->accept(this); 
+    void postAssignment(Assignment* p)
+    {
+        if(isa<Variable>(p->m_lhs))
+        {
             fprintf(m_outputfile, "\tpopl\t%%ebx\n"); //Pull value of expression
             fprintf(m_outputfile, "\tpopl\t%%eax\n"); //Pull offset back
             fprintf(m_outputfile, "\tmovl %%ebx,\t(%%ebp, %%eax, 1)\n");
         }
 
-        if(DerefVariable* lhs_var = dynamic_cast<DerefVariable*>(p->m_lhs))
+        if(isa<DerefVariable>(p->m_lhs))
         {
-            int offset = -(m_st->lookup(lhs_var->m_attribute.m_scope, lhs_var->m_symname->spelling())->get_offset() + 4); 
-            fprintf(m_outputfile, "\tmovl %d(%%ebp), %%eax", offset); //Get address stored at offset
-            fprintf(m_outputfile, "\tpushl\t%%eax\n"); //Push onto stack for later
-
-            p->m_expr->accept(this); 
             fprintf(m_outputfile, "\tpopl\t%%ebx\n"); //Pull value of expression
             fprintf(m_outputfile, "\tpopl\t%%eax\n"); //Pull address back
             fprintf(m_outputfile, "\tmovl\t%%ebx, (%%eax)"); 
         }
-
-
     }
 
-    void visitCall(Call* p)
+    // The args from the last to the first, the call, and then the lhs
+    bool stepCall(Call* p, unsigned i)
     {
-        //p->visit_children(this);
-        int num_children = 0; 
-        for(auto rit = p->m_expr_list->rbegin(); rit != p->m_expr_list->rend(); ++rit)
+        size_t num_children = p->m_expr_list->size(); 
+        if(i > 0 && i <= num_children)
         {
-            (*rit)->accept(this); 
             fprintf(m_outputfile, "\tpopl\t%%eax\n"); 
             fprintf(m_outputfile, "\tpushl\t%%eax\n"); 
-            num_children++; 
         }
 
-        fprintf(m_outputfile, "\tcall\t%s\n", p->m_symname->spelling()); 
-        fprintf(m_outputfile, "\taddl\t$%d,%%esp\n", num_children*4);
+        if(i < num_children)
+        {
+            child((*p->m_expr_list)[num_children - 1 - i]);
+            return true;
+        }
+
+        if(i > num_children)
+        {
+            return false;
+        }
+
+        fprintf(m_outputfile, "\tcall\t%s\n", p->m_symname.spelling()); 
+        fprintf(m_outputfile, "\taddl\t$%d,%%esp\n", (int) num_children*4);
         //Value of call in eax - push onto stack
         fprintf(m_outputfile, "\tpushl\t%%eax\n"); 
 
-        p->m_lhs->accept(this); 
-        if(Variable* lhs_var = dynamic_cast<Variable*>(p->m_lhs))
+        child(p->m_lhs); 
+        return true;
+    }
+
+    void postCall(Call* p)
+    {
+        if(Variable* lhs_var = dyn_cast<Variable>(p->m_lhs))
         {
-            int offset = -(m_st->lookup(lhs_var->m_attribute.m_scope, lhs_var->m_symname->spelling())->get_offset() + 4); 
+            int offset = -(m_st->lookup(lhs_var->m_symname.m_scope, lhs_var->m_symname.spelling())->get_offset() + 4); 
             fprintf(m_outputfile, "\tmovl\t$%d,%%eax\n", offset); //Get offset
             fprintf(m_outputfile, "\tpushl\t%%eax\n"); //Push onto stack for later
         }
@@ -266,103 +321,99 @@ class Codegen : public Visitor
         fprintf(m_outputfile, "\tmovl %%ebx,\t(%%ebp, %%eax, 1)\n");     
     }
 
-    void visitReturn(Return* p)
+    void postReturn(Return*)
     {
-        p->visit_children(this);
-
         // Load expression into %eax
         fprintf(m_outputfile, "\tpopl\t%%eax\n");
     }
 
     // Control flow
-    void visitIfNoElse(IfNoElse* p)
-    {
-        int label_num = new_label(); 
-        //p->visit_children(this);
-        p->m_expr->accept(this);
-        fprintf(m_outputfile, "\tpopl\t%%eax\n");
-        fprintf(m_outputfile, "\tcmpl\t$1,%%eax\n");
-        fprintf(m_outputfile, "\tjne\tend_%d\n", label_num);
-        p->m_nested_block->accept(this); 
-        fprintf(m_outputfile, "end_%d:\n", label_num);
-    }
-
-    void visitIfWithElse(IfWithElse* p)
+    bool preIfNoElse(IfNoElse*)
     {
-        int label_num = new_label(); 
-        //p->visit_children(this);
-        p->m_expr->accept(this); 
-        fprintf(m_outputfile, "\tpopl\t%%eax\n"); 
-        fprintf(m_outputfile, "\tcmpl\t$1,%%eax\n"); 
-        fprintf(m_outputfile, "\tjne\telse_%d\n", label_num);
-        p->m_nested_block_1->accept(this); 
-        fprintf(m_outputfile, "\tjmp\tend_%d\n", label_num); 
-        fprintf(m_outputfile, "else_%d:\n", label_num);
-        p->m_nested_block_2->accept(this); 
-        fprintf(m_outputfile, "end_%d:\n", label_num); 
+        return push_label();
     }
 
-    void visitWhileLoop(WhileLoop* p)
+    bool stepIfNoElse(IfNoElse* p, unsigned i)
     {
-        //p->visit_children(this);
-        int label_num = new_label(); 
-
-        fprintf(m_outputfile, "while_begin_%d:\n", label_num); 
-        p->m_expr->accept(this); 
-        fprintf(m_outputfile, "\tpopl\t%%eax\n"); 
-        fprintf(m_outputfile, "\tcmpl\t$1,%%eax\n"); 
-        fprintf(m_outputfile, "\tjne\twhile_end_%d\n", label_num); 
-        p->m_nested_block->accept(this); 
-        fprintf(m_outputfile, "\tjmp\twhile_begin_%d\n", label_num); 
-        fprintf(m_outputfile, "while_end_%d:\n", label_num); 
+        int label_num = m_labels.back(); 
+        if(i == 1)
+        {
+            fprintf(m_outputfile, "\tpopl\t%%eax\n");
+            fprintf(m_outputfile, "\tcmpl\t$1,%%eax\n");
+            fprintf(m_outputfile, "\tjne\tend_%d\n", label_num);
+        }
+        return StackVisitor<Codegen>::stepIfNoElse(p, i);
     }
 
-    void visitCodeBlock(CodeBlock *p) 
+    void postIfNoElse(IfNoElse*)
     {
-        p->visit_children(this);
+        int label_num = pop_label(); 
+        fprintf(m_outputfile, "end_%d:\n", label_num);
     }
 
-    // Variable declarations (no code generation needed)
-    void visitDeclImpl(DeclImpl* p)
+    bool preIfWithElse(IfWithElse*)
     {
-        p->visit_children(this);
+        return push_label();
     }
 
-    void visitTInteger(TInteger* p)
+    bool stepIfWithElse(IfWithElse* p, unsigned i)
     {
-        p->visit_children(this);
+        int label_num = m_labels.back(); 
+        if(i == 1)
+        {
+            fprintf(m_outputfile, "\tpopl\t%%eax\n"); 
+            fprintf(m_outputfile, "\tcmpl\t$1,%%eax\n"); 
+            fprintf(m_outputfile, "\tjne\telse_%d\n", label_num);
+        }
+        else if(i == 2)
+        {
+            fprintf(m_outputfile, "\tjmp\tend_%d\n", label_num); 
+            fprintf(m_outputfile, "else_%d:\n", label_num);
+        }
+        return StackVisitor<Codegen>::stepIfWithElse(p, i);
     }
 
-    void visitTIntPtr(TIntPtr* p)
+    void postIfWithElse(IfWithElse*)
     {
-        p->visit_children(this);
+        int label_num = pop_label(); 
+        fprintf(m_outputfile, "end_%d:\n", label_num); 
     }
 
-    void visitTBoolean(TBoolean* p)
+    bool preWhileLoop(WhileLoop*)
     {
-        p->visit_children(this);
+        push_label();
+        fprintf(m_outputfile, "while_begin_%d:\n", m_labels.back()); 
+        return true;
     }
 
-    void visitTCharacter(TCharacter* p)
+    bool stepWhileLoop(WhileLoop* p, unsigned i)
     {
-        p->visit_children(this);
+        int label_num = m_labels.back(); 
+        if(i == 1)
+        {
+            fprintf(m_outputfile, "\tpopl\t%%eax\n"); 
+            fprintf(m_outputfile, "\tcmpl\t$1,%%eax\n"); 
+            fprintf(m_outputfile, "\tjne\twhile_end_%d\n", label_num); 
+        }
+        return StackVisitor<Codegen>::stepWhileLoop(p, i);
     }
 
-    void visitTCharPtr(TCharPtr* p)
+    void postWhileLoop(WhileLoop*)
     {
-        p->visit_children(this);
+        int label_num = pop_label(); 
+        fprintf(m_outputfile, "\tjmp\twhile_begin_%d\n", label_num); 
+        fprintf(m_outputfile, "while_end_%d:\n", label_num); 
     }
 
-    void visitTString(TString* p)
+    // Comparison operations
+    bool preCompare(Compare*)
     {
-        p->visit_children(this);
+        return push_label();
     }
 
-    // Comparison operations
-    void visitCompare(Compare* p)
+    void postCompare(Compare*)
     {
-        int label_num = new_label(); 
-        p->visit_children(this);
+        int label_num = pop_label();
         fprintf(m_outputfile, "\tpopl\t%%ebx\n"); 
         fprintf(m_outputfile, "\tpopl\t%%eax\n"); 
         fprintf(m_outputfile, "\tcmpl\t%%ebx, %%eax\n");
@@ -374,10 +425,14 @@ class Codegen : public Visitor
         fprintf(m_outputfile, "end_%d:\n", label_num);
     }
 
-    void visitNoteq(Noteq* p)
+    bool preNoteq(Noteq*)
     {
-        int label_num = new_label(); 
-        p->visit_children(this);
+        return push_label();
+    }
+
+    void postNoteq(Noteq*)
+    {
+        int label_num = pop_label();
         fprintf(m_outputfile, "\tpopl\t%%ebx\n"); 
         fprintf(m_outputfile, "\tpopl\t%%eax\n"); 
         fprintf(m_outputfile, "\tcmpl\t%%ebx, %%eax\n");
@@ -389,10 +444,14 @@ class Codegen : public Visitor
         fprintf(m_outputfile, "end_%d:\n", label_num);
     }
 
-    void visitGt(Gt* p)
+    bool preGt(Gt*)
     {
-        int label_num = new_label(); 
-        p->visit_children(this);
+        return push_label();
+    }
+
+    void postGt(Gt*)
+    {
+        int label_num = pop_label();
         fprintf(m_outputfile, "\tpopl\t%%ebx\n"); 
         fprintf(m_outputfile, "\tpopl\t%%eax\n"); 
         fprintf(m_outputfile, "\tcmpl\t%%ebx, %%eax\n");
@@ -404,10 +463,14 @@ class Codegen : public Visitor
         fprintf(m_outputfile, "end_%d:\n", label_num);
     }
 
-    void visitGteq(Gteq* p)
+    bool preGteq(Gteq*)
     {
-        int label_num = new_label(); 
-        p->visit_children(this);
+        return push_label();
+    }
+
+    void postGteq(Gteq*)
+    {
+        int label_num = pop_label();
         fprintf(m_outputfile, "\tpopl\t%%ebx\n"); 
         fprintf(m_outputfile, "\tpopl\t%%eax\n"); 
         fprintf(m_outputfile, "\tcmpl\t%%ebx, %%eax\n");
@@ -419,10 +482,14 @@ class Codegen : public Visitor
         fprintf(m_outputfile, "end_%d:\n", label_num);
     }
 
-    void visitLt(Lt* p)
+    bool preLt(Lt*)
     {
-        int label_num = new_label(); 
-        p->visit_children(this);
+        return push_label();
+    }
+
+    void postLt(Lt*)
+    {
+        int label_num = pop_label();
         fprintf(m_outputfile, "\tpopl\t%%ebx\n"); 
         fprintf(m_outputfile, "\tpopl\t%%eax\n"); 
         fprintf(m_outputfile, "\tcmpl\t%%ebx, %%eax\n");
@@ -434,10 +501,14 @@ class Codegen : public Visitor
         fprintf(m_outputfile, "end_%d:\n", label_num);
     }
 
-    void visitLteq(Lteq* p)
+    bool preLteq(Lteq*)
     {
-        int label_num = new_label(); 
-        p->visit_children(this);
+        return push_label();
+    }
+
+    void postLteq(Lteq*)
+    {
+        int label_num = pop_label();
         fprintf(m_outputfile, "\tpopl\t%%ebx\n"); 
         fprintf(m_outputfile, "\tpopl\t%%eax\n"); 
         fprintf(m_outputfile, "\tcmpl\t%%ebx, %%eax\n");
@@ -450,54 +521,48 @@ class Codegen : public Visitor
     }
 
     // Arithmetic and logic operations
-    void visitAnd(And* p)
+    void postAnd(And*)
     {
-        p->visit_children(this);
         fprintf(m_outputfile, "\tpopl\t%%ebx\n"); 
         fprintf(m_outputfile, "\tpopl\t%%eax\n"); 
         fprintf(m_outputfile, "\tandl\t%%ebx, %%eax\n"); 
         fprintf(m_outputfile, "\tpushl\t%%eax\n");
     }
 
-    void visitOr(Or* p)
+    void postOr(Or*)
     {
-        p->visit_children(this);
         fprintf(m_outputfile, "\tpopl\t%%ebx\n"); 
         fprintf(m_outputfile, "\tpopl\t%%eax\n"); 
         fprintf(m_outputfile, "\torl\t%%ebx, %%eax\n"); 
         fprintf(m_outputfile, "\tpushl\t%%eax\n");
     }
 
-    void visitMinus(Minus* p)
+    void postMinus(Minus*)
     {
-        p->visit_children(this);
         fprintf(m_outputfile, "\tpopl\t%%ebx\n"); 
         fprintf(m_outputfile, "\tpopl\t%%eax\n"); 
         fprintf(m_outputfile, "\tsubl\t%%ebx, %%eax\n"); 
         fprintf(m_outputfile, "\tpushl\t%%eax\n"); 
     }
 
-    void visitPlus(Plus* p)
+    void postPlus(Plus*)
     {
-        p->visit_children(this);
         fprintf(m_outputfile, "\tpopl\t%%ebx\n"); 
         fprintf(m_outputfile, "\tpopl\t%%eax\n"); 
         fprintf(m_outputfile, "\taddl\t%%ebx, %%eax\n"); 
         fprintf(m_outputfile, "\tpushl\t%%eax\n"); 
     }
 
-    void visitTimes(Times* p)
+    void postTimes(Times*)
     {
-        p->visit_children(this);
         fprintf(m_outputfile, "\tpopl\t%%ebx\n"); 
         fprintf(m_outputfile, "\tpopl\t%%eax\n"); 
         fprintf(m_outputfile, "\timull\t%%ebx, %%eax\n"); 
         fprintf(m_outputfile, "\tpushl\t%%eax\n"); 
     }
 
-    void visitDiv(Div* p)
+    void postDiv(Div*)
     {
-        p->visit_children(this);
         fprintf(m_outputfile, "\tpopl\t%%ebx\n"); 
         fprintf(m_outputfile, "\tpopl\t%%eax\n"); 
         fprintf(m_outputfile, "\tcdq\n");
@@ -505,10 +570,14 @@ class Codegen : public Visitor
         fprintf(m_outputfile, "\tpushl\t%%eax\n"); 
     }
 
-    void visitNot(Not* p)
+    bool preNot(Not*)
     {
-        int label_num = new_label(); 
-        p->visit_children(this);
+        return push_label();
+    }
+
+    void postNot(Not*)
+    {
+        int label_num = pop_label();
         fprintf(m_outputfile, "\tpopl\t%%eax\n");
         fprintf(m_outputfile, "\tcmpl\t$1, %%eax\n");
         fprintf(m_outputfile, "\tjne\tfalse_%d\n", label_num);
@@ -519,63 +588,59 @@ class Codegen : public Visitor
         fprintf(m_outputfile, "end_%d:\n", label_num); 
     }
 
-    void visitUminus(Uminus* p)
+    void postUminus(Uminus*)
     {
-        p->visit_children(this);
         fprintf(m_outputfile, "\tpopl\t%%eax\n");
         fprintf(m_outputfile, "\tnegl\t%%eax\n");
         fprintf(m_outputfile, "\tpushl\t%%eax\n");
     }
 
     // Variable and constant access
-    void visitIdent(Ident* p)
+    bool preIdent(Ident* p)
     {
-        //p->visit_children(this);
-        if(m_st->lookup(p->m_attribute.m_scope, p->m_symname->spelling())->m_basetype == bt_string)
+        if(m_st->lookup(p->m_symname.m_scope, p->m_symname.spelling())->m_basetype == bt_string)
         {
-            fprintf(m_outputfile, "\tlea\t%d(%%ebp), %%eax\n", m_st->lookup(p->m_attribute.m_scope, p->m_symname->spelling())->get_offset() + 4);
+            fprintf(m_outputfile, "\tlea\t%d(%%ebp), %%eax\n", m_st->lookup(p->m_symname.m_scope, p->m_symname.spelling())->get_offset() + 4);
 
         }
 
-        int offset = -(m_st->lookup(p->m_attribute.m_scope, p->m_symname->spelling())->get_offset() + 4); 
+        int offset = -(m_st->lookup(p->m_symname.m_scope, p->m_symname.spelling())->get_offset() + 4); 
         fprintf(m_outputfile, "\tmovl\t%d(%%ebp),%%eax\n", offset);
         fprintf(m_outputfile, "\tpushl\t%%eax\n");
-        
+        return false;
     }
 
-    void visitBoolLit(BoolLit* p)
+    void postBoolLit(BoolLit* p)
     {
-        p->visit_children(this);
-        fprintf(m_outputfile, "\tpushl\t$0x%x\n", p->m_primitive->m_data);
+        fprintf(m_outputfile, "\tpushl\t$0x%x\n", p->m_primitive.m_data);
     }
 
-    void visitCharLit(CharLit* p)
+    void postCharLit(CharLit* p)
     {
-        p->visit_children(this);
-        fprintf(m_outputfile, "\tpushl\t$0x%x\n", p->m_primitive->m_data);
+        fprintf(m_outputfile, "\tpushl\t$0x%x\n", p->m_primitive.m_data);
     }
 
-    void visitIntLit(IntLit* p)
+    void postIntLit(IntLit* p)
     {
-        p->visit_children(this);
-        fprintf(m_outputfile, "\tpushl\t$0x%x\n", p->m_primitive->m_data);
+        fprintf(m_outputfile, "\tpushl\t$0x%x\n", p->m_primitive.m_data);
     }
 
-    void visitNullLit(NullLit* p)
+    void postNullLit(NullLit*)
     {
-        p->visit_children(this);
         fprintf(m_outputfile, "\tpushl\t$0\n");
     }
 
-    void visitArrayAccess(ArrayAccess* p)
+    bool preArrayAccess(ArrayAccess*)
     {
-        SymScope *scope = p->m_attribute.m_scope; 
-        const char *name = p->m_symname->spelling(); 
         fprintf(m_outputfile, "#Accessing array element\n");
-        p->visit_children(this); 
+        return true;
+    }
+
+    void postArrayAccess(ArrayAccess* p)
+    {
         fprintf(m_outputfile, "\tpopl\t%%edx\n"); //Index value 
         fprintf(m_outputfile, "\timull\t$4,%%edx\n"); //Multiply index by 4
-        int offset = -(m_st->lookup(p->m_attribute.m_scope, p->m_symname->spelling())->get_offset() + 4); 
+        int offset = -(m_st->lookup(p->m_symname.m_scope, p->m_symname.spelling())->get_offset() + 4); 
         fprintf(m_outputfile, "\tmovl\t$%d,%%ebx\n", offset); 
         fprintf(m_outputfile, "\taddl\t%%edx,%%ebx\n"); //Add index value to offset
         fprintf(m_outputfile, "\tmovl\t(%%ebx,%%ebp,1),%%eax\n");
@@ -583,44 +648,20 @@ class Codegen : public Visitor
     }
 
     // LHS
-    void visitVariable(Variable* p)
+    void postVariable(Variable*)
     {
-        p->visit_children(this);
-        // fprintf(m_outputfile, "\tmovl\t%d,%%eax\n", m_st->lookup(p->m_attribute.m_scope, p->m_symname->spelling())->get_offset());
+        // fprintf(m_outputfile, "\tmovl\t%d,%%eax\n", m_st->lookup(p->m_symname.m_scope, p->m_symname.spelling())->get_offset());
         // fprintf(m_outputfile, "\tpushl\t%%eax\n");
     }
 
-    void visitDerefVariable(DerefVariable* p)
-    {
-        p->visit_children(this);
-    }
-
-    void visitArrayElement(ArrayElement* p)
-    {
-        p->visit_children(this);
-    }
-
-    // Special cases
-    void visitSymName(SymName* p)
-    {
-        //p->visit_children(this);
-    }
-
-    void visitPrimitive(Primitive* p)
-    {
-        //p->visit_children(this);
-    }
-
     // Strings
-    void visitStringAssignment(StringAssignment* p)
+    bool preStringAssignment(StringAssignment* p)
     {
-        //p->visit_children(this);
         int label_num = new_label(); 
-        //p->visit_children(this);
 
-        if(Variable* lhs_var = dynamic_cast<Variable*>(p->m_lhs))
+        if(Variable* lhs_var = dyn_cast<Variable>(p->m_lhs))
         {
-            int offset = -(m_st->lookup(p->m_attribute.m_scope, lhs_var->m_symname->spelling())->get_offset() + 4); 
+            int offset = -(m_st->lookup(lhs_var->m_symname.m_scope, lhs_var->m_symname.spelling())->get_offset() + 4); 
             fprintf(m_outputfile, "\tmovl\t$%d,%%eax\n", offset); //Get offset
             for(int i = 0; i <= strlen(p->m_stringprimitive->m_string); ++i)
             {
@@ -639,55 +680,61 @@ class Codegen : public Visitor
                 }
             }
         }
+        return false;
     }
 
-    void visitStringPrimitive(StringPrimitive* p)
-    {
-        
-    }
-
-    void visitAbsoluteValue(AbsoluteValue* p)
+    // The size of a string, or the code for the expression and then its
+    // absolute value
+    bool preAbsoluteValue(AbsoluteValue* p)
     {
         int label_num = new_label(); 
-        Ident* id = dynamic_cast<Ident*>(p->m_expr); 
+        Ident* id = dyn_cast<Ident>(p->m_expr); 
         if(id!=NULL){
-            SymScope *scope = p->m_attribute.m_scope; 
-            Symbol *sym = m_st->lookup(scope, id->m_symname->spelling());
+            SymScope *scope = id->m_symname.m_scope; 
+            Symbol *sym = m_st->lookup(scope, id->m_symname.spelling());
             if(sym->m_basetype==bt_string)
             {
                 fprintf(m_outputfile, "\tpushl\t$%d\n", sym->get_size());
             }
+            return false;
         }
-        else
-        {
-            p->visit_children(this);
-            fprintf(m_outputfile, "\tpopl\t%%eax\n"); 
-            fprintf(m_outputfile, "\tcmpl\t$0,%%eax\n"); 
-            fprintf(m_outputfile, "\tjge\tpositive_%d\n", label_num); 
-            fprintf(m_outputfile, "\tneg\t%%eax\n"); 
-            fprintf(m_outputfile, "positive_%d:\n", label_num); 
-            fprintf(m_outputfile, "\tpushl\t%%eax\n"); 
-        }
-
-    }
-
-    // Pointer
-    void visitAddressOf(AddressOf* p)
-    {
-        p->visit_children(this);
+        m_labels.push_back(label_num);
+        return true;
     }
 
-    void visitDeref(Deref* p)
+    void postAbsoluteValue(AbsoluteValue*)
     {
-        p->visit_children(this);
-
+        int label_num = pop_label(); 
+        fprintf(m_outputfile, "\tpopl\t%%eax\n"); 
+        fprintf(m_outputfile, "\tcmpl\t$0,%%eax\n"); 
+        fprintf(m_outputfile, "\tjge\tpositive_%d\n", label_num); 
+        fprintf(m_outputfile, "\tneg\t%%eax\n"); 
+        fprintf(m_outputfile, "positive_%d:\n", label_num); 
+        fprintf(m_outputfile, "\tpushl\t%%eax\n"); 
     }
 };
 
 
-void dopass_codegen(Program_ptr ast, SymTab* st)
+void dopass_codegen(Program_ptr ast, SymTab* st, FILE* out)
 {
-    Codegen* codegen = new Codegen(stdout, st);
-    ast->accept(codegen);
+    Codegen* codegen = new Codegen(out, st);
+    codegen->walk(ast);
     delete codegen;
-}
\ No newline at end of file
+}
+
+// The same pass a procedure at a time (see typecheck_proc): codegen_begin
+// first, then codegen_proc on each top level procedure in order.  Labels
+// are numbered over the whole program, so *labels carries the count from
+// one procedure to the next, starting at 0.
+void codegen_begin(FILE* out)
+{
+    Codegen codegen(out, NULL);
+    codegen.begin_program();
+}
+
+void codegen_proc(Proc_ptr proc, SymTab* st, FILE* out, int* labels)
+{
+    Codegen codegen(out, st, *labels);
+    codegen.walk(proc);
+    *labels = codegen.next_label();
+}
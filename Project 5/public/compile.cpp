@@ -0,0 +1,272 @@
+#include <cstdio>
+#include <cstdlib>
+
+#include "arena.hpp"
+#include "ast.hpp"
+#include "astcache.hpp"
+#include "exprpool.hpp"
+#include "parser.hpp"
+#include "lexer.hpp"
+#include "symtab.hpp"
+#include "source.hpp"
+#include "strpool.hpp"
+#include "compile.hpp"
+
+// These are defined in rdparser.cpp
+int rdparse(yyscan_t scanner, Program_ptr* ast, ProcedureSink* sink,
+            FILE* errors);
+int rdparse_lazy(yyscan_t scanner, Program_ptr* ast, ProcedureSink* sink,
+                 FILE* errors);
+
+// This is defined in ast2dot.cpp
+void dopass_ast2dot(Program_ptr ast, FILE* out);
+
+// These are defined in typecheck.cpp
+void dopass_typecheck(Program_ptr ast, SymTab* st, FILE* errors);
+void typecheck_proc(Proc_ptr proc, SymTab* st, FILE* errors);
+void typecheck_program(Program_ptr ast, SymTab* st, FILE* errors);
+
+// These are defined in codegen.cpp
+void dopass_codegen(Program_ptr ast, SymTab* st, FILE* out);
+void codegen_begin(FILE* out);
+void codegen_proc(Proc_ptr proc, SymTab* st, FILE* out, int* labels);
+
+// A FILE* for the passes to print to, read back at the end.  Most are
+// kept in memory, but the assembly goes to a temporary file (if one can be
+// made), so a big program's code does not have to fit in memory as well.
+class Spool
+{
+  private:
+    char* m_buffer;     // for one in memory
+    size_t m_size;
+    FILE* m_file;
+
+  public:
+    Spool(bool on_disk = false) {
+        m_buffer = NULL;
+        m_size = 0;
+        m_file = on_disk ? tmpfile() : NULL;
+        if(m_file == NULL) {
+            m_file = open_memstream(&m_buffer, &m_size);
+        }
+        if(m_file == NULL) {
+            perror("open_memstream");
+            exit(1);
+        }
+    }
+
+    ~Spool() {
+        fclose(m_file);
+        free(m_buffer);
+    }
+
+    FILE* file() {
+        return m_file;
+    }
+
+    // Writes everything written so far to f
+    void copy_to(FILE* f) {
+        fflush(m_file);
+        if(m_buffer) {
+            fwrite(m_buffer, 1, m_size, f);
+            return;
+        }
+        char block[1 << 16];
+        rewind(m_file);
+        for(size_t n; (n = fread(block, 1, sizeof(block), m_file)) > 0; ) {
+            fwrite(block, 1, n, f);
+        }
+    }
+
+    // Everything written so far
+    std::string contents() {
+        fflush(m_file);
+        if(m_buffer) {
+            return std::string(m_buffer, m_size);
+        }
+        std::string s;
+        char block[1 << 16];
+        rewind(m_file);
+        for(size_t n; (n = fread(block, 1, sizeof(block), m_file)) > 0; ) {
+            s.append(block, n);
+        }
+        return s;
+    }
+};
+
+// Typechecks and generates code for each top level procedure as soon as
+// the parser has it, then frees its body and its scopes, so the compiler
+// needs memory for the biggest procedure rather than the whole program.
+// Only the names and parameters stay, for typecheck_program at the end.
+//
+// The bodies are made in m_bodies, which is reset after each procedure.
+class StreamingCompiler : public ProcedureSink
+{
+  public:
+    SymTab m_st;
+    FILE* m_code;
+    Spool m_errors;         // the first error typecheck_proc found
+    int m_status;           // the status that goes with it, 0 for none
+    int m_labels;
+    Arena m_bodies;
+    Arena* m_outer;         // the arena the rest of the tree is made in
+    int m_depth;            // how many bodies the parser is in
+
+    StreamingCompiler(FILE* code) {
+        m_code = code;
+        m_status = 0;
+        m_labels = 0;
+        m_outer = NULL;
+        m_depth = 0;
+        codegen_begin(m_code);
+    }
+
+    // yyparse does not leave the bodies it was in when it finds a syntax
+    // error
+    ~StreamingCompiler() {
+        if(m_depth > 0) {
+            Arena::set_current(m_outer);
+        }
+    }
+
+    void enter_body() {
+        if(m_depth++ == 0) {
+            m_outer = Arena::current();
+            Arena::set_current(&m_bodies);
+        }
+    }
+
+    void leave_body() {
+        if(--m_depth == 0) {
+            Arena::set_current(m_outer);
+        }
+    }
+
+    void procedure(Proc_ptr proc) {
+        ProcImpl* p = cast<ProcImpl>(proc);
+        if(m_status == 0) {
+            try {
+                typecheck_proc(p, &m_st, m_errors.file());
+                codegen_proc(p, &m_st, m_code, &m_labels);
+                m_st.drop_scope(p->m_symname.m_scope);
+            } catch(const CompileError& e) {
+                // The symbol table is left half way through the
+                // procedure, so the rest of the program is only parsed
+                m_status = e.m_status;
+            }
+        }
+        p->m_procedure_block = NULL;
+        m_bodies.reset();
+    }
+};
+
+// The code is held back until the end either way, since a syntax error
+// further on, or an error typecheck_program finds, is reported instead of
+// anything the procedures had.
+CompileResult compile(SourceBuffer* source, const CompileOptions& options)
+{
+    CompileResult result;
+    Arena tree;                 // The ast, gone all at once at the end
+    ArenaScope scope(&tree);
+    ExprPool pool;
+    ExprPoolScope pool_scope(options.m_share_exprs ? &pool : NULL);
+    Spool out;                  // characters the scanner does not know
+    Spool code(true);           // the assembly
+    Spool errors;
+    StringPool strpool;         // Identifiers in the program
+    Program_ptr ast = NULL;
+    StreamingCompiler* stream = NULL;
+
+    if(!options.m_whole_tree && !options.m_ast_cache) {
+        stream = new StreamingCompiler(code.file());
+    }
+
+    // The lexer cuts string literals out of the text, so the text is
+    // hashed before it starts
+    AstReader cache(&strpool);  // the tree is only good while it is open
+    unsigned long long key = 0;
+    unsigned flags = options.m_lazy_bodies ? AST_CACHE_LAZY : 0;
+    if(options.m_ast_cache) {
+        key = ast_cache_key(source->text(), source->size());
+    }
+
+    // A file that turns out to be wrong as it is read is as good as none
+    if(options.m_ast_cache && cache.open(options.m_ast_cache, key,
+                                         source->size(), flags)) {
+        ast = cache.root();
+    }
+    if(ast != NULL) {
+        fwrite(cache.output(), 1, cache.output_size(), out.file());
+        result.m_status = 0;
+    } else {
+        // A body can only be skipped over in the text, not in the tokens
+        // of a program lexed in parallel
+        int threads = options.m_lazy_bodies ? 1 : options.m_threads;
+        yyscan_t scanner = lexer_create(source, &strpool, out.file(),
+                                        threads);
+        if(options.m_lazy_bodies) {
+            result.m_status = rdparse_lazy(scanner, &ast, stream,
+                                           errors.file()) ? 1 : 0;
+        } else if(options.m_hand_parser) {
+            result.m_status = rdparse(scanner, &ast, stream,
+                                      errors.file()) ? 1 : 0;
+        } else {
+            result.m_status = yyparse(scanner, &ast, stream, NULL,
+                                      errors.file()) ? 1 : 0;
+        }
+        lexer_destroy(scanner);
+
+        // A program that does not parse is not kept, and not being able
+        // to keep one is no reason to fail the compilation
+        if(options.m_ast_cache && result.m_status == 0) {
+            AstWriter writer;
+            writer.save(options.m_ast_cache, ast, key, source->size(), flags,
+                        out.contents());
+        }
+    }
+
+    // The tree can be there even when the parse failed, since the start
+    // rule is reduced before the parser finds out the input goes on
+    if(result.m_status == 0 && stream) {
+        try {
+            typecheck_program(ast, &stream->m_st, errors.file());
+            if(stream->m_status != 0) {
+                stream->m_errors.copy_to(errors.file());
+                result.m_status = stream->m_status;
+            }
+        } catch(const CompileError& e) {
+            result.m_status = e.m_status;
+        }
+    } else if(result.m_status == 0) {  // Walk over the ast
+        SymTab st;                      // Symbol Table
+        try {
+            dopass_typecheck(ast, &st, errors.file());
+            // dopass_ast2dot(ast, code.file());
+            dopass_codegen(ast, &st, code.file());
+        } catch(const CompileError& e) {
+            result.m_status = e.m_status;
+        }
+    }
+    delete stream;
+
+    if(options.m_output) {
+        out.copy_to(options.m_output);
+        if(result.m_status == 0) {
+            code.copy_to(options.m_output);
+        }
+    } else {
+        result.m_output = out.contents();
+        if(result.m_status == 0) {
+            result.m_output += code.contents();
+        }
+    }
+    result.m_errors = errors.contents();
+    return result;
+}
+
+CompileResult compile(const char* text, size_t length,
+                      const CompileOptions& options)
+{
+    SourceBuffer source(text, length);
+    return compile(&source, options);
+}
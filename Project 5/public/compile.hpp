@@ -0,0 +1,106 @@
+#ifndef COMPILE_HPP
+#define COMPILE_HPP
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+class SourceBuffer;
+
+// The whole compiler, from program text to assembly, as a function.  It
+// keeps no state between calls and shares none between them, so any
+// number of programs can be compiled at once on different threads.
+//
+//   CompileResult r = compile(text, length, CompileOptions());
+//   if(r.m_status == 0) { ... r.m_output is the assembly ... }
+
+class CompileOptions
+{
+  public:
+    int m_threads;      // lex a big program on this many threads
+
+    // Build the tree for the whole program before checking any of it,
+    // instead of compiling each procedure as soon as it is parsed and then
+    // freeing it.  The result is the same; this just takes memory for the
+    // whole program.
+    bool m_whole_tree;
+
+    // Parse with the hand written parser in rdparser.cpp instead of the
+    // bison one.  They build the same tree and report the same errors.
+    bool m_hand_parser;
+
+    // Only parse, check and generate code for the top level procedures
+    // Main can get to through calls; the bodies of the others are skipped
+    // over without being parsed.  That leaves out their code, any errors
+    // in them and any characters in them the scanner would have copied to
+    // the output, and errors in the rest come in the order the bodies are
+    // parsed.  A body is taken to end at the "}" that matches its "{", so
+    // where the braces do not match up the syntax error can be a different
+    // one.  It uses the hand written parser, and lexes on one thread.
+    bool m_lazy_bodies;
+
+    // Where to write the output, instead of returning it in m_output.
+    // It is written at the end, and only goes through memory a block at a
+    // time, which matters for a big program.
+    FILE* m_output;
+
+    // A file to keep the parsed program in (see astcache.hpp).  If it has
+    // the tree for this program the scanner and the parser are skipped,
+    // otherwise the program is parsed and the tree written to it.  The
+    // tree is built whole (as with m_whole_tree) either way.  NULL for
+    // none.
+    const char* m_ast_cache;
+
+    // Make each expression only once in each block, and use it wherever
+    // the block has it again (see exprpool.hpp).  The output is the same;
+    // the tree is smaller where a program repeats itself.  A tree read
+    // from m_ast_cache is not shared.
+    bool m_share_exprs;
+
+    CompileOptions() {
+        m_threads = 1;
+        m_whole_tree = false;
+        m_hand_parser = false;
+        m_lazy_bodies = false;
+        m_output = NULL;
+        m_ast_cache = NULL;
+        m_share_exprs = false;
+    }
+};
+
+class CompileResult
+{
+  public:
+    // 0 if the program compiled, otherwise what csimple exits with: 1 for
+    // a syntax error, 2 and up for the errors typecheck finds
+    int m_status;
+
+    // The assembly, after any characters the scanner did not know (which
+    // it copies to the output, like flex does), unless the options gave a
+    // FILE* for it
+    std::string m_output;
+
+    // The error message, if there is one
+    std::string m_errors;
+};
+
+CompileResult compile(const char* text, size_t length,
+                      const CompileOptions& options);
+
+// The same, for a program that is already in a SourceBuffer.  String
+// literals are cut out of the text in place, so it is not usable again.
+CompileResult compile(SourceBuffer* source, const CompileOptions& options);
+
+// What the passes throw when they find an error in the program, once they
+// have written the message out.  compile() catches it.
+class CompileError
+{
+  public:
+    int m_status;
+
+    CompileError(int status) {
+        m_status = status;
+    }
+};
+
+#endif //COMPILE_HPP
@@ -0,0 +1,56 @@
+#include "exprpool.hpp"
+
+thread_local ExprPool* ExprPool::s_current = NULL;
+
+ExprPool::ExprPool()
+{
+    m_made = 0;
+    m_shared = 0;
+    m_last = NULL;
+    m_last_line = 0;
+}
+
+void ExprPool::enter_block()
+{
+    m_blocks.push_back(Block());
+}
+
+void ExprPool::leave_block()
+{
+    m_blocks.pop_back();
+}
+
+Visitable* ExprPool::share(Visitable* p)
+{
+    if(m_blocks.empty() || !isa<Expr>(p)) {
+        return p;
+    }
+    ++m_made;
+    m_last_line = static_cast<Expr*>(p)->m_attribute.lineno;
+    std::pair<Block::iterator, bool> found = m_blocks.back().insert(p);
+    if(found.second) {
+        m_last = p;
+        return p;
+    }
+    ++m_shared;
+    ast_release(this, p);
+    m_last = *found.first;
+    return m_last;
+}
+
+Expr* ExprPool::own_line(Expr* e)
+{
+    if(e != m_last || e->m_attribute.lineno == m_last_line) {
+        return e;
+    }
+    Expr* q = static_cast<Expr*>(ast_remake(e));
+    q->m_attribute.lineno = m_last_line;
+    return q;
+}
+
+void ExprPool::release(Visitable* p)
+{
+    if(!isa<Expr>(p)) {
+        ast_release(this, p);
+    }
+}
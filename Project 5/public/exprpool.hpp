@@ -0,0 +1,335 @@
+#ifndef EXPRPOOL_HPP
+#define EXPRPOOL_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "arena.hpp"
+#include "ast.hpp"
+#include "primitive.hpp"
+#include "symtab.hpp"
+
+// Structural hashing and equality for the tree: ast_hash and ast_equal,
+// generated from ast.cdef into ast.cpp, go through a node and tell AstHash
+// and AstEqual about each of its children, which keep what is left to do
+// on a stack rather than recursing, for a tree of any depth.  Line numbers
+// do not count.
+//
+//   AstHash h;
+//   AstEqual e;
+//   if(ast_hash(&h, a) == ast_hash(&h, b) && ast_equal(&e, a, b)) ...
+//
+// ExprPool uses them to share expressions: each expression the parser
+// makes is looked up among the ones the block it is in already has, and if
+// it is there the new one is given back to the arena and the old one used
+// instead.  A block that says a + 1 five hundred times then has one Plus,
+// one Ident and one IntLit for it, and two expressions are the same
+// exactly when they are the same node, so a pass looking for common
+// subexpressions can go by their address.
+//
+// Only expressions are shared, since they are all there is to them: the
+// language has no side effects in an expression (a call is a statement).
+// Each block has its own, since the same name can mean another variable
+// in a nested block, and typecheck gives an Ident the scope it is in.  A
+// shared expression keeps the line it was first made on, which is where
+// typecheck comes to it first and so where it reports an error in it.
+// The one error that is not about the expression itself, a condition that
+// is not boolean, is reported on the condition's line, so the parsers give
+// each condition its own line (own_line).
+//
+// An ExprPool is used the way an Arena is: the parsers share the
+// expressions they make (share_expr) in the pool that is current on their
+// thread, if there is one, which ExprPoolScope makes current.
+
+inline size_t ast_hash_mix(size_t h, size_t x)
+{
+    return (h ^ x) * 1099511628211ULL;
+}
+
+class AstHash
+{
+  private:
+    bool m_shared;
+    std::vector<AstFrame> m_frames;     // the nodes being hashed,
+    std::vector<size_t> m_hashes;       // and their children's hashes so far
+
+    // Mixes the last n hashes into k, in place of them
+    void mix(size_t k, size_t n) {
+        size_t mark = m_hashes.size() - n;
+        for(size_t i = mark; i < m_hashes.size(); ++i) {
+            k = ast_hash_mix(k, m_hashes[i]);
+        }
+        m_hashes.resize(mark);
+        m_hashes.push_back(k);
+    }
+
+  public:
+    // shared says the expressions were made through an ExprPool, so a
+    // child that is one hashes by its address, without going down it
+    AstHash(bool shared = false) {
+        m_shared = shared;
+    }
+
+    /*** For ast_hash ***/
+
+    std::vector<AstFrame>& frames() {
+        return m_frames;
+    }
+
+    // A node is hashed when ast_hash comes back up to it, after its
+    // children; the rest at once.  Either way its hash ends up on top of
+    // m_hashes.
+    void child(Visitable* p) {
+        if(m_shared && isa<Expr>(p)) {
+            m_hashes.push_back((size_t) p);
+        } else {
+            m_frames.push_back(AstFrame(p));
+        }
+    }
+
+    // Names are interned
+    void child(SymName* p) {
+        m_hashes.push_back((size_t) p->spelling());
+    }
+
+    void child(Primitive* p) {
+        m_hashes.push_back(p->m_data);
+    }
+
+    void child(StringPrimitive* p) {
+        size_t k = 0;
+        for(const char* s = p->m_string; *s; ++s) {
+            k = ast_hash_mix(k, (unsigned char) *s);
+        }
+        m_hashes.push_back(k);
+    }
+
+    // A list whose items were just hashed, or a node whose children were
+    template<class T, size_t N> void close(ArenaVector<T, N>* list) {
+        mix(list->size(), list->size());
+    }
+
+    void node(NodeKind kind, size_t children) {
+        mix(kind, children);
+    }
+
+    size_t pop() {
+        size_t k = m_hashes.back();
+        m_hashes.pop_back();
+        return k;
+    }
+};
+
+class AstEqual
+{
+  public:
+    typedef std::pair<Visitable*, Visitable*> Pair;
+
+  private:
+    bool m_shared;
+    std::vector<Pair> m_pairs;          // the nodes still to compare
+
+  public:
+    // The same as for AstHash
+    AstEqual(bool shared = false) {
+        m_shared = shared;
+    }
+
+    /*** For ast_equal ***/
+
+    std::vector<Pair>& pairs() {
+        return m_pairs;
+    }
+
+    // Two nodes are compared later, by ast_equal, unless it is plain what
+    // they are; false only if they are not the same
+    bool child(Visitable* a, Visitable* b) {
+        if(a == b) {
+            return true;
+        }
+        if(m_shared && isa<Expr>(a)) {
+            return false;
+        }
+        m_pairs.push_back(Pair(a, b));
+        return true;
+    }
+
+    template<class T, size_t N> bool child(ArenaVector<T, N>* a,
+                                           ArenaVector<T, N>* b) {
+        if(a->size() != b->size()) {
+            return false;
+        }
+        for(size_t i = 0; i < a->size(); ++i) {
+            if(!child((*a)[i], (*b)[i])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool child(SymName* a, SymName* b) {
+        return a->spelling() == b->spelling();
+    }
+
+    bool child(Primitive* a, Primitive* b) {
+        return a->m_data == b->m_data;
+    }
+
+    bool child(StringPrimitive* a, StringPrimitive* b) {
+        return !strcmp(a->m_string, b->m_string);
+    }
+};
+
+class ExprPool
+{
+  private:
+    struct Hash
+    {
+        // One for each thread, so its stacks are there for the next
+        size_t operator()(Visitable* p) const {
+            static thread_local AstHash h(true);
+            return ast_hash(&h, p);
+        }
+    };
+
+    struct Equal
+    {
+        bool operator()(Visitable* a, Visitable* b) const {
+            static thread_local AstEqual e(true);
+            return ast_equal(&e, a, b);
+        }
+    };
+
+    typedef std::unordered_set<Visitable*, Hash, Equal> Block;
+
+    std::vector<Block> m_blocks;    // the innermost last
+    size_t m_made;                  // expressions made in a block
+    size_t m_shared;                // and found there already
+    Visitable* m_last;              // what share gave last,
+    int m_last_line;                // for a node made on this line
+
+    static thread_local ExprPool* s_current;
+
+  public:
+    ExprPool();
+
+    // Around each block, { ... } and procedure bodies
+    void enter_block();
+    void leave_block();
+
+    // p, or the same expression made before in this block, in which case
+    // p is given back.  Anything that is not an expression, or is not in a
+    // block, is p.
+    Visitable* share(Visitable* p);
+
+    // e, or if e is what share just gave for an expression made on another
+    // line, a node like it on that line
+    Expr* own_line(Expr* e);
+
+    size_t made() const {
+        return m_made;
+    }
+
+    size_t shared() const {
+        return m_shared;
+    }
+
+    static ExprPool* current() {
+        return s_current;
+    }
+
+    static void set_current(ExprPool* pool) {
+        s_current = pool;
+    }
+
+    /*** For ast_release ***/
+
+    void give_back(void* p, size_t n) {
+        Arena::current()->release(p, n);
+    }
+
+    // An expression child is shared, so it stays; the rest were made for
+    // the node being given back
+    void release(Visitable* p);
+
+    template<class T, size_t N> void release(ArenaVector<T, N>* list) {
+        give_back(list, sizeof(*list));
+        for(size_t i = 0; i < list->size(); ++i) {
+            release((*list)[i]);
+        }
+    }
+
+    void release(SymName* p) {
+        give_back(p, sizeof(*p));
+    }
+
+    void release(StringPrimitive* p) {
+        give_back(p, sizeof(*p));
+    }
+};
+
+// Makes a pool current for as long as it is in scope
+class ExprPoolScope
+{
+  private:
+    ExprPool* m_previous;
+
+  public:
+    ExprPoolScope(ExprPool* pool) {
+        m_previous = ExprPool::current();
+        ExprPool::set_current(pool);
+    }
+
+    ~ExprPoolScope() {
+        ExprPool::set_current(m_previous);
+    }
+};
+
+/*** For the parsers ***/
+
+// The parsers make each node with this, once it has its line number
+template<class T> T* share_expr(T* node)
+{
+    ExprPool* pool = ExprPool::current();
+    return pool ? static_cast<T*>(pool->share(node)) : node;
+}
+
+// The parsers give the condition of an if or a while to this, as soon as
+// they have it
+inline Expr* own_line(Expr* e)
+{
+    ExprPool* pool = ExprPool::current();
+    return pool ? pool->own_line(e) : e;
+}
+
+inline void enter_expr_block()
+{
+    if(ExprPool::current()) {
+        ExprPool::current()->enter_block();
+    }
+}
+
+inline void leave_expr_block()
+{
+    if(ExprPool::current()) {
+        ExprPool::current()->leave_block();
+    }
+}
+
+// Enters a block for as long as it is in scope, syntax error or not
+class ExprBlock
+{
+  public:
+    ExprBlock() {
+        enter_expr_block();
+    }
+
+    ~ExprBlock() {
+        leave_expr_block();
+    }
+};
+
+#endif //EXPRPOOL_HPP
@@ -0,0 +1,27 @@
+#include "flatast.hpp"
+
+FlatNode FlatAst::add(SymName* p)
+{
+    m_strings.push_back(p->spelling());
+    return node(fk_SymName, m_strings.size() - 1);
+}
+
+FlatNode FlatAst::add(Primitive* p)
+{
+    return node(fk_Primitive, p->m_data);
+}
+
+FlatNode FlatAst::add(StringPrimitive* p)
+{
+    m_strings.push_back(p->m_string);
+    return node(fk_StringPrimitive, m_strings.size() - 1);
+}
+
+size_t FlatAst::bytes() const
+{
+    return m_kind.capacity() * sizeof(unsigned char)
+        + m_first_child.capacity() * sizeof(FlatNode)
+        + m_next_sibling.capacity() * sizeof(FlatNode)
+        + m_payload.capacity() * sizeof(unsigned)
+        + m_strings.capacity() * sizeof(const char*);
+}
@@ -0,0 +1,187 @@
+#ifndef FLATAST_HPP
+#define FLATAST_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "ast.hpp"
+#include "primitive.hpp"
+#include "symtab.hpp"
+
+// The tree again, without pointers: each node is a number, a FlatNode,
+// and what there is to know about it is kept in arrays indexed by that
+// number, one array for each thing:
+//
+//   kind          a NodeKind, or a FlatKind for what is not a node
+//   first child   or FLAT_NONE
+//   next sibling  the next child of its parent, or FLAT_NONE
+//   payload       a node's line, how many items a list has, a name's or
+//                 a string literal's index in the strings, or a
+//                 Primitive's value
+//
+// There is no vtable or Attribute, and the children are
+// not spread around the arena, so a node takes 13 bytes and a pass that
+// looks at every node reads memory in order.  The nodes are numbered the
+// way a walk comes to them, each node before its children, so a pass that
+// does not care about the shape can simply go from 0 to size().  A list
+// is a node of its own, whose children are its items.
+//
+// ast_flatten, generated from ast.cdef into ast.cpp, adds a tree, with the
+// nodes it is in on a stack of FlatAst's rather than by recursion:
+//
+//   FlatAst flat;
+//   FlatNode root = flat.add(ast);
+//   for(FlatNode c = flat.first_child(root); c != FLAT_NONE;
+//       c = flat.next_sibling(c)) ...
+//
+// The compiler itself still uses the tree; parsebench times a walk over
+// the flat one against the walks over the tree.
+
+const FlatNode FLAT_NONE = 0xffffffff;
+
+// The kinds after the NodeKinds
+enum FlatKind
+{
+    fk_List = nk_count,
+    fk_SymName,
+    fk_Primitive,
+    fk_StringPrimitive
+};
+
+class FlatAst
+{
+  private:
+    std::vector<unsigned char> m_kind;
+    std::vector<FlatNode> m_first_child;
+    std::vector<FlatNode> m_next_sibling;
+    std::vector<unsigned> m_payload;
+    std::vector<const char*> m_strings;
+
+    struct Parent
+    {
+        FlatNode m_node;
+        FlatNode m_last;                // child so far
+
+        Parent(FlatNode node) : m_node(node), m_last(FLAT_NONE) {}
+    };
+
+    std::vector<AstFrame> m_frames;     // the nodes being added,
+    std::vector<Parent> m_parents;      // and their flat nodes and lists
+
+    // Makes n the next child of the innermost parent, if there is one
+    void link(FlatNode n) {
+        if(m_parents.empty()) {
+            return;
+        }
+        Parent& parent = m_parents.back();
+        if(parent.m_last == FLAT_NONE) {
+            m_first_child[parent.m_node] = n;
+        } else {
+            m_next_sibling[parent.m_last] = n;
+        }
+        parent.m_last = n;
+    }
+
+  public:
+    // Adds the tree under p and gives its root
+    FlatNode add(Visitable* p) {
+        return ast_flatten(this, p);
+    }
+
+    FlatNode add(SymName* p);
+    FlatNode add(Primitive* p);
+    FlatNode add(StringPrimitive* p);
+
+    size_t size() const {
+        return m_kind.size();
+    }
+
+    // What the arrays take
+    size_t bytes() const;
+
+    // A NodeKind or a FlatKind
+    int kind(FlatNode n) const {
+        return m_kind[n];
+    }
+
+    FlatNode first_child(FlatNode n) const {
+        return m_first_child[n];
+    }
+
+    FlatNode next_sibling(FlatNode n) const {
+        return m_next_sibling[n];
+    }
+
+    unsigned payload(FlatNode n) const {
+        return m_payload[n];
+    }
+
+    // Of a node
+    int lineno(FlatNode n) const {
+        return m_payload[n];
+    }
+
+    // Of a name or a string literal
+    const char* string(FlatNode n) const {
+        return m_strings[m_payload[n]];
+    }
+
+    // Of a Primitive
+    int value(FlatNode n) const {
+        return (int) m_payload[n];
+    }
+
+    /*** For ast_flatten ***/
+
+    std::vector<AstFrame>& frames() {
+        return m_frames;
+    }
+
+    // A node with no children yet
+    FlatNode node(int kind, unsigned payload) {
+        m_kind.push_back(kind);
+        m_first_child.push_back(FLAT_NONE);
+        m_next_sibling.push_back(FLAT_NONE);
+        m_payload.push_back(payload);
+        return m_kind.size() - 1;
+    }
+
+    // A node or a list as the next child of the one ast_flatten is in,
+    // which it is in itself until leave
+    void enter(int kind, unsigned payload) {
+        FlatNode n = node(kind, payload);
+        link(n);
+        m_parents.push_back(Parent(n));
+    }
+
+    void leave() {
+        m_parents.pop_back();
+    }
+
+    // A node is added when ast_flatten comes to it; the rest at once
+    void child(Visitable* p) {
+        m_frames.push_back(AstFrame(p));
+    }
+
+    void child(SymName* p) {
+        link(add(p));
+    }
+
+    void child(Primitive* p) {
+        link(add(p));
+    }
+
+    void child(StringPrimitive* p) {
+        link(add(p));
+    }
+
+    template<class T, size_t N> void open(ArenaVector<T, N>* list) {
+        enter(fk_List, list->size());
+    }
+
+    template<class T, size_t N> void close(ArenaVector<T, N>*) {
+        leave();
+    }
+};
+
+#endif //FLATAST_HPP
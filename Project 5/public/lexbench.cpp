@@ -0,0 +1,300 @@
+// lexbench runs the scanner in scanner.cpp on its own, without the
+// parser, to time it or to see what it does.
+//
+// usage: lexbench [-d] [-n runs] [-j threads] file
+//        lexbench -g bytes [-t kind]
+//   -d    print every token, one per line, instead of timing the scanner.
+//         It prints the same thing on one thread as on more, which is
+//         what "make lexcheck" checks.
+//   -n    scan the file this many times and keep the fastest (default 5)
+//   -j    lex on this many threads
+//   -g    write a made up program of about this many bytes to stdout, full
+//         of the corner cases of the number, comment and literal rules
+//   -t    what kind of program -g makes: mixed (the default), comments
+//         (mostly long comments) or literals (mostly numbers, strings and
+//         things that start out looking like them)
+//
+// Characters the scanner does not know are echoed to stdout, like flex
+// does, so timing runs should send stdout somewhere.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "ast.hpp"
+#include "parser.hpp"
+#include "lexer.hpp"
+#include "source.hpp"
+#include "strpool.hpp"
+
+/*** Dumping and timing ***/
+
+static const char* s_token_names[] = {
+    "T_BOOLEAN", "T_CHAR", "T_INTEGER", "T_STRING", "T_INTPTR", "T_CHARPTR",
+    "T_IF", "T_ELSE", "T_WHILE", "T_VAR", "T_PROCEDURE", "T_RETURN", "T_NULL",
+    "T_AND", "T_DIVIDE", "T_EQUAL", "T_BOOL_EQUAL", "T_GREATER_THAN",
+    "T_GREATER_THAN_OR_EQUAL", "T_LESS_THAN", "T_LESS_THAN_OR_EQUAL",
+    "T_MINUS", "T_NOT", "T_NOT_EQUAL", "T_OR", "T_PLUS", "T_TIMES",
+    "T_REFERENCE", "T_DEREFERENCE", "T_BOOL_LITERAL", "T_CHAR_LITERAL",
+    "T_INTEGER_LITERAL", "T_STRING_LITERAL", "T_IDENTIFIER_LITERAL",
+    "T_SEMICOLON", "T_COLON", "T_COMMA", "T_BAR", "T_OPEN_CURLY",
+    "T_CLOSE_CURLY", "T_OPEN_PARAN", "T_CLOSE_PARAN", "T_OPEN_SQUARE",
+    "T_CLOSE_SQUARE",
+};
+
+// The line, the token and its value.  Echoed characters end up in between
+// the tokens, so they get compared too.
+static void dump(SourceBuffer& source, int threads)
+{
+    StringPool strpool;
+    YYSTYPE value;
+    yyscan_t scanner = lexer_create(&source, &strpool, stdout, threads);
+
+    for(int token; (token = yylex(&value, scanner)) != 0; ) {
+        printf("%d %s", lexer_lineno(scanner),
+               s_token_names[token - T_BOOLEAN]);
+        switch(token) {
+            case T_BOOL_LITERAL:
+            case T_CHAR_LITERAL:
+            case T_INTEGER_LITERAL:
+                printf(" %d", value.u_base_int);
+                break;
+            case T_STRING_LITERAL:
+                printf(" \"%s\"", value.u_base_charptr);
+                break;
+            case T_IDENTIFIER_LITERAL:
+                printf(" %s #%d", value.u_base_charptr,
+                       StringPool::id(value.u_base_charptr));
+                break;
+        }
+        printf("\n");
+    }
+    printf("%d end\n", lexer_lineno(scanner));
+    lexer_destroy(scanner);
+}
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Scans the file runs times.  Each run gets a fresh copy of the file,
+// since string literals are cut out of it in place.
+static void bench(const char* path, int runs, int threads)
+{
+    double best = 1e30;
+    long tokens = 0;
+    size_t bytes = 0;
+
+    for(int i = 0; i < runs; ++i) {
+        int fd = open(path, O_RDONLY);
+        if(fd < 0) {
+            perror(path);
+            exit(1);
+        }
+        SourceBuffer source(fd);
+        close(fd);
+        StringPool strpool;
+        YYSTYPE value;
+        bytes = source.size();
+
+        double start = now();
+        yyscan_t scanner = lexer_create(&source, &strpool, stdout, threads);
+        for(tokens = 0; yylex(&value, scanner) != 0; ++tokens)
+            ;
+        double seconds = now() - start;
+        lexer_destroy(scanner);
+        if(seconds < best) {
+            best = seconds;
+        }
+    }
+
+    fprintf(stderr, "%s: %zu bytes, %ld tokens, %.4f s, %.1f MB/s, %.2f Mtok/s\n",
+            path, bytes, tokens, best, bytes / best / 1e6, tokens / best / 1e6);
+}
+
+/*** Making up programs ***/
+
+static unsigned long long s_seed = 5;
+
+static unsigned random(unsigned n)
+{
+    s_seed = s_seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (unsigned)(s_seed >> 33) % n;
+}
+
+static const char* pick(const char* const* words, int n)
+{
+    return words[random(n)];
+}
+
+#define PICK(words) pick(words, sizeof(words) / sizeof(words[0]))
+
+// Keywords and words that are nearly keywords
+static const char* const s_words[] = {
+    "boolean", "char", "integer", "string", "intptr", "charptr", "if",
+    "else", "while", "var", "procedure", "return", "null", "true", "false",
+    "booleans", "cha", "charp", "i", "iff", "elsewhere", "truex", "False",
+    "x", "count", "a_b", "n0", "Main", "procedure_1", "z9_",
+};
+
+static const char* const s_operators[] = {
+    "&&", "&", "/", "=", "==", ">", ">=", "<", "<=", "-", "!", "!=", "||",
+    "|", "+", "*", "^", ";", ":", ",", "{", "}", "(", ")", "[", "]",
+};
+
+static const char* const s_numbers[] = {
+    "0", "7", "42", "1234567", "99999999999999999999", "0x1F", "0XfF",
+    "0x", "0|", "0|a", "017", "019", "00", "0101b", "1b", "0b", "12b",
+    "101", "0x0x1", "08",
+};
+
+static const char* const s_literals[] = {
+    "'a'", "' '", "'''", "'\"'", "'ab'", "'", "\"hello\"", "\"\"",
+    "\"a 'quoted' word\"", "\"unterminated\n",
+};
+
+static const char* const s_comments[] = {
+    "/% a comment %/", "/%%/", "/%%%/", "/% 50%% %/", "/% %%/ still in %/",
+    "/%\nover\nlines\n%/", "/% % / %/", "/%/ %/", "%/", "/ %",
+};
+
+// Bits of comment for the long ones in -t comments
+static const char* const s_comment_text[] = {
+    "the quick brown fox", "%%", "%%/", "% ", "/", "//", "\n", "\n  ",
+    "\"not a string\"", "'x'", "100%% sure", "if (x) { }",
+};
+
+// More literals, for -t literals
+static const char* const s_long_literals[] = {
+    "0101010101010101010101010101010101", "0101010101010101010101010101b",
+    "1111111111111111111111111111111112", "0x0123456789abcdefABCDEF",
+    "0777777777777777777778", "123456789012345678901234567890",
+    "\"a longer string literal, with 'quotes' and /% no comment %/ in it\"",
+    "\"this one has no end ' \n", "'ab", "''", "'\"'", "'\t'",
+};
+
+static const char* const s_strays[] = { "%", "_", "@", "#", "$", ".", "?" };
+
+static const char* const s_spaces[] = { " ", " ", " ", "\n", "\t", "  ", "" };
+
+static void generate_mixed(long bytes)
+{
+    long written = 0;
+    while(written < bytes) {
+        const char* s;
+        switch(random(20)) {
+            case 0: case 1: case 2: case 3: case 4: case 5: case 6:
+                s = PICK(s_words);
+                break;
+            case 7: case 8: case 9: case 10: case 11:
+                s = PICK(s_operators);
+                break;
+            case 12: case 13: case 14:
+                s = PICK(s_numbers);
+                break;
+            case 15: case 16:
+                s = PICK(s_literals);
+                break;
+            case 17: case 18:
+                s = PICK(s_comments);
+                break;
+            default:
+                s = PICK(s_strays);
+                break;
+        }
+        written += printf("%s%s", s, PICK(s_spaces));
+    }
+    // In case the last "/%" was left open
+    printf("\n%%/\n");
+}
+
+static void generate_comments(long bytes)
+{
+    long written = 0;
+    while(written < bytes) {
+        written += printf("%s = %s;\n/%%", PICK(s_words), PICK(s_numbers));
+        for(int n = random(200); n > 0; --n) {
+            written += printf("%s", PICK(s_comment_text));
+        }
+        written += printf("%%/\n");
+    }
+}
+
+static void generate_literals(long bytes)
+{
+    long written = 0;
+    while(written < bytes) {
+        const char* s = random(2) ? PICK(s_long_literals) : PICK(s_numbers);
+        written += printf("%s%s", s, random(4) ? " " : PICK(s_operators));
+    }
+}
+
+/*** Main ***/
+
+static void usage(const char* prog)
+{
+    fprintf(stderr, "usage: %s [-d] [-n runs] [-j threads] file\n", prog);
+    fprintf(stderr, "       %s -g bytes [-t mixed|comments|literals]\n", prog);
+    exit(1);
+}
+
+int main(int argc, char** argv)
+{
+    bool dumping = false;
+    int runs = 5;
+    int threads = 1;
+    long generating = 0;
+    const char* kind = "mixed";
+    int i;
+
+    for(i = 1; i < argc && argv[i][0] == '-'; ++i) {
+        if(!strcmp(argv[i], "-d")) {
+            dumping = true;
+        } else if(!strcmp(argv[i], "-n") && i + 1 < argc) {
+            runs = atoi(argv[++i]);
+        } else if(!strcmp(argv[i], "-j") && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if(!strcmp(argv[i], "-g") && i + 1 < argc) {
+            generating = atol(argv[++i]);
+        } else if(!strcmp(argv[i], "-t") && i + 1 < argc) {
+            kind = argv[++i];
+        } else {
+            usage(argv[0]);
+        }
+    }
+    if(generating > 0 && i == argc) {
+        if(!strcmp(kind, "mixed")) {
+            generate_mixed(generating);
+        } else if(!strcmp(kind, "comments")) {
+            generate_comments(generating);
+        } else if(!strcmp(kind, "literals")) {
+            generate_literals(generating);
+        } else {
+            usage(argv[0]);
+        }
+        return 0;
+    }
+    if(i + 1 != argc || runs < 1) {
+        usage(argv[0]);
+    }
+
+    if(dumping) {
+        int fd = open(argv[i], O_RDONLY);
+        if(fd < 0) {
+            perror(argv[i]);
+            exit(1);
+        }
+        SourceBuffer source(fd);
+        dump(source, threads);
+    } else {
+        bench(argv[i], runs, threads);
+    }
+    return 0;
+}
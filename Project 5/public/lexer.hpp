@@ -0,0 +1,49 @@
+#ifndef LEXER_HPP
+#define LEXER_HPP
+
+#include <cstdio>
+
+#include "ast.hpp"
+
+class SourceBuffer;
+class StringPool;
+
+// What the parser and the compiler need from a scanner, which scanner.cpp
+// provides.  It keeps the names a reentrant flex scanner would have.  All
+// the state of a scan is in the yyscan_t, so any number of them can run at
+// once, on different threads.
+
+// The same typedef as flex's
+typedef void* yyscan_t;
+
+// A scanner for the program in source, scanned in place, that interns
+// identifiers into strpool.  Both have to outlive the AST, which points
+// into them.  Characters that no rule matches are copied to out, like
+// flex does.  With threads > 1 a big program is lexed in parallel.
+yyscan_t lexer_create(SourceBuffer* source, StringPool* strpool,
+                      FILE* out, int threads);
+void lexer_destroy(yyscan_t scanner);
+
+// The next token, with its value in *value, or 0 at the end
+int yylex(YYSTYPE* value, yyscan_t scanner);
+
+// The line the scanner is on (yylineno)
+int lexer_lineno(yyscan_t scanner);
+
+// For parsing a procedure body later than the rest (rdparser.cpp).  None
+// of these work on a program that was lexed in parallel.
+
+// Where in the text the scanner is, just after the last token it returned
+const char* lexer_position(yyscan_t scanner);
+
+// Goes on scanning from pos, with pos on line.  The text from pos on can
+// not have been scanned yet (string literals are cut out of it in place).
+void lexer_seek(yyscan_t scanner, const char* pos, int line);
+
+// Moves past a { } block whose "{" is the last token returned, without
+// making tokens of what is in it (see skip_block in source.hpp), and gives
+// where and on what line its body starts.  False, with the scanner where
+// it was, if the program ends before the block does.
+bool lexer_skip_block(yyscan_t scanner, const char** body, int* line);
+
+#endif //LEXER_HPP
@@ -1,41 +1,60 @@
 /**
  *  This file is provided for you to run your parser.  You should not have
  *  to edit anything if you did the yacc, lex, and typecheck.cpp files
- *  correctly. All this file does is calls yyparse() and uses the visitor
- *  class to typecheck and print the graph.
+ *  correctly. All this file does is read the program and hand it to
+ *  compile() (compile.cpp), which parses, typechecks and generates code.
  */
 
-#include "ast.hpp"
-#include "parser.hpp"
-#include "symtab.hpp"
-#include "primitive.hpp"
-#include <assert.h>
+#include "source.hpp"
+#include "compile.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 extern int yydebug;
-extern int yyparse();
 
-// This is defined in ast2dot.cpp
-void dopass_ast2dot(Program_ptr ast);
-
-// This is defined in typecheck.cpp
-void dopass_typecheck(Program_ptr ast, SymTab* st);
-
-// This is defined in codegen.cpp
-void dopass_codegen(Program_ptr ast, SymTab* st);
-
-// Make sure to set this to the final // syntax tree in parser.ypp
-Program_ptr ast;
-int main(void)
+int main(int argc, char** argv)
 {
     yydebug = 0;    // Set yydebug to 1 if you want yyparse() to dump a trace
-    yyparse();
 
-    SymTab st;      // Symbol Table
-    if(ast) {       // Walk over the ast
-        dopass_typecheck(ast, &st);
-        // dopass_ast2dot(ast);
-        dopass_codegen(ast, &st);
+    // csimple [-j threads] [-w] [-r] [-l] [-c file] [-s] < program
+    //   -j  lex a big program on this many threads
+    //   -w  parse the whole program before compiling any of it
+    //   -r  parse with the hand written parser instead of the bison one
+    //   -l  only parse the procedures Main can get to (implies -r).  The
+    //       others are left out of the assembly, so it is shorter than
+    //       without -l, and characters in their bodies that the scanner
+    //       does not know are not copied to it either.
+    //   -c  keep the parsed program in file, and use it if the program
+    //       has not changed (implies -w)
+    //   -s  make each expression only once in each block
+    CompileOptions options;
+    for(int i = 1; i < argc; ++i) {
+        if(!strcmp(argv[i], "-j") && i + 1 < argc) {
+            options.m_threads = atoi(argv[++i]);
+        } else if(!strcmp(argv[i], "-w")) {
+            options.m_whole_tree = true;
+        } else if(!strcmp(argv[i], "-r")) {
+            options.m_hand_parser = true;
+        } else if(!strcmp(argv[i], "-l")) {
+            options.m_lazy_bodies = true;
+        } else if(!strcmp(argv[i], "-c") && i + 1 < argc) {
+            options.m_ast_cache = argv[++i];
+        } else if(!strcmp(argv[i], "-s")) {
+            options.m_share_exprs = true;
+        } else {
+            fprintf(stderr,
+                    "usage: %s [-j threads] [-w] [-r] [-l] [-c file] [-s] "
+                    "< program\n",
+                    argv[0]);
+            return 1;
+        }
     }
 
-    return 0;
+    SourceBuffer source(0);     // The program, read from stdin
+    options.m_output = stdout;
+    CompileResult result = compile(&source, options);
+
+    fwrite(result.m_errors.data(), 1, result.m_errors.size(), stderr);
+    return result.m_status;
 }
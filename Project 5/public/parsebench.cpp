@@ -0,0 +1,905 @@
+// parsebench runs the two parsers, the bison one (parser.ypp) and the hand
+// written one (rdparser.cpp, also with lazy bodies), on their own, without
+// typecheck or codegen, to time them or to see what tree they build.
+//
+// usage: parsebench [-d] [-r | -l | -m] [-c tree] [-S] [-n runs] file
+//        parsebench -g bytes [-e] [-D] [-s seed]
+//   -d    print the tree, with the line of every node, and any syntax
+//         error, instead of timing the parsers.  Both parsers print the
+//         same thing for the same input when they agree, which is what
+//         "make parsecheck" checks.
+//   -r    with -d, use the hand written parser (the default is bison)
+//   -l    with -d, use the hand written parser, only parsing the bodies
+//         of what Main can get to (rdparse_lazy)
+//   -m    with -d, use bison, and leave out of the tree the procedures Main
+//         can not get to.  For a program without syntax errors this prints
+//         what -l does.
+//   -c    with -d, save the tree to this file (see astcache.hpp), read it
+//         back, and print what was read.  It should print the same.
+//   -S    with -d, share expressions the way csimple -s does (see
+//         exprpool.hpp).  A shared expression is printed wherever it is
+//         used, with the line it was first made on.
+//   -n    parse the file this many times with each parser and keep the
+//         fastest (default 5)
+//   -g    write a made up program of about this many bytes to stdout,
+//         using every rule of the grammar
+//   -e    put syntax errors in it (a token here and there is changed)
+//   -D    now and then nest an expression far deeper than usual: deep
+//         enough that the hand written parser leaves the procedure to
+//         bison, and with -e sometimes deeper than bison's stack goes (see
+//         PARSER_STACK_DEPTH)
+//   -s    the seed for -g
+//
+// The times include the scanner, which is timed on its own too, so what
+// the parser takes is the difference.  Walking the tree (through the
+// virtual Visitor, StaticVisitor and StackVisitor) and freeing it are not
+// in them; they are timed apart, with how big the tree is and what that
+// comes to for each node walked (names and literals count as nodes).  So
+// are making the flat tree (see flatast.hpp) and walking it, from child to
+// sibling and in the order of the nodes.  The cache row is how long
+// csimple -c takes instead, when it finds the tree saved: to hash the text
+// and read the tree the hand written parser built.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "arena.hpp"
+#include "ast.hpp"
+#include "astcache.hpp"
+#include "exprpool.hpp"
+#include "flatast.hpp"
+#include "primitive.hpp"
+#include "symtab.hpp"
+#include "parser.hpp"
+#include "lexer.hpp"
+#include "source.hpp"
+#include "strpool.hpp"
+
+// These are defined in rdparser.cpp
+int rdparse(yyscan_t scanner, Program_ptr* ast, ProcedureSink* sink,
+            FILE* errors);
+int rdparse_lazy(yyscan_t scanner, Program_ptr* ast, ProcedureSink* sink,
+                 FILE* errors);
+
+enum Parser { BISON, HAND, LAZY, SCANNER, CACHE };
+
+static int parse(int parser, yyscan_t scanner, Program_ptr* ast,
+                 FILE* errors)
+{
+    switch(parser) {
+        case HAND:
+            return rdparse(scanner, ast, NULL, errors);
+        case LAZY:
+            return rdparse_lazy(scanner, ast, NULL, errors);
+    }
+    return yyparse(scanner, ast, NULL, NULL, errors);
+}
+
+/*** Dumping and timing ***/
+
+#define EVERY_NODE(NODE) \
+    NODE(ProgramImpl) NODE(ProcImpl) NODE(Procedure_blockImpl) \
+    NODE(Nested_blockImpl) NODE(DeclImpl) NODE(Assignment) \
+    NODE(StringAssignment) NODE(Call) NODE(IfNoElse) NODE(IfWithElse) \
+    NODE(WhileLoop) NODE(CodeBlock) NODE(Return) NODE(TInteger) \
+    NODE(TCharacter) NODE(TBoolean) NODE(TCharPtr) NODE(TIntPtr) \
+    NODE(TString) NODE(AbsoluteValue) NODE(AddressOf) NODE(And) NODE(Div) \
+    NODE(Compare) NODE(Gt) NODE(Gteq) NODE(Lt) NODE(Lteq) NODE(Minus) \
+    NODE(Noteq) NODE(Or) NODE(Plus) NODE(Times) NODE(Not) NODE(Uminus) \
+    NODE(Ident) NODE(ArrayAccess) NODE(IntLit) NODE(CharLit) NODE(BoolLit) \
+    NODE(NullLit) NODE(Deref) NODE(Variable) NODE(DerefVariable) \
+    NODE(ArrayElement)
+
+// One node per line, indented under its parent, with its line number
+class Dump : public Visitor
+{
+  private:
+    int m_depth;
+
+    void print(const char* name, int line) {
+        printf("%*s%s %d\n", 2 * m_depth, "", name, line);
+    }
+
+  public:
+    Dump() {
+        m_depth = 0;
+    }
+
+#define NODE(T) \
+    void visit##T(T* p) { \
+        print(#T, p->m_attribute.lineno); \
+        ++m_depth; \
+        p->visit_children(this); \
+        --m_depth; \
+    }
+
+    EVERY_NODE(NODE)
+
+#undef NODE
+
+    void visitSymName(SymName* p) {
+        printf("%*s%s\n", 2 * m_depth, "", p->spelling());
+    }
+
+    void visitPrimitive(Primitive* p) {
+        printf("%*s%d\n", 2 * m_depth, "", p->m_data);
+    }
+
+    void visitStringPrimitive(StringPrimitive* p) {
+        printf("%*s\"%s\"\n", 2 * m_depth, "", p->m_string);
+    }
+};
+
+// The names of the procedures called anywhere under a node
+class Calls : public StaticVisitor<Calls>
+{
+  public:
+    std::vector<const char*> m_names;
+
+    void visitCall(Call* p) {
+        m_names.push_back(p->m_symname.spelling());
+        visit_children(p);
+    }
+};
+
+// Deletes the top level procedures that Main does not call, or call
+// something that does, and so on, the way rdparse_lazy decides which
+// bodies to parse
+static void keep_reachable(ProgramImpl* program)
+{
+    Proc_list* procs = program->m_proc_list;
+    std::vector<bool> reached(procs->size(), false);
+    std::vector<const char*> names(1, "Main");
+
+    while(!names.empty()) {
+        const char* name = names.back();
+        names.pop_back();
+        for(size_t i = 0; i < procs->size(); ++i) {
+            ProcImpl* proc = cast<ProcImpl>((*procs)[i]);
+            if(!reached[i] && !strcmp(name, proc->m_symname.spelling())) {
+                reached[i] = true;
+                Calls calls;
+                calls.visit(proc);
+                names.insert(names.end(), calls.m_names.begin(),
+                             calls.m_names.end());
+            }
+        }
+    }
+
+    size_t kept = 0;
+    for(size_t i = 0; i < procs->size(); ++i) {
+        if(reached[i]) {
+            (*procs)[kept++] = (*procs)[i];
+        }
+    }
+    procs->resize(kept);
+}
+
+// The line is the program's, which is where the scanner is once it has
+// read to the end, except that rdparse_lazy goes back to parse the bodies
+static void dump(SourceBuffer& source, int parser, bool reachable,
+                 const char* cache, bool sharing)
+{
+    Arena tree;
+    ArenaScope scope(&tree);
+    ExprPool pool;
+    ExprPoolScope pool_scope(sharing ? &pool : NULL);
+    StringPool strpool;
+    AstReader reader(&strpool);
+    Program_ptr ast = NULL;
+    unsigned long long key = ast_cache_key(source.text(), source.size());
+    unsigned flags = parser == LAZY ? AST_CACHE_LAZY : 0;
+    yyscan_t scanner = lexer_create(&source, &strpool, stdout, 1);
+
+    int status = parse(parser, scanner, &ast, stdout);
+    if(status == 0 && cache) {
+        AstWriter writer;
+        if(!writer.save(cache, ast, key, source.size(), flags, "")
+           || !reader.open(cache, key, source.size(), flags)) {
+            perror(cache);
+            exit(1);
+        }
+        ast = reader.root();
+        if(ast == NULL) {
+            fprintf(stderr, "%s: the tree read back is wrong\n", cache);
+            exit(1);
+        }
+    }
+    printf("status %d, line %d\n", status,
+           status == 0 ? ast->m_attribute.lineno : lexer_lineno(scanner));
+    if(status == 0) {
+        if(reachable) {
+            keep_reachable(cast<ProgramImpl>(ast));
+        }
+        Dump d;
+        ast->accept(&d);
+    }
+    lexer_destroy(scanner);
+}
+
+static double now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Visits every node, the way typecheck and codegen walk the tree.  Count
+// goes through accept, StaticCount through StaticVisitor and StackCount
+// through StackVisitor.
+class Count : public Visitor
+{
+  public:
+    long m_nodes;
+
+    Count() {
+        m_nodes = 0;
+    }
+
+#define NODE(T) \
+    void visit##T(T* p) { \
+        ++m_nodes; \
+        p->visit_children(this); \
+    }
+
+    EVERY_NODE(NODE)
+
+#undef NODE
+
+    void visitSymName(SymName*) {
+        ++m_nodes;
+    }
+
+    void visitPrimitive(Primitive*) {
+        ++m_nodes;
+    }
+
+    void visitStringPrimitive(StringPrimitive*) {
+        ++m_nodes;
+    }
+};
+
+class StaticCount : public StaticVisitor<StaticCount>
+{
+  public:
+    long m_nodes;
+
+    StaticCount() {
+        m_nodes = 0;
+    }
+
+#define NODE(T) \
+    void visit##T(T* p) { \
+        ++m_nodes; \
+        visit_children(p); \
+    }
+
+    EVERY_NODE(NODE)
+
+#undef NODE
+
+    void visitSymName(SymName*) {
+        ++m_nodes;
+    }
+
+    void visitPrimitive(Primitive*) {
+        ++m_nodes;
+    }
+
+    void visitStringPrimitive(StringPrimitive*) {
+        ++m_nodes;
+    }
+};
+
+class StackCount : public StackVisitor<StackCount>
+{
+  public:
+    long m_nodes;
+
+    StackCount() {
+        m_nodes = 0;
+    }
+
+#define NODE(T) \
+    bool pre##T(T*) { \
+        ++m_nodes; \
+        return true; \
+    }
+
+    EVERY_NODE(NODE)
+
+#undef NODE
+
+    void visitSymName(SymName*) {
+        ++m_nodes;
+    }
+
+    void visitPrimitive(Primitive*) {
+        ++m_nodes;
+    }
+
+    void visitStringPrimitive(StringPrimitive*) {
+        ++m_nodes;
+    }
+};
+
+// The same walk over the flat tree, counting what Count does
+static long flat_count(const FlatAst& flat, FlatNode n)
+{
+    long nodes = flat.kind(n) != fk_List;
+    for(FlatNode c = flat.first_child(n); c != FLAT_NONE;
+        c = flat.next_sibling(c)) {
+        nodes += flat_count(flat, c);
+    }
+    return nodes;
+}
+
+// The fastest of the runs at each thing
+struct Timing
+{
+    size_t bytes;
+    long tokens;
+    double parse;       // scanning (and parsing)
+    double walk;        // visiting the whole tree, with Count
+    double static_walk; // and with StaticCount
+    double stack_walk;  // and with StackCount
+    double teardown;    // freeing the tree
+    double flatten;     // making the flat tree
+    double flat_walk;   // walking it with flat_count
+    double flat_scan;   // and in the order of the nodes
+    size_t tree;        // how much of the arena the tree took
+    size_t flat;        // and how much the flat tree took
+    long nodes;
+};
+
+// Parses the file runs times with one of the parsers, or (SCANNER) just
+// scans it, or (CACHE) reads the tree from cache.  Each run gets a fresh
+// copy of the file, since string literals are cut out of it in place.
+static Timing bench(const char* path, int runs, int what, const char* cache)
+{
+    Timing best;
+    best.parse = best.walk = best.static_walk = best.stack_walk = 1e30;
+    best.teardown = 1e30;
+    best.flatten = best.flat_walk = best.flat_scan = 1e30;
+    best.flat = 0;
+    best.tokens = best.nodes = 0;
+
+    for(int i = 0; i < runs; ++i) {
+        int fd = open(path, O_RDONLY);
+        if(fd < 0) {
+            perror(path);
+            exit(1);
+        }
+        SourceBuffer source(fd);
+        close(fd);
+        StringPool strpool;
+        AstReader reader(&strpool);
+        Program_ptr ast = NULL;
+        Arena* arena = new Arena();
+        ArenaScope scope(arena);
+        best.bytes = source.size();
+
+        // The tree the hand written parser builds is saved for the cache
+        // row, under the text as it is before the scanner cuts it
+        unsigned long long key = 0;
+        if(what == HAND && i == 0) {
+            key = ast_cache_key(source.text(), source.size());
+        }
+
+        double start = now();
+        if(what == CACHE) {
+            if(!reader.open(cache, ast_cache_key(source.text(), source.size()),
+                            source.size(), 0)) {
+                fprintf(stderr, "%s: no tree for %s\n", cache, path);
+                exit(1);
+            }
+            ast = reader.root();
+            if(ast == NULL) {
+                fprintf(stderr, "%s: a wrong tree for %s\n", cache, path);
+                exit(1);
+            }
+        } else {
+            yyscan_t scanner = lexer_create(&source, &strpool, stdout, 1);
+            if(what == SCANNER) {
+                YYSTYPE value;
+                for(best.tokens = 0; yylex(&value, scanner) != 0;
+                    ++best.tokens)
+                    ;
+            } else if(parse(what, scanner, &ast, stderr) != 0) {
+                exit(1);
+            }
+            lexer_destroy(scanner);
+        }
+        double parsing = now() - start;
+        best.tree = arena->bytes();
+
+        start = now();
+        if(ast) {
+            Count count;
+            ast->accept(&count);
+            best.nodes = count.m_nodes;
+        }
+        double walking = now() - start;
+
+        start = now();
+        if(ast) {
+            StaticCount count;
+            count.visit(ast);
+            if(count.m_nodes != best.nodes) {
+                fprintf(stderr, "the walks visit %ld and %ld nodes\n",
+                        best.nodes, count.m_nodes);
+                exit(1);
+            }
+        }
+        double static_walking = now() - start;
+
+        start = now();
+        if(ast) {
+            StackCount count;
+            count.walk(ast);
+            if(count.m_nodes != best.nodes) {
+                fprintf(stderr, "the walks visit %ld and %ld nodes\n",
+                        best.nodes, count.m_nodes);
+                exit(1);
+            }
+        }
+        double stack_walking = now() - start;
+
+        FlatAst flat;
+        start = now();
+        if(ast) {
+            flat.add(ast);
+            best.flat = flat.bytes();
+        }
+        double flattening = now() - start;
+
+        start = now();
+        if(ast) {
+            long nodes = flat_count(flat, 0);
+            if(nodes != best.nodes) {
+                fprintf(stderr, "the flat walk visits %ld nodes, not %ld\n",
+                        nodes, best.nodes);
+                exit(1);
+            }
+        }
+        double flat_walking = now() - start;
+
+        start = now();
+        if(ast) {
+            long nodes = 0;
+            for(FlatNode n = 0; n < flat.size(); ++n) {
+                nodes += flat.kind(n) != fk_List;
+            }
+            if(nodes != best.nodes) {
+                fprintf(stderr, "the flat tree has %ld nodes, not %ld\n",
+                        nodes, best.nodes);
+                exit(1);
+            }
+        }
+        double flat_scanning = now() - start;
+
+        if(what == HAND && i == 0) {
+            AstWriter writer;
+            if(!writer.save(cache, ast, key, best.bytes, 0, "")) {
+                perror(cache);
+                exit(1);
+            }
+        }
+
+        start = now();
+        delete arena;
+        double freeing = now() - start;
+
+        best.parse = parsing < best.parse ? parsing : best.parse;
+        best.walk = walking < best.walk ? walking : best.walk;
+        best.static_walk = static_walking < best.static_walk ? static_walking
+                                                             : best.static_walk;
+        best.stack_walk = stack_walking < best.stack_walk ? stack_walking
+                                                          : best.stack_walk;
+        best.teardown = freeing < best.teardown ? freeing : best.teardown;
+        best.flatten = flattening < best.flatten ? flattening : best.flatten;
+        best.flat_walk = flat_walking < best.flat_walk ? flat_walking
+                                                       : best.flat_walk;
+        best.flat_scan = flat_scanning < best.flat_scan ? flat_scanning
+                                                        : best.flat_scan;
+    }
+    return best;
+}
+
+// The tree is saved next to the file for the cache row, and removed after
+static void bench(const char* path, int runs)
+{
+    static const char* const names[] = { "bison", "hand", "lazy", "scanner",
+                                         "cache" };
+    std::string cache = std::string(path) + ".ast";
+    Timing scan = bench(path, runs, SCANNER, NULL);
+    Timing hand;
+
+    for(int what = BISON; what <= CACHE; ++what) {
+        Timing t = what == SCANNER ? scan : bench(path, runs, what,
+                                                  cache.c_str());
+        hand = what == HAND ? t : hand;
+        fprintf(stderr, "%s: %-7s %zu bytes, %ld tokens, %.4f s, %.1f MB/s, "
+                "%.2f Mtok/s", path, names[what], t.bytes, scan.tokens,
+                t.parse, t.bytes / t.parse / 1e6, scan.tokens / t.parse / 1e6);
+        if(what == CACHE) {
+            fprintf(stderr, ", %.1f times as fast as hand", hand.parse / t.parse);
+        } else if(what != SCANNER) {
+            fprintf(stderr, ", %.2f Mtok/s parsing",
+                    scan.tokens / (t.parse - scan.parse) / 1e6);
+        }
+        if(what != SCANNER) {
+            fprintf(stderr, "\n    %.1f MB tree (%.1f bytes a node), %ld nodes "
+                    "walked in %.4f s (%.4f s statically, %.4f s with a "
+                    "stack), freed in %.4f s", t.tree / 1e6,
+                    (double) t.tree / t.nodes, t.nodes, t.walk, t.static_walk,
+                    t.stack_walk, t.teardown);
+            fprintf(stderr, "\n    %.1f MB flat tree, made in %.4f s, walked "
+                    "in %.4f s (%.4f s in order)", t.flat / 1e6, t.flatten,
+                    t.flat_walk, t.flat_scan);
+        }
+        fprintf(stderr, "\n");
+    }
+    unlink(cache.c_str());
+}
+
+/*** Making up programs ***/
+
+static unsigned long long s_seed = 5;
+static bool s_errors = false;
+static bool s_deep = false;
+static long s_written = 0;
+
+static unsigned random(unsigned n)
+{
+    s_seed = s_seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (unsigned)(s_seed >> 33) % n;
+}
+
+static const char* pick(const char* const* words, int n)
+{
+    return words[random(n)];
+}
+
+#define PICK(words) pick(words, sizeof(words) / sizeof(words[0]))
+
+static const char* const s_names[] = {
+    "x", "y", "count", "a_b", "n0", "p", "s", "Main", "f", "g",
+};
+
+static const char* const s_types[] = {
+    "boolean", "char", "integer", "string", "intptr", "charptr",
+};
+
+static const char* const s_binary[] = {
+    "||", "&&", "==", "!=", ">", ">=", "<", "<=", "+", "-", "*", "/",
+};
+
+static const char* const s_unary[] = { "-", "!", "^" };
+
+static const char* const s_literals[] = {
+    "0", "7", "42", "0x1F", "017", "101b", "true", "false", "'a'", "' '",
+    "null",
+};
+
+// Any token, for -e to put in the wrong place
+static const char* const s_tokens[] = {
+    "boolean", "char", "integer", "string", "intptr", "charptr", "if",
+    "else", "while", "var", "procedure", "return", "null", "&&", "&", "/",
+    "=", "==", ">", ">=", "<", "<=", "-", "!", "!=", "||", "+", "*", "^",
+    "true", "'c'", "1", "\"str\"", "x", ";", ":", ",", "|", "{", "}", "(",
+    ")", "[", "]",
+};
+
+static const char* const s_spaces[] = {
+    " ", " ", " ", " ", "\n", "\n", "\n  ", "\t", "  /% note %/ ",
+};
+
+// Writes a token and the space after it.  With -e, now and then the token
+// is left out or another is put in its place.
+static void emit(const char* token)
+{
+    if(s_errors && random(400) == 0) {
+        token = random(3) ? PICK(s_tokens) : "";
+    }
+    s_written += printf("%s%s", token, PICK(s_spaces));
+}
+
+static void gen_expression(int depth);
+
+static void gen_lhs(int depth)
+{
+    switch(random(4)) {
+        case 0:
+            emit("^");
+            emit(PICK(s_names));
+            break;
+        case 1:
+            emit(PICK(s_names));
+            emit("[");
+            gen_expression(depth + 1);
+            emit("]");
+            break;
+        default:
+            emit(PICK(s_names));
+            break;
+    }
+}
+
+// For -D
+static void gen_deep()
+{
+    int n = s_errors ? 150 + random(60) : 100 + random(50);
+    const char* open = PICK(s_unary);
+    bool parens = random(2);
+    for(int i = 0; i < n; ++i) {
+        emit(parens ? "(" : open);
+    }
+    emit(PICK(s_names));
+    for(int i = 0; parens && i < n; ++i) {
+        emit(")");
+    }
+}
+
+static void gen_operand(int depth)
+{
+    unsigned r = depth > 6 ? 5 + random(5) : random(10);
+    switch(r) {
+        case 0:
+            emit(PICK(s_unary));
+            gen_operand(depth + 1);
+            break;
+        case 1:
+            emit("&");
+            gen_lhs(depth);
+            break;
+        case 2:
+            emit("(");
+            gen_expression(depth + 1);
+            emit(")");
+            break;
+        case 3:
+            emit("|");
+            gen_expression(depth + 1);
+            emit("|");
+            break;
+        case 4:
+            emit(PICK(s_names));
+            emit("[");
+            gen_expression(depth + 1);
+            emit("]");
+            break;
+        case 5: case 6:
+            emit(PICK(s_names));
+            break;
+        default:
+            emit(PICK(s_literals));
+            break;
+    }
+}
+
+static void gen_expression(int depth)
+{
+    if(s_deep && depth == 0 && random(2000) == 0) {
+        gen_deep();
+        return;
+    }
+    gen_operand(depth);
+    for(int n = random(depth > 4 ? 2 : 5); n > 0; --n) {
+        emit(PICK(s_binary));
+        gen_operand(depth);
+    }
+}
+
+static void gen_identifiers()
+{
+    emit(PICK(s_names));
+    for(int n = random(3); n > 0; --n) {
+        emit(",");
+        emit(PICK(s_names));
+    }
+}
+
+static void gen_variables()
+{
+    for(int n = random(4); n > 0; --n) {
+        emit("var");
+        gen_identifiers();
+        emit(":");
+        if(random(4) == 0) {
+            emit("string");
+            emit("[");
+            emit(random(2) ? "10" : "0x20");
+            emit("]");
+        } else {
+            emit(PICK(s_types));
+        }
+        emit(";");
+    }
+}
+
+static void gen_statements(int depth);
+
+static void gen_block(int depth)
+{
+    emit("{");
+    gen_variables();
+    gen_statements(depth + 1);
+    emit("}");
+}
+
+static void gen_statement(int depth)
+{
+    switch(depth > 3 ? 4 + random(6) : random(10)) {
+        case 0:
+            emit("if");
+            emit("(");
+            gen_expression(0);
+            emit(")");
+            gen_block(depth);
+            if(random(2)) {
+                emit("else");
+                gen_block(depth);
+            }
+            break;
+        case 1:
+            emit("while");
+            emit("(");
+            gen_expression(0);
+            emit(")");
+            gen_block(depth);
+            break;
+        case 2:
+            gen_block(depth);
+            break;
+        case 3: case 4:
+            gen_lhs(0);
+            emit("=");
+            emit(PICK(s_names));
+            emit("(");
+            if(random(3)) {
+                gen_expression(0);
+                for(int n = random(3); n > 0; --n) {
+                    emit(",");
+                    gen_expression(0);
+                }
+            }
+            emit(")");
+            emit(";");
+            break;
+        case 5:
+            gen_lhs(0);
+            emit("=");
+            emit(random(2) ? "\"hello\"" : "\"\"");
+            emit(";");
+            break;
+        default:
+            gen_lhs(0);
+            emit("=");
+            gen_expression(0);
+            emit(";");
+            break;
+    }
+}
+
+static void gen_statements(int depth)
+{
+    for(int n = random(depth > 2 ? 3 : 6); n > 0; --n) {
+        gen_statement(depth);
+    }
+}
+
+// Never with an empty body: the AST cannot be built for one (a
+// Procedure_blockImpl without a return statement), whichever parser reads it
+static void gen_procedure(int depth)
+{
+    emit("procedure");
+    emit(PICK(s_names));
+    emit("(");
+    for(int n = random(4); n > 0; --n) {
+        gen_identifiers();
+        emit(":");
+        emit(PICK(s_types));
+        if(n > 1 || random(2)) {
+            emit(";");
+        }
+    }
+    emit(")");
+    emit("return");
+    emit(PICK(s_types));
+    emit("{");
+    for(int n = depth < 2 ? random(3) : 0; n > 0; --n) {
+        gen_procedure(depth + 1);
+    }
+    gen_variables();
+    gen_statements(0);
+    emit("return");
+    gen_expression(0);
+    emit(";");
+    emit("}");
+}
+
+static void generate(long bytes)
+{
+    while(s_written < bytes) {
+        gen_procedure(0);
+        s_written += printf("\n");
+    }
+}
+
+/*** Main ***/
+
+static void usage(const char* prog)
+{
+    fprintf(stderr, "usage: %s [-d] [-r | -l | -m] [-c tree] [-S] [-n runs] "
+            "file\n", prog);
+    fprintf(stderr, "       %s -g bytes [-e] [-D] [-s seed]\n", prog);
+    exit(1);
+}
+
+int main(int argc, char** argv)
+{
+    bool dumping = false;
+    int parser = BISON;
+    bool reachable = false;
+    const char* cache = NULL;
+    bool sharing = false;
+    int runs = 5;
+    long generating = 0;
+    int i;
+
+    for(i = 1; i < argc && argv[i][0] == '-'; ++i) {
+        if(!strcmp(argv[i], "-d")) {
+            dumping = true;
+        } else if(!strcmp(argv[i], "-r")) {
+            parser = HAND;
+        } else if(!strcmp(argv[i], "-l")) {
+            parser = LAZY;
+        } else if(!strcmp(argv[i], "-m")) {
+            reachable = true;
+        } else if(!strcmp(argv[i], "-c") && i + 1 < argc) {
+            cache = argv[++i];
+        } else if(!strcmp(argv[i], "-S")) {
+            sharing = true;
+        } else if(!strcmp(argv[i], "-n") && i + 1 < argc) {
+            runs = atoi(argv[++i]);
+        } else if(!strcmp(argv[i], "-g") && i + 1 < argc) {
+            generating = atol(argv[++i]);
+        } else if(!strcmp(argv[i], "-e")) {
+            s_errors = true;
+        } else if(!strcmp(argv[i], "-D")) {
+            s_deep = true;
+        } else if(!strcmp(argv[i], "-s") && i + 1 < argc) {
+            s_seed = strtoull(argv[++i], NULL, 10);
+        } else {
+            usage(argv[0]);
+        }
+    }
+    if(generating > 0 && i == argc) {
+        generate(generating);
+        return 0;
+    }
+    if(i + 1 != argc || runs < 1) {
+        usage(argv[0]);
+    }
+
+    if(dumping) {
+        int fd = open(argv[i], O_RDONLY);
+        if(fd < 0) {
+            perror(argv[i]);
+            exit(1);
+        }
+        SourceBuffer source(fd);
+        close(fd);
+        dump(source, parser, reachable, cache, sharing);
+    } else {
+        bench(argv[i], runs);
+    }
+    return 0;
+}
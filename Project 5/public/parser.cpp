@@ -0,0 +1,2299 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison implementation for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* C LALR(1) parser skeleton written by Richard Stallman, by
+   simplifying the original so-called "semantic" parser.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+/* All symbols defined below should begin with yy or YY, to avoid
+   infringing on user name space.  This should be done even for local
+   variables, as they might otherwise be expanded by user macros.
+   There are some unavoidable exceptions within include files to
+   define necessary library symbols; they are noted "INFRINGES ON
+   USER NAME SPACE" below.  */
+
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
+
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
+
+/* Skeleton name.  */
+#define YYSKELETON_NAME "yacc.c"
+
+/* Pure parsers.  */
+#define YYPURE 2
+
+/* Push parsers.  */
+#define YYPUSH 0
+
+/* Pull parsers.  */
+#define YYPULL 1
+
+
+
+
+/* First part of user prologue.  */
+#line 1 "parser.ypp"
+
+    #include <cstdio>
+    #include <cstdlib>
+
+    #include "ast.hpp"
+    #include "exprpool.hpp"
+    #include "primitive.hpp"
+    #include "symtab.hpp"
+
+    #define YYDEBUG 1
+
+    /* The AST constructors do not know where in the program they are, so
+     * the nodes are made with LINE, which gives them the line the scanner
+     * is on (and shares the expressions, see exprpool.hpp) */
+    template<class T> static T* at_line(T* node, int line)
+    {
+        node->m_attribute.lineno = line;
+        return share_expr(node);
+    }
+    #define LINE(node) at_line(node, current_line(scanner, replay))
+
+#line 93 "parser.cpp"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
+
+#include "parser.hpp"
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_T_BOOLEAN = 3,                  /* T_BOOLEAN  */
+  YYSYMBOL_T_CHAR = 4,                     /* T_CHAR  */
+  YYSYMBOL_T_INTEGER = 5,                  /* T_INTEGER  */
+  YYSYMBOL_T_STRING = 6,                   /* T_STRING  */
+  YYSYMBOL_T_INTPTR = 7,                   /* T_INTPTR  */
+  YYSYMBOL_T_CHARPTR = 8,                  /* T_CHARPTR  */
+  YYSYMBOL_T_IF = 9,                       /* T_IF  */
+  YYSYMBOL_T_ELSE = 10,                    /* T_ELSE  */
+  YYSYMBOL_T_WHILE = 11,                   /* T_WHILE  */
+  YYSYMBOL_T_VAR = 12,                     /* T_VAR  */
+  YYSYMBOL_T_PROCEDURE = 13,               /* T_PROCEDURE  */
+  YYSYMBOL_T_RETURN = 14,                  /* T_RETURN  */
+  YYSYMBOL_T_NULL = 15,                    /* T_NULL  */
+  YYSYMBOL_T_AND = 16,                     /* T_AND  */
+  YYSYMBOL_T_DIVIDE = 17,                  /* T_DIVIDE  */
+  YYSYMBOL_T_EQUAL = 18,                   /* T_EQUAL  */
+  YYSYMBOL_T_BOOL_EQUAL = 19,              /* T_BOOL_EQUAL  */
+  YYSYMBOL_T_GREATER_THAN = 20,            /* T_GREATER_THAN  */
+  YYSYMBOL_T_GREATER_THAN_OR_EQUAL = 21,   /* T_GREATER_THAN_OR_EQUAL  */
+  YYSYMBOL_T_LESS_THAN = 22,               /* T_LESS_THAN  */
+  YYSYMBOL_T_LESS_THAN_OR_EQUAL = 23,      /* T_LESS_THAN_OR_EQUAL  */
+  YYSYMBOL_T_MINUS = 24,                   /* T_MINUS  */
+  YYSYMBOL_T_NOT = 25,                     /* T_NOT  */
+  YYSYMBOL_T_NOT_EQUAL = 26,               /* T_NOT_EQUAL  */
+  YYSYMBOL_T_OR = 27,                      /* T_OR  */
+  YYSYMBOL_T_PLUS = 28,                    /* T_PLUS  */
+  YYSYMBOL_T_TIMES = 29,                   /* T_TIMES  */
+  YYSYMBOL_T_REFERENCE = 30,               /* T_REFERENCE  */
+  YYSYMBOL_T_DEREFERENCE = 31,             /* T_DEREFERENCE  */
+  YYSYMBOL_T_BOOL_LITERAL = 32,            /* T_BOOL_LITERAL  */
+  YYSYMBOL_T_CHAR_LITERAL = 33,            /* T_CHAR_LITERAL  */
+  YYSYMBOL_T_INTEGER_LITERAL = 34,         /* T_INTEGER_LITERAL  */
+  YYSYMBOL_T_STRING_LITERAL = 35,          /* T_STRING_LITERAL  */
+  YYSYMBOL_T_IDENTIFIER_LITERAL = 36,      /* T_IDENTIFIER_LITERAL  */
+  YYSYMBOL_T_SEMICOLON = 37,               /* T_SEMICOLON  */
+  YYSYMBOL_T_COLON = 38,                   /* T_COLON  */
+  YYSYMBOL_T_COMMA = 39,                   /* T_COMMA  */
+  YYSYMBOL_T_BAR = 40,                     /* T_BAR  */
+  YYSYMBOL_T_OPEN_CURLY = 41,              /* T_OPEN_CURLY  */
+  YYSYMBOL_T_CLOSE_CURLY = 42,             /* T_CLOSE_CURLY  */
+  YYSYMBOL_T_OPEN_PARAN = 43,              /* T_OPEN_PARAN  */
+  YYSYMBOL_T_CLOSE_PARAN = 44,             /* T_CLOSE_PARAN  */
+  YYSYMBOL_T_OPEN_SQUARE = 45,             /* T_OPEN_SQUARE  */
+  YYSYMBOL_T_CLOSE_SQUARE = 46,            /* T_CLOSE_SQUARE  */
+  YYSYMBOL_UMINUS = 47,                    /* UMINUS  */
+  YYSYMBOL_YYACCEPT = 48,                  /* $accept  */
+  YYSYMBOL_start = 49,                     /* start  */
+  YYSYMBOL_listEnd = 50,                   /* listEnd  */
+  YYSYMBOL_procedureList = 51,             /* procedureList  */
+  YYSYMBOL_procedure = 52,                 /* procedure  */
+  YYSYMBOL_53_1 = 53,                      /* $@1  */
+  YYSYMBOL_parameterList = 54,             /* parameterList  */
+  YYSYMBOL_parameters = 55,                /* parameters  */
+  YYSYMBOL_declare = 56,                   /* declare  */
+  YYSYMBOL_procedureBody = 57,             /* procedureBody  */
+  YYSYMBOL_identifiers = 58,               /* identifiers  */
+  YYSYMBOL_variable = 59,                  /* variable  */
+  YYSYMBOL_variableList = 60,              /* variableList  */
+  YYSYMBOL_leftHandSide = 61,              /* leftHandSide  */
+  YYSYMBOL_codeBlock = 62,                 /* codeBlock  */
+  YYSYMBOL_63_2 = 63,                      /* $@2  */
+  YYSYMBOL_returnStatement = 64,           /* returnStatement  */
+  YYSYMBOL_condition = 65,                 /* condition  */
+  YYSYMBOL_statement = 66,                 /* statement  */
+  YYSYMBOL_statementList = 67,             /* statementList  */
+  YYSYMBOL_expressionList = 68,            /* expressionList  */
+  YYSYMBOL_expression = 69,                /* expression  */
+  YYSYMBOL_type = 70                       /* type  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
+
+
+
+/* Unqualified %code blocks.  */
+#line 81 "parser.ypp"
+
+    void yyerror(yyscan_t scanner, Program_ptr* ast, ProcedureSink* sink,
+                 TokenReplay* replay, FILE* errors, const char* s);
+
+    // The replay tokens first, if there are any left
+    static int next_token(YYSTYPE* value, yyscan_t scanner,
+                          TokenReplay* replay)
+    {
+        if(replay && replay->m_next < replay->m_tokens.size()) {
+            const ReplayToken& t = replay->m_tokens[replay->m_next++];
+            replay->m_line = t.line;
+            *value = t.value;
+            return t.token;
+        }
+        if(replay && replay->m_then_end) {
+            return 0;
+        }
+        return (yylex)(value, scanner);
+    }
+    #define yylex(value, scanner) next_token(value, scanner, replay)
+
+    // The line the last token read came from
+    static int current_line(yyscan_t scanner, TokenReplay* replay)
+    {
+        if(replay && replay->m_next < replay->m_tokens.size()) {
+            return replay->m_line;
+        }
+        return lexer_lineno(scanner);
+    }
+
+#line 229 "parser.cpp"
+
+#ifdef short
+# undef short
+#endif
+
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
+#endif
+
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
+typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
+#else
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
+#else
+typedef short yytype_uint8;
+#endif
+
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
+#else
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
+#endif
+
+#ifndef YYSIZE_T
+# ifdef __SIZE_TYPE__
+#  define YYSIZE_T __SIZE_TYPE__
+# elif defined size_t
+#  define YYSIZE_T size_t
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYSIZE_T size_t
+# else
+#  define YYSIZE_T unsigned
+# endif
+#endif
+
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_uint8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
+
+#ifndef YY_
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
+# endif
+#endif
+
+/* Suppress unused-variable warnings by "using" E.  */
+#if ! defined lint || defined __GNUC__
+# define YY_USE(E) ((void) (E))
+#else
+# define YY_USE(E) /* empty */
+#endif
+
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
+#else
+# define YY_INITIAL_VALUE(Value) Value
+#endif
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
+#endif
+
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if 1
+
+/* The parser invokes alloca or malloc; define the necessary symbols.  */
+
+# ifdef YYSTACK_USE_ALLOCA
+#  if YYSTACK_USE_ALLOCA
+#   ifdef __GNUC__
+#    define YYSTACK_ALLOC __builtin_alloca
+#   elif defined __BUILTIN_VA_ARG_INCR
+#    include <alloca.h> /* INFRINGES ON USER NAME SPACE */
+#   elif defined _AIX
+#    define YYSTACK_ALLOC __alloca
+#   elif defined _MSC_VER
+#    include <malloc.h> /* INFRINGES ON USER NAME SPACE */
+#    define alloca _alloca
+#   else
+#    define YYSTACK_ALLOC alloca
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
+#     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
+#     endif
+#    endif
+#   endif
+#  endif
+# endif
+
+# ifdef YYSTACK_ALLOC
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+    /* The OS might guarantee only one guard page at the bottom of the stack,
+       and a page size can be as small as 4096 bytes.  So we cannot safely
+       invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
+       to allow for a few compiler-allocated temporary stack slots.  */
+#   define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
+#  endif
+# else
+#  define YYSTACK_ALLOC YYMALLOC
+#  define YYSTACK_FREE YYFREE
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+#   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
+#  endif
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
+       && ! ((defined YYMALLOC || defined malloc) \
+             && (defined YYFREE || defined free)))
+#   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
+#   endif
+#  endif
+#  ifndef YYMALLOC
+#   define YYMALLOC malloc
+#   if ! defined malloc && ! defined EXIT_SUCCESS
+void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+#  ifndef YYFREE
+#   define YYFREE free
+#   if ! defined free && ! defined EXIT_SUCCESS
+void free (void *); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+# endif
+#endif /* 1 */
+
+#if (! defined yyoverflow \
+     && (! defined __cplusplus \
+         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+
+/* A type that is properly aligned for any stack member.  */
+union yyalloc
+{
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
+};
+
+/* The size of the maximum gap between one aligned stack and the next.  */
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
+
+/* The size of an array large to enough to hold all stacks, each with
+   N elements.  */
+# define YYSTACK_BYTES(N) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
+      + YYSTACK_GAP_MAXIMUM)
+
+# define YYCOPY_NEEDED 1
+
+/* Relocate STACK from its old location to the new one.  The
+   local variables YYSIZE and YYSTACKSIZE give the old and new number of
+   elements in the stack, and YYPTR gives the new location of the
+   stack.  Advance YYPTR to a properly aligned location for the next
+   stack.  */
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
+
+#endif
+
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
+/* YYFINAL -- State number of the termination state.  */
+#define YYFINAL  3
+/* YYLAST -- Last index in YYTABLE.  */
+#define YYLAST   288
+
+/* YYNTOKENS -- Number of terminals.  */
+#define YYNTOKENS  48
+/* YYNNTS -- Number of nonterminals.  */
+#define YYNNTS  23
+/* YYNRULES -- Number of rules.  */
+#define YYNRULES  70
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  141
+
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   302
+
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
+{
+       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
+       5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
+      15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
+      25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
+      35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
+      45,    46,    47
+};
+
+#if YYDEBUG
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
+{
+       0,   195,   195,   211,   214,   220,   224,   224,   238,   241,
+     245,   248,   252,   255,   259,   263,   270,   273,   278,   280,
+     284,   287,   291,   293,   295,   299,   299,   305,   311,   314,
+     316,   318,   320,   322,   324,   326,   328,   332,   336,   340,
+     342,   346,   347,   348,   349,   350,   351,   352,   353,   354,
+     355,   356,   357,   358,   359,   360,   361,   362,   363,   364,
+     366,   367,   368,   369,   371,   374,   375,   376,   377,   378,
+     379
+};
+#endif
+
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if 1
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
+/* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
+   First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
+static const char *const yytname[] =
+{
+  "\"end of file\"", "error", "\"invalid token\"", "T_BOOLEAN", "T_CHAR",
+  "T_INTEGER", "T_STRING", "T_INTPTR", "T_CHARPTR", "T_IF", "T_ELSE",
+  "T_WHILE", "T_VAR", "T_PROCEDURE", "T_RETURN", "T_NULL", "T_AND",
+  "T_DIVIDE", "T_EQUAL", "T_BOOL_EQUAL", "T_GREATER_THAN",
+  "T_GREATER_THAN_OR_EQUAL", "T_LESS_THAN", "T_LESS_THAN_OR_EQUAL",
+  "T_MINUS", "T_NOT", "T_NOT_EQUAL", "T_OR", "T_PLUS", "T_TIMES",
+  "T_REFERENCE", "T_DEREFERENCE", "T_BOOL_LITERAL", "T_CHAR_LITERAL",
+  "T_INTEGER_LITERAL", "T_STRING_LITERAL", "T_IDENTIFIER_LITERAL",
+  "T_SEMICOLON", "T_COLON", "T_COMMA", "T_BAR", "T_OPEN_CURLY",
+  "T_CLOSE_CURLY", "T_OPEN_PARAN", "T_CLOSE_PARAN", "T_OPEN_SQUARE",
+  "T_CLOSE_SQUARE", "UMINUS", "$accept", "start", "listEnd",
+  "procedureList", "procedure", "$@1", "parameterList", "parameters",
+  "declare", "procedureBody", "identifiers", "variable", "variableList",
+  "leftHandSide", "codeBlock", "$@2", "returnStatement", "condition",
+  "statement", "statementList", "expressionList", "expression", "type", YY_NULLPTR
+};
+
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
+{
+  return yytname[yysymbol];
+}
+#endif
+
+#define YYPACT_NINF (-53)
+
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
+
+#define YYTABLE_NINF (-16)
+
+#define yytable_value_is_error(Yyn) \
+  0
+
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int16 yypact[] =
+{
+     -53,     4,     1,   -53,    -7,   -53,   -53,   -30,   -53,   -21,
+      -4,    37,   -53,    -6,   166,    16,    15,   -53,   -53,   -53,
+     -53,   -53,   -53,    18,   -53,   166,   -53,    20,    14,   -53,
+       1,    22,   -53,    65,   -53,    -4,   -53,    19,    -6,    28,
+      28,    42,    34,   -53,    66,    63,   -53,   -53,    47,   167,
+      43,    43,   -53,   167,   -53,   167,    49,   153,   280,   -53,
+     167,   167,     0,   167,   -53,   -53,   -53,    44,   167,   167,
+     123,    80,   -53,    46,    65,   226,   -53,    58,   -33,   207,
+      57,    70,   -53,   -53,   -53,   -53,   167,   192,   137,   167,
+     167,   167,   167,   167,   167,   167,   167,   167,   167,   167,
+     167,   -53,    43,   -53,    19,   -53,    94,   -53,    74,   -53,
+      77,   -53,   -53,   253,   -53,    -2,    59,    59,    59,    59,
+      32,    -2,   240,    32,   -53,   -53,    68,    75,    72,   226,
+      67,   -53,   -53,   -53,   167,    73,    79,   226,    83,   -53,
+     -53
+};
+
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_int8 yydefact[] =
+{
+       5,     0,     3,     1,     0,     2,     4,     0,    11,     0,
+       9,     0,    17,     3,     0,     0,     0,    65,    66,    68,
+      70,    69,    67,     0,    16,     0,     6,     8,    13,    10,
+      21,     0,    12,    38,     7,     0,    20,     3,     3,     0,
+       0,     0,    22,    25,     0,     0,    36,    37,     0,     0,
+       0,     0,    24,     0,    21,     0,     0,     0,     0,    64,
+       0,     0,     0,     0,    62,    63,    61,    60,     0,     0,
+       0,    29,    35,     0,    38,    27,    14,     0,    60,     0,
+      70,     0,    41,    44,    42,    43,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,    28,     0,    23,     3,    32,     0,    31,     0,    18,
+       0,    58,    57,    45,    48,    55,    51,    53,    52,    54,
+      50,    56,    46,    49,    47,    30,     0,     0,     3,    40,
+       0,    59,    26,    34,     0,     0,     0,    39,     0,    19,
+      33
+};
+
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int8 yypgoto[] =
+{
+     -53,   -53,   -13,   -53,    84,   -53,   -53,   -53,   -53,   -53,
+      86,   -53,    78,    60,   -44,   -53,   -53,    89,   -53,    61,
+     -53,   -52,   -23
+};
+
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_uint8 yydefgoto[] =
+{
+       0,     1,     5,     2,     6,    28,     9,    10,    30,    31,
+      13,    36,    33,    45,    46,    54,    56,    50,    47,    37,
+     128,    70,    23
+};
+
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_int16 yytable[] =
+{
+      16,    73,    27,    75,     3,    79,    71,    72,    82,    83,
+     106,    85,    86,     8,     4,    90,    87,    88,    92,    93,
+      94,    95,    96,    11,    44,    48,    99,   100,    39,     7,
+      40,    41,    12,    15,   110,    81,    42,   113,   114,   115,
+     116,   117,   118,   119,   120,   121,   122,   123,   124,    90,
+      41,    14,    24,    25,   129,    42,   -15,    29,   125,    26,
+      43,   100,    89,    90,    34,    91,    92,    93,    94,    95,
+      96,    49,    97,    98,    99,   100,    90,    35,    52,    53,
+      55,    57,   137,    96,    43,    58,    76,    99,   100,    86,
+     102,   126,   103,    89,    90,   105,    91,    92,    93,    94,
+      95,    96,   108,    97,    98,    99,   100,   109,   130,    59,
+     132,   134,   133,   136,    32,   135,   139,   138,    60,    61,
+     140,    38,    84,   131,    62,    63,    64,    65,    66,    51,
+      67,     0,    74,     0,    68,   104,     0,    69,   127,    89,
+      90,     0,    91,    92,    93,    94,    95,    96,     0,    97,
+      98,    99,   100,    89,    90,     0,    91,    92,    93,    94,
+      95,    96,     0,    97,    98,    99,   100,   101,    59,    17,
+      18,    19,    20,    21,    22,     0,     0,    60,    61,     0,
+       0,   112,    59,    62,    63,    64,    65,    66,    77,    78,
+       0,    60,    61,    68,     0,     0,    69,    62,    63,    64,
+      65,    66,     0,    67,     0,     0,     0,    68,    89,    90,
+      69,    91,    92,    93,    94,    95,    96,     0,    97,    98,
+      99,   100,     0,    89,    90,     0,    91,    92,    93,    94,
+      95,    96,   111,    97,    98,    99,   100,     0,     0,     0,
+       0,     0,    89,    90,   107,    91,    92,    93,    94,    95,
+      96,     0,    97,    98,    99,   100,    89,    90,     0,    91,
+      92,    93,    94,    95,    96,     0,    97,     0,    99,   100,
+      90,     0,    91,    92,    93,    94,    95,    96,     0,    97,
+       0,    99,   100,    17,    18,    19,    80,    21,    22
+};
+
+static const yytype_int16 yycheck[] =
+{
+      13,    53,    25,    55,     0,    57,    50,    51,    60,    61,
+      43,    63,    45,    43,    13,    17,    68,    69,    20,    21,
+      22,    23,    24,    44,    37,    38,    28,    29,     9,    36,
+      11,    31,    36,    39,    86,    58,    36,    89,    90,    91,
+      92,    93,    94,    95,    96,    97,    98,    99,   100,    17,
+      31,    14,    36,    38,   106,    36,    42,    37,   102,    41,
+      41,    29,    16,    17,    42,    19,    20,    21,    22,    23,
+      24,    43,    26,    27,    28,    29,    17,    12,    36,    45,
+      14,    18,   134,    24,    41,    38,    37,    28,    29,    45,
+      10,   104,    46,    16,    17,    37,    19,    20,    21,    22,
+      23,    24,    45,    26,    27,    28,    29,    37,    34,    15,
+      42,    39,    37,    46,    30,   128,    37,    44,    24,    25,
+      37,    35,    62,    46,    30,    31,    32,    33,    34,    40,
+      36,    -1,    54,    -1,    40,    74,    -1,    43,    44,    16,
+      17,    -1,    19,    20,    21,    22,    23,    24,    -1,    26,
+      27,    28,    29,    16,    17,    -1,    19,    20,    21,    22,
+      23,    24,    -1,    26,    27,    28,    29,    44,    15,     3,
+       4,     5,     6,     7,     8,    -1,    -1,    24,    25,    -1,
+      -1,    44,    15,    30,    31,    32,    33,    34,    35,    36,
+      -1,    24,    25,    40,    -1,    -1,    43,    30,    31,    32,
+      33,    34,    -1,    36,    -1,    -1,    -1,    40,    16,    17,
+      43,    19,    20,    21,    22,    23,    24,    -1,    26,    27,
+      28,    29,    -1,    16,    17,    -1,    19,    20,    21,    22,
+      23,    24,    40,    26,    27,    28,    29,    -1,    -1,    -1,
+      -1,    -1,    16,    17,    37,    19,    20,    21,    22,    23,
+      24,    -1,    26,    27,    28,    29,    16,    17,    -1,    19,
+      20,    21,    22,    23,    24,    -1,    26,    -1,    28,    29,
+      17,    -1,    19,    20,    21,    22,    23,    24,    -1,    26,
+      -1,    28,    29,     3,     4,     5,     6,     7,     8
+};
+
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
+{
+       0,    49,    51,     0,    13,    50,    52,    36,    43,    54,
+      55,    44,    36,    58,    14,    39,    50,     3,     4,     5,
+       6,     7,     8,    70,    36,    38,    41,    70,    53,    37,
+      56,    57,    52,    60,    42,    12,    59,    67,    58,     9,
+      11,    31,    36,    41,    50,    61,    62,    66,    50,    43,
+      65,    65,    36,    45,    63,    14,    64,    18,    38,    15,
+      24,    25,    30,    31,    32,    33,    34,    36,    40,    43,
+      69,    62,    62,    69,    60,    69,    37,    35,    36,    69,
+       6,    70,    69,    69,    61,    69,    45,    69,    69,    16,
+      17,    19,    20,    21,    22,    23,    24,    26,    27,    28,
+      29,    44,    10,    46,    67,    37,    43,    37,    45,    37,
+      69,    40,    44,    69,    69,    69,    69,    69,    69,    69,
+      69,    69,    69,    69,    69,    62,    50,    44,    68,    69,
+      34,    46,    42,    37,    39,    50,    46,    69,    44,    37,
+      37
+};
+
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
+{
+       0,    48,    49,    50,    51,    51,    53,    52,    54,    54,
+      55,    55,    56,    56,    57,    57,    58,    58,    59,    59,
+      60,    60,    61,    61,    61,    63,    62,    64,    65,    66,
+      66,    66,    66,    66,    66,    66,    66,    67,    67,    68,
+      68,    69,    69,    69,    69,    69,    69,    69,    69,    69,
+      69,    69,    69,    69,    69,    69,    69,    69,    69,    69,
+      69,    69,    69,    69,    69,    70,    70,    70,    70,    70,
+      70
+};
+
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     2,     0,     2,     0,     0,    11,     5,     1,
+       6,     0,     2,     0,     6,     0,     3,     1,     6,     9,
+       2,     0,     1,     4,     2,     0,     6,     2,     3,     3,
+       5,     4,     4,     8,     6,     3,     1,     2,     0,     3,
+       1,     2,     2,     2,     2,     3,     3,     3,     3,     3,
+       3,     3,     3,     3,     3,     3,     3,     3,     3,     4,
+       1,     1,     1,     1,     1,     1,     1,     1,     1,     1,
+       1
+};
+
+
+enum { YYENOMEM = -2 };
+
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
+
+
+#define YYRECOVERING()  (!!yyerrstatus)
+
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (scanner, ast, sink, replay, errors, YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
+
+
+/* Enable debugging if requested.  */
+#if YYDEBUG
+
+# ifndef YYFPRINTF
+#  include <stdio.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYFPRINTF fprintf
+# endif
+
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value, scanner, ast, sink, replay, errors); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
+static void
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, yyscan_t scanner, Program_ptr* ast, ProcedureSink* sink, TokenReplay* replay, FILE* errors)
+{
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  YY_USE (scanner);
+  YY_USE (ast);
+  YY_USE (sink);
+  YY_USE (replay);
+  YY_USE (errors);
+  if (!yyvaluep)
+    return;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
+
+static void
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, yyscan_t scanner, Program_ptr* ast, ProcedureSink* sink, TokenReplay* replay, FILE* errors)
+{
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
+
+  yy_symbol_value_print (yyo, yykind, yyvaluep, scanner, ast, sink, replay, errors);
+  YYFPRINTF (yyo, ")");
+}
+
+/*------------------------------------------------------------------.
+| yy_stack_print -- Print the state stack from its BOTTOM up to its |
+| TOP (included).                                                   |
+`------------------------------------------------------------------*/
+
+static void
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
+{
+  YYFPRINTF (stderr, "Stack now");
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
+  YYFPRINTF (stderr, "\n");
+}
+
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
+
+
+/*------------------------------------------------.
+| Report that the YYRULE is going to be reduced.  |
+`------------------------------------------------*/
+
+static void
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule, yyscan_t scanner, Program_ptr* ast, ProcedureSink* sink, TokenReplay* replay, FILE* errors)
+{
+  int yylno = yyrline[yyrule];
+  int yynrhs = yyr2[yyrule];
+  int yyi;
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
+  /* The symbols being reduced.  */
+  for (yyi = 0; yyi < yynrhs; yyi++)
+    {
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)], scanner, ast, sink, replay, errors);
+      YYFPRINTF (stderr, "\n");
+    }
+}
+
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, Rule, scanner, ast, sink, replay, errors); \
+} while (0)
+
+/* Nonzero means print parse trace.  It is left uninitialized so that
+   multiple parsers can coexist.  */
+int yydebug;
+#else /* !YYDEBUG */
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
+# define YY_STACK_PRINT(Bottom, Top)
+# define YY_REDUCE_PRINT(Rule)
+#endif /* !YYDEBUG */
+
+
+/* YYINITDEPTH -- initial size of the parser's stacks.  */
+#ifndef YYINITDEPTH
+# define YYINITDEPTH 200
+#endif
+
+/* YYMAXDEPTH -- maximum size the stacks can grow to (effective only
+   if the built-in stack extension method is used).
+
+   Do not make this value too large; the results are undefined if
+   YYSTACK_ALLOC_MAXIMUM < YYSTACK_BYTES (YYMAXDEPTH)
+   evaluated with infinite-precision integer arithmetic.  */
+
+#ifndef YYMAXDEPTH
+# define YYMAXDEPTH 10000
+#endif
+
+
+/* Context of a parse error.  */
+typedef struct
+{
+  yy_state_t *yyssp;
+  yysymbol_kind_t yytoken;
+} yypcontext_t;
+
+/* Put in YYARG at most YYARGN of the expected tokens given the
+   current YYCTX, and return the number of tokens stored in YYARG.  If
+   YYARG is null, return the number of expected tokens (guaranteed to
+   be less than YYNTOKENS).  Return YYENOMEM on memory exhaustion.
+   Return 0 if there are more than YYARGN expected tokens, yet fill
+   YYARG up to YYARGN. */
+static int
+yypcontext_expected_tokens (const yypcontext_t *yyctx,
+                            yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  int yyn = yypact[+*yyctx->yyssp];
+  if (!yypact_value_is_default (yyn))
+    {
+      /* Start YYX at -YYN if negative to avoid negative indexes in
+         YYCHECK.  In other words, skip the first -YYN actions for
+         this state because they are default actions.  */
+      int yyxbegin = yyn < 0 ? -yyn : 0;
+      /* Stay within bounds of both yycheck and yytname.  */
+      int yychecklim = YYLAST - yyn + 1;
+      int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
+      int yyx;
+      for (yyx = yyxbegin; yyx < yyxend; ++yyx)
+        if (yycheck[yyx + yyn] == yyx && yyx != YYSYMBOL_YYerror
+            && !yytable_value_is_error (yytable[yyx + yyn]))
+          {
+            if (!yyarg)
+              ++yycount;
+            else if (yycount == yyargn)
+              return 0;
+            else
+              yyarg[yycount++] = YY_CAST (yysymbol_kind_t, yyx);
+          }
+    }
+  if (yyarg && yycount == 0 && 0 < yyargn)
+    yyarg[0] = YYSYMBOL_YYEMPTY;
+  return yycount;
+}
+
+
+
+
+#ifndef yystrlen
+# if defined __GLIBC__ && defined _STRING_H
+#  define yystrlen(S) (YY_CAST (YYPTRDIFF_T, strlen (S)))
+# else
+/* Return the length of YYSTR.  */
+static YYPTRDIFF_T
+yystrlen (const char *yystr)
+{
+  YYPTRDIFF_T yylen;
+  for (yylen = 0; yystr[yylen]; yylen++)
+    continue;
+  return yylen;
+}
+# endif
+#endif
+
+#ifndef yystpcpy
+# if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
+#  define yystpcpy stpcpy
+# else
+/* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
+   YYDEST.  */
+static char *
+yystpcpy (char *yydest, const char *yysrc)
+{
+  char *yyd = yydest;
+  const char *yys = yysrc;
+
+  while ((*yyd++ = *yys++) != '\0')
+    continue;
+
+  return yyd - 1;
+}
+# endif
+#endif
+
+#ifndef yytnamerr
+/* Copy to YYRES the contents of YYSTR after stripping away unnecessary
+   quotes and backslashes, so that it's suitable for yyerror.  The
+   heuristic is that double-quoting is unnecessary unless the string
+   contains an apostrophe, a comma, or backslash (other than
+   backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
+   null, do not copy; instead, return the length of what the result
+   would have been.  */
+static YYPTRDIFF_T
+yytnamerr (char *yyres, const char *yystr)
+{
+  if (*yystr == '"')
+    {
+      YYPTRDIFF_T yyn = 0;
+      char const *yyp = yystr;
+      for (;;)
+        switch (*++yyp)
+          {
+          case '\'':
+          case ',':
+            goto do_not_strip_quotes;
+
+          case '\\':
+            if (*++yyp != '\\')
+              goto do_not_strip_quotes;
+            else
+              goto append;
+
+          append:
+          default:
+            if (yyres)
+              yyres[yyn] = *yyp;
+            yyn++;
+            break;
+
+          case '"':
+            if (yyres)
+              yyres[yyn] = '\0';
+            return yyn;
+          }
+    do_not_strip_quotes: ;
+    }
+
+  if (yyres)
+    return yystpcpy (yyres, yystr) - yyres;
+  else
+    return yystrlen (yystr);
+}
+#endif
+
+
+static int
+yy_syntax_error_arguments (const yypcontext_t *yyctx,
+                           yysymbol_kind_t yyarg[], int yyargn)
+{
+  /* Actual size of YYARG. */
+  int yycount = 0;
+  /* There are many possibilities here to consider:
+     - If this state is a consistent state with a default action, then
+       the only way this function was invoked is if the default action
+       is an error action.  In that case, don't check for expected
+       tokens because there are none.
+     - The only way there can be no lookahead present (in yychar) is if
+       this state is a consistent state with a default action.  Thus,
+       detecting the absence of a lookahead is sufficient to determine
+       that there is no unexpected or expected token to report.  In that
+       case, just report a simple "syntax error".
+     - Don't assume there isn't a lookahead just because this state is a
+       consistent state with a default action.  There might have been a
+       previous inconsistent state, consistent state with a non-default
+       action, or user semantic action that manipulated yychar.
+     - Of course, the expected token list depends on states to have
+       correct lookahead information, and it depends on the parser not
+       to perform extra reductions after fetching a lookahead from the
+       scanner and before detecting a syntax error.  Thus, state merging
+       (from LALR or IELR) and default reductions corrupt the expected
+       token list.  However, the list is correct for canonical LR with
+       one exception: it will still contain any token that will not be
+       accepted due to an error action in a later state.
+  */
+  if (yyctx->yytoken != YYSYMBOL_YYEMPTY)
+    {
+      int yyn;
+      if (yyarg)
+        yyarg[yycount] = yyctx->yytoken;
+      ++yycount;
+      yyn = yypcontext_expected_tokens (yyctx,
+                                        yyarg ? yyarg + 1 : yyarg, yyargn - 1);
+      if (yyn == YYENOMEM)
+        return YYENOMEM;
+      else
+        yycount += yyn;
+    }
+  return yycount;
+}
+
+/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
+   about the unexpected token YYTOKEN for the state stack whose top is
+   YYSSP.
+
+   Return 0 if *YYMSG was successfully written.  Return -1 if *YYMSG is
+   not large enough to hold the message.  In that case, also set
+   *YYMSG_ALLOC to the required number of bytes.  Return YYENOMEM if the
+   required number of bytes is too large to store.  */
+static int
+yysyntax_error (YYPTRDIFF_T *yymsg_alloc, char **yymsg,
+                const yypcontext_t *yyctx)
+{
+  enum { YYARGS_MAX = 5 };
+  /* Internationalized format string. */
+  const char *yyformat = YY_NULLPTR;
+  /* Arguments of yyformat: reported tokens (one for the "unexpected",
+     one per "expected"). */
+  yysymbol_kind_t yyarg[YYARGS_MAX];
+  /* Cumulated lengths of YYARG.  */
+  YYPTRDIFF_T yysize = 0;
+
+  /* Actual size of YYARG. */
+  int yycount = yy_syntax_error_arguments (yyctx, yyarg, YYARGS_MAX);
+  if (yycount == YYENOMEM)
+    return YYENOMEM;
+
+  switch (yycount)
+    {
+#define YYCASE_(N, S)                       \
+      case N:                               \
+        yyformat = S;                       \
+        break
+    default: /* Avoid compiler warnings. */
+      YYCASE_(0, YY_("syntax error"));
+      YYCASE_(1, YY_("syntax error, unexpected %s"));
+      YYCASE_(2, YY_("syntax error, unexpected %s, expecting %s"));
+      YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
+      YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
+      YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
+#undef YYCASE_
+    }
+
+  /* Compute error message size.  Don't count the "%s"s, but reserve
+     room for the terminator.  */
+  yysize = yystrlen (yyformat) - 2 * yycount + 1;
+  {
+    int yyi;
+    for (yyi = 0; yyi < yycount; ++yyi)
+      {
+        YYPTRDIFF_T yysize1
+          = yysize + yytnamerr (YY_NULLPTR, yytname[yyarg[yyi]]);
+        if (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM)
+          yysize = yysize1;
+        else
+          return YYENOMEM;
+      }
+  }
+
+  if (*yymsg_alloc < yysize)
+    {
+      *yymsg_alloc = 2 * yysize;
+      if (! (yysize <= *yymsg_alloc
+             && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
+        *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
+      return -1;
+    }
+
+  /* Avoid sprintf, as that infringes on the user's name space.
+     Don't have undefined behavior even if the translation
+     produced a string with the wrong number of "%s"s.  */
+  {
+    char *yyp = *yymsg;
+    int yyi = 0;
+    while ((*yyp = *yyformat) != '\0')
+      if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
+        {
+          yyp += yytnamerr (yyp, yytname[yyarg[yyi++]]);
+          yyformat += 2;
+        }
+      else
+        {
+          ++yyp;
+          ++yyformat;
+        }
+  }
+  return 0;
+}
+
+
+/*-----------------------------------------------.
+| Release the memory associated to this symbol.  |
+`-----------------------------------------------*/
+
+static void
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, yyscan_t scanner, Program_ptr* ast, ProcedureSink* sink, TokenReplay* replay, FILE* errors)
+{
+  YY_USE (yyvaluep);
+  YY_USE (scanner);
+  YY_USE (ast);
+  YY_USE (sink);
+  YY_USE (replay);
+  YY_USE (errors);
+  if (!yymsg)
+    yymsg = "Deleting";
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+
+
+
+
+/*----------.
+| yyparse.  |
+`----------*/
+
+int
+yyparse (yyscan_t scanner, Program_ptr* ast, ProcedureSink* sink, TokenReplay* replay, FILE* errors)
+{
+/* Lookahead token kind.  */
+int yychar;
+
+
+/* The semantic value of the lookahead symbol.  */
+/* Default value used for initialization, for pacifying older GCCs
+   or non-GCC compilers.  */
+YY_INITIAL_VALUE (static YYSTYPE yyval_default;)
+YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
+
+    /* Number of syntax errors so far.  */
+    int yynerrs = 0;
+
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
+
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
+
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
+
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
+
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
+  /* The variables used to return semantic value and location from the
+     action routines.  */
+  YYSTYPE yyval;
+
+  /* Buffer for error messages, and its allocated size.  */
+  char yymsgbuf[128];
+  char *yymsg = yymsgbuf;
+  YYPTRDIFF_T yymsg_alloc = sizeof yymsgbuf;
+
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
+
+  /* The number of symbols on the RHS of the reduced rule.
+     Keep to zero when no symbol should be popped.  */
+  int yylen = 0;
+
+  YYDPRINTF ((stderr, "Starting parse\n"));
+
+  yychar = YYEMPTY; /* Cause a token to be read.  */
+
+  goto yysetstate;
+
+
+/*------------------------------------------------------------.
+| yynewstate -- push a new state, which is found in yystate.  |
+`------------------------------------------------------------*/
+yynewstate:
+  /* In all cases, when you get here, the value and location stacks
+     have just been pushed.  So pushing a state here evens the stacks.  */
+  yyssp++;
+
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
+
+  if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
+    {
+      /* Get the current used size of the three stacks, in elements.  */
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
+
+# if defined yyoverflow
+      {
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
+      }
+# else /* defined YYSTACK_RELOCATE */
+      /* Extend the stack our own way.  */
+      if (YYMAXDEPTH <= yystacksize)
+        YYNOMEM;
+      yystacksize *= 2;
+      if (YYMAXDEPTH < yystacksize)
+        yystacksize = YYMAXDEPTH;
+
+      {
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+#  undef YYSTACK_RELOCATE
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
+      }
+# endif
+
+      yyssp = yyss + yysize - 1;
+      yyvsp = yyvs + yysize - 1;
+
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
+
+      if (yyss + yystacksize - 1 <= yyssp)
+        YYABORT;
+    }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
+
+
+  if (yystate == YYFINAL)
+    YYACCEPT;
+
+  goto yybackup;
+
+
+/*-----------.
+| yybackup.  |
+`-----------*/
+yybackup:
+  /* Do appropriate processing given the current state.  Read a
+     lookahead token if we need one and don't already have one.  */
+
+  /* First try to decide what to do without reference to lookahead token.  */
+  yyn = yypact[yystate];
+  if (yypact_value_is_default (yyn))
+    goto yydefault;
+
+  /* Not known => get a lookahead token if don't already have one.  */
+
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
+  if (yychar == YYEMPTY)
+    {
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex (&yylval, scanner);
+    }
+
+  if (yychar <= YYEOF)
+    {
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
+      YYDPRINTF ((stderr, "Now at end of input.\n"));
+    }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
+  else
+    {
+      yytoken = YYTRANSLATE (yychar);
+      YY_SYMBOL_PRINT ("Next token is", yytoken, &yylval, &yylloc);
+    }
+
+  /* If the proper action on seeing token YYTOKEN is to reduce or to
+     detect an error, take that action.  */
+  yyn += yytoken;
+  if (yyn < 0 || YYLAST < yyn || yycheck[yyn] != yytoken)
+    goto yydefault;
+  yyn = yytable[yyn];
+  if (yyn <= 0)
+    {
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
+      yyn = -yyn;
+      goto yyreduce;
+    }
+
+  /* Count tokens shifted since error; after three, turn off error
+     status.  */
+  if (yyerrstatus)
+    yyerrstatus--;
+
+  /* Shift the lookahead token.  */
+  YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
+  yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
+  goto yynewstate;
+
+
+/*-----------------------------------------------------------.
+| yydefault -- do the default action for the current state.  |
+`-----------------------------------------------------------*/
+yydefault:
+  yyn = yydefact[yystate];
+  if (yyn == 0)
+    goto yyerrlab;
+  goto yyreduce;
+
+
+/*-----------------------------.
+| yyreduce -- do a reduction.  |
+`-----------------------------*/
+yyreduce:
+  /* yyn is the number of a rule to reduce with.  */
+  yylen = yyr2[yyn];
+
+  /* If YYLEN is nonzero, implement the default value of the action:
+     '$$ = $1'.
+
+     Otherwise, the following line sets YYVAL to garbage.
+     This behavior is undocumented and Bison
+     users should not rely upon it.  Assigning to YYVAL
+     unconditionally makes the parser a bit smaller, and it avoids a
+     GCC warning that YYVAL may be used uninitialized.  */
+  yyval = yyvsp[1-yylen];
+
+
+  YY_REDUCE_PRINT (yyn);
+  switch (yyn)
+    {
+  case 2: /* start: procedureList listEnd  */
+#line 195 "parser.ypp"
+                                            {//printf("In start\n"); 
+                                               yyval.u_proc_list = yyvsp[-1].u_proc_list; 
+                                               *ast = LINE(new ProgramImpl(yyval.u_proc_list));}
+#line 1598 "parser.cpp"
+    break;
+
+  case 4: /* procedureList: procedureList procedure  */
+#line 214 "parser.ypp"
+                                              {//printf("In procedureList branch 1\n");
+                                               yyval.u_proc_list = yyvsp[-1].u_proc_list; 
+                                               if(sink) {
+                                                   sink->procedure(yyvsp[0].u_proc);
+                                               }
+                                               yyval.u_proc_list->push_back(yyvsp[0].u_proc); }
+#line 1609 "parser.cpp"
+    break;
+
+  case 5: /* procedureList: %empty  */
+#line 220 "parser.ypp"
+                      { //printf("In procedureList branch 2\n");
+                        yyval.u_proc_list = new Proc_list(); }
+#line 1616 "parser.cpp"
+    break;
+
+  case 6: /* $@1: %empty  */
+#line 224 "parser.ypp"
+                                                                                                                           { if(sink) {
+                                                                                                                    sink->enter_body();
+                                                                                                                }
+                                                                                                                enter_expr_block(); }
+#line 1625 "parser.cpp"
+    break;
+
+  case 7: /* procedure: T_PROCEDURE T_IDENTIFIER_LITERAL T_OPEN_PARAN parameterList T_CLOSE_PARAN T_RETURN type T_OPEN_CURLY $@1 procedureBody T_CLOSE_CURLY  */
+#line 228 "parser.ypp"
+                                                  {    //printf("In procedure\n");
+                                                     leave_expr_block();
+                                                     if(sink) {
+                                                         sink->leave_body();
+                                                     }
+                                                     yyval.u_proc = LINE(new ProcImpl(SymName(yyvsp[-9].u_base_charptr), yyvsp[-7].u_decl_list, yyvsp[-4].u_type, yyvsp[-1].u_procedure_block)); }
+#line 1636 "parser.cpp"
+    break;
+
+  case 8: /* parameterList: parameters identifiers listEnd T_COLON type  */
+#line 238 "parser.ypp"
+                                                                  {//printf("In parameterList branch 1\n");
+                                                           yyval.u_decl_list = yyvsp[-4].u_decl_list; 
+                                                           yyval.u_decl_list->push_back(LINE(new DeclImpl(yyvsp[-3].u_symname_list, yyvsp[0].u_type))); }
+#line 1644 "parser.cpp"
+    break;
+
+  case 9: /* parameterList: parameters  */
+#line 241 "parser.ypp"
+                                 {//printf("In parameterList branch 2\n");
+                                  yyval.u_decl_list = yyvsp[0].u_decl_list; }
+#line 1651 "parser.cpp"
+    break;
+
+  case 10: /* parameters: parameters identifiers listEnd T_COLON type T_SEMICOLON  */
+#line 245 "parser.ypp"
+                                                                              {//printf("In parameters branch 1\n"); 
+                                                                       yyval.u_decl_list = yyvsp[-5].u_decl_list; 
+                                                                       yyval.u_decl_list->push_back(LINE(new DeclImpl(yyvsp[-4].u_symname_list, yyvsp[-1].u_type))); }
+#line 1659 "parser.cpp"
+    break;
+
+  case 11: /* parameters: %empty  */
+#line 248 "parser.ypp"
+                      { //printf("In parameters branch 2\n"); 
+                        yyval.u_decl_list = new Decl_list(); }
+#line 1666 "parser.cpp"
+    break;
+
+  case 12: /* declare: declare procedure  */
+#line 252 "parser.ypp"
+                                        {//printf("In declare branch 1\n");
+                                         yyval.u_proc_list = yyvsp[-1].u_proc_list; 
+                                         yyval.u_proc_list->push_back(yyvsp[0].u_proc); }
+#line 1674 "parser.cpp"
+    break;
+
+  case 13: /* declare: %empty  */
+#line 255 "parser.ypp"
+                      { //printf("In declare branch 2\n");
+                        yyval.u_proc_list = new Proc_list();}
+#line 1681 "parser.cpp"
+    break;
+
+  case 14: /* procedureBody: declare variableList statementList listEnd returnStatement T_SEMICOLON  */
+#line 259 "parser.ypp"
+                                                                                             {  //printf("In procedureBody branch 1\n"); 
+                                                                                yyval.u_procedure_block = LINE(new Procedure_blockImpl(yyvsp[-5].u_proc_list, yyvsp[-4].u_decl_list, yyvsp[-3].u_stat_list, yyvsp[-1].u_return_stat)); 
+                                                                                //printf("Exiting procedureBody branch 1\n");
+                                                                                }
+#line 1690 "parser.cpp"
+    break;
+
+  case 15: /* procedureBody: %empty  */
+#line 263 "parser.ypp"
+                      { //printf("In procedureBody branch 2\n"); 
+                        Proc_list* procList = new Proc_list(); 
+                        Decl_list* varList = new Decl_list(); 
+                        Stat_list* statList = new Stat_list(); 
+                        yyval.u_procedure_block = LINE(new Procedure_blockImpl(procList, varList, statList, nullptr)); }
+#line 1700 "parser.cpp"
+    break;
+
+  case 16: /* identifiers: identifiers T_COMMA T_IDENTIFIER_LITERAL  */
+#line 270 "parser.ypp"
+                                                               {//printf("In identifiers branch 1\n"); 
+                                                                yyval.u_symname_list = yyvsp[-2].u_symname_list; 
+                                                                yyval.u_symname_list->push_back(new SymName(yyvsp[0].u_base_charptr)); }
+#line 1708 "parser.cpp"
+    break;
+
+  case 17: /* identifiers: T_IDENTIFIER_LITERAL  */
+#line 273 "parser.ypp"
+                                           {//printf("In indentifiers branch 2\n");
+                                            yyval.u_symname_list = new SymName_list(); 
+                                            yyval.u_symname_list->push_back(new SymName(yyvsp[0].u_base_charptr));}
+#line 1716 "parser.cpp"
+    break;
+
+  case 18: /* variable: T_VAR identifiers listEnd T_COLON type T_SEMICOLON  */
+#line 278 "parser.ypp"
+                                                                         { //printf("In variable branch 1\n");
+                                                                            yyval.u_decl = LINE(new DeclImpl(yyvsp[-4].u_symname_list, yyvsp[-1].u_type)); }
+#line 1723 "parser.cpp"
+    break;
+
+  case 19: /* variable: T_VAR identifiers listEnd T_COLON T_STRING T_OPEN_SQUARE T_INTEGER_LITERAL T_CLOSE_SQUARE T_SEMICOLON  */
+#line 280 "parser.ypp"
+                                                                                                                             {  //printf("In variable branch 2\n");
+                                                                                                                                yyval.u_decl = LINE(new DeclImpl(yyvsp[-7].u_symname_list, LINE(new TString(Primitive(yyvsp[-2].u_base_int))))); }
+#line 1730 "parser.cpp"
+    break;
+
+  case 20: /* variableList: variableList variable  */
+#line 284 "parser.ypp"
+                                            {//printf("In variableList branch 1\n");
+                                             yyval.u_decl_list = yyvsp[-1].u_decl_list; 
+                                             yyval.u_decl_list->push_back(yyvsp[0].u_decl);}
+#line 1738 "parser.cpp"
+    break;
+
+  case 21: /* variableList: %empty  */
+#line 287 "parser.ypp"
+                     {//printf("In variableList branch 2\n");
+                      yyval.u_decl_list = new Decl_list(); }
+#line 1745 "parser.cpp"
+    break;
+
+  case 22: /* leftHandSide: T_IDENTIFIER_LITERAL  */
+#line 291 "parser.ypp"
+                                           {//printf("In leftHandSide branch 1\n"); 
+                                            yyval.u_lhs = LINE(new Variable(SymName(yyvsp[0].u_base_charptr))); }
+#line 1752 "parser.cpp"
+    break;
+
+  case 23: /* leftHandSide: T_IDENTIFIER_LITERAL T_OPEN_SQUARE expression T_CLOSE_SQUARE  */
+#line 293 "parser.ypp"
+                                                                                   {//printf("In leftHandSide branch 2\n"); 
+                                                                                    yyval.u_lhs = LINE(new ArrayElement(SymName(yyvsp[-3].u_base_charptr), yyvsp[-1].u_expr)); }
+#line 1759 "parser.cpp"
+    break;
+
+  case 24: /* leftHandSide: T_DEREFERENCE T_IDENTIFIER_LITERAL  */
+#line 295 "parser.ypp"
+                                                         {  //printf("In leftHandSide branch 3\n"); 
+                                                            yyval.u_lhs = LINE(new DerefVariable(SymName(yyvsp[0].u_base_charptr))); }
+#line 1766 "parser.cpp"
+    break;
+
+  case 25: /* $@2: %empty  */
+#line 299 "parser.ypp"
+                                   { enter_expr_block(); }
+#line 1772 "parser.cpp"
+    break;
+
+  case 26: /* codeBlock: T_OPEN_CURLY $@2 variableList statementList listEnd T_CLOSE_CURLY  */
+#line 300 "parser.ypp"
+                                                                       {//printf("In codeblock\n"); 
+                                                                    leave_expr_block();
+                                                                    yyval.u_nested_block = LINE(new Nested_blockImpl(yyvsp[-3].u_decl_list, yyvsp[-2].u_stat_list)); }
+#line 1780 "parser.cpp"
+    break;
+
+  case 27: /* returnStatement: T_RETURN expression  */
+#line 305 "parser.ypp"
+                                          { //printf("In returnStatement\n");
+                                            yyval.u_return_stat = LINE(new Return(yyvsp[0].u_expr)); }
+#line 1787 "parser.cpp"
+    break;
+
+  case 28: /* condition: T_OPEN_PARAN expression T_CLOSE_PARAN  */
+#line 311 "parser.ypp"
+                                                            { yyval.u_expr = own_line(yyvsp[-1].u_expr); }
+#line 1793 "parser.cpp"
+    break;
+
+  case 29: /* statement: T_IF condition codeBlock  */
+#line 314 "parser.ypp"
+                                               {  //printf("In statement branch 1\n"); 
+                                                                                        yyval.u_stat = LINE(new IfNoElse(yyvsp[-1].u_expr, yyvsp[0].u_nested_block)); }
+#line 1800 "parser.cpp"
+    break;
+
+  case 30: /* statement: T_IF condition codeBlock T_ELSE codeBlock  */
+#line 316 "parser.ypp"
+                                                                { //printf("In statement branch 2\n"); 
+                                                                                                        yyval.u_stat = LINE(new IfWithElse(yyvsp[-3].u_expr, yyvsp[-2].u_nested_block, yyvsp[0].u_nested_block)); }
+#line 1807 "parser.cpp"
+    break;
+
+  case 31: /* statement: leftHandSide T_EQUAL expression T_SEMICOLON  */
+#line 318 "parser.ypp"
+                                                                  {   //printf("In statement branch 3\n");
+                                                                                yyval.u_stat = LINE(new Assignment(yyvsp[-3].u_lhs, yyvsp[-1].u_expr)); }
+#line 1814 "parser.cpp"
+    break;
+
+  case 32: /* statement: leftHandSide T_EQUAL T_STRING_LITERAL T_SEMICOLON  */
+#line 320 "parser.ypp"
+                                                                        { //printf("In statement branch 4\n");
+                                                                                    yyval.u_stat = LINE(new StringAssignment(yyvsp[-3].u_lhs, new StringPrimitive(yyvsp[-1].u_base_charptr))); }
+#line 1821 "parser.cpp"
+    break;
+
+  case 33: /* statement: leftHandSide T_EQUAL T_IDENTIFIER_LITERAL T_OPEN_PARAN expressionList listEnd T_CLOSE_PARAN T_SEMICOLON  */
+#line 322 "parser.ypp"
+                                                                                                                              {   //printf("In statement branch 5\n"); 
+                                                                                                                                    yyval.u_stat = LINE(new Call(yyvsp[-7].u_lhs, SymName(yyvsp[-5].u_base_charptr), yyvsp[-3].u_expr_list)); }
+#line 1828 "parser.cpp"
+    break;
+
+  case 34: /* statement: leftHandSide T_EQUAL T_IDENTIFIER_LITERAL T_OPEN_PARAN T_CLOSE_PARAN T_SEMICOLON  */
+#line 324 "parser.ypp"
+                                                                                                       {  //printf("In statement branch 6\n"); 
+                                                                                                                    yyval.u_stat = LINE(new Call(yyvsp[-5].u_lhs, SymName(yyvsp[-3].u_base_charptr), new Expr_list())); }
+#line 1835 "parser.cpp"
+    break;
+
+  case 35: /* statement: T_WHILE condition codeBlock  */
+#line 326 "parser.ypp"
+                                                  {   //printf("In statement branch 7\n"); 
+                                                                                            yyval.u_stat = LINE(new WhileLoop(yyvsp[-1].u_expr, yyvsp[0].u_nested_block)); }
+#line 1842 "parser.cpp"
+    break;
+
+  case 36: /* statement: codeBlock  */
+#line 328 "parser.ypp"
+                                { //printf("In statement branch 8\n"); 
+                                            yyval.u_stat = LINE(new CodeBlock(yyvsp[0].u_nested_block)); }
+#line 1849 "parser.cpp"
+    break;
+
+  case 37: /* statementList: statementList statement  */
+#line 332 "parser.ypp"
+                                              {//printf("In statementList branch 1\n"); 
+                                               yyval.u_stat_list = yyvsp[-1].u_stat_list; 
+                                               yyval.u_stat_list->push_back(yyvsp[0].u_stat); 
+                                                       }
+#line 1858 "parser.cpp"
+    break;
+
+  case 38: /* statementList: %empty  */
+#line 336 "parser.ypp"
+                        {//printf("In statementList branch 2\n"); 
+                         yyval.u_stat_list = new Stat_list(); }
+#line 1865 "parser.cpp"
+    break;
+
+  case 39: /* expressionList: expressionList T_COMMA expression  */
+#line 340 "parser.ypp"
+                                                        {yyval.u_expr_list = yyvsp[-2].u_expr_list; 
+                                                         yyval.u_expr_list->push_back(yyvsp[0].u_expr); }
+#line 1872 "parser.cpp"
+    break;
+
+  case 40: /* expressionList: expression  */
+#line 342 "parser.ypp"
+                                 {yyval.u_expr_list = new Expr_list(); 
+                                  yyval.u_expr_list->push_back(yyvsp[0].u_expr); }
+#line 1879 "parser.cpp"
+    break;
+
+  case 41: /* expression: T_MINUS expression  */
+#line 346 "parser.ypp"
+                                                      {yyval.u_expr = LINE(new Uminus{yyvsp[0].u_expr}); }
+#line 1885 "parser.cpp"
+    break;
+
+  case 42: /* expression: T_REFERENCE leftHandSide  */
+#line 347 "parser.ypp"
+                                               {yyval.u_expr = LINE(new AddressOf(yyvsp[0].u_lhs)); }
+#line 1891 "parser.cpp"
+    break;
+
+  case 43: /* expression: T_DEREFERENCE expression  */
+#line 348 "parser.ypp"
+                                               {yyval.u_expr = LINE(new Deref(yyvsp[0].u_expr)); }
+#line 1897 "parser.cpp"
+    break;
+
+  case 44: /* expression: T_NOT expression  */
+#line 349 "parser.ypp"
+                                       {yyval.u_expr = LINE(new Not(yyvsp[0].u_expr)); }
+#line 1903 "parser.cpp"
+    break;
+
+  case 45: /* expression: expression T_AND expression  */
+#line 350 "parser.ypp"
+                                                  {yyval.u_expr = LINE(new And(yyvsp[-2].u_expr, yyvsp[0].u_expr)); }
+#line 1909 "parser.cpp"
+    break;
+
+  case 46: /* expression: expression T_OR expression  */
+#line 351 "parser.ypp"
+                                                 {yyval.u_expr = LINE(new Or(yyvsp[-2].u_expr, yyvsp[0].u_expr)); }
+#line 1915 "parser.cpp"
+    break;
+
+  case 47: /* expression: expression T_TIMES expression  */
+#line 352 "parser.ypp"
+                                                    { yyval.u_expr = LINE(new Times(yyvsp[-2].u_expr, yyvsp[0].u_expr)); }
+#line 1921 "parser.cpp"
+    break;
+
+  case 48: /* expression: expression T_DIVIDE expression  */
+#line 353 "parser.ypp"
+                                                     { yyval.u_expr = LINE(new Div(yyvsp[-2].u_expr, yyvsp[0].u_expr)); }
+#line 1927 "parser.cpp"
+    break;
+
+  case 49: /* expression: expression T_PLUS expression  */
+#line 354 "parser.ypp"
+                                                   { yyval.u_expr = LINE(new Plus(yyvsp[-2].u_expr, yyvsp[0].u_expr)); }
+#line 1933 "parser.cpp"
+    break;
+
+  case 50: /* expression: expression T_MINUS expression  */
+#line 355 "parser.ypp"
+                                                    { yyval.u_expr = LINE(new Minus(yyvsp[-2].u_expr, yyvsp[0].u_expr)); }
+#line 1939 "parser.cpp"
+    break;
+
+  case 51: /* expression: expression T_GREATER_THAN expression  */
+#line 356 "parser.ypp"
+                                                           {yyval.u_expr = LINE(new Gt(yyvsp[-2].u_expr, yyvsp[0].u_expr)); }
+#line 1945 "parser.cpp"
+    break;
+
+  case 52: /* expression: expression T_LESS_THAN expression  */
+#line 357 "parser.ypp"
+                                                        {yyval.u_expr = LINE(new Lt(yyvsp[-2].u_expr, yyvsp[0].u_expr)); }
+#line 1951 "parser.cpp"
+    break;
+
+  case 53: /* expression: expression T_GREATER_THAN_OR_EQUAL expression  */
+#line 358 "parser.ypp"
+                                                                    {yyval.u_expr = LINE(new Gteq(yyvsp[-2].u_expr, yyvsp[0].u_expr)); }
+#line 1957 "parser.cpp"
+    break;
+
+  case 54: /* expression: expression T_LESS_THAN_OR_EQUAL expression  */
+#line 359 "parser.ypp"
+                                                                 {yyval.u_expr = LINE(new Lteq(yyvsp[-2].u_expr, yyvsp[0].u_expr)); }
+#line 1963 "parser.cpp"
+    break;
+
+  case 55: /* expression: expression T_BOOL_EQUAL expression  */
+#line 360 "parser.ypp"
+                                                         {yyval.u_expr = LINE(new Compare(yyvsp[-2].u_expr, yyvsp[0].u_expr)); }
+#line 1969 "parser.cpp"
+    break;
+
+  case 56: /* expression: expression T_NOT_EQUAL expression  */
+#line 361 "parser.ypp"
+                                                        {yyval.u_expr = LINE(new Noteq(yyvsp[-2].u_expr, yyvsp[0].u_expr)); }
+#line 1975 "parser.cpp"
+    break;
+
+  case 57: /* expression: T_OPEN_PARAN expression T_CLOSE_PARAN  */
+#line 362 "parser.ypp"
+                                                            {yyval.u_expr = yyvsp[-1].u_expr; }
+#line 1981 "parser.cpp"
+    break;
+
+  case 58: /* expression: T_BAR expression T_BAR  */
+#line 363 "parser.ypp"
+                                             {yyval.u_expr = LINE(new AbsoluteValue(yyvsp[-1].u_expr)); }
+#line 1987 "parser.cpp"
+    break;
+
+  case 59: /* expression: T_IDENTIFIER_LITERAL T_OPEN_SQUARE expression T_CLOSE_SQUARE  */
+#line 364 "parser.ypp"
+                                                                                   {//printf("In expression branch 19\n");
+                                                                                    yyval.u_expr = LINE(new ArrayAccess(SymName(yyvsp[-3].u_base_charptr), yyvsp[-1].u_expr)); }
+#line 1994 "parser.cpp"
+    break;
+
+  case 60: /* expression: T_IDENTIFIER_LITERAL  */
+#line 366 "parser.ypp"
+                                           {yyval.u_expr = LINE(new Ident(SymName(yyvsp[0].u_base_charptr))); }
+#line 2000 "parser.cpp"
+    break;
+
+  case 61: /* expression: T_INTEGER_LITERAL  */
+#line 367 "parser.ypp"
+                                        {yyval.u_expr = LINE(new IntLit(Primitive(yyvsp[0].u_base_int))); }
+#line 2006 "parser.cpp"
+    break;
+
+  case 62: /* expression: T_BOOL_LITERAL  */
+#line 368 "parser.ypp"
+                                     {yyval.u_expr = LINE(new BoolLit(Primitive(yyvsp[0].u_base_int))); }
+#line 2012 "parser.cpp"
+    break;
+
+  case 63: /* expression: T_CHAR_LITERAL  */
+#line 369 "parser.ypp"
+                                     {  
+                                        yyval.u_expr = LINE(new CharLit(Primitive(yyvsp[0].u_base_int))); }
+#line 2019 "parser.cpp"
+    break;
+
+  case 64: /* expression: T_NULL  */
+#line 371 "parser.ypp"
+                                {yyval.u_expr = LINE(new NullLit()); }
+#line 2025 "parser.cpp"
+    break;
+
+  case 65: /* type: T_BOOLEAN  */
+#line 374 "parser.ypp"
+                                {yyval.u_type = LINE(new TBoolean()); }
+#line 2031 "parser.cpp"
+    break;
+
+  case 66: /* type: T_CHAR  */
+#line 375 "parser.ypp"
+                             {yyval.u_type = LINE(new TCharacter()); }
+#line 2037 "parser.cpp"
+    break;
+
+  case 67: /* type: T_CHARPTR  */
+#line 376 "parser.ypp"
+                                {yyval.u_type = LINE(new TCharPtr()); }
+#line 2043 "parser.cpp"
+    break;
+
+  case 68: /* type: T_INTEGER  */
+#line 377 "parser.ypp"
+                                {yyval.u_type = LINE(new TInteger()); }
+#line 2049 "parser.cpp"
+    break;
+
+  case 69: /* type: T_INTPTR  */
+#line 378 "parser.ypp"
+                               {yyval.u_type = LINE(new TIntPtr()); }
+#line 2055 "parser.cpp"
+    break;
+
+  case 70: /* type: T_STRING  */
+#line 379 "parser.ypp"
+                               {yyval.u_type = LINE(new TString(Primitive(255)));}
+#line 2061 "parser.cpp"
+    break;
+
+
+#line 2065 "parser.cpp"
+
+      default: break;
+    }
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
+
+  YYPOPSTACK (yylen);
+  yylen = 0;
+
+  *++yyvsp = yyval;
+
+  /* Now 'shift' the result of the reduction.  Determine what state
+     that goes to, based on the state we popped back to and the rule
+     number reduced by.  */
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
+
+  goto yynewstate;
+
+
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
+yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
+  /* If not already recovering from an error, report this error.  */
+  if (!yyerrstatus)
+    {
+      ++yynerrs;
+      {
+        yypcontext_t yyctx
+          = {yyssp, yytoken};
+        char const *yymsgp = YY_("syntax error");
+        int yysyntax_error_status;
+        yysyntax_error_status = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
+        if (yysyntax_error_status == 0)
+          yymsgp = yymsg;
+        else if (yysyntax_error_status == -1)
+          {
+            if (yymsg != yymsgbuf)
+              YYSTACK_FREE (yymsg);
+            yymsg = YY_CAST (char *,
+                             YYSTACK_ALLOC (YY_CAST (YYSIZE_T, yymsg_alloc)));
+            if (yymsg)
+              {
+                yysyntax_error_status
+                  = yysyntax_error (&yymsg_alloc, &yymsg, &yyctx);
+                yymsgp = yymsg;
+              }
+            else
+              {
+                yymsg = yymsgbuf;
+                yymsg_alloc = sizeof yymsgbuf;
+                yysyntax_error_status = YYENOMEM;
+              }
+          }
+        yyerror (scanner, ast, sink, replay, errors, yymsgp);
+        if (yysyntax_error_status == YYENOMEM)
+          YYNOMEM;
+      }
+    }
+
+  if (yyerrstatus == 3)
+    {
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
+
+      if (yychar <= YYEOF)
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
+      else
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval, scanner, ast, sink, replay, errors);
+          yychar = YYEMPTY;
+        }
+    }
+
+  /* Else will try to reuse lookahead token after shifting the error
+     token.  */
+  goto yyerrlab1;
+
+
+/*---------------------------------------------------.
+| yyerrorlab -- error raised explicitly by YYERROR.  |
+`---------------------------------------------------*/
+yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
+
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYERROR.  */
+  YYPOPSTACK (yylen);
+  yylen = 0;
+  YY_STACK_PRINT (yyss, yyssp);
+  yystate = *yyssp;
+  goto yyerrlab1;
+
+
+/*-------------------------------------------------------------.
+| yyerrlab1 -- common code for both syntax error and YYERROR.  |
+`-------------------------------------------------------------*/
+yyerrlab1:
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
+
+  /* Pop stack until we find a state that shifts the error token.  */
+  for (;;)
+    {
+      yyn = yypact[yystate];
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
+
+      /* Pop the current state because it cannot handle the error token.  */
+      if (yyssp == yyss)
+        YYABORT;
+
+
+      yydestruct ("Error: popping",
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, scanner, ast, sink, replay, errors);
+      YYPOPSTACK (1);
+      yystate = *yyssp;
+      YY_STACK_PRINT (yyss, yyssp);
+    }
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+
+  /* Shift the error token.  */
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
+
+  yystate = yyn;
+  goto yynewstate;
+
+
+/*-------------------------------------.
+| yyacceptlab -- YYACCEPT comes here.  |
+`-------------------------------------*/
+yyacceptlab:
+  yyresult = 0;
+  goto yyreturnlab;
+
+
+/*-----------------------------------.
+| yyabortlab -- YYABORT comes here.  |
+`-----------------------------------*/
+yyabortlab:
+  yyresult = 1;
+  goto yyreturnlab;
+
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
+yyexhaustedlab:
+  yyerror (scanner, ast, sink, replay, errors, YY_("memory exhausted"));
+  yyresult = 2;
+  goto yyreturnlab;
+
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YYEMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval, scanner, ast, sink, replay, errors);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYABORT or YYACCEPT.  */
+  YYPOPSTACK (yylen);
+  YY_STACK_PRINT (yyss, yyssp);
+  while (yyssp != yyss)
+    {
+      yydestruct ("Cleanup: popping",
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, scanner, ast, sink, replay, errors);
+      YYPOPSTACK (1);
+    }
+#ifndef yyoverflow
+  if (yyss != yyssa)
+    YYSTACK_FREE (yyss);
+#endif
+  if (yymsg != yymsgbuf)
+    YYSTACK_FREE (yymsg);
+  return yyresult;
+}
+
+#line 382 "parser.ypp"
+
+
+/** You shall not pass!
+ *  You should not  have to do or edit anything past this.
+ */
+
+void yyerror(yyscan_t scanner, Program_ptr*, ProcedureSink*,
+             TokenReplay* replay, FILE* errors, const char* s)
+{
+    fprintf(errors, "%s at line %d\n", s, current_line(scanner, replay));
+}
@@ -0,0 +1,179 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison interface for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+#ifndef YY_YY_PARSER_HPP_INCLUDED
+# define YY_YY_PARSER_HPP_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 0
+#endif
+#if YYDEBUG
+extern int yydebug;
+#endif
+/* "%code requires" blocks.  */
+#line 23 "parser.ypp"
+
+    #include <cstdio>
+    #include <vector>
+    #include "lexer.hpp"
+
+    // Gets each top level procedure as soon as it is parsed, so it can be
+    // compiled while the parser goes on with the rest (see compile.cpp).
+    // The procedure still goes into the tree afterwards.
+    //
+    // enter_body and leave_body go around the body of every procedure,
+    // nested ones too, so the sink can make the bodies in an arena of its
+    // own (see arena.hpp) and drop it once it is done with a procedure.
+    class ProcedureSink
+    {
+      public:
+        virtual void procedure(Proc_ptr proc) = 0;
+        virtual void enter_body() {}
+        virtual void leave_body() {}
+        virtual ~ProcedureSink() {}
+    };
+
+    // How many states the parser's stack holds.  It cannot grow the stack
+    // (bison only moves a YYSTYPE that is marked trivially copyable in C++),
+    // so a program that nests deeper than this is "memory exhausted", and
+    // rdparser.cpp has to know when that would happen.
+    #define PARSER_STACK_DEPTH 200
+    #define YYINITDEPTH PARSER_STACK_DEPTH
+
+    // Tokens for the parser to read before it goes on to the scanner, with
+    // the line the scanner was on after each one.  The hand written parser
+    // (rdparser.cpp) uses it to hand a procedure it cannot parse over to
+    // this one, with the tokens of it that it has already read.
+    struct ReplayToken
+    {
+        int token;
+        int line;
+        YYSTYPE value;
+    };
+
+    class TokenReplay
+    {
+      public:
+        std::vector<ReplayToken> m_tokens;
+        size_t m_next;      // the next one to read
+        int m_line;         // the line of the last one read
+
+        // Whether the program ends after them, instead of going on with
+        // the scanner (for a procedure body parsed out of order)
+        bool m_then_end;
+
+        TokenReplay() {
+            m_next = 0;
+            m_line = 1;
+            m_then_end = false;
+        }
+    };
+
+#line 107 "parser.hpp"
+
+/* Token kinds.  */
+#ifndef YYTOKENTYPE
+# define YYTOKENTYPE
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    T_BOOLEAN = 258,               /* T_BOOLEAN  */
+    T_CHAR = 259,                  /* T_CHAR  */
+    T_INTEGER = 260,               /* T_INTEGER  */
+    T_STRING = 261,                /* T_STRING  */
+    T_INTPTR = 262,                /* T_INTPTR  */
+    T_CHARPTR = 263,               /* T_CHARPTR  */
+    T_IF = 264,                    /* T_IF  */
+    T_ELSE = 265,                  /* T_ELSE  */
+    T_WHILE = 266,                 /* T_WHILE  */
+    T_VAR = 267,                   /* T_VAR  */
+    T_PROCEDURE = 268,             /* T_PROCEDURE  */
+    T_RETURN = 269,                /* T_RETURN  */
+    T_NULL = 270,                  /* T_NULL  */
+    T_AND = 271,                   /* T_AND  */
+    T_DIVIDE = 272,                /* T_DIVIDE  */
+    T_EQUAL = 273,                 /* T_EQUAL  */
+    T_BOOL_EQUAL = 274,            /* T_BOOL_EQUAL  */
+    T_GREATER_THAN = 275,          /* T_GREATER_THAN  */
+    T_GREATER_THAN_OR_EQUAL = 276, /* T_GREATER_THAN_OR_EQUAL  */
+    T_LESS_THAN = 277,             /* T_LESS_THAN  */
+    T_LESS_THAN_OR_EQUAL = 278,    /* T_LESS_THAN_OR_EQUAL  */
+    T_MINUS = 279,                 /* T_MINUS  */
+    T_NOT = 280,                   /* T_NOT  */
+    T_NOT_EQUAL = 281,             /* T_NOT_EQUAL  */
+    T_OR = 282,                    /* T_OR  */
+    T_PLUS = 283,                  /* T_PLUS  */
+    T_TIMES = 284,                 /* T_TIMES  */
+    T_REFERENCE = 285,             /* T_REFERENCE  */
+    T_DEREFERENCE = 286,           /* T_DEREFERENCE  */
+    T_BOOL_LITERAL = 287,          /* T_BOOL_LITERAL  */
+    T_CHAR_LITERAL = 288,          /* T_CHAR_LITERAL  */
+    T_INTEGER_LITERAL = 289,       /* T_INTEGER_LITERAL  */
+    T_STRING_LITERAL = 290,        /* T_STRING_LITERAL  */
+    T_IDENTIFIER_LITERAL = 291,    /* T_IDENTIFIER_LITERAL  */
+    T_SEMICOLON = 292,             /* T_SEMICOLON  */
+    T_COLON = 293,                 /* T_COLON  */
+    T_COMMA = 294,                 /* T_COMMA  */
+    T_BAR = 295,                   /* T_BAR  */
+    T_OPEN_CURLY = 296,            /* T_OPEN_CURLY  */
+    T_CLOSE_CURLY = 297,           /* T_CLOSE_CURLY  */
+    T_OPEN_PARAN = 298,            /* T_OPEN_PARAN  */
+    T_CLOSE_PARAN = 299,           /* T_CLOSE_PARAN  */
+    T_OPEN_SQUARE = 300,           /* T_OPEN_SQUARE  */
+    T_CLOSE_SQUARE = 301,          /* T_CLOSE_SQUARE  */
+    UMINUS = 302                   /* UMINUS  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
+#endif
+
+/* Value type.  */
+#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
+typedef int YYSTYPE;
+# define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
+#endif
+
+
+
+
+int yyparse (yyscan_t scanner, Program_ptr* ast, ProcedureSink* sink, TokenReplay* replay, FILE* errors);
+
+
+#endif /* !YY_YY_PARSER_HPP_INCLUDED  */
@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <string.h>
+#include "ast.hpp"
 #include "primitive.hpp"
 
 /*************/
@@ -13,13 +14,11 @@ Primitive::~Primitive()
 Primitive::Primitive(int x)
 {
     m_data = x;
-    m_parent_attribute = NULL;
 }
 
 Primitive::Primitive(const Primitive & other)
 {
     m_data = other.m_data;
-    m_parent_attribute = other.m_parent_attribute;
 }
 
 Primitive& Primitive::operator=(const Primitive & other)
@@ -49,26 +48,22 @@ void Primitive::swap(Primitive & other)
 /* StringPrimitive */
 /*******************/
 
-StringPrimitive::StringPrimitive(char *x)
+StringPrimitive::StringPrimitive(const char *x)
 {
     m_string = x;
-    m_parent_attribute = NULL;
 }
 
 StringPrimitive::StringPrimitive(const StringPrimitive & other)
 {
-    m_string = strdup(other.m_string);
-    m_parent_attribute = other.m_parent_attribute;
+    m_string = other.m_string;
 }
 
 StringPrimitive::~StringPrimitive()
 {
-    delete (m_string);
 }
 
 StringPrimitive& StringPrimitive::operator=(const StringPrimitive & other)
 {
-    delete m_string;
     StringPrimitive tmp(other);
     swap(tmp);
     return *this;
@@ -1,36 +1,42 @@
 #ifndef PRIMITIVE_HPP
 #define PRIMITIVE_HPP
 
-#include "ast.hpp"
+#include "arena.hpp"
 #include "attribute.hpp"
 
-class Primitive
+class Visitor;
+
+// A Primitive is kept in the node that has it (it is inline in ast.cdef)
+// and has nothing virtual, so it is just its value.  A StringPrimitive is
+// made in the current Arena, like the AST nodes.
+class Primitive : public ArenaObject
 {
   public:
   int m_data;
-  Attribute* m_parent_attribute;
 
   Primitive(const Primitive &);
 
   Primitive &operator=(const Primitive &);
-  Primitive(int x);
+  Primitive(int x = 0);
   ~Primitive();
-  virtual void accept(Visitor *v);
-  virtual Primitive *clone() const;
+  void accept(Visitor *v);
+  Primitive *clone() const;
   void swap(Primitive &);
 };
 
 
-class StringPrimitive
+// m_string points into the program text (see source.hpp), where the lexer
+// NUL terminated the literal in place, so it is not owned by the
+// StringPrimitive and copies just share it
+class StringPrimitive : public ArenaObject
 {
   public:
-  char *m_string;
-  Attribute* m_parent_attribute;
+  const char *m_string;
 
   StringPrimitive(const StringPrimitive &);
 
   StringPrimitive &operator=(const StringPrimitive &);
-  StringPrimitive(char *x);
+  StringPrimitive(const char *x);
   ~StringPrimitive();
   virtual void accept(Visitor *v);
   virtual StringPrimitive *clone() const;
@@ -0,0 +1,753 @@
+// A hand written parser for csimple: recursive descent for the procedures
+// and statements, and precedence climbing for the expressions.  It takes
+// the same arguments as yyparse and builds exactly the same tree, line
+// numbers and all, so compile() can use either (csimple -r picks this one).
+//
+// A node gets the line the scanner is on when the node is made.  bison
+// only reads a token ahead when the state it is in needs one, so this
+// parser only reads the next token when it has to look at it (peek), and
+// makes each node where bison would reduce it.  That is before the token
+// after it is read where nothing could follow that would change the
+// reduction (a literal, a prefix operator, "*" and "/", which bind tightest
+// of the binary operators), and after it everywhere else.
+//
+// It does not try to report syntax errors itself.  It keeps the tokens of
+// the top level procedure it is in, and when one of them is not what the
+// grammar allows, it hands them to yyparse, which parses that procedure and
+// the rest of the program and says what is wrong the way it always has.
+// The same goes for a procedure that nests deep enough that yyparse could
+// run out of stack on it (see enter()).  The procedures before it are the
+// same either way, since procedureList is left recursive and bison is in
+// the same state after any number of them.
+//
+// rdparse_lazy (csimple -l) only skips over the body of each top level
+// procedure at first, keeping where it is in the text, and then parses the
+// bodies of Main and of what it calls, and of what they call, and so on.
+// The rest are never parsed, so a program that is mostly a library costs
+// little more than the part of it that is used.  A body that fails goes to
+// yyparse on its own, with the program ending after it.
+//
+// "make parsecheck" compares the trees the two parsers build, and
+// "make parsebench" times them (see parsebench.cpp).
+
+#include <cstdio>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "ast.hpp"
+#include "exprpool.hpp"
+#include "primitive.hpp"
+#include "symtab.hpp"
+#include "parser.hpp"
+#include "lexer.hpp"
+
+// Thrown at a token the parser does not expect, and caught at the top
+class ParseFailed
+{
+};
+
+// A top level procedure whose body has been skipped
+struct LazyProcedure
+{
+    const char* name;
+    Decl_list* params;
+    Type* type;
+    size_t header;                      // its tokens up to the "{", in
+    size_t header_size;                 // Parser::m_headers
+    const char* body;                   // the text after the "{"
+    int body_line;
+    const char* end;                    // and after the "}"
+    Proc_ptr proc;                      // once the body is parsed
+};
+
+class Parser
+{
+  private:
+    yyscan_t m_scanner;
+    ProcedureSink* m_sink;
+    ProcedureSink* m_bodies;    // told about the bodies, NULL for none
+
+    bool m_have;            // whether the next token has been read
+    int m_token;
+    YYSTYPE m_value;
+
+    TokenReplay m_replay;   // the tokens of this top level procedure
+
+    // At least as many states as yyparse would have on its stack, not
+    // counting the last few symbols of the innermost rule (SLACK)
+    int m_height;
+
+    // The names of the procedures called, if anyone wants them
+    std::vector<const char*>* m_calls;
+
+    // The tokens of the headers of the procedures whose bodies were
+    // skipped, one after the other, for yyparse if a body fails
+    std::vector<ReplayToken> m_headers;
+
+    // The next token, read if it has not been
+    int peek() {
+        if(!m_have) {
+            m_token = yylex(&m_value, m_scanner);
+            m_have = true;
+            ReplayToken t = { m_token, lexer_lineno(m_scanner), m_value };
+            m_replay.m_tokens.push_back(t);
+        }
+        return m_token;
+    }
+
+    // Moves past the next token, which has to be token
+    YYSTYPE take(int token) {
+        if(peek() != token) {
+            throw ParseFailed();
+        }
+        m_have = false;
+        return m_value;
+    }
+
+    // Moves past the next token, whatever it is
+    YYSTYPE take() {
+        peek();
+        m_have = false;
+        return m_value;
+    }
+
+    template<class T> T* line(T* node) {
+        node->m_attribute.lineno = lexer_lineno(m_scanner);
+        return share_expr(node);
+    }
+
+    // Each construct that can nest adds what yyparse keeps on its stack
+    // while it parses the part that nests: "PROCEDURE name ( ... ) RETURN
+    // type {", the action after the "{" and "declare variableList
+    // statementList RETURN" for a procedure, "e +" for the right operand of a binary operator, and so
+    // on.  Before yyparse could run out, the procedure goes to yyparse,
+    // which either has room after all or says "memory exhausted".
+    enum { SLACK = 10 };
+
+    void enter(int symbols) {
+        m_height += symbols;
+        if(m_height + SLACK >= PARSER_STACK_DEPTH) {
+            throw ParseFailed();
+        }
+    }
+
+    void leave(int symbols) {
+        m_height -= symbols;
+    }
+
+    enum { MAX_PRECEDENCE = 6 };
+
+    // The precedence of a binary operator, the same as in parser.ypp; 0
+    // for any other token
+    static int precedence(int token) {
+        switch(token) {
+            case T_OR:
+                return 1;
+            case T_AND:
+                return 2;
+            case T_BOOL_EQUAL: case T_NOT_EQUAL:
+                return 3;
+            case T_GREATER_THAN: case T_GREATER_THAN_OR_EQUAL:
+            case T_LESS_THAN: case T_LESS_THAN_OR_EQUAL:
+                return 4;
+            case T_PLUS: case T_MINUS:
+                return 5;
+            case T_TIMES: case T_DIVIDE:
+                return MAX_PRECEDENCE;
+        }
+        return 0;
+    }
+
+    static Expr* binary_node(int op, Expr* left, Expr* right) {
+        switch(op) {
+            case T_OR:                      return new Or(left, right);
+            case T_AND:                     return new And(left, right);
+            case T_BOOL_EQUAL:              return new Compare(left, right);
+            case T_NOT_EQUAL:               return new Noteq(left, right);
+            case T_GREATER_THAN:            return new Gt(left, right);
+            case T_GREATER_THAN_OR_EQUAL:   return new Gteq(left, right);
+            case T_LESS_THAN:               return new Lt(left, right);
+            case T_LESS_THAN_OR_EQUAL:      return new Lteq(left, right);
+            case T_PLUS:                    return new Plus(left, right);
+            case T_MINUS:                   return new Minus(left, right);
+            case T_TIMES:                   return new Times(left, right);
+            default:                        return new Div(left, right);
+        }
+    }
+
+    /*** Procedures and declarations ***/
+
+    // Tells m_bodies a procedure body starts, and that it ends when this
+    // goes out of scope, syntax error or not
+    class Body
+    {
+      private:
+        ProcedureSink* m_sink;
+
+      public:
+        Body(ProcedureSink* sink) {
+            m_sink = sink;
+            if(m_sink) {
+                m_sink->enter_body();
+            }
+        }
+
+        ~Body() {
+            if(m_sink) {
+                m_sink->leave_body();
+            }
+        }
+    };
+
+    Proc_ptr procedure() {
+        enter(13);
+        take(T_PROCEDURE);
+        const char* name = take(T_IDENTIFIER_LITERAL).u_base_charptr;
+        take(T_OPEN_PARAN);
+        Decl_list* params = parameter_list();
+        take(T_CLOSE_PARAN);
+        take(T_RETURN);
+        Type* type = this->type();
+        take(T_OPEN_CURLY);
+        Procedure_block* body;
+        {
+            Body scope(m_bodies);
+            body = procedure_body();
+            take(T_CLOSE_CURLY);
+        }
+        leave(13);
+        return line(new ProcImpl(SymName(name), params, type, body));
+    }
+
+    // "identifiers : type ;" any number of times, and the last ";" can go
+    Decl_list* parameter_list() {
+        Decl_list* params = new Decl_list();
+        while(peek() == T_IDENTIFIER_LITERAL) {
+            SymName_list* names = identifiers();
+            take(T_COLON);
+            Type* type = this->type();
+            if(peek() != T_SEMICOLON) {
+                params->push_back(line(new DeclImpl(names, type)));
+                break;
+            }
+            take();
+            params->push_back(line(new DeclImpl(names, type)));
+        }
+        return params;
+    }
+
+    SymName_list* identifiers() {
+        SymName_list* names = new SymName_list();
+        names->push_back(new SymName(take(T_IDENTIFIER_LITERAL).u_base_charptr));
+        while(peek() == T_COMMA) {
+            take();
+            names->push_back(new SymName(take(T_IDENTIFIER_LITERAL).u_base_charptr));
+        }
+        return names;
+    }
+
+    Type* type() {
+        switch(peek()) {
+            case T_BOOLEAN:
+                take();
+                return line(new TBoolean());
+            case T_CHAR:
+                take();
+                return line(new TCharacter());
+            case T_CHARPTR:
+                take();
+                return line(new TCharPtr());
+            case T_INTEGER:
+                take();
+                return line(new TInteger());
+            case T_INTPTR:
+                take();
+                return line(new TIntPtr());
+            case T_STRING:
+                take();
+                return line(new TString(Primitive(255)));
+        }
+        throw ParseFailed();
+    }
+
+    Procedure_block* procedure_body() {
+        ExprBlock block;
+        if(peek() == T_CLOSE_CURLY) {
+            return line(new Procedure_blockImpl(new Proc_list(),
+                                                new Decl_list(),
+                                                new Stat_list(),
+                                                nullptr));
+        }
+        Proc_list* procs = new Proc_list();
+        while(peek() == T_PROCEDURE) {
+            procs->push_back(procedure());
+        }
+        Decl_list* vars = variable_list();
+        Stat_list* stats = statement_list();
+        take(T_RETURN);
+        Expr* value = expression();
+        Return_stat* ret = line(new Return(value));
+        take(T_SEMICOLON);
+        return line(new Procedure_blockImpl(procs, vars, stats, ret));
+    }
+
+    Decl_list* variable_list() {
+        Decl_list* vars = new Decl_list();
+        while(peek() == T_VAR) {
+            vars->push_back(variable());
+        }
+        return vars;
+    }
+
+    // A string type is only made once the token after it is read, since
+    // it could turn out to be string[size]
+    Decl_ptr variable() {
+        take(T_VAR);
+        SymName_list* names = identifiers();
+        take(T_COLON);
+        if(peek() != T_STRING) {
+            Type* type = this->type();
+            take(T_SEMICOLON);
+            return line(new DeclImpl(names, type));
+        }
+        take();
+        if(peek() != T_OPEN_SQUARE) {
+            Type* type = line(new TString(Primitive(255)));
+            take(T_SEMICOLON);
+            return line(new DeclImpl(names, type));
+        }
+        take();
+        int size = take(T_INTEGER_LITERAL).u_base_int;
+        take(T_CLOSE_SQUARE);
+        take(T_SEMICOLON);
+        return line(new DeclImpl(names, line(new TString(Primitive(size)))));
+    }
+
+    /*** Statements ***/
+
+    Stat_list* statement_list() {
+        Stat_list* stats = new Stat_list();
+        for(;;) {
+            switch(peek()) {
+                case T_IF: case T_WHILE: case T_OPEN_CURLY:
+                case T_IDENTIFIER_LITERAL: case T_DEREFERENCE:
+                    stats->push_back(statement());
+                    break;
+                default:
+                    return stats;
+            }
+        }
+    }
+
+    // As many as "lhs = f ( args , e" or "IF condition codeBlock ELSE
+    // codeBlock"
+    Stat_ptr statement() {
+        enter(7);
+        Stat_ptr stat = bare_statement();
+        leave(7);
+        return stat;
+    }
+
+    Stat_ptr bare_statement() {
+        switch(peek()) {
+            case T_IF: {
+                take();
+                take(T_OPEN_PARAN);
+                Expr* cond = expression();
+                take(T_CLOSE_PARAN);
+                cond = own_line(cond);
+                Nested_block* then = code_block();
+                if(peek() != T_ELSE) {
+                    return line(new IfNoElse(cond, then));
+                }
+                take();
+                Nested_block* otherwise = code_block();
+                return line(new IfWithElse(cond, then, otherwise));
+            }
+            case T_WHILE: {
+                take();
+                take(T_OPEN_PARAN);
+                Expr* cond = expression();
+                take(T_CLOSE_PARAN);
+                cond = own_line(cond);
+                Nested_block* body = code_block();
+                return line(new WhileLoop(cond, body));
+            }
+            case T_OPEN_CURLY: {
+                Nested_block* block = code_block();
+                return line(new CodeBlock(block));
+            }
+        }
+        return assignment();
+    }
+
+    // lhs = "string"; lhs = f(args); or lhs = expression;  Which one it is
+    // can take until the token after an identifier to tell.
+    Stat_ptr assignment() {
+        Lhs* lhs = left_hand_side();
+        take(T_EQUAL);
+        if(peek() == T_STRING_LITERAL) {
+            const char* s = take().u_base_charptr;
+            take(T_SEMICOLON);
+            return line(new StringAssignment(lhs, new StringPrimitive(s)));
+        }
+        Expr* value;
+        if(peek() == T_IDENTIFIER_LITERAL) {
+            const char* name = take().u_base_charptr;
+            if(peek() == T_OPEN_PARAN) {
+                take();
+                Expr_list* args = new Expr_list();
+                if(peek() != T_CLOSE_PARAN) {
+                    args->push_back(expression());
+                    while(peek() == T_COMMA) {
+                        take();
+                        args->push_back(expression());
+                    }
+                }
+                take(T_CLOSE_PARAN);
+                take(T_SEMICOLON);
+                if(m_calls) {
+                    m_calls->push_back(name);
+                }
+                return line(new Call(lhs, SymName(name), args));
+            }
+            value = binary(identifier(name), 1);
+        } else {
+            value = expression();
+        }
+        take(T_SEMICOLON);
+        return line(new Assignment(lhs, value));
+    }
+
+    Lhs* left_hand_side() {
+        if(peek() == T_DEREFERENCE) {
+            take();
+            const char* name = take(T_IDENTIFIER_LITERAL).u_base_charptr;
+            return line(new DerefVariable(SymName(name)));
+        }
+        const char* name = take(T_IDENTIFIER_LITERAL).u_base_charptr;
+        if(peek() != T_OPEN_SQUARE) {
+            return line(new Variable(SymName(name)));
+        }
+        take();
+        enter(2);
+        Expr* index = expression();
+        leave(2);
+        take(T_CLOSE_SQUARE);
+        return line(new ArrayElement(SymName(name), index));
+    }
+
+    Nested_block* code_block() {
+        enter(5);
+        take(T_OPEN_CURLY);
+        ExprBlock block;
+        Decl_list* vars = variable_list();
+        Stat_list* stats = statement_list();
+        take(T_CLOSE_CURLY);
+        leave(5);
+        return line(new Nested_blockImpl(vars, stats));
+    }
+
+    /*** Expressions ***/
+
+    Expr* expression() {
+        return binary(unary(), 1);
+    }
+
+    // Precedence climbing: left, then any operators of at least min_prec
+    // with their right operands.  All of them are left associative.  No
+    // operator binds tighter than "*" and "/", so nothing is read after
+    // their right operand before they are made.
+    Expr* binary(Expr* left, int min_prec) {
+        for(;;) {
+            int op = peek();
+            int prec = precedence(op);
+            if(prec < min_prec) {
+                return left;
+            }
+            take();
+            enter(2);
+            Expr* right = unary();
+            if(prec < MAX_PRECEDENCE) {
+                right = binary(right, prec + 1);
+            }
+            leave(2);
+            left = line(binary_node(op, left, right));
+        }
+    }
+
+    // The prefix operators bind tighter than any binary one
+    Expr* unary() {
+        enter(1);
+        Expr* e;
+        switch(peek()) {
+            case T_MINUS:
+                take();
+                e = unary();
+                e = line(new Uminus(e));
+                break;
+            case T_NOT:
+                take();
+                e = unary();
+                e = line(new Not(e));
+                break;
+            case T_DEREFERENCE:
+                take();
+                e = unary();
+                e = line(new Deref(e));
+                break;
+            case T_REFERENCE: {
+                take();
+                Lhs* lhs = left_hand_side();
+                e = line(new AddressOf(lhs));
+                break;
+            }
+            default:
+                e = primary();
+                break;
+        }
+        leave(1);
+        return e;
+    }
+
+    Expr* primary() {
+        Expr* e;
+        switch(peek()) {
+            case T_OPEN_PARAN:
+                take();
+                e = expression();
+                take(T_CLOSE_PARAN);
+                return e;
+            case T_BAR:
+                take();
+                e = expression();
+                take(T_BAR);
+                return line(new AbsoluteValue(e));
+            case T_IDENTIFIER_LITERAL:
+                return identifier(take().u_base_charptr);
+            case T_INTEGER_LITERAL:
+                return line(new IntLit(Primitive(take().u_base_int)));
+            case T_BOOL_LITERAL:
+                return line(new BoolLit(Primitive(take().u_base_int)));
+            case T_CHAR_LITERAL:
+                return line(new CharLit(Primitive(take().u_base_int)));
+            case T_NULL:
+                take();
+                return line(new NullLit());
+        }
+        throw ParseFailed();
+    }
+
+    // An identifier that has been read, and the index after it if it is
+    // an array
+    Expr* identifier(const char* name) {
+        if(peek() != T_OPEN_SQUARE) {
+            return line(new Ident(SymName(name)));
+        }
+        take();
+        enter(2);
+        Expr* index = expression();
+        leave(2);
+        take(T_CLOSE_SQUARE);
+        return line(new ArrayAccess(SymName(name), index));
+    }
+
+    // Gives the procedure the parser was in, and the rest of the program,
+    // to yyparse, and puts the procedures before it in front of its list
+    int hand_over(Proc_list* procs, Program_ptr* ast,
+                  FILE* errors) {
+        Program_ptr rest = NULL;
+        int status = yyparse(m_scanner, &rest, m_sink, &m_replay, errors);
+        ProgramImpl* program = dyn_cast<ProgramImpl>(rest);
+        if(program) {
+            program->m_proc_list->insert(program->m_proc_list->begin(),
+                                         procs->begin(), procs->end());
+            *ast = program;
+        }
+        return status;
+    }
+
+    /*** Parsing bodies later ***/
+
+    // "PROCEDURE name ( parameters ) RETURN type {", and past the body
+    LazyProcedure header() {
+        LazyProcedure p;
+        take(T_PROCEDURE);
+        p.name = take(T_IDENTIFIER_LITERAL).u_base_charptr;
+        take(T_OPEN_PARAN);
+        p.params = parameter_list();
+        take(T_CLOSE_PARAN);
+        take(T_RETURN);
+        p.type = type();
+        take(T_OPEN_CURLY);
+        if(!lexer_skip_block(m_scanner, &p.body, &p.body_line)) {
+            throw ParseFailed();
+        }
+        p.end = lexer_position(m_scanner);
+        p.header = m_headers.size();
+        p.header_size = m_replay.m_tokens.size();
+        m_headers.insert(m_headers.end(), m_replay.m_tokens.begin(),
+                         m_replay.m_tokens.end());
+        p.proc = NULL;
+        return p;
+    }
+
+    // Goes back and parses the body of p, which makes the procedure.  The
+    // status from yyparse if it has to take over, otherwise 0.
+    int body(LazyProcedure& p, FILE* errors) {
+        m_replay.m_tokens.assign(m_headers.begin() + p.header,
+                                 m_headers.begin() + p.header + p.header_size);
+        m_replay.m_next = 0;
+        m_have = false;
+        lexer_seek(m_scanner, p.body, p.body_line);
+        try {
+            enter(13);
+            Procedure_block* block = procedure_body();
+            take(T_CLOSE_CURLY);
+            leave(13);
+            p.proc = line(new ProcImpl(SymName(p.name), p.params, p.type,
+                                       block));
+        } catch(const ParseFailed&) {
+            m_height = 2;
+            return reparse(p, errors);
+        }
+        m_replay.m_tokens.clear();
+        return 0;
+    }
+
+    // yyparse gets the procedure's tokens so far, the rest of its body,
+    // and then the end of the program.  Without a syntax error it makes
+    // the procedure, with its own parameters.
+    int reparse(LazyProcedure& p, FILE* errors) {
+        while(lexer_position(m_scanner) < p.end) {
+            ReplayToken t;
+            t.token = yylex(&t.value, m_scanner);
+            t.line = lexer_lineno(m_scanner);
+            if(t.token == 0) {
+                break;
+            }
+            m_replay.m_tokens.push_back(t);
+        }
+        m_replay.m_then_end = true;
+
+        Program_ptr rest = NULL;
+        int status = yyparse(m_scanner, &rest, NULL, &m_replay, errors);
+        ProgramImpl* program = dyn_cast<ProgramImpl>(rest);
+        if(status == 0 && program) {
+            p.proc = program->m_proc_list->front();
+        }
+        m_replay.m_tokens.clear();
+        m_replay.m_then_end = false;
+        return status;
+    }
+
+  public:
+    Parser(yyscan_t scanner, ProcedureSink* sink) {
+        m_scanner = scanner;
+        m_sink = sink;
+        m_bodies = sink;
+        m_have = false;
+        m_token = 0;
+        m_height = 2;       // state 0 and procedureList
+        m_calls = NULL;
+    }
+
+    int parse(Program_ptr* ast, FILE* errors) {
+        Proc_list* procs = new Proc_list();
+        try {
+            // Nothing has been read past the last procedure's "}"
+            for(m_replay.m_tokens.clear(); peek() != 0;
+                m_replay.m_tokens.clear()) {
+                Proc_ptr proc = procedure();
+                if(m_sink) {
+                    m_sink->procedure(proc);
+                }
+                procs->push_back(proc);
+            }
+        } catch(const ParseFailed&) {
+            return hand_over(procs, ast, errors);
+        }
+        *ast = line(new ProgramImpl(procs));
+        return 0;
+    }
+
+    // Only the procedures that can be reached from Main end up in the
+    // program, in the order they are in the text.  The sink only gets them
+    // once they are all parsed, so their bodies are not its to free.
+    int parse_lazy(Program_ptr* ast, FILE* errors) {
+        std::vector<LazyProcedure> lazy;
+        m_bodies = NULL;
+        int end_line;
+        try {
+            for(m_replay.m_tokens.clear(); peek() != 0;
+                m_replay.m_tokens.clear()) {
+                lazy.push_back(header());
+            }
+            end_line = lexer_lineno(m_scanner);
+        } catch(const ParseFailed&) {
+            // The headers so far are fine, so this is a syntax error, and
+            // yyparse says so
+            return hand_over(new Proc_list(), ast, errors);
+        }
+
+        std::unordered_map<const char*, std::vector<size_t> > by_name;
+        std::vector<const char*> calls;
+        for(size_t i = 0; i < lazy.size(); ++i) {
+            by_name[lazy[i].name].push_back(i);
+            if(!strcmp(lazy[i].name, "Main")) {
+                calls.push_back(lazy[i].name);
+            }
+        }
+
+        // Each name is looked up once, the first time it is called
+        int status = 0;
+        m_calls = &calls;
+        while(!calls.empty() && status == 0) {
+            auto found = by_name.find(calls.back());
+            calls.pop_back();
+            if(found == by_name.end()) {
+                continue;
+            }
+            std::vector<size_t> procs;
+            procs.swap(found->second);
+            by_name.erase(found);
+            for(size_t i = 0; i < procs.size() && status == 0; ++i) {
+                status = body(lazy[procs[i]], errors);
+            }
+        }
+        m_calls = NULL;
+
+        if(status != 0) {
+            return status;
+        }
+
+        Proc_list* procs = new Proc_list();
+        for(size_t i = 0; i < lazy.size(); ++i) {
+            if(lazy[i].proc) {
+                procs->push_back(lazy[i].proc);
+            }
+        }
+        for(size_t i = 0; m_sink && i < procs->size(); ++i) {
+            m_sink->procedure((*procs)[i]);
+        }
+        ProgramImpl* program = new ProgramImpl(procs);
+        program->m_attribute.lineno = end_line;
+        *ast = program;
+        return 0;
+    }
+};
+
+int rdparse(yyscan_t scanner, Program_ptr* ast, ProcedureSink* sink,
+            FILE* errors)
+{
+    Parser parser(scanner, sink);
+    return parser.parse(ast, errors);
+}
+
+int rdparse_lazy(yyscan_t scanner, Program_ptr* ast, ProcedureSink* sink,
+                 FILE* errors)
+{
+    Parser parser(scanner, sink);
+    return parser.parse_lazy(ast, errors);
+}
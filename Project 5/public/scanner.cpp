@@ -0,0 +1,776 @@
+// csimple's scanner, written by hand in place of the flex one (lexer.l)
+// the compiler started out with.  It keeps that scanner's rules exactly:
+// the parser gets the same tokens, the same yylval and the same yylineno,
+// even where the flex rules are odd (see scan_number and comment_end).
+// "make lexcheck" checks that lexing in parallel gives the same tokens and
+// "make lexbench" times it.
+//
+// Whitespace, comment bodies and identifiers are scanned 16 bytes at a
+// time with SSE2, which every x86-64 has, so no special compiler flags are
+// needed; elsewhere the same loops are done a byte at a time.  Keywords are
+// picked out of the identifiers with a perfect hash.
+//
+// Given more than one thread, lexer_create lexes a big program up front in
+// chunks, all at once, into an array of tokens that yylex then hands out
+// (see "Lexing in parallel" at the bottom).
+
+#include <atomic>
+#include <cassert>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "ast.hpp"
+#include "parser.hpp"
+#include "lexer.hpp"
+#include "source.hpp"
+#include "strpool.hpp"
+
+/*** Blocks of 16 ***/
+
+// The source is padded with zeros, so these all read past the end of the
+// text without checking and stop there since a NUL never matches.
+
+#ifdef __SSE2__
+
+static inline unsigned match(__m128i v, char c)
+{
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(c)));
+}
+
+// Bytes in [lo, hi], as a signed compare, so nothing >= 0x80 is ever in
+static inline __m128i in_range(__m128i v, char lo, char hi)
+{
+    return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(lo - 1)),
+                         _mm_cmplt_epi8(v, _mm_set1_epi8(hi + 1)));
+}
+
+// Skips [ \t\n]*, adding the newlines to lines
+static const char* skip_space(const char* p, int& lines)
+{
+    for(;;) {
+        __m128i v = _mm_loadu_si128((const __m128i*) p);
+        unsigned nl = match(v, '\n');
+        unsigned space = match(v, ' ') | match(v, '\t') | nl;
+        if(space != 0xffff) {
+            unsigned n = __builtin_ctz(~space);
+            lines += __builtin_popcount(nl & ((1u << n) - 1));
+            return p + n;
+        }
+        lines += __builtin_popcount(nl);
+        p += 16;
+    }
+}
+
+// Skips [0-9_a-zA-Z]*
+static const char* skip_ident(const char* p)
+{
+    for(;;) {
+        __m128i v = _mm_loadu_si128((const __m128i*) p);
+        // Or-ing in 0x20 lower cases the letters and nothing else lands
+        // in a-z
+        __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+        __m128i ident = _mm_or_si128(
+                _mm_or_si128(in_range(lower, 'a', 'z'), in_range(v, '0', '9')),
+                _mm_cmpeq_epi8(v, _mm_set1_epi8('_')));
+        unsigned mask = _mm_movemask_epi8(ident);
+        if(mask != 0xffff) {
+            return p + __builtin_ctz(~mask);
+        }
+        p += 16;
+    }
+}
+
+// The first '/' at or after p, or NULL if there is none before end
+static const char* find_slash(const char* p, const char* end)
+{
+    for(; p < end; p += 16) {
+        unsigned mask = match(_mm_loadu_si128((const __m128i*) p), '/');
+        if(mask) {
+            p += __builtin_ctz(mask);
+            return p < end ? p : NULL;
+        }
+    }
+    return NULL;
+}
+
+static int count_lines(const char* p, const char* end)
+{
+    int lines = 0;
+    for(; p + 16 <= end; p += 16) {
+        lines += __builtin_popcount(match(_mm_loadu_si128((const __m128i*) p), '\n'));
+    }
+    for(; p < end; ++p) {
+        lines += *p == '\n';
+    }
+    return lines;
+}
+
+#else
+
+static const char* skip_space(const char* p, int& lines)
+{
+    for(; *p == ' ' || *p == '\t' || *p == '\n'; ++p) {
+        lines += *p == '\n';
+    }
+    return p;
+}
+
+static const char* skip_ident(const char* p)
+{
+    while((*p >= 'a' && *p <= 'z') || (*p >= 'A' && *p <= 'Z') ||
+          (*p >= '0' && *p <= '9') || *p == '_') {
+        ++p;
+    }
+    return p;
+}
+
+static const char* find_slash(const char* p, const char* end)
+{
+    return (const char*) memchr(p, '/', end - p);
+}
+
+static int count_lines(const char* p, const char* end)
+{
+    int lines = 0;
+    for(; p < end; ++p) {
+        lines += *p == '\n';
+    }
+    return lines;
+}
+
+#endif
+
+/*** Keywords ***/
+
+struct Keyword {
+    const char* name;
+    int token;
+    int value;
+};
+
+// Indexed by keyword_hash, which gives each keyword its own slot
+static const Keyword s_keywords[32] = {
+    { "char", T_CHAR, 0 },
+    { NULL, 0, 0 },
+    { NULL, 0, 0 },
+    { "charptr", T_CHARPTR, 0 },
+    { "null", T_NULL, 0 },
+    { "var", T_VAR, 0 },
+    { "if", T_IF, 0 },
+    { NULL, 0, 0 },
+    { "procedure", T_PROCEDURE, 0 },
+    { NULL, 0, 0 },
+    { NULL, 0, 0 },
+    { "true", T_BOOL_LITERAL, 1 },
+    { NULL, 0, 0 },
+    { "else", T_ELSE, 0 },
+    { "intptr", T_INTPTR, 0 },
+    { "integer", T_INTEGER, 0 },
+    { "false", T_BOOL_LITERAL, 0 },
+    { "string", T_STRING, 0 },
+    { "while", T_WHILE, 0 },
+    { NULL, 0, 0 },
+    { "return", T_RETURN, 0 },
+    { "boolean", T_BOOLEAN, 0 },
+    { NULL, 0, 0 },
+    { NULL, 0, 0 },
+    { NULL, 0, 0 },
+    { NULL, 0, 0 },
+    { NULL, 0, 0 },
+    { NULL, 0, 0 },
+    { NULL, 0, 0 },
+    { NULL, 0, 0 },
+    { NULL, 0, 0 },
+    { NULL, 0, 0 },
+};
+
+static inline unsigned keyword_hash(const char* s, size_t len)
+{
+    return (2 * (unsigned char) s[0] + 19 * (unsigned char) s[len - 1] + len) & 31;
+}
+
+// The token for the identifier-shaped word at s: a keyword if the whole
+// word is one (flex took the earlier rule when two matched the same
+// length), otherwise an identifier, interned into strpool
+static int word_token(const char* s, size_t len, StringPool* strpool,
+                      YYSTYPE* value)
+{
+    if(len >= 2 && len <= 9) {
+        const Keyword& k = s_keywords[keyword_hash(s, len)];
+        if(k.name && !strncmp(k.name, s, len) && k.name[len] == '\0') {
+            if(k.token == T_BOOL_LITERAL) {
+                value->u_base_int = k.value;
+            }
+            return k.token;
+        }
+    }
+    value->u_base_charptr = strpool->intern(s, len);
+    return T_IDENTIFIER_LITERAL;
+}
+
+/*** Literals ***/
+
+// What strtol(s, NULL, base) gives for the digits from s to end, as an int
+static int to_int(const char* s, const char* end, int base)
+{
+    unsigned long value = 0;
+    for(; s < end; ++s) {
+        int d = *s <= '9' ? *s - '0' : (*s | 0x20) - 'a' + 10;
+        if(value > (unsigned long) (LONG_MAX - d) / base) {
+            return (int) LONG_MAX;
+        }
+        value = value * base + d;
+    }
+    return (int) value;
+}
+
+static inline bool is_hex(char c)
+{
+    return (c >= '0' && c <= '9') || ((c | 0x20) >= 'a' && (c | 0x20) <= 'f');
+}
+
+// The number rules overlap, so each one is tried and the
+// longest match wins, the earliest rule on a tie:
+//
+//   [0]|[1-9][0-9]*        decimal
+//   [0][X|x][0-9a-fA-F]*   hex (the class has a '|' in it, so "0|" is 0)
+//   [0][0-7]*              octal, so "019" is 1 then 9
+//   [01]+b                 binary, so "101b" is 5 but "12b" is 12 then b
+static const char* scan_number(const char* p, YYSTYPE* value)
+{
+    const char* end = p + 1;
+    const char* digits = p;
+    int base = 10;
+
+    if(*p != '0') {
+        while(*end >= '0' && *end <= '9') {
+            ++end;
+        }
+    } else if(p[1] == 'X' || p[1] == 'x' || p[1] == '|') {
+        for(end = p + 2; is_hex(*end); ++end)
+            ;
+        digits = p + 2;
+        base = 16;
+    } else {
+        const char* q = p + 1;
+        while(*q >= '0' && *q <= '7') {
+            ++q;
+        }
+        if(q > end) {
+            end = q;
+            digits = p + 1;
+            base = 8;
+        }
+    }
+
+    const char* q = p;
+    while(*q == '0' || *q == '1') {
+        ++q;
+    }
+    if(q > p && *q == 'b' && q + 1 > end) {
+        end = q + 1;
+        digits = p;
+        base = 2;
+    }
+
+    value->u_base_int = to_int(digits, base == 2 ? end - 1 : end, base);
+    return end;
+}
+
+/*** Scanner ***/
+
+// Scans the text from start, one token at a time, stopping before the
+// first token that would start at or past limit.  yylex uses one of these
+// for the whole program; in parallel each chunk gets its own.
+class Scanner
+{
+  public:
+    // scan() gives this for a character no rule matches, which flex's
+    // default rule copies to the output (value->u_base_int is the
+    // character)
+    enum { ECHO = -1 };
+
+    const char* m_pos;          // where scanning carries on
+    const char* m_token;        // where the last token started
+    int m_line;                 // counts the newlines scanned over
+
+    Scanner();
+    Scanner(const char* start, const char* limit, const char* end, int line,
+            StringPool* strpool, bool cut_strings);
+
+    // The next token and its value, or 0 for no more
+    int scan(YYSTYPE* value);
+
+    const char* end() const {
+        return m_end;
+    }
+
+  private:
+    const char* m_limit;
+    const char* m_end;          // end of the program text
+    StringPool* m_strpool;      // identifiers are interned here
+
+    // Whether string literals get their closing quote turned into a NUL
+    // (see the '"' case in scan)
+    bool m_cut_strings;
+
+    // Once a comment has been found to have no end, where its body
+    // started (see comment_end)
+    const char* m_no_comment_end;
+
+    const char* comment_end(const char* body);
+};
+
+Scanner::Scanner()
+{
+    m_pos = m_token = m_limit = m_end = m_no_comment_end = NULL;
+    m_line = 0;
+    m_strpool = NULL;
+    m_cut_strings = false;
+}
+
+Scanner::Scanner(const char* start, const char* limit, const char* end,
+                 int line, StringPool* strpool, bool cut_strings)
+{
+    m_pos = m_token = start;
+    m_limit = limit;
+    m_end = end;
+    m_line = line;
+    m_strpool = strpool;
+    m_cut_strings = cut_strings;
+    m_no_comment_end = NULL;
+}
+
+// Where the comment whose body starts at body ends, or NULL if it never
+// does.  The rule is \/%(%[^\/]|[^%]|\n)*%\/, so every '%' in the body
+// pairs up with the character after it, which cannot be a '/'.  That makes
+// the first '/' after an odd number of '%'s the end, and nothing can go
+// past it.
+//
+// flex, finding no end, went back to matching just the "/", and the next
+// "/%" started the search over.  Remembering where the last search failed
+// keeps a run of "/%/%/%..." from taking quadratic time: a later search
+// only sees the same '%' runs, apart from the first.
+const char* Scanner::comment_end(const char* body)
+{
+    const char* p = body;
+
+    if(m_no_comment_end && m_no_comment_end <= body) {
+        while(*p == '%') {
+            ++p;
+        }
+        if(*p == '/' && (p - body) % 2 == 1 && p < m_end) {
+            return p + 1;
+        }
+        return NULL;
+    }
+
+    for(;;) {
+        const char* slash = find_slash(p, m_end);
+        if(!slash) {
+            m_no_comment_end = body;
+            return NULL;
+        }
+        const char* q = slash;
+        while(q > body && q[-1] == '%') {
+            --q;
+        }
+        if((slash - q) % 2 == 1) {
+            return slash + 1;
+        }
+        p = slash + 1;
+    }
+}
+
+// One or two character operators, the second character being c2
+#define PAIR(c2, long_token, short_token) \
+    if(p[1] == c2) { \
+        m_pos = p + 2; \
+        return long_token; \
+    } \
+    m_pos = p + 1; \
+    return short_token;
+
+#define SINGLE(token) \
+    m_pos = p + 1; \
+    return token;
+
+int Scanner::scan(YYSTYPE* value)
+{
+    for(;;) {
+        const char* p = skip_space(m_pos, m_line);
+        m_pos = m_token = p;
+        if(p >= m_limit || p >= m_end) {
+            return 0;
+        }
+
+        switch(*p) {
+            case 'a': case 'b': case 'c': case 'd': case 'e': case 'f':
+            case 'g': case 'h': case 'i': case 'j': case 'k': case 'l':
+            case 'm': case 'n': case 'o': case 'p': case 'q': case 'r':
+            case 's': case 't': case 'u': case 'v': case 'w': case 'x':
+            case 'y': case 'z':
+            case 'A': case 'B': case 'C': case 'D': case 'E': case 'F':
+            case 'G': case 'H': case 'I': case 'J': case 'K': case 'L':
+            case 'M': case 'N': case 'O': case 'P': case 'Q': case 'R':
+            case 'S': case 'T': case 'U': case 'V': case 'W': case 'X':
+            case 'Y': case 'Z':
+                m_pos = skip_ident(p + 1);
+                return word_token(p, m_pos - p, m_strpool, value);
+
+            case '0': case '1': case '2': case '3': case '4':
+            case '5': case '6': case '7': case '8': case '9':
+                m_pos = scan_number(p, value);
+                return T_INTEGER_LITERAL;
+
+            case '/':
+                if(p[1] == '%') {
+                    const char* end = comment_end(p + 2);
+                    if(end) {
+                        m_line += count_lines(p, end);
+                        m_pos = end;
+                        continue;
+                    }
+                }
+                SINGLE(T_DIVIDE)
+
+            case '\'':
+                // \'[^\"\n]\'  (past the end p[2] is a NUL, not a quote)
+                if(p[1] != '"' && p[1] != '\n' && p[2] == '\'') {
+                    value->u_base_int = p[1];
+                    m_pos = p + 3;
+                    return T_CHAR_LITERAL;
+                }
+                break;
+
+            case '"': {
+                // \"[^\"\n]*\", which stays in the text
+                char* q = (char*) p + 1;
+                while(q < m_end && *q != '"' && *q != '\n') {
+                    ++q;
+                }
+                if(q < m_end && *q == '"') {
+                    if(m_cut_strings) {
+                        *q = '\0';
+                    }
+                    value->u_base_charptr = p + 1;
+                    m_pos = q + 1;
+                    return T_STRING_LITERAL;
+                }
+                break;
+            }
+
+            case '&': PAIR('&', T_AND, T_REFERENCE)
+            case '=': PAIR('=', T_BOOL_EQUAL, T_EQUAL)
+            case '>': PAIR('=', T_GREATER_THAN_OR_EQUAL, T_GREATER_THAN)
+            case '<': PAIR('=', T_LESS_THAN_OR_EQUAL, T_LESS_THAN)
+            case '!': PAIR('=', T_NOT_EQUAL, T_NOT)
+            case '|': PAIR('|', T_OR, T_BAR)
+
+            case '-': SINGLE(T_MINUS)
+            case '+': SINGLE(T_PLUS)
+            case '*': SINGLE(T_TIMES)
+            case '^': SINGLE(T_DEREFERENCE)
+            case ';': SINGLE(T_SEMICOLON)
+            case ':': SINGLE(T_COLON)
+            case ',': SINGLE(T_COMMA)
+            case '{': SINGLE(T_OPEN_CURLY)
+            case '}': SINGLE(T_CLOSE_CURLY)
+            case '(': SINGLE(T_OPEN_PARAN)
+            case ')': SINGLE(T_CLOSE_PARAN)
+            case '[': SINGLE(T_OPEN_SQUARE)
+            case ']': SINGLE(T_CLOSE_SQUARE)
+        }
+
+        value->u_base_int = *p;
+        m_pos = p + 1;
+        return ECHO;
+    }
+}
+
+/*** Lexing in parallel ***/
+
+// A token as the parser gets it, with the yylineno that goes with it
+struct Token {
+    int token;              // or Scanner::ECHO
+    int line;
+    YYSTYPE value;
+};
+
+// The program is cut into chunks of about CHUNK_SIZE bytes, each just
+// after a newline, and every chunk is lexed on its own as if a token
+// started right at its beginning.  Nothing but a comment can run over a
+// newline, so that guess is only wrong where a comment (or an unknown
+// number of "/%"s with no end) crosses the cut.  Then the token before
+// the cut ends somewhere past it, and the chunk after is lexed again from
+// there, up to the first token it has in common with the guess; from a
+// given place the scanner always does the same thing, so the rest of the
+// guess stands.
+enum { CHUNK_SIZE = 1 << 20 };
+
+struct Chunk {
+    const char* start;
+    const char* end;            // start of the next chunk
+    int newlines;               // in the chunk
+
+    // What the chunk lexes to.  Lines count from the start of the chunk,
+    // identifiers are interned into the chunk's own pool (it may not be
+    // the program's first time seeing them) and string literals are not
+    // cut out yet, since the guess could be wrong.
+    std::vector<Token> tokens;
+    std::vector<const char*> starts;    // where each token starts
+    const char* resume;                 // where the next chunk's tokens start
+    StringPool strpool;
+};
+
+static void lex_chunk(Chunk& c, const char* text_end)
+{
+    Scanner scanner(c.start, c.end, text_end, 0, &c.strpool, false);
+    Token t;
+
+    while((t.token = scanner.scan(&t.value)) != 0) {
+        t.line = scanner.m_line;
+        c.tokens.push_back(t);
+        c.starts.push_back(scanner.m_token);
+    }
+    c.resume = scanner.m_pos;
+    c.newlines = count_lines(c.start, c.end);
+}
+
+// The chunk's tokens really start at from, not at its start
+static void relex_chunk(Chunk& c, const char* from, const char* text_end)
+{
+    std::vector<Token> tokens;
+    size_t k = 0;
+
+    if(from >= c.end) {
+        // All of it is in a comment
+        c.tokens.swap(tokens);
+        c.resume = from;
+        return;
+    }
+
+    Scanner scanner(from, c.end, text_end, count_lines(c.start, from),
+                    &c.strpool, false);
+    Token t;
+    while((t.token = scanner.scan(&t.value)) != 0) {
+        while(k < c.starts.size() && c.starts[k] < scanner.m_token) {
+            ++k;
+        }
+        if(k < c.starts.size() && c.starts[k] == scanner.m_token) {
+            // Back in step, so the rest of the guess holds
+            tokens.insert(tokens.end(), c.tokens.begin() + k, c.tokens.end());
+            c.tokens.swap(tokens);
+            return;
+        }
+        t.line = scanner.m_line;
+        tokens.push_back(t);
+    }
+    c.tokens.swap(tokens);
+    c.resume = scanner.m_pos;
+}
+
+// Puts the program's tokens in tokens and returns the line at the end
+static int lex_parallel(SourceBuffer* source, StringPool* strpool,
+                        int threads, std::vector<Token>& tokens)
+{
+    const char* text = source->text();
+    const char* text_end = text + source->size();
+
+    std::vector<const char*> cuts;
+    for(const char* p = text; p < text_end; ) {
+        cuts.push_back(p);
+        const char* q = NULL;
+        if(text_end - p > CHUNK_SIZE) {
+            q = (const char*) memchr(p + CHUNK_SIZE, '\n',
+                                     text_end - p - CHUNK_SIZE);
+        }
+        p = q ? q + 1 : text_end;
+    }
+
+    std::vector<Chunk> chunks(cuts.size());
+    for(size_t i = 0; i < chunks.size(); ++i) {
+        chunks[i].start = cuts[i];
+        chunks[i].end = i + 1 < cuts.size() ? cuts[i + 1] : text_end;
+    }
+
+    // Guess
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> workers;
+    for(int i = 0; i < threads && i < (int) chunks.size(); ++i) {
+        workers.push_back(std::thread([&]() {
+            for(size_t n; (n = next++) < chunks.size(); ) {
+                lex_chunk(chunks[n], text_end);
+            }
+        }));
+    }
+    for(size_t i = 0; i < workers.size(); ++i) {
+        workers[i].join();
+    }
+
+    // Check the guesses in order, fixing the wrong ones, and put the
+    // tokens together.  Identifiers are interned into the real pool in
+    // the order they come in, so they get the same ids as when lexing
+    // one token at a time.
+    size_t count = 0;
+    const char* from = text;
+    for(size_t i = 0; i < chunks.size(); ++i) {
+        if(from != chunks[i].start) {
+            relex_chunk(chunks[i], from, text_end);
+        }
+        from = chunks[i].resume;
+        count += chunks[i].tokens.size();
+    }
+
+    tokens.clear();
+    tokens.reserve(count);
+    int line = 1;
+    for(size_t i = 0; i < chunks.size(); ++i) {
+        Chunk& c = chunks[i];
+        std::vector<const char*> names(c.strpool.size(), (const char*) NULL);
+
+        for(size_t k = 0; k < c.tokens.size(); ++k) {
+            Token t = c.tokens[k];
+            t.line += line;
+            if(t.token == T_IDENTIFIER_LITERAL) {
+                int id = StringPool::id(t.value.u_base_charptr);
+                if(!names[id]) {
+                    names[id] = strpool->intern(t.value.u_base_charptr);
+                }
+                t.value.u_base_charptr = names[id];
+            } else if(t.token == T_STRING_LITERAL) {
+                char* q = (char*) t.value.u_base_charptr;
+                while(*q != '"') {
+                    ++q;
+                }
+                *q = '\0';
+            }
+            tokens.push_back(t);
+        }
+
+        line += c.newlines;
+        std::vector<Token>().swap(c.tokens);
+    }
+    return line;
+}
+
+/*** yylex ***/
+
+// What a yyscan_t points to
+struct Lexer {
+    Scanner scanner;
+    int lineno;                 // yylineno
+    FILE* out;                  // for characters no rule matches
+
+    // The program's tokens and the next one for yylex, if it was lexed in
+    // parallel
+    bool feeding;
+    std::vector<Token> tokens;
+    size_t next;
+    int last_line;              // yylineno at the end
+};
+
+int yylex(YYSTYPE* value, yyscan_t scanner)
+{
+    Lexer* lexer = (Lexer*) scanner;
+
+    if(lexer->feeding) {
+        while(lexer->next < lexer->tokens.size()) {
+            const Token& t = lexer->tokens[lexer->next++];
+            if(t.token == Scanner::ECHO) {
+                putc(t.value.u_base_int, lexer->out);
+                continue;
+            }
+            lexer->lineno = t.line;
+            *value = t.value;
+            return t.token;
+        }
+        lexer->lineno = lexer->last_line;
+        return 0;
+    }
+
+    for(;;) {
+        int token = lexer->scanner.scan(value);
+        lexer->lineno = lexer->scanner.m_line;
+        if(token != Scanner::ECHO) {
+            return token;
+        }
+        // Nothing matched, so like flex's default rule copy the character
+        // to the output and go on
+        putc(value->u_base_int, lexer->out);
+    }
+}
+
+// With more than one thread a program bigger than a chunk is lexed right
+// away, in parallel.
+yyscan_t lexer_create(SourceBuffer* source, StringPool* strpool,
+                      FILE* out, int threads)
+{
+    const char* text = source->text();
+    const char* text_end = text + source->size();
+    Lexer* lexer = new Lexer;
+
+    lexer->lineno = 1;
+    lexer->out = out;
+    lexer->next = 0;
+    lexer->last_line = 1;
+    if(threads > 1 && source->size() > CHUNK_SIZE) {
+        lexer->last_line = lex_parallel(source, strpool, threads,
+                                        lexer->tokens);
+        lexer->feeding = true;
+    } else {
+        lexer->scanner = Scanner(text, text_end, text_end, 1, strpool, true);
+        lexer->feeding = false;
+    }
+    return lexer;
+}
+
+void lexer_destroy(yyscan_t scanner)
+{
+    delete (Lexer*) scanner;
+}
+
+int lexer_lineno(yyscan_t scanner)
+{
+    return ((Lexer*) scanner)->lineno;
+}
+
+const char* lexer_position(yyscan_t scanner)
+{
+    Lexer* lexer = (Lexer*) scanner;
+    assert(!lexer->feeding);
+    return lexer->scanner.m_pos;
+}
+
+void lexer_seek(yyscan_t scanner, const char* pos, int line)
+{
+    Lexer* lexer = (Lexer*) scanner;
+    assert(!lexer->feeding);
+    lexer->scanner.m_pos = pos;
+    lexer->scanner.m_line = line;
+    lexer->lineno = line;
+}
+
+bool lexer_skip_block(yyscan_t scanner, const char** body, int* line)
+{
+    Lexer* lexer = (Lexer*) scanner;
+    assert(!lexer->feeding);
+    Scanner& s = lexer->scanner;
+    int end_line = s.m_line;
+    const char* end = skip_block(s.m_pos, s.end(), &end_line);
+    if(!end) {
+        return false;
+    }
+    *body = s.m_pos;
+    *line = s.m_line;
+    lexer_seek(scanner, end, end_line);
+    return true;
+}
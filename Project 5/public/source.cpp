@@ -0,0 +1,199 @@
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "source.hpp"
+
+SourceBuffer::SourceBuffer(int fd)
+{
+    struct stat st;
+
+    m_text = NULL;
+    m_size = 0;
+    m_map_size = 0;
+
+    if(fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        // Reserve room for the file plus the padding, then map the file
+        // over the front of it.  The rest of the last page of the file and
+        // anything past it reads as zeros, so the NULs come for free.
+        size_t page = sysconf(_SC_PAGESIZE);
+        size_t map_size = (st.st_size + PADDING + page - 1) / page * page;
+        void* base = mmap(NULL, map_size, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(base != MAP_FAILED) {
+            void* m = mmap(base, st.st_size, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_FIXED, fd, 0);
+            if(m != MAP_FAILED) {
+                m_text = (char*) base;
+                m_size = st.st_size;
+                m_map_size = map_size;
+                return;
+            }
+            munmap(base, map_size);
+        }
+    }
+
+    // Not a file (or it could not be mapped), so read the whole thing
+    read_all(fd);
+}
+
+SourceBuffer::SourceBuffer(const char* text, size_t size)
+{
+    m_text = (char*) malloc(size + PADDING);
+    if(m_text == NULL) {
+        fprintf(stderr, "out of memory reading the program\n");
+        exit(1);
+    }
+    m_size = size;
+    m_map_size = 0;
+    memcpy(m_text, text, size);
+    memset(m_text + size, 0, PADDING);
+}
+
+void SourceBuffer::read_all(int fd)
+{
+    size_t cap = 1 << 16;
+    m_text = (char*) malloc(cap);
+
+    for(;;) {
+        if(cap - m_size <= PADDING) {
+            cap *= 2;
+            m_text = (char*) realloc(m_text, cap);
+        }
+        if(m_text == NULL) {
+            fprintf(stderr, "out of memory reading the program\n");
+            exit(1);
+        }
+
+        ssize_t n = read(fd, m_text + m_size, cap - m_size - PADDING);
+        if(n < 0 && errno == EINTR) {
+            continue;
+        }
+        if(n < 0) {
+            perror("reading the program");
+            exit(1);
+        }
+        if(n == 0) {
+            break;
+        }
+        m_size += n;
+    }
+
+    memset(m_text + m_size, 0, PADDING);
+}
+
+SourceBuffer::~SourceBuffer()
+{
+    if(m_map_size) {
+        munmap(m_text, m_map_size);
+    } else {
+        free(m_text);
+    }
+}
+
+char* SourceBuffer::text()
+{
+    return m_text;
+}
+
+size_t SourceBuffer::size()
+{
+    return m_size;
+}
+
+// Just past the end of the comment whose body starts at body, or NULL if
+// it does not end before end.  Inside a comment every '%' pairs up with the
+// character after it, and the pair "%/" ends it.  *no_end is where the
+// body of the last comment found not to end started: after that a comment
+// can only end in its first run of '%'s, as the scanner's comment_end works
+// out.
+static const char* comment_end(const char* body, const char* end,
+                               const char** no_end)
+{
+    const char* p = body;
+
+    if(*no_end && *no_end <= body) {
+        while(*p == '%') {
+            ++p;
+        }
+        if(*p == '/' && (p - body) % 2 == 1 && p < end) {
+            return p + 1;
+        }
+        return NULL;
+    }
+
+    for(; p < end; ++p) {
+        if(*p == '%') {
+            if(p[1] == '/') {
+                return p + 2;
+            }
+            if(p[1] == '%') {
+                ++p;
+            }
+        }
+    }
+    *no_end = body;
+    return NULL;
+}
+
+// The text is padded with NULs, so looking a character or two past end
+// finds one of those, which matches nothing
+const char* skip_block(const char* p, const char* end, int* line)
+{
+    int depth = 1;
+    const char* no_end = NULL;
+
+    while(p < end) {
+        switch(*p) {
+            case '\n':
+                ++*line;
+                break;
+            case '{':
+                ++depth;
+                break;
+            case '}':
+                if(--depth == 0) {
+                    return p + 1;
+                }
+                break;
+            case '\'':
+                // \'[^\"\n]\'
+                if(p[1] != '"' && p[1] != '\n' && p[2] == '\'') {
+                    p += 2;
+                }
+                break;
+            case '"': {
+                // \"[^\"\n]*\", otherwise the quote is just a character
+                const char* q = p + 1;
+                while(q < end && *q != '"' && *q != '\n') {
+                    ++q;
+                }
+                if(q < end && *q == '"') {
+                    p = q;
+                }
+                break;
+            }
+            case '/': {
+                if(p[1] != '%') {
+                    break;
+                }
+                // A "/%" with no end is just a '/', and what follows it
+                // is code
+                const char* q = comment_end(p + 2, end, &no_end);
+                if(q) {
+                    for(; p < q - 1; ++p) {
+                        *line += *p == '\n';
+                    }
+                }
+                break;
+            }
+        }
+        ++p;
+    }
+    return NULL;
+}
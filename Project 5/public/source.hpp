@@ -0,0 +1,47 @@
+#ifndef SOURCE_HPP
+#define SOURCE_HPP
+
+#include <cstddef>
+
+// The text of the program being compiled.  It stays in memory, at the
+// same address, for the whole compilation, so the lexer can scan it in
+// place and tokens (string literals, for example) can point straight into
+// it instead of being copied out.
+//
+// A regular file is mapped copy-on-write, anything else (a pipe) is read
+// into memory, and a program that is already in memory is copied.  Either
+// way the text is writable and followed by PADDING NUL bytes, since the
+// scanner reads up to 16 bytes at a time without looking where the text
+// ends.
+class SourceBuffer
+{
+  public:
+    enum { PADDING = 32 };
+
+  private:
+    char* m_text;
+    size_t m_size;      // bytes of program text (not counting the NULs)
+    size_t m_map_size;  // size of the mapping, 0 if the text was read in
+
+    void read_all(int fd);
+
+  public:
+    // Reads the program from the file descriptor fd
+    SourceBuffer(int fd);
+    // Copies the size bytes of program at text
+    SourceBuffer(const char* text, size_t size);
+    ~SourceBuffer();
+
+    // The program text, followed by PADDING NUL bytes
+    char* text();
+    size_t size();
+};
+
+// Where the { } block whose body starts at p (just after its "{") ends,
+// just after the matching "}", or NULL if the text runs out at end first.
+// It goes by the scanner's rules, so a brace in a comment or in a string or
+// char literal does not count (a "/%" with no end is no comment), and it
+// adds the newlines it passes to *line.  Nothing in the text is changed.
+const char* skip_block(const char* p, const char* end, int* line);
+
+#endif //SOURCE_HPP
@@ -0,0 +1,121 @@
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+
+#include "strpool.hpp"
+
+// Each string is stored as its id followed by its characters and a NUL,
+// and intern() hands out a pointer to the characters, so id() is just a
+// load from right before them.
+static const size_t BLOCK_SIZE = 1 << 16;
+
+StringPool::StringPool()
+{
+    m_next = NULL;
+    m_left = 0;
+    m_table.assign(1024, -1);
+}
+
+StringPool::~StringPool()
+{
+    for(size_t i = 0; i < m_blocks.size(); ++i) {
+        free(m_blocks[i]);
+    }
+}
+
+// FNV-1a
+unsigned StringPool::hash(const char* s, size_t len)
+{
+    unsigned h = 2166136261u;
+    for(size_t i = 0; i < len; ++i) {
+        h = (h ^ (unsigned char) s[i]) * 16777619u;
+    }
+    return h;
+}
+
+// n bytes of pool memory, aligned for an int
+char* StringPool::allocate(size_t n)
+{
+    n = (n + sizeof(int) - 1) / sizeof(int) * sizeof(int);
+    if(n > m_left) {
+        size_t size = n > BLOCK_SIZE ? n : BLOCK_SIZE;
+        char* block = (char*) malloc(size);
+        assert(block != NULL);
+        m_blocks.push_back(block);
+        m_next = block;
+        m_left = size;
+    }
+    char* p = m_next;
+    m_next += n;
+    m_left -= n;
+    return p;
+}
+
+// Doubles the hash table once it gets half full
+void StringPool::grow_table()
+{
+    std::vector<int> table(m_table.size() * 2, -1);
+    size_t mask = table.size() - 1;
+    for(size_t id = 0; id < m_strings.size(); ++id) {
+        size_t i = m_hashes[id] & mask;
+        while(table[i] != -1) {
+            i = (i + 1) & mask;
+        }
+        table[i] = id;
+    }
+    m_table.swap(table);
+}
+
+const char* StringPool::intern(const char* s, size_t len)
+{
+    unsigned h = hash(s, len);
+    size_t mask = m_table.size() - 1;
+    size_t i = h & mask;
+
+    for(; m_table[i] != -1; i = (i + 1) & mask) {
+        int id = m_table[i];
+        const char* str = m_strings[id];
+        if(m_hashes[id] == h && !strncmp(str, s, len) && str[len] == '\0') {
+            return str;
+        }
+    }
+
+    // Not seen before, so make the copy
+    int id = m_strings.size();
+    char* p = allocate(sizeof(int) + len + 1);
+    memcpy(p, &id, sizeof(int));
+    char* str = p + sizeof(int);
+    memcpy(str, s, len);
+    str[len] = '\0';
+
+    m_table[i] = id;
+    m_strings.push_back(str);
+    m_hashes.push_back(h);
+    if(m_strings.size() * 2 > m_table.size()) {
+        grow_table();
+    }
+    return str;
+}
+
+const char* StringPool::intern(const char* s)
+{
+    return intern(s, strlen(s));
+}
+
+int StringPool::id(const char* interned)
+{
+    int id;
+    memcpy(&id, interned - sizeof(int), sizeof(int));
+    return id;
+}
+
+const char* StringPool::spelling(int id)
+{
+    assert(id >= 0 && id < (int) m_strings.size());
+    return m_strings[id];
+}
+
+int StringPool::size()
+{
+    return m_strings.size();
+}
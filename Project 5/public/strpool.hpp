@@ -0,0 +1,49 @@
+#ifndef STRPOOL_HPP
+#define STRPOOL_HPP
+
+#include <cstddef>
+#include <vector>
+
+// Holds one copy of every identifier in the program, for as long as the
+// compilation runs.  intern() returns the same pointer every time it is
+// given the same spelling, so names can be compared and hashed by their
+// pointer (this is how the SymTab looks them up).  Each name also gets a
+// small id, handed out 0, 1, 2, ... in order of first appearance, for
+// anything that wants to keep a table indexed by name.
+//
+// The strings are packed into large blocks, so interning a name that has
+// been seen before does no allocation at all, and a new one only now and
+// then.
+class StringPool
+{
+  private:
+    std::vector<char*> m_blocks;      // where the strings live
+    char* m_next;                     // free space in the last block
+    size_t m_left;
+
+    std::vector<const char*> m_strings;   // by id
+    std::vector<unsigned> m_hashes;       // by id
+    std::vector<int> m_table;             // open addressing, -1 is empty
+
+    static unsigned hash(const char* s, size_t len);
+    char* allocate(size_t n);
+    void grow_table();
+
+  public:
+    StringPool();
+    ~StringPool();
+
+    // The interned copy of the len characters at s (which need not be NUL
+    // terminated).  The copy is NUL terminated.
+    const char* intern(const char* s, size_t len);
+    const char* intern(const char* s);
+
+    // The id of a string returned by intern, and the other way around
+    static int id(const char* interned);
+    const char* spelling(int id);
+
+    // Number of different strings interned so far
+    int size();
+};
+
+#endif //STRPOOL_HPP
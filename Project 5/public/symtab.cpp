@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <functional>
+#include <list>
 #include <string>
 #include <unordered_map>
 
@@ -7,25 +8,25 @@
 #include <cstdio>
 #include <cstring>
 
+#include "ast.hpp"
 #include "symtab.hpp"
 
 /****** SymName Implemenation **************************************/
 
-SymName::SymName(char* const x)
+SymName::SymName(const char* x)
 {
     m_spelling = x;
-    m_parent_attribute = NULL;
+    m_scope = NULL;
 }
 
 SymName::SymName(const SymName & other)
 {
-    m_spelling = strdup(other.m_spelling);
-    m_parent_attribute = other.m_parent_attribute;
+    m_spelling = other.m_spelling;
+    m_scope = other.m_scope;
 }
 
 SymName& SymName::operator=(const SymName & other)
 {
-    delete m_spelling;
     SymName tmp(other);
     swap(tmp);
     return *this;
@@ -34,11 +35,11 @@ SymName& SymName::operator=(const SymName & other)
 void SymName::swap(SymName & other)
 {
     std::swap(m_spelling, other.m_spelling);
+    std::swap(m_scope, other.m_scope);
 }
 
 SymName::~SymName()
 {
-    delete(m_spelling);
 }
 
 void SymName::accept(Visitor *v)
@@ -66,21 +67,6 @@ const char* SymName::mangled_spelling()
     // fix me: should handle the name scoping properly
 }
 
-Symbol* SymName::symbol()
-{
-    return m_symbol;
-}
-
-void SymName::set_symbol(Symbol* s)
-{
-    // You should not try to reset a symbol pointer
-    // Once it is set, that pointer is used all
-    // sorts of places - changes to it once it is
-    // set can results in weird behavior
-    assert(m_symbol == NULL);
-    m_symbol = s;
-}
-
 
 /****** SymScope Def (used by SymTab) **************************************/
 
@@ -90,19 +76,19 @@ class SymScope
   private:
     SymScope* m_parent;
     std::list<SymScope*> m_child;
-    typedef std::unordered_map<std::string, Symbol*> ScopeTableType;
+    // keyed by the interned name, so hashing and comparing is on pointers
+    typedef std::unordered_map<const char*, Symbol*> ScopeTableType;
     ScopeTableType m_scopetable;
     int m_scopesize;
     SymScope* parent();
     void add_child(SymScope* c);
     SymScope(SymScope * parent);
-    bool is_dup_string(char* name);     // Used for error checking
 
     void dump(FILE* f, int nest_level);
     SymScope* open_scope();
     SymScope* close_scope();
-    bool exist(char* name);
-    Symbol* insert(char* name, Symbol * s);
+    bool exist(const char* name);
+    Symbol* insert(const char* name, Symbol * s);
     Symbol* lookup(const char * name);
 
   public:
@@ -126,11 +112,6 @@ SymTab::~SymTab()
     delete m_head;
 }
 
-bool SymTab::is_dup_string(char* name)
-{
-    return m_head->is_dup_string(name);
-}
-
 void SymTab::open_scope()
 {
     m_cur_scope = m_cur_scope->open_scope();
@@ -153,21 +134,16 @@ SymScope* SymTab::get_scope()
     return m_cur_scope;
 }
 
-bool SymTab::exist(char* name)
+bool SymTab::exist(const char* name)
 {
     assert(name != NULL);
     return m_cur_scope->exist(name);
 }
 
-bool SymTab::insert(char* name, Symbol* s)
+bool SymTab::insert(const char* name, Symbol* s)
 {
     assert(name != NULL);
     assert(s != NULL);
-    // the assert below fails, it is because you tried to insert
-    // a pointer to a string that is already in the SymTab.  You
-    // can have duplicate names, but each needs to reside it it's
-    // own chunk of memory (see example)
-    assert(is_dup_string(name));
     Symbol* r = m_cur_scope->insert(name, s);
     if(r == NULL) {
         return true;
@@ -176,15 +152,10 @@ bool SymTab::insert(char* name, Symbol* s)
     }
 }
 
-bool SymTab::insert_in_parent_scope(char* name, Symbol* s)
+bool SymTab::insert_in_parent_scope(const char* name, Symbol* s)
 {
     assert(name != NULL);
     assert(s != NULL);
-    // the assert below fails, it is because you tried to insert
-    // a pointer to a string that is already in the SymTab.  You
-    // can have duplicate names, but each needs to reside it it's
-    // own chunk of memory (see example)
-    assert(is_dup_string(name));
     // make sure there is an actual parent scope
     assert(m_cur_scope->m_parent != NULL);
     Symbol* r = m_cur_scope->m_parent->insert(name, s);
@@ -208,6 +179,17 @@ Symbol* SymTab::lookup(SymScope* targetscope, const char* name)
     return targetscope->lookup(name);
 }
 
+void SymTab::drop_scope(SymScope* targetscope)
+{
+    assert(targetscope != NULL);
+    assert(targetscope->m_parent != NULL);
+    for(SymScope* s = m_cur_scope; s != NULL; s = s->m_parent) {
+        assert(s != targetscope);
+    }
+    targetscope->m_parent->m_child.remove(targetscope);
+    delete targetscope;
+}
+
 int SymTab::scopesize(SymScope* targetscope)
 {
     assert(targetscope != NULL);
@@ -248,13 +230,16 @@ SymScope::SymScope(SymScope * parent)
 
 SymScope::~SymScope()
 {
-    // Delete the keys, but not the symbols (symbols are linked elsewhere)
+    // Delete the symbols along with the keys.  The SymNames in the AST
+    // still point at them, so the table has to go only once the passes
+    // are done with the tree.
     for(ScopeTableType::iterator si = m_scopetable.begin(), this_si;
             si != m_scopetable.end();)
     {
         this_si = si;
         ++si;
 
+        delete this_si->second;
         m_scopetable.erase(this_si);
     }
 
@@ -284,7 +269,7 @@ void SymScope::dump(FILE* f, int nest_level)
         for(int i=0; i<nest_level; i++) {
             std::fprintf(f, "\t");
         }
-        std::fprintf(f, "| %s \n", (char*) si->first.c_str());
+        std::fprintf(f, "| %s \n", si->first);
     }
 
     for(int i=0; i<nest_level; i++) {
@@ -300,27 +285,6 @@ void SymScope::dump(FILE* f, int nest_level)
     }
 }
 
-bool SymScope::is_dup_string(char* name)
-{
-    ScopeTableType::iterator si = m_scopetable.find(name);
-    if(si != m_scopetable.end() && (char*)si->first.c_str() == name) {
-        // Check if the pointers match
-        return false;
-    }
-
-    for(std::list<SymScope*>::iterator li = m_child.begin();
-            li!=m_child.end(); ++li)
-    {
-        bool r = (*li)->is_dup_string(name);
-        if(r == false) {
-            return false;
-        }
-    }
-
-    // If it gets this far, there is no duplicate
-    return true;
-}
-
 void SymScope::add_child(SymScope* c)
 {
     m_child.push_back(c);
@@ -336,7 +300,7 @@ SymScope* SymScope::close_scope()
     return m_parent;
 }
 
-bool SymScope::exist( char* name )
+bool SymScope::exist( const char* name )
 {
     Symbol* s;
     s = lookup(name);
@@ -348,10 +312,10 @@ bool SymScope::exist( char* name )
     }
 }
 
-Symbol* SymScope::insert( char* name, Symbol * s )
+Symbol* SymScope::insert( const char* name, Symbol * s )
 {
     std::pair<ScopeTableType::iterator,bool> iret;
-    typedef std::pair<char*,Symbol*> hpair;
+    typedef std::pair<const char*,Symbol*> hpair;
     iret = m_scopetable.insert(hpair(name, s));
     if(iret.second == true) {
         // Insert was successfull
@@ -371,7 +335,7 @@ Symbol* SymScope::lookup( const char * name )
 {
     // First check the current table;
     ScopeTableType::const_iterator i;
-    i = m_scopetable.find( (char*) name );
+    i = m_scopetable.find( name );
     if(i != m_scopetable.end()) {
         return i->second;
     }
@@ -9,32 +9,39 @@
 
 #include <cassert>
 
-#include "ast.hpp"
+#include "arena.hpp"
 #include "attribute.hpp"
 
+class Visitor;
+class SymScope;
 class Symbol;
 
-class SymName
+// The spelling of a SymName comes from the StringPool (see strpool.hpp) and
+// is not owned by the SymName, so copies of it just share the pointer.
+// The nodes with a name keep it in themselves (it is inline in ast.cdef);
+// the names in a declaration are made in the current Arena, like the
+// nodes.  There is nothing virtual, so it is no bigger than what it holds.
+class SymName : public ArenaObject
 {
   private:
-    char* m_spelling; // "name" of the symbol
-    Symbol* m_symbol; // Pointer to the symbol for this name
+    const char* m_spelling; // "name" of the symbol (interned)
 
   public:
     SymName(const SymName &);
     SymName &operator=(const SymName &);
-    SymName(char* const x);
+    SymName(const char* x = NULL);
     ~SymName();
-    virtual void accept(Visitor *v);
-    virtual SymName *clone() const;
+    void accept(Visitor *v);
+    SymName *clone() const;
     void swap(SymName &);
 
     const char* spelling();
     const char* mangled_spelling();
-    Symbol* symbol();
-    void set_symbol( Symbol* symbol );
 
-    Attribute* m_parent_attribute; // pointer to the attribute of the parent of this node
+    // The scope typecheck looks the name up in, which codegen looks it up
+    // in again.  A procedure's name has the scope of its parameters and
+    // body instead.
+    SymScope* m_scope;
 };
 
 // this is one-level of scope for the SymTab
@@ -127,12 +134,15 @@ class Symbol
 // in class. There is a open and close scope to grow a symbol table tree.
 // lookup and exist recurisively search all of the parent scopes, while insert
 // considers only the current scope.  An example chunk of code is below
+//
+// Names are keyed by their pointer, so they have to be interned in the
+// StringPool (which is where SymName::spelling() gets them from).  The
+// SymTab does not own them.
 class SymTab
 {
   private:
     SymScope* m_head;
     SymScope* m_cur_scope;
-    bool is_dup_string(char*);
 
   public:
     SymTab();
@@ -144,21 +154,22 @@ class SymTab
     // Return the current scope so that we can search within that scope later
     SymScope* get_scope();
 
+    // Deletes targetscope, which has to be closed, with the scopes inside
+    // it and all their symbols.  This is for a procedure that has been
+    // compiled, when nothing will look in its scopes again.
+    void drop_scope(SymScope* targetscope);
+
     // Returns true if name is found in the current SymTab or any of the
     // parents
-    bool exist(char* name);
+    bool exist(const char* name);
 
     // Tries to insert a pointer to s into the symbol table and returns true
-    // if successful.
-    // name should be a "fresh" copy, meaning that the SymTab will keep track
-    // of the memory pointed to by name and free it in the destructor. name
-    // should not point to some memory that has already been inserted into the
-    // symtab (see example)
-    bool insert(char* name, Symbol* s);
+    // if successful (false if name is already in the current scope).
+    bool insert(const char* name, Symbol* s);
 
     // Does an insert into the parent scope of the working scope (it will have
     // an assert failure if there is no parent scope)
-    bool insert_in_parent_scope(char* name, Symbol* s);
+    bool insert_in_parent_scope(const char* name, Symbol* s);
 
     // Tries to locate name in the current SymTab and all of the parent
     // SymTabs
@@ -190,14 +201,15 @@ class SymTab
 * //---------------------------------------------
 * // SymTab example code
 * //---------------------------------------------
+*   StringPool pool;
 *   SymTab st;
 *
-*   // each entry in the SymTab needs a unique copy of
-*   // a string for the key (which it will delete
-*   // in the destructor)
-*   char* foo_string = strdup("foo");
-*   char* foo2_string = strdup("foo");
-*   char* bar_string = strdup("bar");
+*   // names are keyed by pointer, so they have to
+*   // come from the pool.  Interning the same
+*   // spelling twice gives the same pointer
+*   const char* foo_string = pool.intern("foo");
+*   const char* bar_string = pool.intern("bar");
+*   assert( pool.intern("foo") == foo_string );
 *
 *   // each entry also needs a pointer to a symbol.
 *   // don't need to be uniqe, multiple
@@ -210,7 +222,7 @@ class SymTab
 *   assert( is_inserted );
 *   is_inserted = st.insert( bar_string, bar_s );
 *   assert( is_inserted );
-*   is_inserted = st.insert( foo2_string, foo_s );
+*   is_inserted = st.insert( foo_string, foo_s );
 *   // this assert should fail if uncommented because
 *   // the above insert would not have been successful
 *   // because there is another "foo" in this scope
@@ -218,33 +230,23 @@ class SymTab
 *
 *   st.open_scope();
 *
-*   // if you uncomment the statement below, it should
-*   // fail because it is trying to put a second copy
-*   // of the "foo" pointed to by foo_string.
-*   // is_inserted = st.insert( foo_string, foo_s );
-*
-*   // instead you need to insert a differt string
-*   // which has the same contents
-*   is_inserted = st.insert( foo2_string, foo_s );
+*   // a new scope can have its own "foo"
+*   is_inserted = st.insert( foo_string, foo_s );
 *   assert( is_inserted );
 *
 *   Symbol* f;
 *   // now some lookups
 *
 *   // should find this in the current scope
-*   f = st.lookup(foo2_string);
-*   assert( f != NULL );
-*   fprintf(stderr,"(%s)\n",f->spelling());
-*   assert( !strcmp(f->spelling(),"foo") );
+*   f = st.lookup(foo_string);
+*   assert( f == foo_s );
 *
 *   // should find this in the parent scope
 *   f = st.lookup(bar_string);
-*   assert( f != NULL);
-*   fprintf(stderr,"(%s)\n",f->spelling());
-*   assert( !strcmp(f->spelling(),"bar") );
+*   assert( f == bar_s );
 *
 *   // should not find this at all
-*   f = st.lookup("snap");
+*   f = st.lookup(pool.intern("snap"));
 *   assert( f == NULL);
 * //--------------------------------------------
 */
@@ -5,20 +5,23 @@
 #include "ast.hpp"
 #include "symtab.hpp"
 #include "primitive.hpp"
+#include "compile.hpp"
 #include "assert.h"
 
-// WRITEME: The default attribute propagation rule
-#define default_rule(X) \
-    (X)->m_attribute.m_scope = m_st->get_scope(); \
-    (X)->visit_children(this); \
-
 #include <typeinfo>
+#include <vector>
 
-class Typecheck : public Visitor
+// The checks on a node come after its children (postX), which have their
+// types by then, and the names under a node get the current scope
+// (visitSymName).  The walk is a StackVisitor's, so a deep expression does
+// not run out of stack.
+class Typecheck : public StackVisitor<Typecheck>
 {
   private:
     FILE* m_errorfile;
     SymTab* m_st;
+    std::vector<Symbol*> m_procs;   // the procedures being checked, the
+                                    // innermost last
 
     // The set of recognized errors
     enum errortype
@@ -46,7 +49,7 @@ class Typecheck : public Visitor
         invalid_deref
     };
 
-    // Print the error to file and exit
+    // Print the error to file and give up on the program
     void t_error(errortype e, Attribute a)
     {
         fprintf(m_errorfile,"on line number %d, ", a.lineno);
@@ -55,67 +58,67 @@ class Typecheck : public Visitor
         {
             case no_main:
                 fprintf(m_errorfile, "error: no main\n");
-                exit(2);
+                throw CompileError(2);
             case nonvoid_main:
                 fprintf(m_errorfile, "error: the Main procedure has arguments\n");
-                exit(3);
+                throw CompileError(3);
             case dup_proc_name:
                 fprintf(m_errorfile, "error: duplicate procedure names in same scope\n");
-                exit(4);
+                throw CompileError(4);
             case dup_var_name:
                 fprintf(m_errorfile, "error: duplicate variable names in same scope\n");
-                exit(5);
+                throw CompileError(5);
             case proc_undef:
                 fprintf(m_errorfile, "error: call to undefined procedure\n");
-                exit(6);
+                throw CompileError(6);
             case var_undef:
                 fprintf(m_errorfile, "error: undefined variable\n");
-                exit(7);
+                throw CompileError(7);
             case narg_mismatch:
                 fprintf(m_errorfile, "error: procedure call has different number of args than declartion\n");
-                exit(8);
+                throw CompileError(8);
             case arg_type_mismatch:
                 fprintf(m_errorfile, "error: argument type mismatch\n");
-                exit(9);
+                throw CompileError(9);
             case ret_type_mismatch:
                 fprintf(m_errorfile, "error: type mismatch in return statement\n");
-                exit(10);
+                throw CompileError(10);
             case call_type_mismatch:
                 fprintf(m_errorfile, "error: type mismatch in procedure call args\n");
-                exit(11);
+                throw CompileError(11);
             case ifpred_err:
                 fprintf(m_errorfile, "error: predicate of if statement is not boolean\n");
-                exit(12);
+                throw CompileError(12);
             case whilepred_err:
                 fprintf(m_errorfile, "error: predicate of while statement is not boolean\n");
-                exit(13);
+                throw CompileError(13);
             case array_index_error:
                 fprintf(m_errorfile, "error: array index not integer\n");
-                exit(14);
+                throw CompileError(14);
             case no_array_var:
                 fprintf(m_errorfile, "error: attempt to index non-array variable\n");
-                exit(15);
+                throw CompileError(15);
             case incompat_assign:
                 fprintf(m_errorfile, "error: type of expr and var do not match in assignment\n");
-                exit(16);
+                throw CompileError(16);
             case expr_type_err:
                 fprintf(m_errorfile, "error: incompatible types used in expression\n");
-                exit(17);
+                throw CompileError(17);
             case expr_abs_error:
                 fprintf(m_errorfile, "error: absolute value can only be applied to integers and strings\n");
-                exit(17);
+                throw CompileError(17);
             case expr_pointer_arithmetic_err:
                 fprintf(m_errorfile, "error: invalid pointer arithmetic\n");
-                exit(18);
+                throw CompileError(18);
             case expr_addressof_error:
                 fprintf(m_errorfile, "error: AddressOf can only be applied to integers, chars, and indexed strings\n");
-                exit(19);
+                throw CompileError(19);
             case invalid_deref:
                 fprintf(m_errorfile, "error: Deref can only be applied to integer pointers and char pointers\n");
-                exit(20);
+                throw CompileError(20);
             default:
                 fprintf(m_errorfile, "error: no good reason\n");
-                exit(21);
+                throw CompileError(21);
         }
     }
 
@@ -123,22 +126,22 @@ class Typecheck : public Visitor
     // WRITEME: You might want write some hepler functions.
     const char* lhs_to_id(Lhs* lhs)
     {
-        Variable *v = dynamic_cast<Variable*>(lhs);
+        Variable *v = dyn_cast<Variable>(lhs);
         if(v)
         {
-            return v->m_symname->spelling(); 
+            return v->m_symname.spelling(); 
         }
 
-        DerefVariable *dv = dynamic_cast<DerefVariable*>(lhs);
+        DerefVariable *dv = dyn_cast<DerefVariable>(lhs);
         if(dv)
         {
-            return dv->m_symname->spelling(); 
+            return dv->m_symname.spelling(); 
         }
 
-        ArrayElement *ae = dynamic_cast<ArrayElement*>(lhs);
+        ArrayElement *ae = dyn_cast<ArrayElement>(lhs);
         if(ae)
         {
-            return ae->m_symname->spelling(); 
+            return ae->m_symname.spelling(); 
         }
 
         return nullptr; 
@@ -158,8 +161,8 @@ class Typecheck : public Visitor
 
         for(auto it = p->m_proc_list->begin(); it != p->m_proc_list->end(); it++)
         {
-            ProcImpl *pip = dynamic_cast<ProcImpl*>((*it));
-            char *name = strdup(pip->m_symname->spelling()); 
+            ProcImpl *pip = cast<ProcImpl>((*it));
+            const char *name = pip->m_symname.spelling(); 
 
             if(strcmp(name, "Main") == 0)
             {
@@ -187,40 +190,42 @@ class Typecheck : public Visitor
     }
 
     // Create a symbol for the procedure and check there is none already
-    // existing
+    // existing, and open the scope of its parameters and body
     void add_proc_symbol(ProcImpl* p)
     {
         Symbol *s = new Symbol(); 
-        char *name = strdup(p->m_symname->spelling());
+        const char *name = p->m_symname.spelling();
         s->m_basetype = bt_procedure; //Set basetype of symbol
 
         if(!m_st->insert(name, s))
         {
+            delete s;
             this->t_error(dup_proc_name, p->m_attribute);
         }
 
 
         m_st->open_scope(); //Open scope for current procedure
+        m_procs.push_back(s);
 
-        (p)->m_attribute.m_scope = m_st->get_scope();
+        (p)->m_symname.m_scope = m_st->get_scope();
+    }
 
-        //Recursively process args and add to m_arg_type array
+    // Once the args and the return type have been through the walk, add
+    // their types to the procedure's symbol, before the body (which can
+    // call the procedure)
+    void set_proc_types(ProcImpl* p)
+    {
+        Symbol *s = m_procs.back();
         for(auto it = p->m_decl_list->begin(); it != p->m_decl_list->end(); it++)
         {
-            DeclImpl *dip = dynamic_cast<DeclImpl*>((*it)); 
-            dip->accept(this);
-
+            DeclImpl *dip = cast<DeclImpl>((*it)); 
             for(int i = 0; i < dip->m_symname_list->size(); i++)
             {
                 s->m_arg_type.push_back(dip->m_type->m_attribute.m_basetype);
             }
         }        
 
-        p->m_type->accept(this); //Accept return type of proc
         s->m_return_type = p->m_type->m_attribute.m_basetype; //Set m_return_type in symbol
-        //m_st->insert_in_parent_scope(name, s); //Insert in parent scope
-        p->m_procedure_block->accept(this); //Accept body
-        m_st->close_scope(); //Close scope
     }
 
     // Add symbol table information for all the declarations following
@@ -229,14 +234,15 @@ class Typecheck : public Visitor
         for(auto it = p->m_symname_list->begin(); it != p->m_symname_list->end(); it++)
         {
             Symbol *s = new Symbol(); 
-            char *name = strdup((*it)->spelling());
-            auto wut = dynamic_cast<TString *>(p->m_type);
+            const char *name = (*it)->spelling();
+            auto wut = dyn_cast<TString>(p->m_type);
             if(wut){
-                s->m_string_size = wut->m_primitive->m_data;
+                s->m_string_size = wut->m_primitive.m_data;
             }
             s->m_basetype = p->m_type->m_attribute.m_basetype; 
             if(!m_st->insert(name, s))
             {
+                delete s;
                 this->t_error(dup_var_name, p->m_attribute);
             }   
         }
@@ -246,7 +252,7 @@ class Typecheck : public Visitor
     void check_proc(ProcImpl *p)
     {
         //Get proc block impl
-        Procedure_blockImpl *pb = dynamic_cast<Procedure_blockImpl*>(p->m_procedure_block); 
+        Procedure_blockImpl *pb = cast<Procedure_blockImpl>(p->m_procedure_block); 
         //Special case for return null
         if(pb->m_return_stat->m_attribute.m_basetype == bt_ptr && ((p->m_type->m_attribute.m_basetype == bt_charptr) || (p->m_type->m_attribute.m_basetype == bt_intptr)))
         {
@@ -271,7 +277,7 @@ class Typecheck : public Visitor
     {
         Symbol *sf, *sid; 
         const char *id = lhs_to_id(p->m_lhs); 
-        const char *f = p->m_symname->spelling(); 
+        const char *f = p->m_symname.spelling(); 
 
         //Check if LHS is defined - i.e. check for undefined variable
         if((sid = m_st->lookup(id)) == 0)
@@ -305,7 +311,7 @@ class Typecheck : public Visitor
 
         //Check argument type
         std::vector<Basetype>::iterator formal_args_iter = sf->m_arg_type.begin(); 
-        for(std::list<Expr_ptr>::iterator act_args_iter = p->m_expr_list->begin(); act_args_iter != p->m_expr_list->end(); act_args_iter++, formal_args_iter++)
+        for(Expr_list::iterator act_args_iter = p->m_expr_list->begin(); act_args_iter != p->m_expr_list->end(); act_args_iter++, formal_args_iter++)
         {
             Basetype act_type = (*act_args_iter)->m_attribute.m_basetype; 
             Basetype form_type = (*formal_args_iter); 
@@ -354,12 +360,12 @@ class Typecheck : public Visitor
         {
             if(!(  ((sid->m_basetype == bt_charptr) && (p->m_expr->m_attribute.m_basetype == bt_ptr)) 
                 || ((sid->m_basetype == bt_intptr) && (p->m_expr->m_attribute.m_basetype == bt_ptr))
-                || ((dynamic_cast<ArrayElement*>(p->m_lhs)) && (p->m_expr->m_attribute.m_basetype == bt_char)) ))
+                || (isa<ArrayElement>(p->m_lhs) && (p->m_expr->m_attribute.m_basetype == bt_char)) ))
             {
-                if(((dynamic_cast<DerefVariable*>(p->m_lhs))))
+                if(isa<DerefVariable>(p->m_lhs))
                 {
-                    DerefVariable *dv = ((dynamic_cast<DerefVariable*>(p->m_lhs))); 
-                    char* name = strdup(dv->m_symname->spelling());
+                    DerefVariable *dv = cast<DerefVariable>(p->m_lhs); 
+                    const char* name = dv->m_symname.spelling();
                     Symbol *s = m_st->lookup(name);
                     if(!((s->m_basetype == bt_intptr && p->m_expr->m_attribute.m_basetype == bt_integer) || (s->m_basetype == bt_charptr && p->m_expr->m_attribute.m_basetype == bt_char)))
                     {
@@ -395,7 +401,7 @@ class Typecheck : public Visitor
     void check_array_access(ArrayAccess* p)
     {
         //Check is symname is defined
-        char *name = strdup(p->m_symname->spelling());
+        const char *name = p->m_symname.spelling();
         if(!(m_st->exist(name)))
         {
             this->t_error(var_undef, p->m_attribute);
@@ -418,7 +424,7 @@ class Typecheck : public Visitor
     void check_array_element(ArrayElement* p)
     {
         //Check is symname is defined
-        char *name = strdup(p->m_symname->spelling());
+        const char *name = p->m_symname.spelling();
         if(!(m_st->exist(name)))
         {
             this->t_error(var_undef, p->m_attribute);
@@ -572,14 +578,14 @@ class Typecheck : public Visitor
         {
             parent->m_attribute.m_basetype = bt_intptr; 
         }
-        else if(sid->m_basetype == bt_char || (dynamic_cast<ArrayElement*>(child)) )
+        else if(sid->m_basetype == bt_char || isa<ArrayElement>(child))
         {
             parent->m_attribute.m_basetype = bt_charptr; 
         }
-        else if((dynamic_cast<DerefVariable*>(child)))
+        else if(isa<DerefVariable>(child))
         {
-            DerefVariable *dv = (dynamic_cast<DerefVariable*>(child)); 
-            char* name = strdup(dv->m_symname->spelling()); 
+            DerefVariable *dv = cast<DerefVariable>(child); 
+            const char* name = dv->m_symname.spelling(); 
             Symbol *s = m_st->lookup(name); 
             if(s->m_basetype == bt_intptr)
             {
@@ -622,7 +628,7 @@ class Typecheck : public Visitor
     void checkset_deref_lhs(DerefVariable* p)
     {
         //Check is symname is defined
-        char *name = strdup(p->m_symname->spelling());
+        const char *name = p->m_symname.spelling();
         if(!(m_st->exist(name)))
         {
             this->t_error(var_undef, p->m_attribute);
@@ -649,7 +655,7 @@ class Typecheck : public Visitor
         //Duplicate variables checked by add_decl_symbol
         //Variables added to symbol table in add_decl_symbol/DeclImpl as well
         //Check if variable is in symbol table and throw error if it isn't
-        char *name = strdup(p->m_symname->spelling());
+        const char *name = p->m_symname.spelling();
         if(m_st->exist(name))
         {
             Symbol* s = m_st->lookup(name);
@@ -669,65 +675,91 @@ class Typecheck : public Visitor
         m_st = st;
     }
 
-    void visitProgramImpl(ProgramImpl* p)
+    bool preProgramImpl(ProgramImpl* p)
+    {
+        check_program(p);
+        return true;
+    }
+
+    // The checks on the program as a whole, which only look at the names
+    // and parameters of the procedures
+    void check_program(ProgramImpl* p)
     {
-        (p)->m_attribute.m_scope = m_st->get_scope();
         check_for_one_main(p); 
-        for(auto it = p->m_proc_list->begin(); it != p->m_proc_list->end(); it++)
+    }
+
+    bool preProcImpl(ProcImpl* p)
+    {
+        add_proc_symbol(p); 
+        return true;
+    }
+
+    // The args, the return type and then the body; the name already has
+    // its scope (add_proc_symbol)
+    bool stepProcImpl(ProcImpl* p, unsigned i)
+    {
+        size_t nargs = p->m_decl_list->size();
+        if(i < nargs)
+        {
+            child((*p->m_decl_list)[i]);
+        }
+        else if(i == nargs)
         {
-            ProcImpl *pip = dynamic_cast<ProcImpl*>((*it));
-            pip->accept(this);
+            child(p->m_type);
         }
+        else if(i == nargs + 1)
+        {
+            set_proc_types(p);
+            child(p->m_procedure_block);
+        }
+        else
+        {
+            return false;
+        }
+        return true;
     }
 
-    void visitProcImpl(ProcImpl* p)
+    void postProcImpl(ProcImpl* p)
     {
-        //(p)->m_attribute.m_scope = m_st->get_scope();
-        add_proc_symbol(p); 
+        m_st->close_scope(); //Close scope
+        m_procs.pop_back();
         check_proc(p); 
     }
 
-    void visitCall(Call* p)
+    void postCall(Call* p)
     {
-        default_rule(p)
         check_call(p);
     }
 
-    void visitNested_blockImpl(Nested_blockImpl* p)
+    bool preNested_blockImpl(Nested_blockImpl*)
     {
-         m_st->open_scope(); 
-        default_rule(p)
-        m_st->close_scope(); 
+        m_st->open_scope(); 
+        return true;
     }
 
-    void visitProcedure_blockImpl(Procedure_blockImpl* p)
+    void postNested_blockImpl(Nested_blockImpl*)
     {
-        default_rule(p)
-        p->m_attribute.m_basetype = p->m_parent_attribute->m_basetype; 
+        m_st->close_scope(); 
     }
 
-    void visitDeclImpl(DeclImpl* p)
+    void postDeclImpl(DeclImpl* p)
     {
-        default_rule(p)
         add_decl_symbol(p);
     }
 
-    void visitAssignment(Assignment* p)
+    void postAssignment(Assignment* p)
     {
-        default_rule(p)
         check_assignment(p);
     }
 
-    void visitStringAssignment(StringAssignment *p)
+    void postStringAssignment(StringAssignment* p)
     {
-        default_rule(p)
         check_string_assignment(p);
     }
 
-    void visitIdent(Ident* p)
+    void postIdent(Ident* p)
     {
-        default_rule(p)
-        char *name = strdup(p->m_symname->spelling());
+        const char *name = p->m_symname.spelling();
         if(m_st->exist(name))
         {
             Symbol* s = m_st->lookup(name);
@@ -739,116 +771,93 @@ class Typecheck : public Visitor
         }
     }
 
-    void visitReturn(Return* p)
+    void postReturn(Return* p)
     {
-        default_rule(p)
         check_return(p);
     }
 
-    void visitIfNoElse(IfNoElse* p)
+    void postIfNoElse(IfNoElse* p)
     {
-        default_rule(p)
         check_pred_if(p->m_expr); 
     }
 
-    void visitIfWithElse(IfWithElse* p)
+    void postIfWithElse(IfWithElse* p)
     {
-        default_rule(p)
         check_pred_if(p->m_expr);
     }
 
-    void visitWhileLoop(WhileLoop* p)
+    void postWhileLoop(WhileLoop* p)
     {
-        default_rule(p)
         check_pred_while(p->m_expr);
     }
 
-    void visitCodeBlock(CodeBlock *p) 
+    void postTInteger(TInteger* p)
     {
-        default_rule(p)
-    }
-
-    void visitTInteger(TInteger* p)
-    {
-        default_rule(p)
         p->m_attribute.m_basetype = bt_integer;
     }
 
-    void visitTBoolean(TBoolean* p)
+    void postTBoolean(TBoolean* p)
     {
-        default_rule(p)
         p->m_attribute.m_basetype = bt_boolean;
     }
 
-    void visitTCharacter(TCharacter* p)
+    void postTCharacter(TCharacter* p)
     {
-        default_rule(p)
         p->m_attribute.m_basetype = bt_char; 
     }
 
-    void visitTString(TString* p)
+    void postTString(TString* p)
     {
-        default_rule(p)
         p->m_attribute.m_basetype = bt_string;
     }
 
-    void visitTCharPtr(TCharPtr* p)
+    void postTCharPtr(TCharPtr* p)
     {
-        default_rule(p)
         p->m_attribute.m_basetype = bt_charptr; 
     }
 
-    void visitTIntPtr(TIntPtr* p)
+    void postTIntPtr(TIntPtr* p)
     {
-        default_rule(p)
         p->m_attribute.m_basetype = bt_intptr; 
     }
 
-    void visitAnd(And* p)
+    void postAnd(And* p)
     {
-        default_rule(p)
         checkset_boolexpr(p, p->m_expr_1, p->m_expr_2);
     }
 
-    void visitDiv(Div* p)
+    void postDiv(Div* p)
     {
-        default_rule(p)
         checkset_arithexpr(p, p->m_expr_1, p->m_expr_2);
     }
 
-    void visitCompare(Compare* p)
+    void postCompare(Compare* p)
     {
-        default_rule(p)
         checkset_equalityexpr(p, p->m_expr_1, p->m_expr_2); 
     }
 
-    void visitGt(Gt* p)
+    void postGt(Gt* p)
     {
-        default_rule(p)
         checkset_relationalexpr(p, p->m_expr_1, p->m_expr_2);
     }
 
-    void visitGteq(Gteq* p)
+    void postGteq(Gteq* p)
     {
-        default_rule(p)
         checkset_relationalexpr(p, p->m_expr_1, p->m_expr_2);
     }
 
-    void visitLt(Lt* p)
+    void postLt(Lt* p)
     {
-        default_rule(p)
         checkset_relationalexpr(p, p->m_expr_1, p->m_expr_2);
     }
 
-    void visitLteq(Lteq* p)
+    void postLteq(Lteq* p)
     {
-        default_rule(p)
         checkset_relationalexpr(p, p->m_expr_1, p->m_expr_2);
     }
 
-    void visitMinus(Minus* p)
+    void postMinus(Minus* p)
     {
-        default_rule(p)
         if(p->m_expr_1->m_attribute.m_basetype == bt_charptr)
         {
             checkset_arithexpr_or_pointer(p, p->m_expr_1, p->m_expr_2);
@@ -859,21 +868,18 @@ class Typecheck : public Visitor
         }
     }
 
-    void visitNoteq(Noteq* p)
+    void postNoteq(Noteq* p)
     {
-        default_rule(p)
         checkset_equalityexpr(p, p->m_expr_1, p->m_expr_2);
     }
 
-    void visitOr(Or* p)
+    void postOr(Or* p)
     {
-        default_rule(p)
         checkset_boolexpr(p, p->m_expr_1, p->m_expr_2);
     }
 
-    void visitPlus(Plus* p)
+    void postPlus(Plus* p)
     {
-        default_rule(p)
         if(p->m_expr_1->m_attribute.m_basetype == bt_charptr)
         {
             checkset_arithexpr_or_pointer(p, p->m_expr_1, p->m_expr_2);
@@ -884,100 +890,103 @@ class Typecheck : public Visitor
         }
     }
 
-    void visitTimes(Times* p)
+    void postTimes(Times* p)
     {
-        default_rule(p)
         checkset_arithexpr(p, p->m_expr_1, p->m_expr_2);
     }
 
-    void visitNot(Not* p)
+    void postNot(Not* p)
     {
-        default_rule(p)
         checkset_not(p, p->m_expr);
     }
 
-    void visitUminus(Uminus* p)
+    void postUminus(Uminus* p)
     {
-        default_rule(p)
         checkset_uminus(p, p->m_expr);
     }
 
-    void visitArrayAccess(ArrayAccess* p)
+    void postArrayAccess(ArrayAccess* p)
     {
-        default_rule(p)
         check_array_access(p); 
     }
 
-    void visitIntLit(IntLit* p)
+    void postIntLit(IntLit* p)
     {
-        default_rule(p); 
         p->m_attribute.m_basetype = bt_integer; 
     }
 
-    void visitCharLit(CharLit* p)
+    void postCharLit(CharLit* p)
     {
-        default_rule(p)
         p->m_attribute.m_basetype = bt_char; 
     }
 
-    void visitBoolLit(BoolLit* p)
+    void postBoolLit(BoolLit* p)
     {
-        default_rule(p)
         p->m_attribute.m_basetype = bt_boolean;
     }
 
-    void visitNullLit(NullLit* p)
+    void postNullLit(NullLit* p)
     {
-        default_rule(p)
         p->m_attribute.m_basetype = bt_ptr; 
     }
 
-    void visitAbsoluteValue(AbsoluteValue* p)
+    void postAbsoluteValue(AbsoluteValue* p)
     {
-        default_rule(p)
         checkset_absolute_value(p, p->m_expr);
     }
 
-    void visitAddressOf(AddressOf* p)
+    void postAddressOf(AddressOf* p)
     {
-        default_rule(p)
         checkset_addressof(p, p->m_lhs); 
     }
 
-    void visitVariable(Variable* p)
+    void postVariable(Variable* p)
     {
-        default_rule(p)
         checkset_variable(p);
     }
 
-    void visitDeref(Deref* p)
+    void postDeref(Deref* p)
     {
-        default_rule(p)
         checkset_deref_expr(p, p->m_expr); 
     }
 
-    void visitDerefVariable(DerefVariable* p)
+    void postDerefVariable(DerefVariable* p)
     {
-        default_rule(p)
         checkset_deref_lhs(p); 
     }
 
-    void visitArrayElement(ArrayElement* p)
+    void postArrayElement(ArrayElement* p)
     {
-        default_rule(p)
         check_array_element(p);
     }
 
     // Special cases
-    void visitPrimitive(Primitive* p) {}
-    void visitSymName(SymName* p) {}
-    void visitStringPrimitive(StringPrimitive* p) {}
+    void visitSymName(SymName* p) {
+        p->m_scope = m_st->get_scope();
+    }
 };
 
 
-void dopass_typecheck(Program_ptr ast, SymTab* st)
+void dopass_typecheck(Program_ptr ast, SymTab* st, FILE* errors)
+{
+    Typecheck typecheck(errors, st);
+    typecheck.walk(ast); // Walk the tree with the visitor above
+}
+
+// The same pass a procedure at a time, for compiling while the parser is
+// still reading the rest of the program: typecheck_proc on each top level
+// procedure in order, then typecheck_program on the whole program.  The
+// program checks come first in dopass_typecheck, so an error from
+// typecheck_program is the one to report even when typecheck_proc has
+// already found another.
+void typecheck_proc(Proc_ptr proc, SymTab* st, FILE* errors)
+{
+    Typecheck typecheck(errors, st);
+    typecheck.walk(proc);
+}
+
+void typecheck_program(Program_ptr ast, SymTab* st, FILE* errors)
 {
-    Typecheck* typecheck = new Typecheck(stderr, st);
-    ast->accept(typecheck); // Walk the tree with the visitor above
-    delete typecheck;
+    Typecheck typecheck(errors, st);
+    typecheck.check_program(cast<ProgramImpl>(ast));
 }